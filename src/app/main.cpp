@@ -1,53 +1,129 @@
-#include <iostream>
+#include <atomic>
+#include <chrono>
 #include <memory>
 #include <csignal>
+#include <cstdlib>
 #include <exception>
+#include <thread>
 
+#include "maat_core/configuration.h"
 #include "maat_core/core_manager.h"
+#include "maat_core/event_trace.h"
+#include "maat_core/log.h"
 #include "maat_core/maat_mediator.h"
+#include "maat_core/session_store.h"
+#ifdef _WIN32
 #include "maat_platform_windows/windows_platform_manager.h"
+using NativePlatformManager = maat::platform::WindowsPlatformManager;
+// Hook callbacks only enqueue; layout runs on the mediator's core thread
+constexpr auto kThreadingMode = maat::core::MaatMediator::ThreadingMode::DedicatedThread;
+// A hung application stalls DeferWindowPos; keep that off the core thread
+constexpr bool kApplyThread = true;
+#else
+#include "maat_platform_sim/sim_platform_manager.h"
+using NativePlatformManager = maat::platform::SimPlatformManager;
+// The simulated backend is single-threaded and deterministic
+constexpr auto kThreadingMode = maat::core::MaatMediator::ThreadingMode::Inline;
+constexpr bool kApplyThread = false;
+#endif
 
-static maat::core::MaatMediator* g_mediator = nullptr;
+// Set by the signal handler, which may do nothing else: logging and the
+// mediator are not async-signal-safe. A watcher thread acts on it.
+static std::atomic<int> g_stopSignal{0};
+static_assert(ATOMIC_INT_LOCK_FREE == 2, "the stop flag must be lock-free to be set from a signal handler");
 
-// Signal handler to trigger shutdown via mediator
 void signalHandler(int signum) {
-    std::cout << "\nSignal (" << signum << ") received. Shutting down...\n";
-    if (g_mediator) {
-        g_mediator->shutdown();
-    }
+    g_stopSignal.store(signum, std::memory_order_relaxed);
 }
 
 int main() {
     // Register SIGINT handler (Ctrl+C)
     std::signal(SIGINT, signalHandler);
 
-    std::cout << "Creating components..." << std::endl;
+    // MAAT_RECORD_TRACE=<file> records every platform event for offline
+    // replay (maat_replay). Declared first so it outlives the mediator.
+    maat::core::EventTraceWriter traceWriter;
+    const char* tracePath = std::getenv("MAAT_RECORD_TRACE");
+
+    // MAAT_CONFIG=<file> selects the configuration; a missing file means defaults
+    const char* configPath = std::getenv("MAAT_CONFIG");
+    maat::core::Configuration configuration(configPath && *configPath ? configPath : "maat.conf");
+    if (!configuration.load()) {
+        MAAT_LOG_WARN("Maat", "Configuration invalid; using defaults",
+                      maat::core::logField("path", configuration.path()),
+                      maat::core::logField("errors", configuration.errors().size()));
+    }
+
+    // MAAT_SESSION=<file> keeps the window arrangement across restarts
+    const char* sessionPath = std::getenv("MAAT_SESSION");
+    maat::core::SessionStore sessionStore(sessionPath && *sessionPath ? sessionPath : "maat.session");
+
+    MAAT_LOG_INFO("Maat", "Creating components");
     auto mediator = std::make_unique<maat::core::MaatMediator>();
-    g_mediator = mediator.get();
 
-    auto platformManager = std::make_unique<maat::platform::WindowsPlatformManager>(*mediator);
-    auto coreManager     = std::make_unique<maat::core::CoreManager>();
+    auto platformManager = std::make_unique<NativePlatformManager>(*mediator);
+    auto coreManager     = std::make_unique<maat::core::CoreManager>(*mediator);
 
-    std::cout << "Registering components with mediator..." << std::endl;
+    // Merge event bursts (e.g. application startup) into one layout pass per 60 Hz frame
+    mediator->setCoalescingWindow(16000);
+    mediator->setThreadingMode(kThreadingMode);
+    mediator->setApplyThread(kApplyThread);
+    if (tracePath && *tracePath && traceWriter.open(tracePath)) {
+        MAAT_LOG_INFO("Maat", "Recording event trace", maat::core::logField("path", tracePath));
+        mediator->setTraceWriter(&traceWriter);
+    }
+
+    MAAT_LOG_INFO("Maat", "Registering components with mediator");
     mediator->registerPlatformManager(*platformManager);
     mediator->registerCoreManager(*coreManager);
+    mediator->registerConfiguration(configuration);
+    mediator->registerSessionStore(sessionStore);
 
-    std::cout << "Initializing Maat via Mediator..." << std::endl;
+    MAAT_LOG_INFO("Maat", "Initializing via mediator");
     try {
         mediator->initialize();
     } catch (const std::exception& e) {
-        std::cerr << "Initialization failed: " << e.what() << std::endl;
+        MAAT_LOG_ERROR("Maat", "Initialization failed", maat::core::logField("error", e.what()));
+        MAAT_LOG_FLUSH();
         return 1;
     }
 
-    std::cout << "Running Maat via Mediator... Press Ctrl+C to exit." << std::endl;
+    // Polls the stop flag and shuts the mediator down from a normal thread
+    std::atomic<bool> running{true};
+    std::thread signalWatcher([&running, &mediator]() {
+        while (running.load(std::memory_order_relaxed)) {
+            const int signum = g_stopSignal.load(std::memory_order_relaxed);
+            if (signum != 0) {
+                MAAT_LOG_INFO("Maat", "Signal received, shutting down", maat::core::logField("signal", signum));
+                mediator->shutdown();
+                return;
+            }
+            std::this_thread::sleep_for(std::chrono::milliseconds(50));
+        }
+    });
+
+    MAAT_LOG_INFO("Maat", "Running; press Ctrl+C to exit");
+    bool failed = false;
     try {
         mediator->run();
     } catch (const std::exception& e) {
-        std::cerr << "Runtime error: " << e.what() << std::endl;
+        MAAT_LOG_ERROR("Maat", "Runtime error", maat::core::logField("error", e.what()));
+        failed = true;
+    }
+    running.store(false, std::memory_order_relaxed);
+    signalWatcher.join();
+    if (failed) {
+        MAAT_LOG_FLUSH();
         return 1;
     }
 
-    std::cout << "Maat finished." << std::endl;
+    mediator->logLatencyReport();
+    if (tracePath && *tracePath) {
+        traceWriter.close();
+        MAAT_LOG_INFO("Maat", "Event trace written", maat::core::logField("records", traceWriter.recordCount()),
+                      maat::core::logField("bytes", traceWriter.bytesWritten()));
+    }
+    MAAT_LOG_INFO("Maat", "Finished");
+    MAAT_LOG_FLUSH();
     return 0;
 }
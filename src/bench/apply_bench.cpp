@@ -0,0 +1,99 @@
+#include <chrono>
+#include <cstdio>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "bench.h"
+#include "maat_core/geometry_apply_stage.h"
+#include "maat_core/latency_histogram.h"
+#include "maat_platform/platform_manager.h"
+
+// Geometry apply against a platform whose every applyWindowGeometries call
+// takes `hang` milliseconds (a hung application inside EndDeferWindowPos):
+//   apply/hung_<ms>/inline   the layout thread applies itself
+//   apply/hung_<ms>/thread   the layout thread hands off to GeometryApplyStage
+// Layout produces a frame of 32 rects every 4 ms; block_* is how long it is
+// held up per frame, superseded_pct how many rects the mailbox never sent.
+
+namespace maat {
+namespace bench {
+
+namespace {
+
+using maat::core::GeometryApplyStage;
+using maat::core::LatencyHistogram;
+using maat::core::steadyMicros;
+using maat::platform::Rect;
+using maat::platform::WindowId;
+
+class HungPlatform : public maat::platform::PlatformManager {
+public:
+    explicit HungPlatform(std::chrono::milliseconds hang) : m_hang(hang) {}
+
+    void applyWindowGeometries(const std::vector<std::pair<WindowId, Rect>>&) override {
+        std::this_thread::sleep_for(m_hang);
+    }
+    void setWindowVisibility(const std::vector<std::pair<WindowId, bool>>&) override {}
+    void queryWindowGeometries(std::vector<std::pair<WindowId, Rect>>&) override {}
+    std::vector<maat::platform::Monitor*> enumerateMonitors() override { return {}; }
+    std::vector<maat::platform::Window*> enumerateInitialWindows() override { return {}; }
+    void releaseWindowTracking(WindowId, std::uint32_t) override {}
+    std::size_t reclassifyWindows() override { return 0; }
+    maat::platform::Timestamp getMonotonicTime() const override { return steadyMicros(); }
+    void scheduleWakeup(maat::platform::Timestamp) override {}
+    void startEventLoop() override {}
+    void stopEventLoop() override {}
+
+private:
+    std::chrono::milliseconds m_hang;
+};
+
+void benchHungApply(BenchContext& context) {
+    const int hangs[] = {5, 50};
+    const std::size_t kWindows = 32;
+    const std::size_t frames = context.quick() ? 25 : 100;
+    for (int hang : hangs) {
+        for (bool threaded : {false, true}) {
+            const std::string name =
+                "apply/hung_" + std::to_string(hang) + (threaded ? "/thread" : "/inline");
+            if (!context.selected(name)) continue;
+
+            HungPlatform platform{std::chrono::milliseconds(hang)};
+            GeometryApplyStage stage(platform);
+            if (threaded) stage.start();
+            LatencyHistogram block;
+            std::vector<std::pair<WindowId, Rect>> frame(kWindows);
+            for (std::size_t f = 0; f < frames; ++f) {
+                for (std::size_t w = 0; w < kWindows; ++w) {
+                    frame[w] = {static_cast<WindowId>(w + 1),
+                                Rect{static_cast<int>(f), static_cast<int>(w * 20), 400, 300}};
+                }
+                const std::uint64_t start = steadyMicros();
+                if (threaded) {
+                    stage.submitGeometry(frame);
+                } else {
+                    platform.applyWindowGeometries(frame);
+                }
+                block.record(steadyMicros() - start);
+                std::this_thread::sleep_for(std::chrono::milliseconds(4));
+            }
+            stage.stop();
+            const GeometryApplyStage::Stats stats = stage.stats();
+            const double submitted = static_cast<double>(frames * kWindows);
+            context.report(name, {{"block_p50_us", static_cast<double>(block.percentile(0.50))},
+                                  {"block_max_us", static_cast<double>(block.max())},
+                                  {"batches", static_cast<double>(threaded ? stats.batches : frames)},
+                                  {"superseded_pct", threaded ? 100.0 * stats.superseded / submitted : 0.0},
+                                  {"max_batch", static_cast<double>(threaded ? stats.maxBatchSize : kWindows)}});
+        }
+    }
+}
+
+} // namespace
+
+MAAT_BENCHMARK("apply", benchHungApply);
+
+} // namespace bench
+} // namespace maat
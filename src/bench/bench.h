@@ -0,0 +1,115 @@
+#ifndef MAAT_BENCH_BENCH_H
+#define MAAT_BENCH_BENCH_H
+
+#include <chrono>
+#include <cstdint>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace maat {
+namespace bench {
+
+// One named value of a benchmark result. Names are part of the output format
+// and must stay stable across releases (snake_case, unit as suffix).
+struct Metric {
+    std::string name;
+    double value;
+};
+
+struct BenchResult {
+    std::string name; // e.g. "layout/full/balanced/1000"
+    std::vector<Metric> metrics;
+};
+
+struct BenchOptions {
+    std::string filter;  // run only benchmarks whose name contains this
+    bool quick = false;  // smaller sizes and shorter timing, for smoke runs
+    double minSeconds = 0.2;
+};
+
+// Handed to every registered benchmark function: selects, times and collects
+// results.
+class BenchContext {
+public:
+    explicit BenchContext(const BenchOptions& options) : m_options(options) {}
+
+    bool quick() const { return m_options.quick; }
+    bool selected(const std::string& name) const {
+        return m_options.filter.empty() || name.find(m_options.filter) != std::string::npos;
+    }
+
+    // Runs `op` in growing batches until the minimum measuring time has
+    // passed and returns the mean wall time per call in nanoseconds. `op`
+    // must leave its state ready for the next call.
+    template <typename Fn>
+    double measureNsPerOp(Fn&& op) {
+        typedef std::chrono::steady_clock Clock;
+        op(); // warm caches and arenas
+        const double minNs = (m_options.quick ? 0.02 : m_options.minSeconds) * 1e9;
+        for (std::uint64_t iterations = 1;; iterations *= 2) {
+            const Clock::time_point start = Clock::now();
+            for (std::uint64_t i = 0; i < iterations; ++i) {
+                op();
+            }
+            const double elapsed = static_cast<double>(
+                std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - start).count());
+            if (elapsed >= minNs || iterations >= (std::uint64_t(1) << 30)) {
+                return elapsed / static_cast<double>(iterations);
+            }
+        }
+    }
+
+    void report(std::string name, std::vector<Metric> metrics) {
+        m_results.push_back({std::move(name), std::move(metrics)});
+    }
+
+    const std::vector<BenchResult>& results() const { return m_results; }
+
+private:
+    BenchOptions m_options;
+    std::vector<BenchResult> m_results;
+};
+
+typedef void (*BenchFunction)(BenchContext& context);
+
+struct BenchRegistration {
+    const char* group;
+    BenchFunction function;
+};
+
+// Benchmarks register themselves at static-initialisation time through
+// MAAT_BENCHMARK and run in registration order, grouped by translation unit.
+std::vector<BenchRegistration>& registeredBenchmarks();
+
+struct BenchRegistrar {
+    BenchRegistrar(const char* group, BenchFunction function) {
+        registeredBenchmarks().push_back({group, function});
+    }
+};
+
+#define MAAT_BENCH_CONCAT_(a, b) a##b
+#define MAAT_BENCH_CONCAT(a, b) MAAT_BENCH_CONCAT_(a, b)
+#define MAAT_BENCHMARK(group, function) \
+    static ::maat::bench::BenchRegistrar MAAT_BENCH_CONCAT(s_benchRegistrar, __LINE__)(group, function)
+
+// Deterministic PRNG (xorshift64*) so every run replays the same workload.
+class Random {
+public:
+    explicit Random(std::uint64_t seed = 0x9E3779B97F4A7C15ULL) : m_state(seed ? seed : 1) {}
+    std::uint64_t next() {
+        m_state ^= m_state >> 12;
+        m_state ^= m_state << 25;
+        m_state ^= m_state >> 27;
+        return m_state * 0x2545F4914F6CDD1DULL;
+    }
+    std::size_t below(std::size_t bound) { return bound ? static_cast<std::size_t>(next() % bound) : 0; }
+
+private:
+    std::uint64_t m_state;
+};
+
+} // namespace bench
+} // namespace maat
+
+#endif // MAAT_BENCH_BENCH_H
@@ -0,0 +1,133 @@
+#include <chrono>
+#include <cstdio>
+#include <filesystem>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "bench.h"
+#include "maat_core/configuration.h"
+
+// Configuration loading for files of 10..10,000 rules:
+//   config/parse/<n>    compileConfig() on the text (tokenize, validate, compile rules)
+//   config/cached/<n>   decodeConfig() on the binary cache of the same text
+//   config/reload/<n>   Configuration::reload() of a file with one rule edited,
+//                       cache rewrite included
+
+namespace maat {
+namespace bench {
+
+namespace {
+
+using maat::core::CompiledConfig;
+using maat::core::ConfigError;
+using maat::core::Configuration;
+
+// A large user configuration: settings, per-application rules and a few
+// dozen bindings. `variant` changes one rule so reloads see an edit.
+std::string makeConfigText(std::size_t ruleCount, std::size_t variant) {
+    std::string text = "# generated\nlayout = master_stack\nmaster_ratio = 0.6\ngaps = 8\n";
+    Random random(ruleCount);
+    for (std::size_t i = 0; i < ruleCount; ++i) {
+        const std::string n = std::to_string(i == 0 ? variant : i);
+        switch (random.below(6)) {
+            case 0: case 1: case 2:
+                text += "rule ignore process=app" + n + ".exe\n";
+                break;
+            case 3:
+                text += "rule manage class=Class" + n + " not_style=dialog\n";
+                break;
+            case 4:
+                text += "rule ignore process=app" + n + ".exe title~=\"Dialog " + n + "\"\n";
+                break;
+            default:
+                text += "rule ignore class=Class" + n + " max_size=400x300\n";
+                break;
+        }
+    }
+    for (int i = 1; i <= 9; ++i) {
+        text += "bind super+" + std::to_string(i) + " = workspace " + std::to_string(i) + "\n";
+        text += "bind super+shift+" + std::to_string(i) + " = move_to_workspace " + std::to_string(i) + "\n";
+    }
+    return text;
+}
+
+bool writeText(const std::string& path, const std::string& text) {
+    std::FILE* file = std::fopen(path.c_str(), "wb");
+    if (!file) return false;
+    const bool written = std::fwrite(text.data(), 1, text.size(), file) == text.size();
+    return std::fclose(file) == 0 && written;
+}
+
+void benchConfig(BenchContext& context) {
+    const std::size_t sizes[] = {10, 100, 1000, 10000};
+    const std::size_t sizeCount = context.quick() ? 3 : 4;
+    for (std::size_t s = 0; s < sizeCount; ++s) {
+        const std::size_t count = sizes[s];
+        const std::string text = makeConfigText(count, 0);
+        std::vector<ConfigError> errors;
+        const std::shared_ptr<const CompiledConfig> compiled = maat::core::compileConfig(text, errors);
+        if (!compiled) {
+            std::fprintf(stderr, "config bench: generated text invalid (%zu errors)\n", errors.size());
+            return;
+        }
+
+        const std::string parseName = "config/parse/" + std::to_string(count);
+        if (context.selected(parseName)) {
+            const double ns = context.measureNsPerOp([&]() {
+                errors.clear();
+                maat::core::compileConfig(text, errors);
+            });
+            context.report(parseName, {{"us_per_load", ns / 1000.0},
+                                       {"source_bytes", static_cast<double>(text.size())}});
+        }
+
+        const std::string cachedName = "config/cached/" + std::to_string(count);
+        if (context.selected(cachedName)) {
+            const std::vector<std::uint8_t> bytes = maat::core::encodeConfig(*compiled);
+            const double ns = context.measureNsPerOp([&]() {
+                maat::core::decodeConfig(bytes.data(), bytes.size(), compiled->sourceHash);
+            });
+            context.report(cachedName, {{"us_per_load", ns / 1000.0},
+                                        {"cache_bytes", static_cast<double>(bytes.size())}});
+        }
+
+        const std::string reloadName = "config/reload/" + std::to_string(count);
+        if (context.selected(reloadName)) {
+            const std::string path =
+                (std::filesystem::temp_directory_path() / ("maat_bench_" + std::to_string(count) + ".conf")).string();
+            const std::string edited = makeConfigText(count, count + 1);
+            Configuration configuration(path);
+            if (!writeText(path, text) || !configuration.load()) {
+                std::fprintf(stderr, "config bench: cannot write %s\n", path.c_str());
+                return;
+            }
+            // Alternates between the two texts; us_per_reload leaves out the
+            // file write that stands in for the user's edit
+            std::size_t next = 0;
+            std::uint64_t reloadMicros = 0;
+            std::uint64_t reloads = 0;
+            const double ns = context.measureNsPerOp([&]() {
+                writeText(path, (++next & 1) ? edited : text);
+                typedef std::chrono::steady_clock Clock;
+                const Clock::time_point start = Clock::now();
+                configuration.reload();
+                reloadMicros += static_cast<std::uint64_t>(
+                    std::chrono::duration_cast<std::chrono::microseconds>(Clock::now() - start).count());
+                ++reloads;
+            });
+            context.report(reloadName, {{"us_per_reload", static_cast<double>(reloadMicros) / reloads},
+                                        {"us_per_edit_and_reload", ns / 1000.0}});
+            std::error_code error;
+            std::filesystem::remove(path, error);
+            std::filesystem::remove(configuration.cachePath(), error);
+        }
+    }
+}
+
+} // namespace
+
+MAAT_BENCHMARK("config", benchConfig);
+
+} // namespace bench
+} // namespace maat
@@ -0,0 +1,290 @@
+#include <algorithm>
+#include <string>
+#include <vector>
+
+#include "bench.h"
+#include "maat_core/layout_policies.h"
+#include "maat_core/layout_tree.h"
+
+// Layout computation on LayoutTree for 1..10,000 windows in several tree shapes:
+//   layout/full/<shape>/<n>            full computeLayout of the whole tree
+//   layout/resize/<shape>/<n>          one split-ratio change + computeDirtyLayout
+//   layout/insert_remove/<shape>/<n>   split a leaf, lay out, remove it, lay out
+//   layout/policy/<policy>/<n>         one full arrange() of a layout policy
+//   layout/limits/<shape>/<n>          full computeLayout with random min/max
+//                                      sizes on half the windows (solver path)
+//   layout/limits_change/<shape>/<n>   one window's limits change + computeDirtyLayout
+
+namespace maat {
+namespace bench {
+
+namespace {
+
+using maat::core::LayoutTree;
+using maat::core::NodeIndex;
+using maat::core::SplitAxis;
+using maat::platform::Rect;
+using maat::platform::SizeHints;
+using maat::platform::WindowId;
+
+const Rect kArea{0, 0, 3840, 2160};
+
+enum class Shape { Flat, Dwindle, Balanced, Grid };
+
+const char* shapeName(Shape shape) {
+    switch (shape) {
+        case Shape::Flat: return "flat";
+        case Shape::Dwindle: return "dwindle";
+        case Shape::Balanced: return "balanced";
+        case Shape::Grid: return "grid";
+    }
+    return "unknown";
+}
+
+SplitAxis flip(SplitAxis axis) {
+    return axis == SplitAxis::Horizontal ? SplitAxis::Vertical : SplitAxis::Horizontal;
+}
+
+// Builds a tree of `count` windows under a new root and returns its leaves.
+NodeIndex buildTree(LayoutTree& tree, Shape shape, std::size_t count, std::vector<NodeIndex>& leaves) {
+    const NodeIndex root = tree.createRoot(shape == Shape::Grid ? SplitAxis::Vertical : SplitAxis::Horizontal);
+    leaves.clear();
+    WindowId nextId = 1;
+    switch (shape) {
+        case Shape::Flat:
+            // One container holding every window side by side
+            for (std::size_t i = 0; i < count; ++i) {
+                leaves.push_back(tree.appendWindow(root, nextId++));
+            }
+            break;
+        case Shape::Dwindle: {
+            // Each window halves the previous one: depth == count
+            NodeIndex last = tree.appendWindow(root, nextId++);
+            leaves.push_back(last);
+            SplitAxis axis = SplitAxis::Vertical;
+            for (std::size_t i = 1; i < count; ++i) {
+                last = tree.splitLeaf(last, axis, nextId++);
+                leaves.push_back(last);
+                axis = flip(axis);
+            }
+            break;
+        }
+        case Shape::Balanced: {
+            // Breadth-first splits (both halves go back on the queue): a
+            // complete binary tree of depth ~log2(count)
+            std::vector<NodeIndex> queue;
+            queue.push_back(tree.appendWindow(root, nextId++));
+            for (std::size_t head = 0; queue.size() - head < count; ++head) {
+                const NodeIndex leaf = queue[head];
+                const SplitAxis axis = flip(tree.node(tree.node(leaf).parent).axis);
+                const NodeIndex added = tree.splitLeaf(leaf, axis, nextId++);
+                queue.push_back(leaf);
+                queue.push_back(added);
+            }
+            tree.forEachLeaf(root, [&leaves](NodeIndex leaf, const LayoutTree::Node&) { leaves.push_back(leaf); });
+            break;
+        }
+        case Shape::Grid: {
+            // sqrt(count) rows of sqrt(count) columns
+            std::size_t columns = 1;
+            while (columns * columns < count) ++columns;
+            std::size_t placed = 0;
+            while (placed < count) {
+                NodeIndex first = tree.appendWindow(root, nextId++);
+                leaves.push_back(first);
+                ++placed;
+                NodeIndex last = first;
+                for (std::size_t c = 1; c < columns && placed < count; ++c, ++placed) {
+                    last = (c == 1) ? tree.splitLeaf(first, SplitAxis::Horizontal, nextId++)
+                                    : tree.insertWindowAfter(last, nextId++);
+                    leaves.push_back(last);
+                }
+            }
+            break;
+        }
+    }
+    return root;
+}
+
+std::string benchName(const char* kind, Shape shape, std::size_t count) {
+    return std::string("layout/") + kind + "/" + shapeName(shape) + "/" + std::to_string(count);
+}
+
+void benchLayout(BenchContext& context) {
+    const Shape shapes[] = {Shape::Flat, Shape::Dwindle, Shape::Balanced, Shape::Grid};
+    const std::size_t fullSizes[] = {1, 10, 100, 1000, 10000};
+    const std::size_t quickSizes[] = {1, 10, 100, 1000};
+
+    for (Shape shape : shapes) {
+        const std::size_t* sizes = context.quick() ? quickSizes : fullSizes;
+        const std::size_t sizeCount = context.quick() ? 4 : 5;
+        for (std::size_t s = 0; s < sizeCount; ++s) {
+            const std::size_t count = sizes[s];
+            LayoutTree tree(count * 2 + 16);
+            std::vector<NodeIndex> leaves;
+            const NodeIndex root = buildTree(tree, shape, count, leaves);
+            LayoutTree::GeometryList out;
+            out.reserve(count + 1);
+            tree.computeLayout(root, kArea, out);
+
+            const std::string fullName = benchName("full", shape, count);
+            if (context.selected(fullName)) {
+                const double ns = context.measureNsPerOp([&]() {
+                    out.clear();
+                    tree.computeLayout(root, kArea, out);
+                });
+                context.report(fullName, {{"ns_per_op", ns}, {"ns_per_window", ns / count}});
+            }
+
+            const std::string resizeName = benchName("resize", shape, count);
+            if (context.selected(resizeName)) {
+                Random random;
+                std::size_t changed = 0;
+                std::size_t ops = 0;
+                bool grow = true;
+                const double ns = context.measureNsPerOp([&]() {
+                    const NodeIndex leaf = leaves[random.below(leaves.size())];
+                    tree.setWeight(leaf, grow ? 1.5f : 1.0f);
+                    grow = !grow;
+                    out.clear();
+                    tree.computeDirtyLayout(root, kArea, out);
+                    changed += out.size();
+                    ++ops;
+                });
+                context.report(resizeName, {{"ns_per_op", ns},
+                                            {"changed_rects_per_op", static_cast<double>(changed) / ops}});
+            }
+
+            const std::string insertName = benchName("insert_remove", shape, count);
+            if (context.selected(insertName)) {
+                Random random;
+                const WindowId transientId = static_cast<WindowId>(count + 1);
+                const double ns = context.measureNsPerOp([&]() {
+                    const NodeIndex leaf = leaves[random.below(leaves.size())];
+                    const NodeIndex added = tree.splitLeaf(leaf, SplitAxis::Horizontal, transientId);
+                    out.clear();
+                    tree.computeDirtyLayout(root, kArea, out);
+                    tree.removeLeaf(added); // collapses back onto `leaf`
+                    out.clear();
+                    tree.computeDirtyLayout(root, kArea, out);
+                });
+                context.report(insertName, {{"ns_per_op", ns},
+                                            {"arena_nodes", static_cast<double>(tree.capacity())}});
+            }
+        }
+    }
+}
+
+// Limits around `share` along the split, so some splits
+// are solvable, some over-constrained and some under-filled
+SizeHints randomLimits(Random& random, int share, SplitAxis axis) {
+    SizeHints limits;
+    const int min = static_cast<int>(random.below(static_cast<std::size_t>(share) * 3 / 2 + 1));
+    const int max = random.below(2) ? min + 1 + static_cast<int>(random.below(static_cast<std::size_t>(share) * 2 + 1)) : 0;
+    if (axis == SplitAxis::Horizontal) {
+        limits.minWidth = min;
+        limits.maxWidth = max;
+    } else {
+        limits.minHeight = min;
+        limits.maxHeight = max;
+    }
+    return limits;
+}
+
+void benchLimits(BenchContext& context) {
+    struct Case {
+        Shape shape;
+        std::size_t count;
+    };
+    // Hundreds of siblings in one container, and a deep chain of nested splits
+    const Case cases[] = {{Shape::Flat, 200}, {Shape::Flat, 800}, {Shape::Dwindle, 64}, {Shape::Grid, 800}};
+    for (const Case& c : cases) {
+        LayoutTree tree(c.count * 2 + 16);
+        std::vector<NodeIndex> leaves;
+        const NodeIndex root = buildTree(tree, c.shape, c.count, leaves);
+        LayoutTree::GeometryList out;
+        out.reserve(c.count + 1);
+        tree.computeLayout(root, kArea, out);
+        Random random;
+        // Around the size the window has without limits
+        auto limitsFor = [&](NodeIndex leaf) {
+            const SplitAxis axis = tree.node(tree.node(leaf).parent).axis;
+            const Rect& rect = tree.node(leaf).rect;
+            return randomLimits(random, axis == SplitAxis::Horizontal ? rect.width : rect.height, axis);
+        };
+        for (std::size_t i = 0; i < leaves.size(); i += 2) {
+            tree.setLimits(leaves[i], limitsFor(leaves[i]));
+        }
+        out.clear();
+        tree.computeLayout(root, kArea, out);
+
+        const std::string fullName = benchName("limits", c.shape, c.count);
+        if (context.selected(fullName)) {
+            const LayoutTree::SolverStats before = tree.solverStats();
+            const double ns = context.measureNsPerOp([&]() {
+                out.clear();
+                tree.computeLayout(root, kArea, out);
+            });
+            const LayoutTree::SolverStats& after = tree.solverStats();
+            const double splits = static_cast<double>(after.constrainedSplits - before.constrainedSplits);
+            const double infeasible = static_cast<double>(after.overconstrained - before.overconstrained +
+                                                          after.underfilled - before.underfilled);
+            context.report(fullName, {{"ns_per_op", ns},
+                                      {"ns_per_window", ns / c.count},
+                                      {"infeasible_pct", splits > 0 ? 100.0 * infeasible / splits : 0.0}});
+        }
+
+        const std::string changeName = benchName("limits_change", c.shape, c.count);
+        if (context.selected(changeName)) {
+            std::size_t changed = 0;
+            std::size_t ops = 0;
+            const double ns = context.measureNsPerOp([&]() {
+                const NodeIndex leaf = leaves[random.below(leaves.size())];
+                tree.setLimits(leaf, limitsFor(leaf));
+                out.clear();
+                tree.computeDirtyLayout(root, kArea, out);
+                changed += out.size();
+                ++ops;
+            });
+            context.report(changeName, {{"ns_per_op", ns},
+                                        {"changed_rects_per_op", static_cast<double>(changed) / ops}});
+        }
+    }
+}
+
+template <typename Policy>
+void benchPolicy(BenchContext& context) {
+    const std::size_t fullSizes[] = {1, 10, 100, 1000, 10000};
+    const std::size_t sizeCount = context.quick() ? 4 : 5;
+    const maat::core::LayoutParams params;
+    for (std::size_t s = 0; s < sizeCount; ++s) {
+        const std::size_t count = fullSizes[s];
+        const std::string name = std::string("layout/policy/") + Policy::kName + "/" + std::to_string(count);
+        if (!context.selected(name)) continue;
+        LayoutTree::GeometryList out;
+        out.reserve(count);
+        const double ns = context.measureNsPerOp([&]() {
+            out.clear();
+            Policy::arrange(kArea, count, params, [&out](std::size_t i, const Rect& rect) {
+                out.emplace_back(static_cast<WindowId>(i + 1), rect);
+            });
+        });
+        context.report(name, {{"ns_per_op", ns}, {"ns_per_window", ns / count}});
+    }
+}
+
+void benchPolicies(BenchContext& context) {
+    benchPolicy<maat::core::MasterStackPolicy>(context);
+    benchPolicy<maat::core::DwindlePolicy>(context);
+    benchPolicy<maat::core::GridPolicy>(context);
+    benchPolicy<maat::core::ColumnsPolicy>(context);
+}
+
+} // namespace
+
+MAAT_BENCHMARK("layout", benchLayout);
+MAAT_BENCHMARK("layout_policy", benchPolicies);
+MAAT_BENCHMARK("layout_limits", benchLimits);
+
+} // namespace bench
+} // namespace maat
@@ -0,0 +1,115 @@
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+
+#include "bench.h"
+#include "maat_core/log.h"
+
+#ifndef MAAT_BENCH_BUILD_TYPE
+#define MAAT_BENCH_BUILD_TYPE ""
+#endif
+
+namespace maat {
+namespace bench {
+
+std::vector<BenchRegistration>& registeredBenchmarks() {
+    static std::vector<BenchRegistration> benchmarks;
+    return benchmarks;
+}
+
+namespace {
+
+void writeJsonString(std::FILE* out, const std::string& text) {
+    std::fputc('"', out);
+    for (char c : text) {
+        if (c == '"' || c == '\\') {
+            std::fputc('\\', out);
+            std::fputc(c, out);
+        } else if (static_cast<unsigned char>(c) < 0x20) {
+            std::fprintf(out, "\\u%04x", static_cast<unsigned>(static_cast<unsigned char>(c)));
+        } else {
+            std::fputc(c, out);
+        }
+    }
+    std::fputc('"', out);
+}
+
+// Output format (schema "maat_bench/1"):
+// { "schema": ..., "build_type": "<CMake config>", "quick": bool,
+//   "benchmarks": [ { "name": "...", "metrics": { "<metric>": number, ... } }, ... ] }
+void writeJson(std::FILE* out, const BenchOptions& options, const std::vector<BenchResult>& results) {
+    std::fprintf(out, "{\n  \"schema\": \"maat_bench/1\",\n  \"build_type\": ");
+    writeJsonString(out, MAAT_BENCH_BUILD_TYPE);
+    std::fprintf(out, ",\n  \"quick\": %s,\n  \"benchmarks\": [", options.quick ? "true" : "false");
+    for (std::size_t i = 0; i < results.size(); ++i) {
+        std::fputs(i == 0 ? "\n    { \"name\": " : ",\n    { \"name\": ", out);
+        writeJsonString(out, results[i].name);
+        std::fputs(", \"metrics\": {", out);
+        const std::vector<Metric>& metrics = results[i].metrics;
+        for (std::size_t m = 0; m < metrics.size(); ++m) {
+            std::fputs(m == 0 ? " " : ", ", out);
+            writeJsonString(out, metrics[m].name);
+            if (std::isfinite(metrics[m].value)) {
+                std::fprintf(out, ": %.6g", metrics[m].value);
+            } else {
+                std::fputs(": null", out);
+            }
+        }
+        std::fputs(" } }", out);
+    }
+    std::fputs("\n  ]\n}\n", out);
+}
+
+void printUsage() {
+    std::fprintf(stderr,
+                 "usage: maat_bench [--quick] [--filter <substring>] [--min-time <seconds>] [--output <file>]\n"
+                 "Runs the headless benchmark suite and prints JSON results.\n");
+}
+
+} // namespace
+
+} // namespace bench
+} // namespace maat
+
+int main(int argc, char** argv) {
+    using namespace maat::bench;
+
+    BenchOptions options;
+    const char* outputPath = nullptr;
+    for (int i = 1; i < argc; ++i) {
+        if (std::strcmp(argv[i], "--quick") == 0) {
+            options.quick = true;
+        } else if (std::strcmp(argv[i], "--filter") == 0 && i + 1 < argc) {
+            options.filter = argv[++i];
+        } else if (std::strcmp(argv[i], "--min-time") == 0 && i + 1 < argc) {
+            options.minSeconds = std::atof(argv[++i]);
+        } else if (std::strcmp(argv[i], "--output") == 0 && i + 1 < argc) {
+            outputPath = argv[++i];
+        } else {
+            printUsage();
+            return 2;
+        }
+    }
+
+    // stdout carries the JSON; keep component chatter off it
+    maat::core::Logger::instance().setMinimumLevel(maat::core::LogLevel::Warn);
+
+    BenchContext context(options);
+    for (const BenchRegistration& registration : registeredBenchmarks()) {
+        std::fprintf(stderr, "[maat_bench] %s\n", registration.group);
+        registration.function(context);
+    }
+
+    std::FILE* out = outputPath ? std::fopen(outputPath, "w") : stdout;
+    if (!out) {
+        std::fprintf(stderr, "maat_bench: cannot open %s\n", outputPath);
+        return 1;
+    }
+    writeJson(out, options, context.results());
+    if (out != stdout) {
+        std::fclose(out);
+    }
+    return 0;
+}
@@ -0,0 +1,397 @@
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <filesystem>
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "bench.h"
+#include "maat_core/core_manager.h"
+#include "maat_core/maat_mediator.h"
+#include "maat_core/session_store.h"
+#include "maat_platform_sim/sim_platform_manager.h"
+#include "sim_stack.h"
+
+// Mediator throughput and apply batching under synthetic event storms, run
+// against the simulated backend on its virtual clock:
+//   storm/<scenario>/coalesce_<micros>
+//   workspace/switch/<windows per workspace>
+//   session/restore/<windows>   startup (initialize) with and without a snapshot
+//   startup/cold/<windows>      initialize() phases, no snapshot
+//   animation/retile/<windows>  animated layout switches at 60 fps, windows
+//                               opening and closing mid-flight
+// Throughput metrics are wall-clock; batch size and rate are deterministic
+// (virtual time), so any change in them is a behavioural change.
+
+namespace maat {
+namespace bench {
+
+namespace {
+
+using maat::core::LatencyStage;
+using maat::core::MaatMediator;
+using maat::core::MonitorArea;
+using maat::core::SessionStore;
+using maat::platform::MonitorId;
+using maat::platform::Rect;
+using maat::platform::SimPlatformManager;
+using maat::platform::WindowId;
+
+const Rect kLeftMonitor{0, 0, 1920, 1080};
+const Rect kRightMonitor{1920, 0, 1920, 1080};
+
+Rect randomRect(Random& random) {
+    const int x = static_cast<int>(random.below(3600));
+    const int y = static_cast<int>(random.below(900));
+    return {x, y, 200 + static_cast<int>(random.below(600)), 150 + static_cast<int>(random.below(400))};
+}
+
+// The shared test stack with a second monitor to the right.
+struct Stack : maat::tests::SimStack {
+    explicit Stack(std::uint64_t coalesceMicros) : SimStack(kLeftMonitor) {
+        mediator.setCoalescingWindow(coalesceMicros);
+        platform.addMonitor(kRightMonitor, true);
+    }
+};
+
+// Scripts the scenario's events onto the sim schedule before the run.
+typedef std::function<void(Stack&, std::size_t eventBudget)> Scenario;
+
+// Create/show/destroy churn: every window lives 0-50 ms (tooltips, menus, popups).
+void createDestroyStorm(Stack& stack, std::size_t eventBudget) {
+    Random random(1);
+    SimPlatformManager& platform = stack.platform;
+    const std::size_t windows = eventBudget / 2;
+    for (std::size_t i = 0; i < windows; ++i) {
+        const std::uint64_t born = i * 500; // 2000 windows per second
+        const std::uint64_t lifetime = random.below(50000);
+        const Rect geometry = randomRect(random);
+        auto id = std::make_shared<WindowId>(0);
+        platform.scheduleAt(born, [&platform, id, geometry]() {
+            *id = platform.createWindow(geometry);
+            platform.showWindow(*id);
+        });
+        platform.scheduleAt(born + lifetime + 1, [&platform, id]() { platform.destroyWindow(*id); });
+    }
+}
+
+// Interactive move/size ends over a stable set of windows, across both monitors.
+void moveSizeStorm(Stack& stack, std::size_t eventBudget) {
+    Random random(2);
+    SimPlatformManager& platform = stack.platform;
+    std::vector<WindowId> ids;
+    for (int i = 0; i < 64; ++i) {
+        ids.push_back(platform.seedWindow(randomRect(random)));
+    }
+    for (std::size_t i = 0; i < eventBudget; ++i) {
+        const WindowId id = ids[random.below(ids.size())];
+        const Rect geometry = randomRect(random);
+        platform.scheduleAt(i * 1000, [&platform, id, geometry]() { platform.moveSizeWindow(id, geometry); });
+    }
+}
+
+// Long-lived windows, moves and occasional monitor work-area changes interleaved.
+void mixedStorm(Stack& stack, std::size_t eventBudget) {
+    Random random(3);
+    SimPlatformManager& platform = stack.platform;
+    auto live = std::make_shared<std::vector<WindowId>>();
+    for (std::size_t i = 0; i < eventBudget; ++i) {
+        const std::uint64_t at = i * 700;
+        const std::size_t roll = random.below(100);
+        const Rect geometry = randomRect(random);
+        const std::size_t pick = random.next();
+        if (roll < 40) {
+            platform.scheduleAt(at, [&platform, live, geometry]() {
+                const WindowId id = platform.createWindow(geometry);
+                platform.showWindow(id);
+                live->push_back(id);
+            });
+        } else if (roll < 70) {
+            platform.scheduleAt(at, [&platform, live, pick]() {
+                if (live->empty()) return;
+                const std::size_t index = pick % live->size();
+                platform.destroyWindow((*live)[index]);
+                (*live)[index] = live->back();
+                live->pop_back();
+            });
+        } else if (roll < 99) {
+            platform.scheduleAt(at, [&platform, live, pick, geometry]() {
+                if (!live->empty()) platform.moveSizeWindow((*live)[pick % live->size()], geometry);
+            });
+        } else {
+            const MonitorId monitor = stack.monitor;
+            platform.scheduleAt(at, [&platform, pick, monitor]() {
+                const int height = (pick & 1) ? 1040 : 1080; // taskbar toggled
+                platform.setMonitorWorkArea(monitor, {0, 0, 1920, height});
+            });
+        }
+    }
+}
+
+void runScenario(BenchContext& context, const char* scenario, const Scenario& script, std::size_t eventBudget) {
+    const std::uint64_t coalesceWindows[] = {0, 16000};
+    for (std::uint64_t coalesce : coalesceWindows) {
+        const std::string name = std::string("storm/") + scenario + "/coalesce_" + std::to_string(coalesce);
+        if (!context.selected(name)) continue;
+
+        // Repeat for the wall-clock figure; everything else is deterministic
+        const int repetitions = context.quick() ? 1 : 3;
+        double bestWallNs = 0.0;
+        std::vector<Metric> metrics;
+        for (int rep = 0; rep < repetitions; ++rep) {
+            Stack stack(coalesce);
+            script(stack, eventBudget);
+            stack.mediator.initialize();
+            stack.platform.clearAppliedBatches();
+
+            const auto start = std::chrono::steady_clock::now();
+            stack.platform.runUntilIdle();
+            stack.mediator.processPendingEvents();
+            const double wallNs = static_cast<double>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+                std::chrono::steady_clock::now() - start).count());
+            if (rep > 0 && wallNs >= bestWallNs) continue;
+            bestWallNs = wallNs;
+
+            const MaatMediator::CoalescingStats& coalescing = stack.mediator.coalescingStats();
+            const auto& batches = stack.platform.appliedBatches();
+            std::size_t largestBatch = 0;
+            for (const auto& batch : batches) largestBatch = std::max(largestBatch, batch.updates.size());
+            const std::size_t updates = stack.platform.appliedUpdateCount();
+            const double virtualSeconds = std::max<std::uint64_t>(stack.platform.clock().now(), 1) / 1e6;
+            const double events = static_cast<double>(coalescing.eventsReceived);
+
+            metrics = {
+                {"events", events},
+                {"wall_ns_per_event", events > 0 ? wallNs / events : 0.0},
+                {"events_per_sec", wallNs > 0 ? events * 1e9 / wallNs : 0.0},
+                {"ops_delivered", static_cast<double>(coalescing.eventsDelivered)},
+                {"layout_passes", static_cast<double>(coalescing.layoutPasses)},
+                {"apply_batches", static_cast<double>(batches.size())},
+                {"apply_updates", static_cast<double>(updates)},
+                {"batch_size_mean", batches.empty() ? 0.0 : static_cast<double>(updates) / batches.size()},
+                {"batch_size_max", static_cast<double>(largestBatch)},
+                {"batches_per_sec", batches.size() / virtualSeconds},
+                {"updates_per_sec", updates / virtualSeconds},
+                {"geometry_updates_dropped", static_cast<double>(stack.mediator.droppedGeometryUpdateCount())},
+                {"window_tiled_p99_us",
+                 static_cast<double>(stack.mediator.latency().histogram(LatencyStage::WindowTiled).percentile(0.99))},
+            };
+        }
+        context.report(name, metrics);
+    }
+}
+
+void benchStorms(BenchContext& context) {
+    const std::size_t budget = context.quick() ? 2000 : 20000;
+    runScenario(context, "create_destroy", createDestroyStorm, budget);
+    runScenario(context, "move_size", moveSizeStorm, budget);
+    runScenario(context, "mixed", mixedStorm, budget);
+}
+
+// Toggling between two populated workspaces of one monitor: a full
+// hide/show cycle through mediator and platform, with no layout work.
+void benchWorkspaceSwitch(BenchContext& context) {
+    const std::size_t sizes[] = {10, 40, 200};
+    for (std::size_t perWorkspace : sizes) {
+        const std::string name = "workspace/switch/" + std::to_string(perWorkspace);
+        if (!context.selected(name)) continue;
+
+        Stack stack(0);
+        for (std::size_t i = 0; i < perWorkspace; ++i) {
+            stack.platform.seedWindow(Rect{100, 100, 400, 300});
+        }
+        stack.mediator.initialize();
+        stack.core.switchWorkspace(stack.monitor, 1);
+        for (std::size_t i = 0; i < perWorkspace; ++i) {
+            const WindowId id = stack.platform.createWindow(Rect{100, 100, 400, 300});
+            stack.platform.showWindow(id);
+        }
+
+        std::size_t target = 0;
+        std::size_t switches = 0;
+        std::size_t updates = 0;
+        std::size_t visibilityChanges = 0;
+        const double ns = context.measureNsPerOp([&]() {
+            stack.platform.clearAppliedBatches();
+            stack.core.switchWorkspace(stack.monitor, target);
+            target ^= 1;
+            ++switches;
+            updates += stack.platform.appliedUpdateCount();
+            for (const auto& batch : stack.platform.visibilityBatches()) visibilityChanges += batch.changes.size();
+        });
+        context.report(name, {{"ns_per_switch", ns},
+                              {"geometry_updates_per_switch", static_cast<double>(updates) / switches},
+                              {"visibility_changes_per_switch", static_cast<double>(visibilityChanges) / switches}});
+    }
+}
+
+// Startup with `windows` windows spread over both monitors and four
+// workspaces each, in tree and master-stack layouts: initialize() from a
+// session snapshot against a cold start that re-places everything.
+void benchSessionRestore(BenchContext& context) {
+    const std::size_t sizes[] = {50, 500};
+    const std::string path = (std::filesystem::temp_directory_path() / "maat_bench.session").string();
+    for (std::size_t windows : sizes) {
+        const std::string name = "session/restore/" + std::to_string(windows);
+        if (!context.selected(name)) continue;
+
+        std::error_code error;
+        std::filesystem::remove(path, error);
+        std::size_t snapshotBytes = 0;
+        {
+            SessionStore store(path);
+            Stack stack(0);
+            stack.mediator.registerSessionStore(store);
+            Random random(windows);
+            std::vector<WindowId> ids;
+            for (std::size_t i = 0; i < windows; ++i) {
+                ids.push_back(stack.platform.seedWindow(randomRect(random)));
+            }
+            stack.mediator.initialize();
+            for (const MonitorArea& monitor : stack.mediator.monitorTopology()->monitors()) {
+                stack.core.switchWorkspace(monitor.id, 1);
+                stack.core.setLayout(monitor.id, maat::core::LayoutKind::MasterStack);
+                stack.core.switchWorkspace(monitor.id, 0);
+            }
+            for (WindowId id : ids) {
+                stack.core.moveWindowToWorkspace(id, random.below(4));
+            }
+            stack.mediator.saveSession();
+            snapshotBytes = static_cast<std::size_t>(std::filesystem::file_size(path, error));
+        }
+
+        // Best of a few cold constructions; each start needs a fresh stack
+        double restoredMicros = 0.0;
+        double coldMicros = 0.0;
+        std::size_t restored = 0;
+        std::size_t batches = 0;
+        for (int rep = 0; rep < (context.quick() ? 1 : 5); ++rep) {
+            for (bool withSession : {true, false}) {
+                SessionStore store(path);
+                Stack stack(0);
+                if (withSession) stack.mediator.registerSessionStore(store);
+                Random random(windows);
+                for (std::size_t i = 0; i < windows; ++i) {
+                    stack.platform.seedWindow(randomRect(random));
+                }
+                const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+                stack.mediator.initialize();
+                const double micros = static_cast<double>(std::chrono::duration_cast<std::chrono::microseconds>(
+                    std::chrono::steady_clock::now() - start).count());
+                double& best = withSession ? restoredMicros : coldMicros;
+                if (rep == 0 || micros < best) best = micros;
+                if (withSession) {
+                    restored = stack.mediator.restoredWindowCount();
+                    batches = stack.platform.appliedBatches().size();
+                }
+            }
+        }
+        std::filesystem::remove(path, error);
+        context.report(name, {{"restore_us", restoredMicros},
+                              {"cold_start_us", coldMicros},
+                              {"windows_restored", static_cast<double>(restored)},
+                              {"geometry_batches", static_cast<double>(batches)},
+                              {"snapshot_bytes", static_cast<double>(snapshotBytes)}});
+    }
+}
+
+// Cold start with `windows` top-level windows, a seventh of them not
+// manageable: the phase breakdown of the best of a few starts. Monitor
+// enumeration overlaps discovery, so total_us is below the phases' sum.
+void benchStartup(BenchContext& context) {
+    const std::size_t sizes[] = {200, 2000};
+    for (std::size_t windows : sizes) {
+        const std::string name = "startup/cold/" + std::to_string(windows);
+        if (!context.selected(name)) continue;
+
+        MaatMediator::StartupStats best;
+        std::size_t batches = 0;
+        for (int rep = 0; rep < (context.quick() ? 1 : 5); ++rep) {
+            Stack stack(0);
+            Random random(windows);
+            for (std::size_t i = 0; i < windows; ++i) {
+                stack.platform.seedWindow(randomRect(random), i % 7 != 3);
+            }
+            stack.mediator.initialize();
+            const MaatMediator::StartupStats& stats = stack.mediator.startupStats();
+            if (rep == 0 || stats.totalMicros < best.totalMicros) best = stats;
+            batches = stack.platform.appliedBatches().size();
+        }
+        context.report(name, {{"total_us", static_cast<double>(best.totalMicros)},
+                              {"topology_us", static_cast<double>(best.topologyMicros)},
+                              {"discovery_us", static_cast<double>(best.discoveryMicros)},
+                              {"classify_us", static_cast<double>(best.classifyMicros)},
+                              {"adopt_us", static_cast<double>(best.adoptMicros)},
+                              {"layout_us", static_cast<double>(best.layoutMicros)},
+                              {"classify_threads", static_cast<double>(best.classifyThreads)},
+                              {"windows", static_cast<double>(best.windows)},
+                              {"geometry_batches", static_cast<double>(batches)}});
+    }
+}
+
+// `windows` windows on one monitor re-tiled by alternating layouts, with a
+// window created and one destroyed while the transition is in flight. Frame
+// counts and sizes come from the virtual clock; us_per_frame is the wall
+// cost of interpolating and applying one frame.
+void benchAnimatedRetile(BenchContext& context) {
+    const std::size_t sizes[] = {32, 128};
+    for (std::size_t windows : sizes) {
+        const std::string name = "animation/retile/" + std::to_string(windows);
+        if (!context.selected(name)) continue;
+
+        Stack stack(0);
+        maat::core::AnimationSettings animation;
+        animation.enabled = true;
+        animation.frameRate = 60;
+        animation.duration = 150000;
+        stack.mediator.setAnimation(animation);
+        for (std::size_t i = 0; i < windows; ++i) {
+            stack.platform.seedWindow(Rect{100, 100, 400, 300});
+        }
+        stack.mediator.initialize();
+
+        SimPlatformManager& platform = stack.platform;
+        bool masterStack = false;
+        std::size_t retiles = 0;
+        std::size_t frameUpdates = 0;
+        const double ns = context.measureNsPerOp([&]() {
+            platform.clearAppliedBatches();
+            masterStack = !masterStack;
+            stack.core.setLayout(stack.monitor, masterStack ? maat::core::LayoutKind::MasterStack
+                                                                : maat::core::LayoutKind::Tree);
+            stack.core.flushLayout();
+            auto id = std::make_shared<WindowId>(0);
+            const std::uint64_t now = platform.getMonotonicTime();
+            platform.scheduleAt(now + 40000, [&platform, id]() {
+                *id = platform.createWindow(Rect{0, 0, 300, 200});
+                platform.showWindow(*id);
+            });
+            platform.scheduleAt(now + 90000, [&platform, id]() { platform.destroyWindow(*id); });
+            platform.runUntilIdle();
+            ++retiles;
+            frameUpdates += platform.appliedUpdateCount();
+        });
+        const maat::core::GeometryAnimator::Stats& stats = stack.mediator.animationStats();
+        const double frames = static_cast<double>(std::max<std::size_t>(stats.frames, 1));
+        context.report(name, {{"us_per_retile", ns / 1000.0},
+                              {"us_per_frame", ns / 1000.0 / (frames / retiles)},
+                              {"frames_per_retile", frames / retiles},
+                              {"updates_per_frame", static_cast<double>(frameUpdates) / frames},
+                              {"max_frame_size", static_cast<double>(stats.maxFrameSize)},
+                              {"retargets_per_retile", static_cast<double>(stats.retargeted) / retiles},
+                              {"final_jumps", static_cast<double>(stats.finalJumps)}});
+    }
+}
+
+} // namespace
+
+MAAT_BENCHMARK("storm", benchStorms);
+MAAT_BENCHMARK("workspace", benchWorkspaceSwitch);
+MAAT_BENCHMARK("session", benchSessionRestore);
+MAAT_BENCHMARK("startup", benchStartup);
+MAAT_BENCHMARK("animation", benchAnimatedRetile);
+
+} // namespace bench
+} // namespace maat
@@ -0,0 +1,166 @@
+#include <chrono>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "bench.h"
+#include "maat_core/window_rules.h"
+#include "maat_platform_sim/sim_window.h"
+
+// Window rule evaluation for rule sets of 10..10,000 rules:
+//   rules/compiled/<n>   WindowRuleSet::evaluate over a pool of windows
+//   rules/linear/<n>     the same rules checked one by one, for reference
+//   rules/cached/<n>     WindowClassifier::classify on already classified windows
+
+namespace maat {
+namespace bench {
+
+namespace {
+
+using maat::core::RuleAction;
+using maat::core::WindowClassifier;
+using maat::core::WindowRule;
+using maat::core::WindowRuleSet;
+using maat::platform::WindowAttributes;
+
+constexpr std::size_t kWindowPool = 1024;
+
+// Mostly per-application rules (process or class names), some title
+// substrings and size limits, as a large user configuration would have.
+std::vector<WindowRule> makeRules(std::size_t count) {
+    std::vector<WindowRule> rules = WindowRuleSet::defaultRules();
+    Random random(count);
+    for (std::size_t i = 0; rules.size() < count; ++i) {
+        const RuleAction action = (i % 3 == 0) ? RuleAction::Manage : RuleAction::Ignore;
+        switch (random.below(8)) {
+            case 0: case 1: case 2:
+                rules.push_back(WindowRule(action).process("app" + std::to_string(i) + ".exe"));
+                break;
+            case 3: case 4:
+                rules.push_back(WindowRule(action).className("Class" + std::to_string(i)));
+                break;
+            case 5:
+                rules.push_back(WindowRule(action).process("app" + std::to_string(i) + ".exe")
+                                    .titleContains("Dialog " + std::to_string(i % 50)));
+                break;
+            case 6:
+                rules.push_back(WindowRule(action).titleContains("Popup " + std::to_string(i % 50)));
+                break;
+            default:
+                rules.push_back(WindowRule(action).className("Class" + std::to_string(i)).maxSize(400, 300));
+                break;
+        }
+    }
+    return rules;
+}
+
+std::vector<WindowAttributes> makeWindows(std::size_t ruleCount) {
+    std::vector<WindowAttributes> windows(kWindowPool);
+    Random random(7);
+    for (WindowAttributes& window : windows) {
+        // About half the windows name something a rule mentions
+        const std::size_t i = random.below(ruleCount * 2);
+        window.className = "Class" + std::to_string(i);
+        window.processName = "app" + std::to_string(i) + ".exe";
+        window.title = (random.below(4) == 0 ? "Popup " : "Document ") + std::to_string(random.below(100));
+        window.geometry = {0, 0, 200 + static_cast<int>(random.below(1600)), 150 + static_cast<int>(random.below(900))};
+    }
+    return windows;
+}
+
+bool matchesLinear(const WindowRule& rule, const WindowAttributes& window) {
+    const std::uint32_t style = window.styleFlags;
+    if ((style & rule.styleAll) != rule.styleAll || (style & rule.styleNone) != 0 ||
+        (rule.styleAny != 0 && (style & rule.styleAny) == 0)) {
+        return false;
+    }
+    if (window.geometry.width < rule.minWidth || window.geometry.height < rule.minHeight ||
+        window.geometry.width > rule.maxWidth || window.geometry.height > rule.maxHeight) {
+        return false;
+    }
+    for (const WindowRule::TextCondition& condition : rule.text) {
+        const std::string& value = condition.field == WindowRule::Text::Class   ? window.className
+                                   : condition.field == WindowRule::Text::Title ? window.title
+                                                                                : window.processName;
+        if (condition.contains ? value.find(condition.value) == std::string::npos : value != condition.value) {
+            return false;
+        }
+    }
+    return true;
+}
+
+RuleAction evaluateLinear(const std::vector<WindowRule>& rules, const WindowAttributes& window) {
+    for (const WindowRule& rule : rules) {
+        if (matchesLinear(rule, window)) return rule.action;
+    }
+    return RuleAction::Manage;
+}
+
+void benchRules(BenchContext& context) {
+    const std::size_t sizes[] = {10, 100, 1000, 10000};
+    const std::size_t sizeCount = context.quick() ? 3 : 4;
+    for (std::size_t s = 0; s < sizeCount; ++s) {
+        const std::size_t count = sizes[s];
+        const std::vector<WindowRule> rules = makeRules(count);
+        const std::vector<WindowAttributes> windows = makeWindows(count);
+
+        const std::string compiledName = "rules/compiled/" + std::to_string(count);
+        if (context.selected(compiledName)) {
+            typedef std::chrono::steady_clock Clock;
+            const Clock::time_point start = Clock::now();
+            const std::shared_ptr<const WindowRuleSet> set = WindowRuleSet::compile(rules);
+            const double compileMs =
+                std::chrono::duration_cast<std::chrono::microseconds>(Clock::now() - start).count() / 1000.0;
+            std::size_t next = 0;
+            std::size_t ignored = 0;
+            const double ns = context.measureNsPerOp([&]() {
+                ignored += set->evaluate(windows[next]) == RuleAction::Ignore;
+                next = (next + 1) % windows.size();
+            });
+            context.report(compiledName, {{"ns_per_eval", ns},
+                                          {"evals_per_sec", 1e9 / ns},
+                                          {"compile_ms", compileMs},
+                                          {"predicates", static_cast<double>(set->predicateCount())}});
+        }
+
+        const std::string linearName = "rules/linear/" + std::to_string(count);
+        if (context.selected(linearName)) {
+            std::size_t next = 0;
+            std::size_t ignored = 0;
+            const double ns = context.measureNsPerOp([&]() {
+                ignored += evaluateLinear(rules, windows[next]) == RuleAction::Ignore;
+                next = (next + 1) % windows.size();
+            });
+            context.report(linearName, {{"ns_per_eval", ns}, {"evals_per_sec", 1e9 / ns}});
+        }
+
+        const std::string cachedName = "rules/cached/" + std::to_string(count);
+        if (context.selected(cachedName)) {
+            std::vector<std::unique_ptr<maat::platform::SimWindow>> simWindows;
+            for (std::size_t i = 0; i < windows.size(); ++i) {
+                simWindows.emplace_back(new maat::platform::SimWindow(
+                    static_cast<maat::platform::WindowId>(i + 1), windows[i].geometry, true));
+                simWindows.back()->setAttributes(windows[i]);
+            }
+            WindowClassifier classifier(WindowRuleSet::compile(rules));
+            for (const auto& window : simWindows) {
+                classifier.classify(*window);
+            }
+            std::size_t next = 0;
+            std::size_t ignored = 0;
+            const double ns = context.measureNsPerOp([&]() {
+                ignored += classifier.classify(*simWindows[next]) == RuleAction::Ignore;
+                next = (next + 1) % simWindows.size();
+            });
+            context.report(cachedName, {{"ns_per_classify", ns},
+                                        {"cache_misses", static_cast<double>(classifier.cacheMisses())}});
+        }
+    }
+}
+
+} // namespace
+
+MAAT_BENCHMARK("rules", benchRules);
+
+} // namespace bench
+} // namespace maat
@@ -0,0 +1,187 @@
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "bench.h"
+#include "maat_core/layout_policies.h"
+#include "maat_core/spatial_index.h"
+
+// SpatialIndex queries over 100..10,000 windows tiled as grids across three
+// monitors of different sizes:
+//   spatial/neighbour/<n>   nearest window in a random direction; scan_ns_per_op
+//                           is the same queries as a linear pass over every
+//                           rect, and any answer that differs aborts the run
+//   spatial/window_at/<n>   window under a random point
+//   spatial/overlap/<n>     windows meeting a random 400x300 rect
+//   spatial/update/<n>      a window moved by 8 px and back (two updates)
+
+namespace maat {
+namespace bench {
+
+namespace {
+
+using maat::core::Direction;
+using maat::core::SpatialIndex;
+using maat::platform::Rect;
+using maat::platform::WindowId;
+
+const Rect kMonitors[] = {{0, 0, 3840, 2160}, {3840, 0, 2560, 1440}, {-1920, 0, 1920, 1080}};
+
+// The baseline: every rect against the query, scored as SpatialIndex does
+WindowId scanNeighbour(const std::vector<std::pair<WindowId, Rect>>& windows, std::size_t from,
+                       Direction direction) {
+    const Rect& f = windows[from].second;
+    const bool horizontal = direction == Direction::Left || direction == Direction::Right;
+    const bool forward = direction == Direction::Right || direction == Direction::Down;
+    const int fromStart = horizontal ? f.x : f.y;
+    const int fromEnd = fromStart + (horizontal ? f.width : f.height);
+    const int acrossStart = horizontal ? f.y : f.x;
+    const int acrossEnd = acrossStart + (horizontal ? f.height : f.width);
+    WindowId best = 0;
+    long long bestDistance = 0;
+    int bestShared = 0;
+    for (std::size_t i = 0; i < windows.size(); ++i) {
+        if (i == from) continue;
+        const Rect& c = windows[i].second;
+        const int start = horizontal ? c.x : c.y;
+        const int end = start + (horizontal ? c.width : c.height);
+        if (forward ? (start < fromEnd && start + end <= 2 * fromEnd) : (end > fromStart && start + end >= 2 * fromStart)) {
+            continue;
+        }
+        const long long gap = forward ? start - fromEnd : fromStart - end;
+        const int candidateStart = horizontal ? c.y : c.x;
+        const int candidateEnd = candidateStart + (horizontal ? c.height : c.width);
+        const int shared = std::min(acrossEnd, candidateEnd) - std::max(acrossStart, candidateStart);
+        const long long distance = std::max(gap, 0LL) + (shared < 0 ? -shared : 0);
+        const int edge = std::max(shared, 0);
+        if (best == 0 || distance < bestDistance || (distance == bestDistance && edge > bestShared)) {
+            best = windows[i].first;
+            bestDistance = distance;
+            bestShared = edge;
+        }
+    }
+    return best;
+}
+
+void benchSpatial(BenchContext& context) {
+    const std::size_t fullSizes[] = {100, 1000, 10000};
+    const std::size_t sizeCount = context.quick() ? 2 : 3;
+    const maat::core::LayoutParams params;
+    for (std::size_t s = 0; s < sizeCount; ++s) {
+        const std::size_t count = fullSizes[s];
+        std::vector<std::pair<WindowId, Rect>> windows;
+        windows.reserve(count);
+        std::vector<Rect> regions(std::begin(kMonitors), std::end(kMonitors));
+        for (std::size_t m = 0; m < regions.size(); ++m) {
+            const std::size_t onMonitor = count / regions.size() + (m < count % regions.size() ? 1 : 0);
+            maat::core::GridPolicy::arrange(regions[m], onMonitor, params, [&windows](std::size_t, const Rect& rect) {
+                windows.emplace_back(static_cast<WindowId>(windows.size() + 1), rect);
+            });
+        }
+        SpatialIndex index;
+        index.setRegions(regions);
+        for (const auto& window : windows) {
+            index.update(window.first, window.second);
+        }
+
+        const std::string neighbourName = "spatial/neighbour/" + std::to_string(count);
+        if (context.selected(neighbourName)) {
+            // One query set for both, so the timings compare like for like
+            // and every answer of the index can be checked against the scan
+            Random random;
+            std::vector<std::pair<std::size_t, Direction>> queries(1024);
+            for (auto& query : queries) {
+                query.first = random.below(windows.size());
+                query.second = static_cast<Direction>(random.below(4));
+            }
+            std::vector<WindowId> answers(queries.size());
+            std::vector<WindowId> scanAnswers(queries.size());
+            std::size_t ops = 0;
+            const double ns = context.measureNsPerOp([&]() {
+                const std::size_t q = ops++ % queries.size();
+                answers[q] = index.neighbour(windows[queries[q].first].first, queries[q].second);
+            });
+            std::size_t scanOps = 0;
+            const double scanNs = context.measureNsPerOp([&]() {
+                const std::size_t q = scanOps++ % queries.size();
+                scanAnswers[q] = scanNeighbour(windows, queries[q].first, queries[q].second);
+            });
+            // A quick run may not reach every query; answer the rest untimed
+            std::size_t found = 0;
+            std::size_t mismatches = 0;
+            for (std::size_t q = 0; q < queries.size(); ++q) {
+                if (q >= ops) answers[q] = index.neighbour(windows[queries[q].first].first, queries[q].second);
+                if (q >= scanOps) scanAnswers[q] = scanNeighbour(windows, queries[q].first, queries[q].second);
+                found += answers[q] != 0;
+                mismatches += answers[q] != scanAnswers[q];
+            }
+            context.report(neighbourName, {{"ns_per_op", ns},
+                                           {"scan_ns_per_op", scanNs},
+                                           {"found_pct", 100.0 * static_cast<double>(found) / queries.size()},
+                                           {"mismatches", static_cast<double>(mismatches)}});
+            if (mismatches != 0) {
+                std::fprintf(stderr, "spatial bench: neighbour disagrees with the scan on %zu of %zu queries\n",
+                             mismatches, queries.size());
+                std::abort();
+            }
+        }
+
+        const std::string hitName = "spatial/window_at/" + std::to_string(count);
+        if (context.selected(hitName)) {
+            Random random;
+            std::size_t hits = 0;
+            std::size_t ops = 0;
+            const double ns = context.measureNsPerOp([&]() {
+                const Rect& monitor = kMonitors[random.below(3)];
+                const int x = monitor.x + static_cast<int>(random.below(static_cast<std::size_t>(monitor.width)));
+                const int y = monitor.y + static_cast<int>(random.below(static_cast<std::size_t>(monitor.height)));
+                hits += index.windowAt(x, y) != 0;
+                ++ops;
+            });
+            context.report(hitName, {{"ns_per_op", ns}, {"hit_pct", 100.0 * static_cast<double>(hits) / ops}});
+        }
+
+        const std::string overlapName = "spatial/overlap/" + std::to_string(count);
+        if (context.selected(overlapName)) {
+            Random random;
+            std::vector<WindowId> out;
+            std::size_t results = 0;
+            std::size_t ops = 0;
+            const double ns = context.measureNsPerOp([&]() {
+                const Rect& monitor = kMonitors[random.below(3)];
+                const Rect query{monitor.x + static_cast<int>(random.below(static_cast<std::size_t>(monitor.width))),
+                                 monitor.y + static_cast<int>(random.below(static_cast<std::size_t>(monitor.height))),
+                                 400, 300};
+                out.clear();
+                index.overlapping(query, out);
+                results += out.size();
+                ++ops;
+            });
+            context.report(overlapName,
+                           {{"ns_per_op", ns}, {"windows_per_op", static_cast<double>(results) / ops}});
+        }
+
+        const std::string updateName = "spatial/update/" + std::to_string(count);
+        if (context.selected(updateName)) {
+            Random random;
+            const double ns = context.measureNsPerOp([&]() {
+                const auto& window = windows[random.below(windows.size())];
+                Rect moved = window.second;
+                moved.x += 8;
+                index.update(window.first, moved);
+                index.update(window.first, window.second);
+            });
+            context.report(updateName, {{"ns_per_op", ns}});
+        }
+    }
+}
+
+} // namespace
+
+MAAT_BENCHMARK("spatial", benchSpatial);
+
+} // namespace bench
+} // namespace maat
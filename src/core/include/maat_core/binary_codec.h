@@ -0,0 +1,179 @@
+#ifndef MAAT_CORE_BINARY_CODEC_H
+#define MAAT_CORE_BINARY_CODEC_H
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <vector>
+#include <maat_platform/platform_types.h>
+
+namespace maat {
+namespace core {
+
+// Primitives shared by the binary file formats (event traces, configuration
+// cache). Fixed-width integers are little-endian, variable-width ones LEB128;
+// signed values are zigzag encoded first so small negatives stay short.
+namespace codec {
+
+inline std::uint64_t zigzag(std::int64_t value) {
+    return (static_cast<std::uint64_t>(value) << 1) ^ static_cast<std::uint64_t>(value >> 63);
+}
+
+inline std::int64_t unzigzag(std::uint64_t value) {
+    return static_cast<std::int64_t>(value >> 1) ^ -static_cast<std::int64_t>(value & 1);
+}
+
+inline void putU32(std::vector<std::uint8_t>& out, std::uint32_t value) {
+    for (int i = 0; i < 4; ++i) {
+        out.push_back(static_cast<std::uint8_t>(value >> (8 * i)));
+    }
+}
+
+inline void putU64(std::vector<std::uint8_t>& out, std::uint64_t value) {
+    putU32(out, static_cast<std::uint32_t>(value));
+    putU32(out, static_cast<std::uint32_t>(value >> 32));
+}
+
+inline void putVarint(std::vector<std::uint8_t>& out, std::uint64_t value) {
+    while (value >= 0x80) {
+        out.push_back(static_cast<std::uint8_t>(value | 0x80));
+        value >>= 7;
+    }
+    out.push_back(static_cast<std::uint8_t>(value));
+}
+
+inline void putSigned(std::vector<std::uint8_t>& out, std::int64_t value) {
+    putVarint(out, zigzag(value));
+}
+
+inline void putFloat(std::vector<std::uint8_t>& out, float value) {
+    std::uint32_t bits;
+    std::memcpy(&bits, &value, sizeof(bits));
+    putU32(out, bits);
+}
+
+// A rect is four zigzag varints (x, y, width, height)
+inline void putRect(std::vector<std::uint8_t>& out, const maat::platform::Rect& rect) {
+    putSigned(out, rect.x);
+    putSigned(out, rect.y);
+    putSigned(out, rect.width);
+    putSigned(out, rect.height);
+}
+
+// Varint length followed by the bytes
+inline void putString(std::vector<std::uint8_t>& out, const std::string& value) {
+    putVarint(out, value.size());
+    out.insert(out.end(), value.begin(), value.end());
+}
+
+inline std::uint32_t readU32(const std::uint8_t* data) {
+    return static_cast<std::uint32_t>(data[0]) | (static_cast<std::uint32_t>(data[1]) << 8) |
+           (static_cast<std::uint32_t>(data[2]) << 16) | (static_cast<std::uint32_t>(data[3]) << 24);
+}
+
+inline std::uint64_t readU64(const std::uint8_t* data) {
+    return static_cast<std::uint64_t>(readU32(data)) | (static_cast<std::uint64_t>(readU32(data + 4)) << 32);
+}
+
+// FNV-1a; used to detect changed inputs, not for security
+inline std::uint64_t hashBytes(const void* data, std::size_t size,
+                               std::uint64_t seed = 0xCBF29CE484222325ULL) {
+    const std::uint8_t* bytes = static_cast<const std::uint8_t*>(data);
+    std::uint64_t hash = seed;
+    for (std::size_t i = 0; i < size; ++i) {
+        hash = (hash ^ bytes[i]) * 0x100000001B3ULL;
+    }
+    return hash;
+}
+
+// Bounds-checked cursor over encoded bytes. Every read returns false instead
+// of running past the end.
+class Reader {
+public:
+    Reader(const std::uint8_t* data, std::size_t size) : m_data(data), m_end(data + size) {}
+
+    bool atEnd() const { return m_data == m_end; }
+    std::size_t remaining() const { return static_cast<std::size_t>(m_end - m_data); }
+
+    bool byte(std::uint8_t& value) {
+        if (m_data == m_end) return false;
+        value = *m_data++;
+        return true;
+    }
+
+    bool u32(std::uint32_t& value) {
+        if (remaining() < 4) return false;
+        value = readU32(m_data);
+        m_data += 4;
+        return true;
+    }
+
+    bool u64(std::uint64_t& value) {
+        if (remaining() < 8) return false;
+        value = readU64(m_data);
+        m_data += 8;
+        return true;
+    }
+
+    bool varint(std::uint64_t& value) {
+        value = 0;
+        for (int shift = 0; shift < 64; shift += 7) {
+            std::uint8_t b;
+            if (!byte(b)) return false;
+            value |= static_cast<std::uint64_t>(b & 0x7F) << shift;
+            if (!(b & 0x80)) return true;
+        }
+        return false; // Over-long encoding
+    }
+
+    bool signedVarint(std::int64_t& value) {
+        std::uint64_t raw;
+        if (!varint(raw)) return false;
+        value = unzigzag(raw);
+        return true;
+    }
+
+    bool floatValue(float& value) {
+        std::uint32_t bits;
+        if (!u32(bits)) return false;
+        std::memcpy(&value, &bits, sizeof(value));
+        return true;
+    }
+
+    bool rect(maat::platform::Rect& rect) {
+        std::int64_t v[4];
+        for (std::int64_t& field : v) {
+            if (!signedVarint(field)) return false;
+        }
+        rect = {static_cast<int>(v[0]), static_cast<int>(v[1]), static_cast<int>(v[2]), static_cast<int>(v[3])};
+        return true;
+    }
+
+    // Consumes the next `size` bytes as a reader of their own
+    bool slice(std::uint64_t size, Reader& out) {
+        if (size > remaining()) return false;
+        out = Reader(m_data, static_cast<std::size_t>(size));
+        m_data += size;
+        return true;
+    }
+
+    bool string(std::string& value) {
+        std::uint64_t size;
+        if (!varint(size) || size > remaining()) return false;
+        value.assign(reinterpret_cast<const char*>(m_data), static_cast<std::size_t>(size));
+        m_data += size;
+        return true;
+    }
+
+private:
+    const std::uint8_t* m_data;
+    const std::uint8_t* m_end;
+};
+
+} // namespace codec
+
+} // namespace core
+} // namespace maat
+
+#endif // MAAT_CORE_BINARY_CODEC_H
@@ -0,0 +1,154 @@
+#ifndef MAAT_CORE_CONFIGURATION_H
+#define MAAT_CORE_CONFIGURATION_H
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "maat_core/geometry_animator.h"
+#include "maat_core/layout_policies.h"
+#include "maat_core/window_rules.h"
+#include "maat_core/workspace_layout.h"
+
+namespace maat {
+namespace core {
+
+// Modifier bits of a KeyBinding
+enum KeyModifier : std::uint8_t {
+    KeyModifierAlt   = 1u << 0,
+    KeyModifierCtrl  = 1u << 1,
+    KeyModifierShift = 1u << 2,
+    KeyModifierSuper = 1u << 3
+};
+
+struct KeyBinding {
+    std::uint8_t modifiers = 0; // KeyModifier bits
+    std::string key;            // lower case: "1", "h", "f11", "left"
+    std::string command;        // e.g. "workspace 1"; interpreted by the input handler
+};
+
+// Parts of a configuration that change independently; a reload only applies
+// the sections whose bits differ
+enum ConfigSection : std::uint32_t {
+    ConfigSectionLayout   = 1u << 0, // default layout, its parameters and the gaps
+    ConfigSectionRules    = 1u << 1,
+    ConfigSectionBindings = 1u << 2,
+    ConfigSectionAnimation = 1u << 3,
+    ConfigSectionAll      = (1u << 4) - 1
+};
+constexpr std::size_t kConfigSectionCount = 4;
+
+struct ConfigError {
+    std::size_t line; // 1-based
+    std::string message;
+};
+
+// Immutable result of compiling a configuration; shared as
+// shared_ptr<const CompiledConfig> and never modified after construction.
+struct CompiledConfig {
+    LayoutKind layout = LayoutKind::Tree;
+    LayoutParams layoutParams;
+    std::vector<WindowRule> rules; // user rules, then WindowRuleSet::defaultRules() unless disabled
+    RuleAction ruleFallback = RuleAction::Manage;
+    std::shared_ptr<const WindowRuleSet> ruleSet;
+    std::vector<KeyBinding> bindings;
+    AnimationSettings animation;
+    std::uint64_t sourceHash = 0; // of the text it was compiled from
+    // Per ConfigSection (bit index), over the section's cached encoding
+    std::uint64_t sectionHashes[kConfigSectionCount] = {};
+};
+
+// Compiles configuration text. Returns nullptr, with every problem in
+// `errors`, if any line is invalid. The syntax, one statement per line,
+// `#` starting a comment and double quotes grouping words:
+//   layout = tree | master_stack | dwindle | grid | columns   (layoutKindName)
+//   master_ratio = 0.6        master_count = 1        axis = horizontal | vertical
+//   gap_inner = 8             gap_outer = 4           gaps = 8   (both)
+//   default_rules = on | off  fallback = manage | ignore
+//   animation = on | off      animation_fps = 60      (1..240)
+//   animation_duration = 150  animation_budget = 8    (milliseconds; budget 0: unlimited)
+//   rule <manage|ignore> <condition>...
+//       class=X  title=X  process=X   exact;  class~=X ... substring
+//       style=a|b  not_style=a  any_style=a|b   (child disabled popup tool
+//                                                noactivate transparent dialog resizable)
+//       min_size=WxH  max_size=WxH
+//   bind <modifier+...+key> = <command>
+std::shared_ptr<const CompiledConfig> compileConfig(const std::string& text, std::vector<ConfigError>& errors);
+
+// Binary form stored in the configuration cache. decodeConfig() returns
+// nullptr for anything but an intact (body hash), well-formed cache of this
+// version compiled from text hashing to `sourceHash`, with every value within
+// the bounds the text parser enforces.
+std::vector<std::uint8_t> encodeConfig(const CompiledConfig& config);
+std::shared_ptr<const CompiledConfig> decodeConfig(const std::uint8_t* data, std::size_t size,
+                                                   std::uint64_t sourceHash);
+
+// ConfigSection bits that differ between `from` (nullptr: everything) and `to`
+std::uint32_t diffConfig(const CompiledConfig* from, const CompiledConfig& to);
+
+// The configuration component: owns the current CompiledConfig for one file.
+//
+// Loading reads and hashes the text, then memory-maps the binary cache next
+// to it; if the cache was compiled from the same text it is decoded instead
+// of parsing, otherwise the text is compiled and the cache rewritten. A
+// missing file yields the built-in defaults; an invalid one is rejected and
+// the current configuration kept. load()/reload() belong to one thread;
+// current() may be called from any thread.
+class Configuration {
+public:
+    struct LoadStats {
+        bool fromCache = false;
+        bool cacheWritten = false;
+        std::size_t sourceBytes = 0;
+        std::uint64_t readMicros = 0;    // reading and hashing the text
+        std::uint64_t compileMicros = 0; // parsing the text or decoding the cache, rule set included
+        std::uint64_t totalMicros = 0;
+    };
+
+    // `cachePath` defaults to `path` + ".cache"
+    explicit Configuration(std::string path, std::string cachePath = std::string());
+
+    Configuration(const Configuration&) = delete;
+    Configuration& operator=(const Configuration&) = delete;
+
+    // Returns false (errors() set, current() unchanged) if the text is invalid
+    bool load();
+    // Loads again and returns the ConfigSection bits that changed (0 if the
+    // text is unchanged or invalid)
+    std::uint32_t reload();
+    // True if the file's size or modification time differs from the last load
+    bool sourceChanged() const;
+
+    std::shared_ptr<const CompiledConfig> current() const { return std::atomic_load(&m_current); }
+    const LoadStats& lastLoadStats() const { return m_stats; }
+    const std::vector<ConfigError>& errors() const { return m_errors; }
+    const std::string& path() const { return m_path; }
+    const std::string& cachePath() const { return m_cachePath; }
+
+private:
+    struct Stamp {
+        bool exists = false;
+        std::uint64_t size = 0;
+        std::int64_t modified = 0;
+        bool operator!=(const Stamp& other) const {
+            return exists != other.exists || size != other.size || modified != other.modified;
+        }
+    };
+
+    Stamp readStamp() const;
+    bool writeCache(const CompiledConfig& config) const;
+
+    std::string m_path;
+    std::string m_cachePath;
+    std::shared_ptr<const CompiledConfig> m_current; // std::atomic_store / atomic_load
+    std::vector<ConfigError> m_errors;
+    LoadStats m_stats;
+    Stamp m_stamp;
+};
+
+} // namespace core
+} // namespace maat
+
+#endif // MAAT_CORE_CONFIGURATION_H
@@ -1,15 +1,159 @@
 #ifndef MAAT_CORE_CORE_MANAGER_H
 #define MAAT_CORE_CORE_MANAGER_H
 
-#include <iostream>
+#include <cstdint>
+#include <memory>
+#include <utility>
+#include <vector>
+#include <maat_platform/platform_types.h>
+
+#include "maat_core/layout_tree.h"
+#include "maat_core/monitor_topology.h"
+#include "maat_core/spatial_index.h"
+#include "maat_core/window_registry.h"
+#include "maat_core/workspace_layout.h"
 
 namespace maat {
 namespace core {
+class MaatMediator;
 
+// Owns the tiling state. Each monitor has a set of workspaces, one of them
+// shown; every workspace keeps its own WorkspaceLayout (tree layouts share
+// one LayoutTree), which caches the rects it last produced. Events only dirty
+// the layout they touch; flushLayout() recomputes the dirty layouts of shown
+// workspaces and hands the mediator just the windows whose rect changed.
+// Hidden workspaces are left dirty until they are shown again.
 class CoreManager {
 public:
-    CoreManager();
+    static constexpr std::size_t kMaxWorkspaces = 16; // per monitor
+
+    explicit CoreManager(MaatMediator& mediator);
     ~CoreManager();
+
+    CoreManager(const CoreManager&) = delete;
+    CoreManager& operator=(const CoreManager&) = delete;
+
+    // Adopts a new monitor topology. Only what `diff` names is touched:
+    // resized monitors get their new work area (and are the only ones
+    // re-laid out on the next flush), added monitors start with one empty
+    // workspace, and the windows of removed monitors move, in one pass, to
+    // the same workspace of the first monitor. Monitor ids are the
+    // topology's stable ids.
+    void setTopology(const MonitorTopology& topology, const TopologyDiff& diff);
+
+    // Layout algorithm of a monitor's shown workspace. Switching keeps the
+    // windows in their current order; the new arrangement is applied on the
+    // next flush. Workspaces created later start with the default layout.
+    void setDefaultLayout(LayoutKind kind, const LayoutParams& params = LayoutParams());
+    // Changes the default (configuration reload): workspaces still on the
+    // previous default layout and parameters switch to the new ones, shown
+    // or not; workspaces changed through setLayout/setLayoutParams keep
+    // theirs. Only the switched workspaces are re-laid out.
+    void applyDefaultLayout(LayoutKind kind, const LayoutParams& params);
+    bool setLayout(maat::platform::MonitorId monitorId, LayoutKind kind);
+    bool setLayoutParams(maat::platform::MonitorId monitorId, const LayoutParams& params);
+    const WorkspaceLayout* layout(maat::platform::MonitorId monitorId) const;
+
+    // Workspaces (created on first use, up to kMaxWorkspaces per monitor).
+    // A switch hides the old workspace's windows and shows the new one's in
+    // one visibility batch, after one geometry batch holding only the rects
+    // that changed while it was hidden; an unchanged workspace costs no
+    // layout work at all. Both are sent immediately.
+    bool switchWorkspace(maat::platform::MonitorId monitorId, std::size_t workspace);
+    // Moves a window to another workspace of its monitor, hiding it if that
+    // workspace is not shown. Also sent immediately.
+    bool moveWindowToWorkspace(maat::platform::WindowId windowId, std::size_t workspace);
+    std::size_t activeWorkspace(maat::platform::MonitorId monitorId) const;
+    std::size_t workspaceCount(maat::platform::MonitorId monitorId) const;
+
+    // Session snapshot (stored by SessionStore): per monitor its work area,
+    // shown workspace and every workspace's layout kind, parameters and
+    // arrangement (split tree, weights, window order). Returns false, writing
+    // nothing, while there is no monitor (nothing worth keeping).
+    bool saveSession(std::vector<std::uint8_t>& out) const;
+    // Adopts the windows present at startup in one pass. Windows named in
+    // `snapshot` (may be nullptr) return to their saved workspace and place
+    // in its layout, on the monitor with the same work area (else the one at
+    // the same position); the others are placed as if just created. Nothing
+    // is sent before the next flushLayout(), which then applies everything in
+    // one geometry and one visibility batch. Returns the number of windows
+    // restored; a malformed snapshot restores none.
+    std::size_t restoreSession(const std::vector<std::pair<maat::platform::WindowId, maat::platform::Rect>>& windows,
+                               const std::uint8_t* snapshot, std::size_t size);
+    // Changes whenever what saveSession() writes may have changed
+    std::uint64_t sessionRevision() const { return m_sessionRevision; }
+    // Shows every window hidden on a workspace that is not shown (sent
+    // immediately). Used on shutdown: hidden windows would otherwise stay
+    // hidden, out of reach of the next instance's enumeration.
+    void revealHiddenWindows();
+
+    // The registry handle of a managed window, or a null one. Events hold on
+    // to it from when they arrive, and the handlers below do nothing for a
+    // handle that is no longer valid (the window has gone since, perhaps
+    // leaving its id to a new one).
+    WindowHandle windowHandle(maat::platform::WindowId windowId) const { return m_registry.find(windowId); }
+
+    // Returns the window's handle (the existing one if already managed)
+    WindowHandle onWindowCreated(maat::platform::WindowId windowId, const maat::platform::Rect& geometry);
+    void onWindowDestroyed(WindowHandle window);
+    // The window rules no longer manage the window: it leaves its layout like
+    // a destroyed one, and is shown again if its workspace is hidden.
+    void onWindowUnmanaged(WindowHandle window);
+    // The user finished moving/sizing a window; it is re-tiled on the monitor
+    // it was dropped on (in that monitor's shown workspace).
+    void onWindowMonitorChanged(WindowHandle window, maat::platform::MonitorId monitorId);
+
+    // Sizes a window was found to refuse (GeometryReconciler); 0 = no limit.
+    // Tree layouts size the window's siblings around them; in every layout
+    // its rect is reported again on the next flush, and from then on every
+    // rect it gets is held within the limits, keeping the tile's top-left
+    // corner the way the OS does. Returns false for an unknown window.
+    bool setWindowSizeLimits(maat::platform::WindowId windowId, const maat::platform::SizeHints& limits);
+
+    // Recomputes dirty layouts of shown workspaces and forwards changed
+    // geometry, then pending visibility changes, to the mediator.
+    void flushLayout();
+
+    std::size_t managedWindowCount() const { return m_registry.size(); }
+    const WindowRegistry& registry() const { return m_registry; }
+    // Rects of the windows on shown workspaces, as last laid out (for
+    // directional focus and hit tests). Kept up to date by flushLayout() from
+    // the same changes it hands the mediator, and by workspace switches.
+    const SpatialIndex& spatialIndex() const { return m_spatial; }
+
+private:
+    // Every member has a default initializer; build one member by member
+    // rather than with a positional brace list
+    struct MonitorState {
+        MonitorArea area{};
+        std::vector<std::unique_ptr<WorkspaceLayout>> workspaces; // never empty
+        std::size_t active = 0;
+
+        WorkspaceLayout& shown() const { return *workspaces[active]; }
+    };
+
+    std::size_t monitorForGeometry(const maat::platform::Rect& geometry) const;
+    std::size_t monitorIndex(maat::platform::MonitorId id) const;
+    void ensureWorkspace(MonitorState& monitor, std::size_t workspace);
+    void replaceLayout(std::unique_ptr<WorkspaceLayout>& layout, LayoutKind kind);
+    void insertIntoMonitor(WindowHandle window, std::size_t monitor, std::size_t workspace);
+    void detach(WindowHandle window);
+    void setHidden(WindowHandle window, bool hidden);
+    bool restoreMonitors(const std::uint8_t* snapshot, std::size_t size, std::vector<WindowHandle>& restored,
+                         std::size_t& matchedMonitors);
+
+    MaatMediator& m_mediator;
+    LayoutTree m_tree; // declared before the layouts allocating in it
+    std::vector<MonitorState> m_monitors;
+    LayoutKind m_defaultLayout = LayoutKind::Tree;
+    LayoutParams m_defaultParams;
+    WindowRegistry m_registry;
+    SpatialIndex m_spatial; // one region per monitor work area
+    LayoutTree::GeometryList m_changes; // reused across flushes
+    std::vector<std::pair<maat::platform::WindowId, bool>> m_visibilityChanges; // pending, per flush
+    std::vector<WindowHandle> m_scratchWindows;
+    std::uint64_t m_sessionRevision = 0;
+    std::size_t m_overconstrainedSeen = 0; // m_tree.solverStats().overconstrained at the last flush
 };
 
 } // namespace core
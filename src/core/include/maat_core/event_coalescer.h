@@ -0,0 +1,82 @@
+#ifndef MAAT_CORE_EVENT_COALESCER_H
+#define MAAT_CORE_EVENT_COALESCER_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include <maat_platform/platform_types.h>
+
+#include "maat_core/flat_id_map.h"
+#include "maat_core/window_handle.h"
+
+namespace maat {
+namespace core {
+
+// Collapses bursts of platform notifications into their net effect per window.
+//
+// Each window gets one pending entry (kept in first-seen order) holding the
+// actions the core still has to perform for it:
+//   create + destroy          -> release only (the core never sees the window)
+//   destroy + create (reuse)  -> destroy + create, platform object kept
+//   repeated move/size ends   -> one move to the last reported monitor
+//   create + unmanage         -> nothing (the platform keeps tracking it)
+// Any number of monitor layout changes collapse into a single flag, and so
+// do configuration reloads.
+//
+// Window events carry the core's handle for their id as of when they were
+// drained (null if the core does not manage it). An entry keeps the one from
+// its first event: its destroy and unmanage refer to that window, and so does
+// its move unless the entry also creates one, so a reused id cannot steer
+// them onto a different window.
+class EventCoalescer {
+public:
+    enum Action : std::uint8_t {
+        kDestroy = 0x1, // remove the managed window from the core
+        kRelease = 0x2, // release platform tracking
+        kCreate  = 0x4, // add the window to the core
+        kMove    = 0x8, // the window was moved/sized onto `monitor`
+        kUnmanage = 0x10 // remove the window from the core, keep platform tracking
+    };
+
+    struct Entry {
+        maat::platform::WindowId id;
+        std::uint8_t actions;
+        maat::platform::Rect geometry;     // valid with kCreate
+        maat::platform::MonitorId monitor; // valid with kMove
+        maat::platform::Timestamp createdAt; // OS event time of the create, valid with kCreate
+        WindowHandle window; // the core's window when the entry opened
+        std::uint32_t incarnation; // valid with kRelease: of the last destroy
+    };
+
+    void addWindowCreated(maat::platform::WindowId id, WindowHandle known, const maat::platform::Rect& geometry,
+                          maat::platform::Timestamp timestamp = 0);
+    void addWindowDestroyed(maat::platform::WindowId id, WindowHandle known, std::uint32_t incarnation = 0);
+    void addWindowMonitorChanged(maat::platform::WindowId id, WindowHandle known, maat::platform::MonitorId monitor);
+    void addWindowUnmanaged(maat::platform::WindowId id, WindowHandle known);
+    void addMonitorLayoutChanged();
+    void addConfigurationChanged();
+
+    bool empty() const { return m_entries.empty() && !m_monitorLayoutChanged && !m_configurationChanged; }
+    bool monitorLayoutChanged() const { return m_monitorLayoutChanged; }
+    bool configurationChanged() const { return m_configurationChanged; }
+    const std::vector<Entry>& entries() const { return m_entries; }
+
+    // Number of core-visible operations the pending entries expand to.
+    std::size_t pendingOperationCount() const;
+
+    // Drops all pending state, keeping allocated capacity.
+    void clear();
+
+private:
+    Entry& entryFor(maat::platform::WindowId id, WindowHandle known);
+
+    std::vector<Entry> m_entries;
+    FlatIdMap<std::uint32_t> m_index;
+    bool m_monitorLayoutChanged = false;
+    bool m_configurationChanged = false;
+};
+
+} // namespace core
+} // namespace maat
+
+#endif // MAAT_CORE_EVENT_COALESCER_H
@@ -0,0 +1,121 @@
+#ifndef MAAT_CORE_EVENT_TRACE_H
+#define MAAT_CORE_EVENT_TRACE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include <vector>
+#include <maat_platform/platform_event.h>
+#include <maat_platform/platform_types.h>
+
+#include "maat_core/monitor_topology.h"
+
+namespace maat {
+namespace core {
+
+// Binary trace of everything the core consumed from the platform, used to
+// replay production incidents offline.
+//
+// Layout (all integers little-endian / LEB128):
+//   header  "MAATTRC\0", u32 version, u32 reserved
+//   record  u8 kind, zigzag varint time delta to the previous record, body
+// Record bodies by kind:
+//   Event (1..6 = PlatformEventType + 1)
+//           varint hook delay (received - OS timestamp), then
+//           WindowCreated        varint window, rect
+//           WindowDestroyed      varint window
+//           WindowMonitorChanged varint window, varint monitor
+//           MonitorLayoutChanged (nothing)
+//           WindowUnmanaged      varint window
+//           ConfigurationChanged (nothing)
+//   MonitorSnapshot (0x10)  varint count, count x (varint id, rect)
+//   InitialWindow   (0x11)  varint window, rect
+// A rect is four zigzag varints (x, y, width, height). Times are
+// getMonotonicTime() microseconds of the recording machine; only differences
+// are meaningful. A typical event takes 4-12 bytes.
+enum class TraceRecordKind : std::uint8_t {
+    Event = 1,              // 1..6, see above; normalised to Event when read
+    MonitorSnapshot = 0x10, // monitors the core was given (initialize / layout change)
+    InitialWindow = 0x11    // window found by enumerateInitialWindows()
+};
+
+// Appends trace records to a file (or only to memory). Not thread-safe: the
+// mediator writes from its consuming thread.
+class EventTraceWriter {
+public:
+    static constexpr std::uint32_t kVersion = 1;
+
+    EventTraceWriter();
+    ~EventTraceWriter();
+
+    EventTraceWriter(const EventTraceWriter&) = delete;
+    EventTraceWriter& operator=(const EventTraceWriter&) = delete;
+
+    // Starts writing to `path` (truncating). Returns false if it cannot be
+    // opened. Without open() records accumulate in buffer().
+    bool open(const std::string& path);
+    void close();
+
+    void writeEvent(const maat::platform::PlatformEvent& event);
+    void writeMonitorSnapshot(maat::platform::Timestamp time, const std::vector<MonitorArea>& monitors);
+    void writeInitialWindow(maat::platform::Timestamp time, maat::platform::WindowId window,
+                            const maat::platform::Rect& geometry);
+
+    // Pushes buffered bytes to the file.
+    void flush();
+
+    std::size_t recordCount() const { return m_recordCount; }
+    std::size_t bytesWritten() const { return m_bytesFlushed + m_buffer.size(); }
+    // Unflushed bytes (everything, for a memory-only writer)
+    const std::vector<std::uint8_t>& buffer() const { return m_buffer; }
+
+private:
+    void beginRecord(std::uint8_t kind, maat::platform::Timestamp time);
+    void putVarint(std::uint64_t value);
+    void putSigned(std::int64_t value);
+    void putRect(const maat::platform::Rect& rect);
+
+    std::FILE* m_file = nullptr;
+    std::vector<std::uint8_t> m_buffer;
+    std::size_t m_bytesFlushed = 0;
+    std::size_t m_recordCount = 0;
+    maat::platform::Timestamp m_lastTime = 0;
+    bool m_haveLastTime = false;
+};
+
+// One decoded trace record.
+struct TraceRecord {
+    TraceRecordKind kind;
+    maat::platform::Timestamp time;     // absolute (recording clock)
+    maat::platform::PlatformEvent event; // Event; InitialWindow uses window and geometry
+    std::uint32_t firstMonitor = 0;     // MonitorSnapshot: range in EventTrace::monitors()
+    std::uint32_t monitorCount = 0;
+};
+
+// A fully decoded trace held in memory.
+class EventTrace {
+public:
+    // Returns false (with error() set) on I/O failure or a malformed trace;
+    // records decoded before a truncated tail are kept.
+    bool load(const std::string& path);
+    bool parse(const std::uint8_t* data, std::size_t size);
+
+    const std::vector<TraceRecord>& records() const { return m_records; }
+    const std::vector<MonitorArea>& monitors() const { return m_monitors; }
+    const std::string& error() const { return m_error; }
+
+    // Time of the first / last record (0 if empty)
+    maat::platform::Timestamp startTime() const { return m_records.empty() ? 0 : m_records.front().time; }
+    maat::platform::Timestamp endTime() const { return m_records.empty() ? 0 : m_records.back().time; }
+
+private:
+    std::vector<TraceRecord> m_records;
+    std::vector<MonitorArea> m_monitors;
+    std::string m_error;
+};
+
+} // namespace core
+} // namespace maat
+
+#endif // MAAT_CORE_EVENT_TRACE_H
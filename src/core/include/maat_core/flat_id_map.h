@@ -0,0 +1,160 @@
+#ifndef MAAT_CORE_FLAT_ID_MAP_H
+#define MAAT_CORE_FLAT_ID_MAP_H
+
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+namespace maat {
+namespace core {
+
+// Open-addressing hash map keyed by platform ids (WindowId / MonitorId).
+//
+// Keys and values sit inline in one flat array probed linearly, so a lookup is
+// usually a single cache miss and no operation allocates once the table has
+// grown to its working size. Erase uses backward-shift deletion, so there are
+// no tombstones and probe chains never degrade. Key 0 is reserved as the
+// empty marker (no platform hands out a null handle). Values need only be
+// default-constructible and movable.
+template <typename V>
+class FlatIdMap {
+public:
+    typedef std::uintptr_t Key;
+
+    explicit FlatIdMap(std::size_t initialCapacity = 16) { rehash(initialCapacity); }
+
+    std::size_t size() const { return m_size; }
+    bool empty() const { return m_size == 0; }
+
+    V* find(Key key) {
+        assert(key != 0);
+        for (std::size_t i = bucketFor(key);; i = (i + 1) & m_mask) {
+            Slot& slot = m_slots[i];
+            if (slot.key == key) return &slot.value;
+            if (slot.key == 0) return nullptr;
+        }
+    }
+
+    const V* find(Key key) const { return const_cast<FlatIdMap*>(this)->find(key); }
+
+    bool contains(Key key) const { return find(key) != nullptr; }
+
+    // Inserts `value` unless `key` is present. Returns the stored value and
+    // whether an insertion happened.
+    std::pair<V*, bool> insert(Key key, const V& value) { return place(key, value); }
+    // As above, moving `value` in; also the way to store move-only values
+    std::pair<V*, bool> insert(Key key, V&& value) { return place(key, std::move(value)); }
+
+    V& operator[](Key key) { return *insert(key, V{}).first; }
+
+    void set(Key key, const V& value) { *insert(key, value).first = value; }
+
+    bool erase(Key key) {
+        assert(key != 0);
+        std::size_t i = bucketFor(key);
+        for (;; i = (i + 1) & m_mask) {
+            if (m_slots[i].key == key) break;
+            if (m_slots[i].key == 0) return false;
+        }
+        // Backward-shift: pull later members of the probe chain into the hole
+        std::size_t hole = i;
+        for (std::size_t j = (i + 1) & m_mask; m_slots[j].key != 0; j = (j + 1) & m_mask) {
+            const std::size_t home = bucketFor(m_slots[j].key);
+            // Move j into the hole unless its home lies cyclically in (hole, j]
+            const bool homeBetween = hole <= j ? (home > hole && home <= j)
+                                               : (home > hole || home <= j);
+            if (!homeBetween) {
+                m_slots[hole] = std::move(m_slots[j]);
+                hole = j;
+            }
+        }
+        m_slots[hole].key = 0;
+        m_slots[hole].value = V{};
+        --m_size;
+        return true;
+    }
+
+    // Removes every entry but keeps the table's capacity.
+    void clear() {
+        for (Slot& slot : m_slots) {
+            slot.key = 0;
+            slot.value = V{};
+        }
+        m_size = 0;
+    }
+
+    // Visits every entry in table order; `fn` must not insert or erase
+    template <typename Fn>
+    void forEach(Fn&& fn) const {
+        for (const Slot& slot : m_slots) {
+            if (slot.key != 0) fn(slot.key, slot.value);
+        }
+    }
+
+    template <typename Fn>
+    void forEach(Fn&& fn) {
+        for (Slot& slot : m_slots) {
+            if (slot.key != 0) fn(slot.key, slot.value);
+        }
+    }
+
+private:
+    struct Slot {
+        Key key = 0;
+        V value{};
+    };
+
+    template <typename U>
+    std::pair<V*, bool> place(Key key, U&& value) {
+        if (V* existing = find(key)) {
+            return {existing, false};
+        }
+        if ((m_size + 1) * 4 > m_slots.size() * 3) {
+            rehash(m_slots.size() * 2); // keep load factor <= 0.75
+        }
+        for (std::size_t i = bucketFor(key);; i = (i + 1) & m_mask) {
+            Slot& slot = m_slots[i];
+            if (slot.key == 0) {
+                slot.key = key;
+                slot.value = std::forward<U>(value);
+                ++m_size;
+                return {&slot.value, true};
+            }
+        }
+    }
+
+    std::size_t bucketFor(Key key) const {
+        // Handles are often aligned and clustered; mix all bits (splitmix64 finaliser)
+        std::uint64_t h = static_cast<std::uint64_t>(key);
+        h ^= h >> 30;
+        h *= 0xbf58476d1ce4e5b9ULL;
+        h ^= h >> 27;
+        h *= 0x94d049bb133111ebULL;
+        h ^= h >> 31;
+        return static_cast<std::size_t>(h) & m_mask;
+    }
+
+    void rehash(std::size_t capacity) {
+        std::size_t size = 8;
+        while (size < capacity) size <<= 1;
+        std::vector<Slot> old;
+        old.swap(m_slots);
+        m_slots.resize(size);
+        m_mask = size - 1;
+        m_size = 0;
+        for (Slot& slot : old) {
+            if (slot.key != 0) place(slot.key, std::move(slot.value));
+        }
+    }
+
+    std::vector<Slot> m_slots;
+    std::size_t m_mask = 0;
+    std::size_t m_size = 0;
+};
+
+} // namespace core
+} // namespace maat
+
+#endif // MAAT_CORE_FLAT_ID_MAP_H
@@ -0,0 +1,100 @@
+#ifndef MAAT_CORE_GEOMETRY_ANIMATOR_H
+#define MAAT_CORE_GEOMETRY_ANIMATOR_H
+
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+#include <vector>
+#include <maat_platform/platform_types.h>
+
+#include "maat_core/flat_id_map.h"
+
+namespace maat {
+namespace core {
+
+struct AnimationSettings {
+    bool enabled = false;
+    std::uint32_t frameRate = 60;                 // frames per second, 1..240
+    maat::platform::Timestamp duration = 150000;  // micros per transition
+    // Longest a frame may take to apply (steady clock) before the animations
+    // in flight jump to their targets; 0 never checks
+    std::uint64_t frameBudget = 8000;
+};
+
+// Interpolates window geometry from where a window is to where the layout
+// wants it, one frame at a time.
+//
+// Transitions are frame-paced on the platform clock: frame() emits the
+// current rect of every window in flight, meant to go out as one
+// applyWindowGeometries batch, and nextFrameTime() says when the next one is
+// due. Starting a transition for a window already in flight retargets it
+// from where it is on screen, cancelling the old one. Under load a frame jumps
+// straight to the targets: when the previous frame took longer than the
+// budget to apply, or when a whole frame interval was missed. Not
+// thread-safe; owned by the consuming thread.
+class GeometryAnimator {
+public:
+    struct Stats {
+        std::size_t started = 0;     // transitions started
+        std::size_t retargeted = 0;  // started for a window already in flight
+        std::size_t cancelled = 0;   // removed before reaching their target
+        std::size_t frames = 0;      // frames emitted, final jumps included
+        std::size_t finalJumps = 0;  // frames that skipped to the targets under load
+        std::size_t maxFrameSize = 0;
+    };
+
+    void setSettings(const AnimationSettings& settings);
+    const AnimationSettings& settings() const { return m_settings; }
+    // True if geometry changes should be animated
+    bool enabled() const { return m_settings.enabled && m_settings.duration > 0; }
+    maat::platform::Timestamp frameInterval() const;
+
+    // Moves `id` to `to`, starting from the rect last emitted for it if it is
+    // in flight, from `from` otherwise
+    void start(maat::platform::WindowId id, const maat::platform::Rect& from, const maat::platform::Rect& to,
+               maat::platform::Timestamp now);
+    // Stops `id` where it is; its target is stored in `target` if given.
+    // Returns false if it was not in flight.
+    bool cancel(maat::platform::WindowId id, maat::platform::Rect* target = nullptr);
+
+    bool active() const { return !m_transitions.empty(); }
+    std::size_t activeCount() const { return m_transitions.size(); }
+    // Only meaningful while active()
+    maat::platform::Timestamp nextFrameTime() const { return m_nextFrame; }
+
+    // Appends the rect at `now` of every window in flight whose rect changed
+    // since the last frame (the target for those done) to `out`; finished
+    // transitions are removed
+    void frame(maat::platform::Timestamp now,
+               std::vector<std::pair<maat::platform::WindowId, maat::platform::Rect>>& out);
+    // How long (steady micros) applying the last frame took
+    void recordFrameCost(std::uint64_t micros) { m_lastFrameCost = micros; }
+    // Appends every target and stops all transitions
+    void finish(std::vector<std::pair<maat::platform::WindowId, maat::platform::Rect>>& out);
+
+    const Stats& stats() const { return m_stats; }
+
+private:
+    struct Transition {
+        maat::platform::WindowId id;
+        maat::platform::Rect from;
+        maat::platform::Rect to;
+        maat::platform::Rect shown; // last rect emitted
+        maat::platform::Timestamp start;
+    };
+
+    maat::platform::Rect currentRect(const Transition& transition, maat::platform::Timestamp now) const;
+    void remove(std::size_t index);
+
+    AnimationSettings m_settings;
+    std::vector<Transition> m_transitions; // in start order, except after swap-removal
+    FlatIdMap<std::uint32_t> m_index;      // window -> position in m_transitions
+    maat::platform::Timestamp m_nextFrame = 0;
+    std::uint64_t m_lastFrameCost = 0;
+    Stats m_stats;
+};
+
+} // namespace core
+} // namespace maat
+
+#endif // MAAT_CORE_GEOMETRY_ANIMATOR_H
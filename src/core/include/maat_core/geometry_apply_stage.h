@@ -0,0 +1,98 @@
+#ifndef MAAT_CORE_GEOMETRY_APPLY_STAGE_H
+#define MAAT_CORE_GEOMETRY_APPLY_STAGE_H
+
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <thread>
+#include <utility>
+#include <vector>
+#include <maat_platform/platform_types.h>
+
+#include "maat_core/flat_id_map.h"
+#include "maat_core/latency_histogram.h"
+
+namespace maat {
+namespace platform {
+class PlatformManager;
+} // namespace platform
+
+namespace core {
+
+// Hands geometry and visibility to the platform from a thread of its own, so
+// a slow or hung application stalls that thread only, never layout.
+//
+// Geometry goes through a per-window mailbox holding the latest desired
+// rect: a rect submitted while an earlier one for the same window is still
+// waiting replaces it (counted as superseded) instead of queueing behind it.
+// Each round the apply thread takes everything waiting as one
+// applyWindowGeometries batch, in first-submitted order, then the visibility
+// changes submitted meanwhile, so a window shown in the same pass appears
+// at its new rect. Submitting only holds the mutex while copying the updates
+// in; the apply thread never holds it while calling the platform.
+class GeometryApplyStage {
+public:
+    struct Stats {
+        std::uint64_t submitted = 0;  // rects submitted
+        std::uint64_t superseded = 0; // replaced in the mailbox before being applied
+        std::uint64_t applied = 0;    // rects handed to the platform
+        std::uint64_t batches = 0;    // applyWindowGeometries calls
+        std::uint64_t visibilityChanges = 0;
+        std::uint64_t maxBatchSize = 0;
+    };
+
+    explicit GeometryApplyStage(maat::platform::PlatformManager& platform);
+    ~GeometryApplyStage();
+
+    GeometryApplyStage(const GeometryApplyStage&) = delete;
+    GeometryApplyStage& operator=(const GeometryApplyStage&) = delete;
+
+    void start();
+    // Applies whatever is still waiting, then joins the apply thread
+    void stop();
+    bool running() const { return m_thread.joinable(); }
+
+    // Any thread; only valid while running(). Returns the submission's
+    // sequence number (1, 2, ...; 0 for an empty submission).
+    std::uint64_t submitGeometry(
+        const std::vector<std::pair<maat::platform::WindowId, maat::platform::Rect>>& updates);
+    void submitVisibility(const std::vector<std::pair<maat::platform::WindowId, bool>>& changes);
+    // Blocks until everything submitted before the call has been applied
+    void flush();
+
+    Stats stats() const;
+    // Highest submission sequence whose rects have all reached the platform
+    std::uint64_t appliedSequence() const;
+    // Per batch, written by the apply thread: how long the platform took, and
+    // how many rects it was given
+    const LatencyHistogram& applyMicros() const { return m_applyMicros; }
+    const LatencyHistogram& batchSizes() const { return m_batchSizes; }
+
+private:
+    void threadMain();
+
+    maat::platform::PlatformManager& m_platform;
+    std::thread m_thread;
+
+    // Guarded by m_mutex
+    mutable std::mutex m_mutex;
+    std::condition_variable m_wake; // work submitted or stop requested
+    std::condition_variable m_idle; // a round finished (flush)
+    std::vector<std::pair<maat::platform::WindowId, maat::platform::Rect>> m_pending;
+    FlatIdMap<std::uint32_t> m_pendingIndex; // window -> position in m_pending
+    std::vector<std::pair<maat::platform::WindowId, bool>> m_pendingVisibility;
+    bool m_applying = false;
+    bool m_stop = false;
+    std::uint64_t m_submitSequence = 0;
+    std::uint64_t m_appliedSequence = 0;
+    Stats m_stats;
+
+    LatencyHistogram m_applyMicros;
+    LatencyHistogram m_batchSizes;
+};
+
+} // namespace core
+} // namespace maat
+
+#endif // MAAT_CORE_GEOMETRY_APPLY_STAGE_H
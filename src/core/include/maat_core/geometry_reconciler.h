@@ -0,0 +1,122 @@
+#ifndef MAAT_CORE_GEOMETRY_RECONCILER_H
+#define MAAT_CORE_GEOMETRY_RECONCILER_H
+
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+#include <vector>
+#include <maat_platform/platform_types.h>
+#include <maat_platform/window_attributes.h>
+
+#include "maat_core/flat_id_map.h"
+
+namespace maat {
+namespace core {
+
+struct ReconcileSettings {
+    bool enabled = true;
+    // Platform-clock micros from applying a rect to reading it back (the OS
+    // moves windows of other processes asynchronously)
+    maat::platform::Timestamp settleDelay = 50000;
+    // A size off by at most this many pixels is the window snapping to its
+    // own increments (character cells), not a limit worth learning
+    int snapTolerance = 24;
+    // Limits learned in a row (each one re-lays the window out) before a
+    // window is left alone for `cooldown`
+    std::uint32_t retryBudget = 3;
+    maat::platform::Timestamp cooldown = 10000000;
+};
+
+// Checks that windows took the rects they were given, and learns the sizes
+// they will not take.
+//
+// Every rect that reaches its window is expected back settleDelay later; the
+// consuming thread then reads the windows' real rects (one platform call for
+// all checks due) and reconciles each. A window larger than asked on an axis
+// has a minimum size there, one smaller a maximum; the limits are handed to
+// the core, whose next rect for the window stays within them, so the rect it
+// would refuse is never sent again. Differences within snapTolerance are
+// taken as they are and teach nothing.
+//
+// A window that answers every rect with new limits (it resizes itself, or
+// grows with whatever it is given) would turn this into an apply/re-layout
+// loop, so each limit learned spends from a per-window budget, refilled when
+// the window takes a rect; once it is spent the window is not checked again
+// until the cooldown has passed. Not thread-safe; owned by the consuming
+// thread.
+class GeometryReconciler {
+public:
+    enum class Outcome : std::uint8_t {
+        Accepted, // the window took the rect
+        Refused,  // it kept a rect of its own; nothing learned
+        Limited,  // it refused, and its limits() changed
+        Exhausted // it spent its retry budget; left alone for the cooldown
+    };
+
+    struct Stats {
+        std::size_t checks = 0; // windows read back
+        std::size_t accepted = 0;
+        std::size_t refused = 0;
+        std::size_t limited = 0;
+        std::size_t exhausted = 0;
+        std::size_t deferred = 0; // due before their rect was applied (apply thread behind)
+    };
+
+    void setSettings(const ReconcileSettings& settings);
+    const ReconcileSettings& settings() const { return m_settings; }
+
+    // `requested` was handed to the platform for `id` in apply `sequence`;
+    // it is checked settleDelay after `now`, replacing any check still
+    // pending for the window. Windows cooling down are not checked.
+    void expect(maat::platform::WindowId id, const maat::platform::Rect& requested, maat::platform::Timestamp now,
+                std::uint64_t sequence = 0);
+    // Drops the pending check (the window is about to move elsewhere)
+    void cancel(maat::platform::WindowId id);
+    // Drops everything known about the window (destroyed or unmanaged)
+    void forget(maat::platform::WindowId id);
+
+    bool pending() const { return !m_checks.empty(); }
+    // Only meaningful while pending()
+    maat::platform::Timestamp nextCheckTime() const { return m_nextCheck; }
+    // Moves the checks due at `now` into `out` as (window, requested rect).
+    // Those whose apply sequence is beyond `appliedSequence` stay, pushed
+    // back by settleDelay.
+    void takeDue(maat::platform::Timestamp now, std::uint64_t appliedSequence,
+                 std::vector<std::pair<maat::platform::WindowId, maat::platform::Rect>>& out);
+
+    // Compares what a window was asked for with where it is
+    Outcome reconcile(maat::platform::WindowId id, const maat::platform::Rect& requested,
+                      const maat::platform::Rect& actual, maat::platform::Timestamp now);
+    // What the window was found to accept (nullptr if nothing was learned)
+    const maat::platform::SizeHints* limits(maat::platform::WindowId id) const;
+
+    const Stats& stats() const { return m_stats; }
+
+private:
+    struct Check {
+        maat::platform::WindowId id;
+        maat::platform::Rect requested;
+        maat::platform::Timestamp due;
+        std::uint64_t sequence;
+    };
+
+    struct WindowState {
+        maat::platform::SizeHints limits;
+        std::uint32_t refusals = 0;               // limits learned in a row
+        maat::platform::Timestamp coolUntil = 0;  // not checked before
+    };
+
+    void removeCheck(std::size_t index);
+
+    ReconcileSettings m_settings;
+    std::vector<Check> m_checks;           // unordered
+    FlatIdMap<std::uint32_t> m_checkIndex; // window -> position in m_checks
+    FlatIdMap<WindowState> m_windows;      // windows that refused at least once
+    maat::platform::Timestamp m_nextCheck = 0;
+    Stats m_stats;
+};
+
+} // namespace core
+} // namespace maat
+
+#endif // MAAT_CORE_GEOMETRY_RECONCILER_H
@@ -0,0 +1,164 @@
+#ifndef MAAT_CORE_LATENCY_HISTOGRAM_H
+#define MAAT_CORE_LATENCY_HISTOGRAM_H
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+
+namespace maat {
+namespace core {
+
+// Fixed-bucket latency histogram with HDR-style log-linear buckets.
+//
+// Values (microseconds) below 2^kSubBucketBits get one bucket each; above
+// that, every power-of-two range is split into 2^kSubBucketBits equal
+// sub-buckets, so any recorded value is reproduced within ~3% relative error
+// from 0 us up to ~12 days. Storage is one fixed array: record() never
+// allocates and costs a few integer instructions.
+//
+// Single writer: record() and reset() must come from one thread at a time.
+// Counters are relaxed atomics, so readers on other threads may take
+// percentiles at any time and see a slightly stale but well-formed view.
+class LatencyHistogram {
+public:
+    static constexpr unsigned kSubBucketBits = 5;
+    static constexpr std::uint64_t kSubBucketCount = 1u << kSubBucketBits;
+    static constexpr unsigned kMaxShift = 35; // largest trackable value ~2^40 us
+    static constexpr std::size_t kBucketCount = (kMaxShift + 2) * kSubBucketCount;
+
+    void record(std::uint64_t micros) {
+        bump(m_buckets[bucketIndex(micros)]);
+        bump(m_count);
+        store(m_total, m_total.load(std::memory_order_relaxed) + micros);
+        if (micros > m_max.load(std::memory_order_relaxed)) store(m_max, micros);
+    }
+
+    void reset() {
+        for (auto& bucket : m_buckets) store(bucket, 0);
+        store(m_count, 0);
+        store(m_total, 0);
+        store(m_max, 0);
+    }
+
+    std::uint64_t count() const { return m_count.load(std::memory_order_relaxed); }
+    std::uint64_t max() const { return m_max.load(std::memory_order_relaxed); }
+    double mean() const {
+        const std::uint64_t n = count();
+        return n ? static_cast<double>(m_total.load(std::memory_order_relaxed)) / n : 0.0;
+    }
+
+    // Smallest recorded value v such that `quantile` of all samples are <= v
+    // (reported as the upper edge of its bucket, capped at max()). 0 if empty.
+    std::uint64_t percentile(double quantile) const {
+        std::uint64_t total = 0;
+        for (const auto& bucket : m_buckets) total += bucket.load(std::memory_order_relaxed);
+        if (total == 0) return 0;
+        if (quantile < 0.0) quantile = 0.0;
+        if (quantile > 1.0) quantile = 1.0;
+        std::uint64_t rank = static_cast<std::uint64_t>(quantile * total + 0.5);
+        if (rank == 0) rank = 1;
+        std::uint64_t seen = 0;
+        for (std::size_t i = 0; i < kBucketCount; ++i) {
+            seen += m_buckets[i].load(std::memory_order_relaxed);
+            if (seen >= rank) {
+                const std::uint64_t upper = bucketUpperBound(i);
+                const std::uint64_t observedMax = max();
+                return upper < observedMax ? upper : observedMax;
+            }
+        }
+        return max();
+    }
+
+    static std::size_t bucketIndex(std::uint64_t value) {
+        if (value < kSubBucketCount) return static_cast<std::size_t>(value);
+        unsigned magnitude = 63u - countLeadingZeros(value);
+        unsigned shift = magnitude - kSubBucketBits;
+        if (shift > kMaxShift) return kBucketCount - 1;
+        return static_cast<std::size_t>((shift + 1) * kSubBucketCount + ((value >> shift) - kSubBucketCount));
+    }
+
+    static std::uint64_t bucketUpperBound(std::size_t index) {
+        if (index < kSubBucketCount) return index;
+        const unsigned shift = static_cast<unsigned>(index / kSubBucketCount) - 1;
+        const std::uint64_t mantissa = kSubBucketCount + index % kSubBucketCount;
+        return (mantissa << shift) + ((std::uint64_t(1) << shift) - 1);
+    }
+
+private:
+    static unsigned countLeadingZeros(std::uint64_t value) {
+        unsigned n = 0;
+        for (std::uint64_t bit = std::uint64_t(1) << 63; bit && !(value & bit); bit >>= 1) ++n;
+        return n;
+    }
+
+    // Single writer, so a relaxed load/store pair replaces a locked RMW
+    static void bump(std::atomic<std::uint64_t>& counter) {
+        counter.store(counter.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+    }
+    static void store(std::atomic<std::uint64_t>& counter, std::uint64_t value) {
+        counter.store(value, std::memory_order_relaxed);
+    }
+
+    std::array<std::atomic<std::uint64_t>, kBucketCount> m_buckets{};
+    std::atomic<std::uint64_t> m_count{0};
+    std::atomic<std::uint64_t> m_total{0};
+    std::atomic<std::uint64_t> m_max{0};
+};
+
+// Wall-clock stopwatch for the compute stages, independent of the platform
+// clock (which is virtual in the simulated backend).
+inline std::uint64_t steadyMicros() {
+    return static_cast<std::uint64_t>(std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count());
+}
+
+// Stages of the event -> geometry pipeline that are timed.
+enum class LatencyStage : std::uint8_t {
+    HookDelivery,  // OS event time -> platform hook received it
+    Queue,         // hook received -> drained by the consumer thread
+    Layout,        // CoreManager layout pass (computeDirtyLayout over dirty monitors)
+    Diff,          // requestApplyLayout filtering against the last applied geometry
+    Apply,         // PlatformManager::applyWindowGeometries call (the hand-off, with the apply thread)
+    WindowTiled,   // OS "window appeared" event time -> its first geometry applied
+    Count
+};
+
+// One histogram per LatencyStage.
+class LatencyRecorder {
+public:
+    static constexpr std::size_t kStageCount = static_cast<std::size_t>(LatencyStage::Count);
+
+    void record(LatencyStage stage, std::uint64_t micros) { histogram(stage).record(micros); }
+
+    LatencyHistogram& histogram(LatencyStage stage) { return m_histograms[static_cast<std::size_t>(stage)]; }
+    const LatencyHistogram& histogram(LatencyStage stage) const {
+        return m_histograms[static_cast<std::size_t>(stage)];
+    }
+
+    void reset() {
+        for (auto& h : m_histograms) h.reset();
+    }
+
+    static const char* stageName(LatencyStage stage) {
+        switch (stage) {
+            case LatencyStage::HookDelivery: return "hook_delivery";
+            case LatencyStage::Queue: return "queue";
+            case LatencyStage::Layout: return "layout";
+            case LatencyStage::Diff: return "diff";
+            case LatencyStage::Apply: return "apply";
+            case LatencyStage::WindowTiled: return "window_tiled";
+            case LatencyStage::Count: break;
+        }
+        return "unknown";
+    }
+
+private:
+    std::array<LatencyHistogram, kStageCount> m_histograms;
+};
+
+} // namespace core
+} // namespace maat
+
+#endif // MAAT_CORE_LATENCY_HISTOGRAM_H
@@ -0,0 +1,189 @@
+#ifndef MAAT_CORE_LAYOUT_POLICIES_H
+#define MAAT_CORE_LAYOUT_POLICIES_H
+
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <maat_platform/platform_types.h>
+
+#include "maat_core/layout_tree.h"
+
+namespace maat {
+namespace core {
+
+// Tunables shared by the layout policies; each policy reads only the ones it
+// documents.
+struct LayoutParams {
+    float masterRatio = 0.55f;      // MasterStack: share of the extent given to the master area
+    std::uint32_t masterCount = 1;  // MasterStack: windows in the master area
+    SplitAxis axis = SplitAxis::Horizontal; // MasterStack: master beside (Horizontal) or above the stack;
+                                            // Dwindle: first split; Columns: columns or rows
+    int innerGap = 0; // All layouts: pixels between neighbouring windows
+    int outerGap = 0; // All layouts: pixels between the windows and the work area edge
+};
+
+// Bounds on LayoutParams, enforced by the configuration parser and by every
+// decoder of saved settings: the ratio lies strictly between 0 and 1, gaps
+// in [0, kMaxLayoutGap], the master count at most kMaxMasterCount
+constexpr std::uint32_t kMaxMasterCount = 1000;
+constexpr int kMaxLayoutGap = 1000;
+
+inline bool validLayoutParams(const LayoutParams& params) {
+    return params.masterRatio > 0.0f && params.masterRatio < 1.0f && params.masterCount <= kMaxMasterCount &&
+           params.innerGap >= 0 && params.innerGap <= kMaxLayoutGap && params.outerGap >= 0 &&
+           params.outerGap <= kMaxLayoutGap;
+}
+
+inline bool operator==(const LayoutParams& a, const LayoutParams& b) {
+    return a.masterRatio == b.masterRatio && a.masterCount == b.masterCount && a.axis == b.axis &&
+           a.innerGap == b.innerGap && a.outerGap == b.outerGap;
+}
+
+inline bool operator!=(const LayoutParams& a, const LayoutParams& b) {
+    return !(a == b);
+}
+
+// Layout algorithms as compile-time policies.
+//
+// A policy is a stateless struct with
+//   static constexpr const char* kName;
+//   template <typename Emit>
+//   static void arrange(const Rect& area, std::size_t count, const LayoutParams& params, Emit&& emit);
+// which calls emit(index, rect) exactly once for each of the `count` windows,
+// in window order. arrange() and the emit callback are both inlined into the
+// caller, so generating rects is a flat loop without any indirect call.
+// Edges come from integer slicing of the full extent, so neighbouring rects
+// always share an edge and the last one ends exactly on the area's edge.
+namespace layout_detail {
+
+// Far edge of slice `i` when [origin, origin + extent) is cut into `count` equal slices
+inline int sliceEdge(int origin, int extent, std::size_t i, std::size_t count) {
+    return origin + static_cast<int>(static_cast<long long>(extent) * static_cast<long long>(i + 1) /
+                                     static_cast<long long>(count));
+}
+
+// Emits `count` equal slices of `area` along `axis` as windows first..first+count-1
+template <typename Emit>
+inline void slices(const maat::platform::Rect& area, SplitAxis axis, std::size_t first, std::size_t count,
+                   Emit& emit) {
+    const bool horizontal = axis == SplitAxis::Horizontal;
+    const int origin = horizontal ? area.x : area.y;
+    const int extent = horizontal ? area.width : area.height;
+    int start = origin;
+    for (std::size_t i = 0; i < count; ++i) {
+        const int end = sliceEdge(origin, extent, i, count);
+        emit(first + i, horizontal ? maat::platform::Rect{start, area.y, end - start, area.height}
+                                   : maat::platform::Rect{area.x, start, area.width, end - start});
+        start = end;
+    }
+}
+
+inline SplitAxis other(SplitAxis axis) {
+    return axis == SplitAxis::Horizontal ? SplitAxis::Vertical : SplitAxis::Horizontal;
+}
+
+} // namespace layout_detail
+
+// Master area holding the first `masterCount` windows, the rest stacked
+// beside it. Falls back to a single stack when every window is a master.
+struct MasterStackPolicy {
+    static constexpr const char* kName = "master_stack";
+
+    template <typename Emit>
+    static void arrange(const maat::platform::Rect& area, std::size_t count, const LayoutParams& params,
+                        Emit&& emit) {
+        using layout_detail::other;
+        using layout_detail::slices;
+        const std::size_t masters = params.masterCount < count ? params.masterCount : count;
+        const SplitAxis stackAxis = other(params.axis);
+        if (masters == 0 || masters == count) {
+            slices(area, stackAxis, 0, count, emit);
+            return;
+        }
+        float ratio = params.masterRatio;
+        ratio = ratio < 0.05f ? 0.05f : (ratio > 0.95f ? 0.95f : ratio);
+        maat::platform::Rect master = area;
+        maat::platform::Rect stack = area;
+        if (params.axis == SplitAxis::Horizontal) {
+            master.width = static_cast<int>(area.width * ratio + 0.5f);
+            stack.x = area.x + master.width;
+            stack.width = area.width - master.width;
+        } else {
+            master.height = static_cast<int>(area.height * ratio + 0.5f);
+            stack.y = area.y + master.height;
+            stack.height = area.height - master.height;
+        }
+        slices(master, stackAxis, 0, masters, emit);
+        slices(stack, stackAxis, masters, count - masters, emit);
+    }
+};
+
+// Each window takes half of the space left by the previous ones, alternating
+// the split axis (starting with params.axis); the last window takes the rest.
+struct DwindlePolicy {
+    static constexpr const char* kName = "dwindle";
+
+    template <typename Emit>
+    static void arrange(const maat::platform::Rect& area, std::size_t count, const LayoutParams& params,
+                        Emit&& emit) {
+        maat::platform::Rect rest = area;
+        SplitAxis axis = params.axis;
+        for (std::size_t i = 0; i < count; ++i) {
+            if (i + 1 == count) {
+                emit(i, rest);
+                break;
+            }
+            maat::platform::Rect part = rest;
+            if (axis == SplitAxis::Horizontal) {
+                part.width = rest.width / 2;
+                rest.x += part.width;
+                rest.width -= part.width;
+            } else {
+                part.height = rest.height / 2;
+                rest.y += part.height;
+                rest.height -= part.height;
+            }
+            emit(i, part);
+            axis = layout_detail::other(axis);
+        }
+    }
+};
+
+// ceil(sqrt(n)) columns filled row by row; the last row's windows share its
+// full width.
+struct GridPolicy {
+    static constexpr const char* kName = "grid";
+
+    template <typename Emit>
+    static void arrange(const maat::platform::Rect& area, std::size_t count, const LayoutParams&, Emit&& emit) {
+        if (count == 0) return;
+        std::size_t columns = static_cast<std::size_t>(std::sqrt(static_cast<double>(count)));
+        while (columns * columns < count) ++columns;
+        const std::size_t rows = (count + columns - 1) / columns;
+        int top = area.y;
+        for (std::size_t row = 0; row < rows; ++row) {
+            const int bottom = layout_detail::sliceEdge(area.y, area.height, row, rows);
+            const std::size_t first = row * columns;
+            const std::size_t inRow = row + 1 == rows ? count - first : columns;
+            layout_detail::slices(maat::platform::Rect{area.x, top, area.width, bottom - top},
+                                  SplitAxis::Horizontal, first, inRow, emit);
+            top = bottom;
+        }
+    }
+};
+
+// Equal columns (params.axis Horizontal) or rows (Vertical).
+struct ColumnsPolicy {
+    static constexpr const char* kName = "columns";
+
+    template <typename Emit>
+    static void arrange(const maat::platform::Rect& area, std::size_t count, const LayoutParams& params,
+                        Emit&& emit) {
+        layout_detail::slices(area, params.axis, 0, count, emit);
+    }
+};
+
+} // namespace core
+} // namespace maat
+
+#endif // MAAT_CORE_LAYOUT_POLICIES_H
@@ -1,6 +1,194 @@
 #ifndef MAAT_CORE_LAYOUT_TREE_H
 #define MAAT_CORE_LAYOUT_TREE_H
 
-// Placeholder for layout tree class
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+#include <vector>
+#include <maat_platform/platform_types.h>
+#include <maat_platform/window_attributes.h>
+
+namespace maat {
+namespace core {
+
+typedef std::uint32_t NodeIndex;
+constexpr NodeIndex kInvalidNode = 0xFFFFFFFFu;
+
+// Direction in which a container lays out its children.
+enum class SplitAxis : std::uint8_t {
+    Horizontal, // children side by side, left to right
+    Vertical    // children stacked, top to bottom
+};
+
+// Tiling layout forest.
+//
+// Every node lives in one contiguous arena and refers to its relatives by
+// 32-bit index, so traversals touch a dense array instead of chasing heap
+// pointers. Freed nodes go onto an intrusive free list and are reused before
+// the arena grows: once the arena has reached its high-water mark, creating
+// and destroying windows performs no heap allocation at all.
+//
+// The forest holds any number of roots (typically one per monitor). Roots are
+// containers; inner nodes are either split containers or leaves holding a
+// WindowId. Each child carries a weight, and a container divides its extent
+// among children proportionally to those weights (the split ratio).
+//
+// Leaves may carry size limits (their window's minimum and maximum size).
+// Every node keeps the limits of its subtree: along a container's axis its
+// children's minimums and maximums add up, across it the largest applies.
+// A container with limited children solves for the split instead of dividing
+// by weight alone: each child gets clamp(lambda * weight, min, max), with the
+// one lambda that fills the extent, found by sorting the 2n points where
+// children hit a bound (O(n log n)). When the minimums do not fit, children
+// are shrunk in proportion to their minimums (nothing overlaps); when the
+// maximums cannot fill the extent, every child gets its maximum and the
+// space left over stays at the far end. Both are counted in solverStats().
+// Trees without any limits take the plain weighted path.
+//
+// Edits mark the smallest affected container dirty. computeDirtyLayout()
+// re-lays out only dirty subtrees (descending into a child only when its
+// rect actually moved) and reports just the leaves whose rect changed, so a
+// single insert or removal costs O(size of the touched container).
+//
+// Node indices stay valid until the node is removed. The tree does not map
+// WindowIds to leaves; callers keep the index returned on insertion.
+class LayoutTree {
+public:
+    enum class NodeKind : std::uint8_t { Free, Container, Leaf };
+
+    struct Node {
+        NodeIndex parent = kInvalidNode;
+        NodeIndex firstChild = kInvalidNode;
+        NodeIndex lastChild = kInvalidNode;
+        NodeIndex prevSibling = kInvalidNode;
+        NodeIndex nextSibling = kInvalidNode; // doubles as free-list link
+        std::uint32_t childCount = 0;
+        float weight = 1.0f;
+        NodeKind kind = NodeKind::Free;
+        SplitAxis axis = SplitAxis::Horizontal;
+        std::uint8_t flags = 0; // kDirty / kChildDirty
+        maat::platform::WindowId window = 0;
+        maat::platform::Rect rect{0, 0, 0, 0}; // last computed geometry
+        maat::platform::SizeHints limits;      // leaf: its own (0 = none); container: its subtree's
+    };
+
+    struct SolverStats {
+        std::size_t constrainedSplits = 0; // containers split by the solver
+        std::size_t overconstrained = 0;   // minimums larger than the extent
+        std::size_t underfilled = 0;       // maximums smaller than the extent
+    };
+
+    typedef std::vector<std::pair<maat::platform::WindowId, maat::platform::Rect>> GeometryList;
+
+    LayoutTree() = default;
+    explicit LayoutTree(std::size_t reserveNodes);
+
+    // Pre-sizes the arena so that up to `nodes` live nodes never allocate.
+    void reserve(std::size_t nodes);
+
+    // Structure editing
+    NodeIndex createRoot(SplitAxis axis = SplitAxis::Horizontal);
+    void destroyRoot(NodeIndex root);
+
+    NodeIndex appendWindow(NodeIndex container, maat::platform::WindowId window, float weight = 1.0f);
+    // Appends an empty split container; used to rebuild saved trees. Give it
+    // children before the next layout pass.
+    NodeIndex appendContainer(NodeIndex container, SplitAxis axis, float weight = 1.0f);
+    NodeIndex insertWindowAfter(NodeIndex sibling, maat::platform::WindowId window, float weight = 1.0f);
+    // Replaces `leaf` by a container along `axis` holding `leaf` followed by a
+    // new leaf for `window`. Returns the new leaf.
+    NodeIndex splitLeaf(NodeIndex leaf, SplitAxis axis, maat::platform::WindowId window);
+    // Removes a leaf. Containers left with a single child are collapsed into
+    // that child and empty non-root containers are removed.
+    void removeLeaf(NodeIndex leaf);
+
+    void setWeight(NodeIndex node, float weight);
+    void setAxis(NodeIndex container, SplitAxis axis);
+    // Size limits of a leaf (0 = no limit). The leaf is reported again on
+    // the next layout pass, and every container up to the root whose
+    // limits change is re-laid out.
+    void setLimits(NodeIndex leaf, const maat::platform::SizeHints& limits);
+
+    // Forces `node` to be re-laid out on the next computeDirtyLayout().
+    void markDirty(NodeIndex node);
+    bool needsLayout(NodeIndex root) const { return m_nodes[root].flags != 0; }
+
+    // Lays out the subtree under `root` inside `area`, appending the rect of
+    // every leaf to `out`. Clears all dirty state.
+    void computeLayout(NodeIndex root, const maat::platform::Rect& area, GeometryList& out);
+
+    // Incremental variant: recomputes only dirty subtrees (everything if
+    // `area` differs from the last one) and appends only the leaves that are
+    // new or whose rect changed.
+    void computeDirtyLayout(NodeIndex root, const maat::platform::Rect& area, GeometryList& out);
+
+    // Queries
+    const Node& node(NodeIndex index) const { return m_nodes[index]; }
+    bool isLeaf(NodeIndex index) const { return m_nodes[index].kind == NodeKind::Leaf; }
+    bool isContainer(NodeIndex index) const { return m_nodes[index].kind == NodeKind::Container; }
+    NodeIndex rootOf(NodeIndex index) const;
+    std::size_t liveNodeCount() const { return m_liveCount; }
+    std::size_t limitedLeafCount() const { return m_limitedLeaves; }
+    const SolverStats& solverStats() const { return m_solverStats; }
+    std::size_t capacity() const { return m_nodes.capacity(); }
+
+    template <typename Fn>
+    void forEachLeaf(NodeIndex root, Fn&& fn) const {
+        // Pre-order walk using sibling/parent links; needs no stack
+        NodeIndex current = root;
+        while (current != kInvalidNode) {
+            const Node& n = m_nodes[current];
+            if (n.kind == NodeKind::Leaf) {
+                fn(current, n);
+            }
+            if (n.firstChild != kInvalidNode) {
+                current = n.firstChild;
+                continue;
+            }
+            while (current != root && m_nodes[current].nextSibling == kInvalidNode) {
+                current = m_nodes[current].parent;
+            }
+            current = (current == root) ? kInvalidNode : m_nodes[current].nextSibling;
+        }
+    }
+
+private:
+    NodeIndex allocateNode(NodeKind kind);
+    void freeNode(NodeIndex index);
+    void freeSubtree(NodeIndex index);
+    void linkAfter(NodeIndex parent, NodeIndex after, NodeIndex child);
+    void unlink(NodeIndex child);
+    void replaceInParent(NodeIndex oldChild, NodeIndex newChild);
+    void layoutChildren(NodeIndex container, bool trackChanges);
+    bool solveChildren(const Node& container, int extent);
+    void refreshLimits(NodeIndex container);
+
+    static constexpr std::uint8_t kDirty = 0x1;      // children must be re-laid out (leaf: must be reported)
+    static constexpr std::uint8_t kChildDirty = 0x2; // some descendant is dirty
+
+    std::vector<Node> m_nodes;
+    NodeIndex m_freeHead = kInvalidNode;
+    std::size_t m_liveCount = 0;
+    std::size_t m_limitedLeaves = 0;
+
+    // solveChildren() scratch, reused across containers
+    struct Breakpoint {
+        double lambda;
+        std::uint32_t child;
+        bool upper; // the child stops growing (else: starts)
+    };
+    struct SolveChild {
+        double weight;
+        double min;
+        double max; // 0 = none
+        double size;
+    };
+    std::vector<Breakpoint> m_breakpoints;
+    std::vector<SolveChild> m_solveChildren;
+    SolverStats m_solverStats;
+};
+
+} // namespace core
+} // namespace maat
 
 #endif // MAAT_CORE_LAYOUT_TREE_H
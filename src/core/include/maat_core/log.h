@@ -0,0 +1,216 @@
+#ifndef MAAT_CORE_LOG_H
+#define MAAT_CORE_LOG_H
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <initializer_list>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <type_traits>
+#include <maat_platform/mpsc_queue.h>
+
+// Compile-time log level. Statements below MAAT_LOG_LEVEL generate no code:
+// their arguments are still compiled (so locals only logged stay "used") but
+// never evaluated. MAAT_LOG_LEVEL_OFF discards every statement. Normally set
+// through the MAAT_LOG_LEVEL CMake cache variable.
+#define MAAT_LOG_LEVEL_TRACE 0
+#define MAAT_LOG_LEVEL_DEBUG 1
+#define MAAT_LOG_LEVEL_INFO 2
+#define MAAT_LOG_LEVEL_WARN 3
+#define MAAT_LOG_LEVEL_ERROR 4
+#define MAAT_LOG_LEVEL_OFF 5
+
+#ifndef MAAT_LOG_LEVEL
+#define MAAT_LOG_LEVEL MAAT_LOG_LEVEL_INFO
+#endif
+
+namespace maat {
+namespace core {
+
+enum class LogLevel : std::uint8_t { Trace, Debug, Info, Warn, Error };
+
+// One key/value pair attached to a log statement. Build with logField().
+struct LogField {
+    enum class Kind : std::uint8_t { Int, UInt, Double, Bool, Text };
+
+    const char* key = nullptr; // must be a string literal
+    Kind kind = Kind::Int;
+    union {
+        std::int64_t i;
+        std::uint64_t u; // Text: offset into LogRecord::text once queued
+        double d;
+        bool b;
+    };
+    const char* text = nullptr; // Text only; copied when the record is queued
+
+    LogField() : i(0) {}
+};
+
+// Fixed-size record passed through the log ring. Component and message are
+// string literals (stored by pointer); text fields are copied into `text`.
+struct LogRecord {
+    static constexpr std::size_t kMaxFields = 6;
+    static constexpr std::size_t kTextCapacity = 96;
+
+    std::uint64_t timestamp = 0; // steady clock, microseconds
+    LogLevel level = LogLevel::Info;
+    std::uint8_t fieldCount = 0;
+    const char* component = nullptr;
+    const char* message = nullptr;
+    LogField fields[kMaxFields];
+    char text[kTextCapacity] = {};
+};
+
+template <typename T>
+LogField logField(const char* key, T value) {
+    LogField field;
+    field.key = key;
+    if constexpr (std::is_same<T, bool>::value) {
+        field.kind = LogField::Kind::Bool;
+        field.b = value;
+    } else if constexpr (std::is_enum<T>::value) {
+        field.kind = LogField::Kind::Int;
+        field.i = static_cast<std::int64_t>(value);
+    } else if constexpr (std::is_integral<T>::value && std::is_signed<T>::value) {
+        field.kind = LogField::Kind::Int;
+        field.i = value;
+    } else if constexpr (std::is_integral<T>::value) {
+        field.kind = LogField::Kind::UInt;
+        field.u = value;
+    } else {
+        static_assert(std::is_floating_point<T>::value, "unsupported log field type");
+        field.kind = LogField::Kind::Double;
+        field.d = value;
+    }
+    return field;
+}
+
+inline LogField logField(const char* key, const char* text) {
+    LogField field;
+    field.key = key;
+    field.kind = LogField::Kind::Text;
+    field.text = text ? text : "";
+    return field;
+}
+
+inline LogField logField(const char* key, const std::string& text) {
+    return logField(key, text.c_str());
+}
+
+// Process-wide asynchronous logger.
+//
+// write() formats nothing: it copies the statement into a LogRecord and pushes
+// it onto a bounded lock-free MPSC ring (never blocking; records are dropped
+// and counted when the ring is full). A background writer thread, started on
+// first use, formats records and writes them out, Warn and above to stderr
+// and the rest to stdout. The writer only sleeps when the ring is empty, so a
+// producer touches the wake mutex solely when the writer is idle.
+class Logger {
+public:
+    static constexpr std::size_t kQueueCapacity = 4096;
+
+    static Logger& instance();
+
+    void write(LogLevel level, const char* component, const char* message,
+               std::initializer_list<LogField> fields);
+
+    // Blocks until every record queued before the call has been written.
+    void flush();
+
+    // Runtime filter on top of MAAT_LOG_LEVEL (e.g. tools that own stdout).
+    void setMinimumLevel(LogLevel level) { m_minimumLevel.store(level, std::memory_order_relaxed); }
+    bool enabled(LogLevel level) const { return level >= m_minimumLevel.load(std::memory_order_relaxed); }
+
+    std::size_t droppedCount() const { return m_queue.droppedCount(); }
+
+    Logger(const Logger&) = delete;
+    Logger& operator=(const Logger&) = delete;
+
+private:
+    Logger();
+    ~Logger();
+
+    void startWriter();
+    void writerMain();
+    void wakeWriter();
+    void format(const LogRecord& record);
+
+    maat::platform::BoundedMpscQueue<LogRecord> m_queue;
+    std::atomic<std::uint64_t> m_queued{0};
+    std::atomic<std::uint64_t> m_written{0};
+    std::size_t m_reportedDrops = 0; // writer thread only
+    std::atomic<LogLevel> m_minimumLevel{LogLevel::Trace};
+
+    std::once_flag m_startOnce;
+    std::thread m_writer;
+    std::atomic<bool> m_stop{false};
+    std::atomic<bool> m_writerSleeping{false};
+    std::mutex m_wakeMutex;
+    std::condition_variable m_wakeCondition;
+    std::condition_variable m_flushedCondition;
+};
+
+template <typename... Fields>
+void logWrite(LogLevel level, const char* component, const char* message, const Fields&... fields) {
+    static_assert(sizeof...(Fields) <= LogRecord::kMaxFields, "too many log fields");
+    Logger& logger = Logger::instance();
+    if (logger.enabled(level)) {
+        logger.write(level, component, message, {fields...});
+    }
+}
+
+} // namespace core
+} // namespace maat
+
+// MAAT_LOG_<LEVEL>(component, message, fields...)
+// e.g. MAAT_LOG_DEBUG("MaatMediator", "window destroyed", logField("window", id));
+
+// A statement below MAAT_LOG_LEVEL: type-checked, never evaluated
+#define MAAT_LOG_DISCARDED(...)                                                  \
+    do {                                                                         \
+        if constexpr (false) {                                                   \
+            ::maat::core::logWrite(::maat::core::LogLevel::Trace, __VA_ARGS__);  \
+        }                                                                        \
+    } while (false)
+
+#if MAAT_LOG_LEVEL <= MAAT_LOG_LEVEL_TRACE
+#define MAAT_LOG_TRACE(...) ::maat::core::logWrite(::maat::core::LogLevel::Trace, __VA_ARGS__)
+#else
+#define MAAT_LOG_TRACE(...) MAAT_LOG_DISCARDED(__VA_ARGS__)
+#endif
+
+#if MAAT_LOG_LEVEL <= MAAT_LOG_LEVEL_DEBUG
+#define MAAT_LOG_DEBUG(...) ::maat::core::logWrite(::maat::core::LogLevel::Debug, __VA_ARGS__)
+#else
+#define MAAT_LOG_DEBUG(...) MAAT_LOG_DISCARDED(__VA_ARGS__)
+#endif
+
+#if MAAT_LOG_LEVEL <= MAAT_LOG_LEVEL_INFO
+#define MAAT_LOG_INFO(...) ::maat::core::logWrite(::maat::core::LogLevel::Info, __VA_ARGS__)
+#else
+#define MAAT_LOG_INFO(...) MAAT_LOG_DISCARDED(__VA_ARGS__)
+#endif
+
+#if MAAT_LOG_LEVEL <= MAAT_LOG_LEVEL_WARN
+#define MAAT_LOG_WARN(...) ::maat::core::logWrite(::maat::core::LogLevel::Warn, __VA_ARGS__)
+#else
+#define MAAT_LOG_WARN(...) MAAT_LOG_DISCARDED(__VA_ARGS__)
+#endif
+
+#if MAAT_LOG_LEVEL <= MAAT_LOG_LEVEL_ERROR
+#define MAAT_LOG_ERROR(...) ::maat::core::logWrite(::maat::core::LogLevel::Error, __VA_ARGS__)
+#else
+#define MAAT_LOG_ERROR(...) MAAT_LOG_DISCARDED(__VA_ARGS__)
+#endif
+
+// Flushes queued records; a no-op when logging is compiled out.
+#if MAAT_LOG_LEVEL < MAAT_LOG_LEVEL_OFF
+#define MAAT_LOG_FLUSH() ::maat::core::Logger::instance().flush()
+#else
+#define MAAT_LOG_FLUSH() ((void)0)
+#endif
+
+#endif // MAAT_CORE_LOG_H
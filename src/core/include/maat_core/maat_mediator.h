@@ -1,9 +1,26 @@
 #ifndef MAAT_CORE_MAAT_MEDIATOR_H
 #define MAAT_CORE_MAAT_MEDIATOR_H
 
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <thread>
 #include <vector>
 #include <utility>
 #include <maat_platform/platform_types.h>
+#include <maat_platform/platform_event.h>
+#include <maat_platform/mpsc_queue.h>
+
+#include "maat_core/event_coalescer.h"
+#include "maat_core/flat_id_map.h"
+#include "maat_core/geometry_animator.h"
+#include "maat_core/geometry_reconciler.h"
+#include "maat_core/latency_histogram.h"
+#include "maat_core/monitor_topology.h"
+#include "maat_core/window_rules.h"
 
 namespace maat {
 namespace platform {
@@ -12,41 +29,341 @@ class Window;
 } // namespace platform
 
 namespace core {
+class Configuration;
 class CoreManager;
+class EventTraceWriter;
+class GeometryApplyStage;
+class SessionStore;
+struct CompiledConfig;
 
 class MaatMediator {
 public:
-    MaatMediator();
+    // Where queued platform events are processed.
+    enum class ThreadingMode {
+        Inline,         // on the notifying thread, right after enqueueing (deterministic)
+        DedicatedThread // on a core thread started by run(); notifications only enqueue
+    };
+
+    static constexpr std::size_t kDefaultEventQueueCapacity = 4096;
+    static constexpr maat::platform::Timestamp kSessionSaveInterval = 2000000; // micros
+    // classifyInitialWindows(): windows per work item, and the worker limit
+    static constexpr std::size_t kClassifyBatchSize = 32;
+    static constexpr std::size_t kMaxClassifyThreads = 4;
+
+    explicit MaatMediator(std::size_t eventQueueCapacity = kDefaultEventQueueCapacity);
+    ~MaatMediator();
+
+    MaatMediator(const MaatMediator&) = delete;
+    MaatMediator& operator=(const MaatMediator&) = delete;
 
     // Component registration
     void registerPlatformManager(maat::platform::PlatformManager& platformManager);
     void registerCoreManager(CoreManager& coreManager);
+    // Its current configuration is applied by initialize(); load it first
+    void registerConfiguration(Configuration& configuration);
+    // initialize() restores the session it holds; the core's arrangement is
+    // saved back to it when it changes (at most once per
+    // kSessionSaveInterval) and on shutdown
+    void registerSessionStore(SessionStore& store);
     // Placeholders for future components
     // void registerInputHandler(InputHandler& inputHandler);
-    // void registerConfiguration(Configuration& config);
 
     // Notifications from PlatformManager
-    void notifyOsWindowCreated(maat::platform::Window* window);
-    void notifyOsWindowDestroyed(maat::platform::WindowId windowId);
+    // Each one snapshots its data into a PlatformEvent and enqueues it on the
+    // lock-free event queue; safe to call from any thread. `eventTime` is when
+    // the OS generated the event on the getMonotonicTime() timeline (0 if the
+    // platform does not know; the time of the call is used instead).
+    void notifyOsWindowCreated(maat::platform::Window* window,
+                               maat::platform::Timestamp eventTime = 0);
+    // `incarnation` comes back with the window's releaseWindowTracking()
+    void notifyOsWindowDestroyed(maat::platform::WindowId windowId,
+                                 maat::platform::Timestamp eventTime = 0,
+                                 std::uint32_t incarnation = 0);
     void notifyOsWindowMonitorChanged(maat::platform::WindowId windowId,
-                                      maat::platform::MonitorId monitorId);
-    void notifyOsMonitorLayoutChanged();
+                                      maat::platform::MonitorId monitorId,
+                                      maat::platform::Timestamp eventTime = 0);
+    void notifyOsMonitorLayoutChanged(maat::platform::Timestamp eventTime = 0);
+    // A reported window that the window rules now ignore (after a rule
+    // change); the platform keeps tracking it
+    void notifyOsWindowUnmanaged(maat::platform::WindowId windowId,
+                                 maat::platform::Timestamp eventTime = 0);
+    // Window rules, applied by the platform before it reports a window as
+    // created. Unlike the notify* calls these run synchronously and must all
+    // be called from the one thread that reports windows; decisions are cached
+    // per window until invalidated or forgotten (on destroy, since handles
+    // are reused). Returns true if the window should be managed.
+    bool classifyWindow(const maat::platform::Window& window);
+    // classifyWindow() for many windows at once (enumerateInitialWindows):
+    // isManageable() and the rules run in parallel batches on worker threads
+    // when there are enough windows, the decisions are cached on the calling
+    // thread. manage[i] is set to 1 for each windows[i] to manage. The
+    // windows must not be used by any other thread meanwhile.
+    void classifyInitialWindows(const std::vector<maat::platform::Window*>& windows,
+                                std::vector<std::uint8_t>& manage);
+    // `changedAttributes` are WindowAttributeField bits; a no-op unless the
+    // rules read one of them. Returns true if they do: the window's decision
+    // may have changed, and a reported window must be classified again.
+    bool invalidateWindowClassification(maat::platform::WindowId windowId, std::uint32_t changedAttributes);
+    void forgetWindowClassification(maat::platform::WindowId windowId);
+    // Replaces the rules (any thread); cached decisions are dropped before the
+    // next classification. Defaults to WindowRuleSet::defaults().
+    void setWindowRules(std::shared_ptr<const WindowRuleSet> rules);
+    const WindowClassifier& windowClassifier() const { return m_classifier; }
+
+    // Configuration hot reload, on the thread that reports windows; no-ops
+    // without a registered configuration. Only the sections that changed are
+    // applied: new rules re-classify the platform's windows, so only windows
+    // whose decision flipped are added to or removed from the core; new layout
+    // settings reach the core as one ConfigurationChanged event and re-lay out
+    // the workspaces using the default; bindings are only stored. Returns the
+    // ConfigSection bits applied.
+    std::uint32_t reloadConfiguration();
+    // reloadConfiguration() if the file changed on disk; cheap enough to poll
+    std::uint32_t pollConfiguration();
+    std::size_t configurationReloadCount() const { return m_configurationReloads; }
+
+    // Called from the platform event loop when a scheduleWakeup() deadline is reached
+    void notifyWakeup();
+    // Enqueues an already built event (used by the notify* helpers). The
+    // overflow policy applies to move and layout events only: a window's
+    // create, destroy or unmanage is never dropped.
+    void postEvent(const maat::platform::PlatformEvent& event);
+
+    // Threading and queue configuration; set before run()
+    void setThreadingMode(ThreadingMode mode);
+    ThreadingMode threadingMode() const { return m_threadingMode; }
+    // While run() runs, geometry and visibility reach the platform through a
+    // GeometryApplyStage on its own thread (so its PlatformManager calls must
+    // be callable from there); otherwise they are applied by the consuming
+    // thread
+    void setApplyThread(bool enabled);
+    bool applyThread() const { return m_applyThreadEnabled; }
+    // The stage run() used (nullptr before, or without the apply thread);
+    // its statistics stay readable after run() returns
+    const GeometryApplyStage* applyStage() const { return m_applyStage.get(); }
+    void setOverflowPolicy(maat::platform::OverflowPolicy policy);
+
+    struct EventQueueStats {
+        std::size_t capacity = 0;
+        std::size_t dropped = 0;       // events lost to overflow
+        std::size_t overflowed = 0;    // window lifecycle events that waited in the overflow list instead
+        std::size_t highWaterMark = 0; // deepest backlog observed when draining
+    };
+    EventQueueStats eventQueueStats() const;
+
+    // Event coalescing: notifications arriving within `micros` of the first
+    // pending one are merged per window and processed in one layout pass.
+    // 0 processes every notification immediately.
+    void setCoalescingWindow(maat::platform::Timestamp micros);
+    maat::platform::Timestamp coalescingWindow() const { return m_coalescingWindow; }
+
+    struct CoalescingStats {
+        std::size_t eventsReceived = 0;  // notifications from the platform
+        std::size_t eventsDelivered = 0; // net operations handed to the core
+        std::size_t batches = 0;
+        std::size_t layoutPasses = 0;
+    };
+    const CoalescingStats& coalescingStats() const { return m_coalescingStats; }
+
+    // Processes everything pending right away, ignoring the coalescing window.
+    // Must run on the consuming thread (or while no core thread is running).
+    void processPendingEvents();
 
     // Requests from CoreManager
+    // Updates identical to (or within the geometry tolerance of) the rect last
+    // sent for that window are dropped before reaching the PlatformManager.
     void requestApplyLayout(
         const std::vector<std::pair<maat::platform::WindowId, maat::platform::Rect>>& layoutUpdates);
 
+    // Shows/hides windows in one platform call (workspace switches). Sent after
+    // any geometry requested in the same pass, so shown windows appear in place.
+    void requestWindowVisibility(const std::vector<std::pair<maat::platform::WindowId, bool>>& changes);
+
+    // Stage timing reported by CoreManager (LatencyStage::Layout)
+    void recordLatency(LatencyStage stage, maat::platform::Timestamp micros);
+
+    // Per-stage latency histograms. Queue, hook delivery and window-tiled
+    // latencies are measured on the platform clock, compute stages (layout,
+    // diff, apply) on the steady clock. Safe to read from any thread.
+    const LatencyRecorder& latency() const { return m_latency; }
+    // Logs count, p50, p99, p999 and max of every stage at INFO level.
+    void logLatencyReport() const;
+
+    // Event tracing: every event the consuming thread takes off the queue,
+    // plus the monitor and window snapshots handed to the core, is appended
+    // to `writer` (nullptr stops recording). Set before run(); the writer
+    // must outlive the mediator or be detached first.
+    void setTraceWriter(EventTraceWriter* writer);
+
+    // Current monitor topology (nullptr before initialize()). Rebuilt when
+    // the platform reports a layout change; a rebuild that changes nothing
+    // (repeated display-change notifications while docking) does not touch
+    // the core. Safe to call from any thread.
+    std::shared_ptr<const MonitorTopology> monitorTopology() const { return std::atomic_load(&m_topology); }
+    // Topology rebuilds that did / did not change anything
+    std::size_t topologyChangeCount() const { return m_topologyChanges; }
+    std::size_t unchangedTopologyCount() const { return m_unchangedTopologies; }
+
+    // Animated re-tiles: a window that already has a rect moves to its new
+    // one over AnimationSettings::duration, all windows in flight going out
+    // as one applyWindowGeometries batch per frame. Frames are paced by
+    // platform wakeups (by its own clock on the core thread) and run after
+    // pending events. New windows, windows the user moved and windows
+    // changing visibility are placed at once. Consuming thread only (or
+    // before run()); initialize() and configuration reloads apply the
+    // configuration's settings.
+    void setAnimation(const AnimationSettings& settings);
+    const AnimationSettings& animation() const { return m_animator.settings(); }
+    const GeometryAnimator::Stats& animationStats() const { return m_animator.stats(); }
+
+    // Geometry reconciliation: settleDelay after a window gets the rect it
+    // is meant to keep, the platform is asked where it really is (one
+    // queryWindowGeometries call for all windows due). Sizes a window
+    // refuses become its size limits in the core, which re-lays it out once
+    // within them; its real rect is taken as sent, so a rect it refused is
+    // not sent again. Checks run after pending events and animation frames,
+    // on platform wakeups (by its own clock on the core thread). Consuming
+    // thread only (or before run()); on by default.
+    void setReconciliation(const ReconcileSettings& settings);
+    const ReconcileSettings& reconciliation() const { return m_reconciler.settings(); }
+    const GeometryReconciler::Stats& reconcileStats() const { return m_reconciler.stats(); }
+
+    // Maximum per-edge difference, in pixels, still treated as "unchanged"
+    void setGeometryTolerance(int pixels);
+    int geometryTolerance() const { return m_geometryTolerance; }
+    std::size_t droppedGeometryUpdateCount() const { return m_droppedGeometryUpdates; }
+
+    // Writes the core's arrangement to the session store now if it changed
+    // since the last save. Returns true if it was written; after a failed
+    // write the arrangement still counts as unsaved and is tried again. Must
+    // run on the consuming thread.
+    bool saveSession();
+    std::size_t restoredWindowCount() const { return m_restoredWindows; }
+
+    // Phases of initialize(), on the steady clock. Monitor enumeration (with
+    // the session load) overlaps window discovery, so total is less than the
+    // sum of the phases.
+    struct StartupStats {
+        std::size_t windows = 0;           // initial windows handed to the core
+        std::size_t classifyThreads = 0;   // 1 when classified inline
+        std::uint64_t topologyMicros = 0;  // monitor enumeration and workspace setup
+        std::uint64_t sessionLoadMicros = 0;
+        std::uint64_t discoveryMicros = 0; // window enumeration, classification included
+        std::uint64_t classifyMicros = 0;
+        std::uint64_t adoptMicros = 0;     // session reconcile and insertion into the layouts
+        std::uint64_t layoutMicros = 0;    // first layout pass and its one geometry batch
+        std::uint64_t totalMicros = 0;
+    };
+    const StartupStats& startupStats() const { return m_startupStats; }
+
     // Lifecycle control (called by main)
     void initialize();
     void run();
     void shutdown();
 
 private:
+    void drainEventQueue();
+    void consumeEvent(const maat::platform::PlatformEvent& event, maat::platform::Timestamp now);
+    void schedulePendingEvents();
+    void startCoreThread();
+    void stopCoreThread();
+    void coreThreadMain();
+    void wakeCoreThread();
+    void refreshTopology(maat::platform::Timestamp time);
+    void applyConfigurationChange();
+    void armWakeup(maat::platform::Timestamp deadline);
+    void advanceAnimation(maat::platform::Timestamp now);
+    void finishAnimations();
+    void reconcileGeometry(maat::platform::Timestamp now);
+    void applyGeometries(const std::vector<std::pair<maat::platform::WindowId, maat::platform::Rect>>& updates);
+    void applyVisibility(const std::vector<std::pair<maat::platform::WindowId, bool>>& changes);
+    void saveSessionIfDue(maat::platform::Timestamp now);
+    void syncClassifierRules();
+
     maat::platform::PlatformManager* m_platformManager = nullptr;
     CoreManager* m_coreManager = nullptr;
+
+    // Last rect handed to applyWindowGeometries, per window (the target of
+    // windows still animating)
+    FlatIdMap<maat::platform::Rect> m_lastAppliedGeometry;
+    std::vector<std::pair<maat::platform::WindowId, maat::platform::Rect>> m_filteredUpdates;
+    int m_geometryTolerance = 0;
+    std::size_t m_droppedGeometryUpdates = 0;
+
+    // Latency instrumentation; written only by the consuming thread
+    LatencyRecorder m_latency;
+    FlatIdMap<maat::platform::Timestamp> m_appearedAt; // created, not yet tiled -> OS event time
+    EventTraceWriter* m_traceWriter = nullptr;
+
+    // Window classification; m_classifier belongs to the reporting thread,
+    // new rules reach it through m_windowRules (std::atomic_store)
+    WindowClassifier m_classifier;
+    std::shared_ptr<const WindowRuleSet> m_windowRules;
+    std::atomic<std::uint64_t> m_windowRulesGeneration{0};
+    std::uint64_t m_classifierGeneration = 0;
+
+    // Written by the consuming thread only, published with std::atomic_store
+    std::shared_ptr<const MonitorTopology> m_topology;
+    std::vector<MonitorArea> m_platformMonitors; // scratch, reused per rebuild
+    std::size_t m_topologyChanges = 0;
+    std::size_t m_unchangedTopologies = 0;
+
+    EventCoalescer m_coalescer;
+    CoalescingStats m_coalescingStats;
+    maat::platform::Timestamp m_coalescingWindow = 0;
+    maat::platform::Timestamp m_pendingSince = 0;
+    bool m_wakeupScheduled = false;
+    maat::platform::Timestamp m_wakeupDeadline = 0;
+
+    // Animated transitions (consuming thread only)
+    GeometryAnimator m_animator;
+    std::vector<std::pair<maat::platform::WindowId, maat::platform::Rect>> m_frameUpdates; // scratch
+
+    // Geometry reconciliation (consuming thread only)
+    GeometryReconciler m_reconciler;
+    std::vector<std::pair<maat::platform::WindowId, maat::platform::Rect>> m_reconcileRequested; // scratch
+    std::vector<std::pair<maat::platform::WindowId, maat::platform::Rect>> m_reconcileActual;    // scratch
+
+    // Platform -> core event path
+    maat::platform::BoundedMpscQueue<maat::platform::PlatformEvent> m_eventQueue;
+    maat::platform::OverflowPolicy m_overflowPolicy = maat::platform::OverflowPolicy::DropNewest;
+    std::atomic<std::size_t> m_queueHighWaterMark{0};
+    // Window lifecycle events that found the ring full. Dropping one would
+    // leave a ghost tile or leak the platform's tracking, so they wait here,
+    // and later ones queue behind them to keep each window's order. The
+    // mutex is only taken while the list is in use.
+    std::mutex m_overflowMutex;
+    std::vector<maat::platform::PlatformEvent> m_overflowEvents;
+    std::vector<maat::platform::PlatformEvent> m_overflowScratch; // consuming thread
+    std::atomic<bool> m_overflowPending{false};
+    std::atomic<std::size_t> m_overflowedEvents{0};
+
+    // Core thread (ThreadingMode::DedicatedThread). The mutex only guards
+    // sleeping; producers touch it solely when the core thread is asleep.
+    ThreadingMode m_threadingMode = ThreadingMode::Inline;
+    std::thread m_coreThread;
+    std::atomic<bool> m_coreThreadRunning{false};
+    std::atomic<bool> m_stopCoreThread{false};
+    std::atomic<bool> m_coreThreadSleeping{false};
+    std::mutex m_wakeMutex;
+    std::condition_variable m_wakeCondition;
+    // Geometry apply thread, started and stopped by run()
+    bool m_applyThreadEnabled = false;
+    std::unique_ptr<GeometryApplyStage> m_applyStage;
+    // Configuration; m_appliedConfig is what the consuming thread last
+    // applied (its layout and animation sections)
+    Configuration* m_configuration = nullptr;
+    std::shared_ptr<const CompiledConfig> m_appliedConfig;
+    std::size_t m_configurationReloads = 0;
+    // Session persistence (consuming thread only)
+    SessionStore* m_sessionStore = nullptr;
+    std::uint64_t m_savedSessionRevision = 0;
+    maat::platform::Timestamp m_lastSessionSave = 0;
+    std::vector<std::uint8_t> m_sessionBuffer;
+    std::size_t m_restoredWindows = 0;
+    StartupStats m_startupStats;
     // Future component pointers
     // InputHandler* m_inputHandler = nullptr;
-    // Configuration* m_configuration = nullptr;
 };
 
 } // namespace core
@@ -0,0 +1,47 @@
+#ifndef MAAT_CORE_MAPPED_FILE_H
+#define MAAT_CORE_MAPPED_FILE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace maat {
+namespace core {
+
+// Read-only memory mapping of a whole file (mmap on POSIX, a file mapping
+// view on Windows). Pages are faulted in on first access, so opening a large
+// file costs nothing until it is read. Empty files are never mapped.
+class MappedFile {
+public:
+    MappedFile() = default;
+    ~MappedFile();
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    // Returns false if the file does not exist, is empty or cannot be mapped
+    bool open(const std::string& path);
+    void close();
+
+    bool isOpen() const { return m_data != nullptr; }
+    const std::uint8_t* data() const { return m_data; }
+    std::size_t size() const { return m_size; }
+
+private:
+    const std::uint8_t* m_data = nullptr;
+    std::size_t m_size = 0;
+#ifdef _WIN32
+    void* m_mapping = nullptr; // HANDLE of the file mapping object
+#endif
+};
+
+// Writes `bytes` beside `path` and renames the result over it, so a reader
+// (or a MappedFile) never sees a half-written file. Returns false, leaving
+// `path` untouched, on any error.
+bool replaceFile(const std::string& path, const std::vector<std::uint8_t>& bytes);
+
+} // namespace core
+} // namespace maat
+
+#endif // MAAT_CORE_MAPPED_FILE_H
@@ -0,0 +1,68 @@
+#ifndef MAAT_CORE_MONITOR_TOPOLOGY_H
+#define MAAT_CORE_MONITOR_TOPOLOGY_H
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+#include <maat_platform/platform_types.h>
+
+namespace maat {
+namespace core {
+
+// Work area of one monitor as seen by the core.
+struct MonitorArea {
+    maat::platform::MonitorId id;
+    maat::platform::Rect workArea;
+};
+
+// Immutable snapshot of the monitor layout, with cached work areas.
+//
+// Snapshots are versioned and shared read-only (std::shared_ptr<const>), so
+// any thread may hold on to one while the mediator publishes its successor.
+//
+// Monitor ids in a snapshot are stable identities owned by the core. A
+// monitor keeps its id as long as the platform reports the same handle, and
+// also across a handle change when a monitor of identical work area takes
+// the place of a vanished one (Windows may hand out new HMONITORs when
+// displays are re-enumerated during docking). The platform handle behind
+// each identity is kept for translating platform events with resolve().
+class MonitorTopology {
+public:
+    // Builds the successor of `previous` (nullptr for the first snapshot)
+    // from the monitors the platform currently reports, in platform order.
+    static std::shared_ptr<const MonitorTopology> build(const MonitorTopology* previous,
+                                                        const std::vector<MonitorArea>& platformMonitors);
+
+    std::uint64_t version() const { return m_version; }
+    // Monitors with stable ids, in platform order (the first is the fallback
+    // for windows that lose their monitor)
+    const std::vector<MonitorArea>& monitors() const { return m_monitors; }
+    const MonitorArea* find(maat::platform::MonitorId id) const;
+    // Stable id of the monitor behind a platform handle; 0 if unknown
+    maat::platform::MonitorId resolve(maat::platform::MonitorId platformId) const;
+
+private:
+    MonitorTopology() = default;
+
+    std::uint64_t m_version = 0;
+    std::vector<MonitorArea> m_monitors;
+    std::vector<maat::platform::MonitorId> m_platformIds; // parallel to m_monitors
+};
+
+// What changed between two snapshots, by stable id.
+struct TopologyDiff {
+    std::vector<maat::platform::MonitorId> added;
+    std::vector<maat::platform::MonitorId> removed;
+    std::vector<maat::platform::MonitorId> resized; // work area changed
+    bool reordered = false;                         // same monitors, different order
+
+    bool empty() const { return added.empty() && removed.empty() && resized.empty() && !reordered; }
+};
+
+// `from` may be nullptr (everything in `to` is added).
+TopologyDiff diffTopology(const MonitorTopology* from, const MonitorTopology& to);
+
+} // namespace core
+} // namespace maat
+
+#endif // MAAT_CORE_MONITOR_TOPOLOGY_H
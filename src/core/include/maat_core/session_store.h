@@ -0,0 +1,61 @@
+#ifndef MAAT_CORE_SESSION_STORE_H
+#define MAAT_CORE_SESSION_STORE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "maat_core/mapped_file.h"
+
+namespace maat {
+namespace core {
+
+// The file holding the session snapshot (CoreManager::saveSession), so a
+// restarted instance can put every window back where it was.
+//
+// The file is a 24-byte header ("MAATSES\0", u32 format version, u32
+// reserved, u64 hash of the body) followed by the body. A snapshot of
+// another version or whose body does not match its hash is ignored, never
+// partially applied. Not thread-safe; the mediator uses it from the
+// consuming thread only.
+class SessionStore {
+public:
+    static constexpr std::uint32_t kFormatVersion = 1;
+
+    explicit SessionStore(std::string path);
+
+    SessionStore(const SessionStore&) = delete;
+    SessionStore& operator=(const SessionStore&) = delete;
+
+    // Maps the snapshot; false if it is missing, of another version or corrupt
+    bool load();
+    // Body of the loaded snapshot, valid until release() or save()
+    const std::uint8_t* data() const { return m_body; }
+    std::size_t size() const { return m_bodySize; }
+    void release();
+
+    // Replaces the snapshot with `body` unless it is the one last loaded or
+    // saved. Returns false only if writing failed.
+    bool save(const std::vector<std::uint8_t>& body);
+
+    const std::string& path() const { return m_path; }
+    std::size_t saveCount() const { return m_saves; }
+    std::size_t skippedSaveCount() const { return m_skippedSaves; }
+
+private:
+    std::string m_path;
+    MappedFile m_file;
+    const std::uint8_t* m_body = nullptr;
+    std::size_t m_bodySize = 0;
+    std::uint64_t m_lastHash = 0;
+    bool m_haveLastHash = false;
+    std::vector<std::uint8_t> m_buffer; // header + body, reused
+    std::size_t m_saves = 0;
+    std::size_t m_skippedSaves = 0;
+};
+
+} // namespace core
+} // namespace maat
+
+#endif // MAAT_CORE_SESSION_STORE_H
@@ -0,0 +1,96 @@
+#ifndef MAAT_CORE_SPATIAL_INDEX_H
+#define MAAT_CORE_SPATIAL_INDEX_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include <maat_platform/platform_types.h>
+
+#include "maat_core/flat_id_map.h"
+
+namespace maat {
+namespace core {
+
+enum class Direction : std::uint8_t { Left, Right, Up, Down };
+
+// Where the shown tiled windows are, for point, overlap and directional
+// neighbour queries without a scan over every window.
+//
+// Each region (a monitor's work area) is cut into a uniform grid of square
+// cells, and a window inside a region is listed in every cell its rect
+// touches. Rects are tiles, so a cell holds a handful of windows however many
+// are managed, and an update or a point query touches a bounded number of
+// cells. A neighbour query walks cells outward from the window's edge, a
+// column (or row) at a time, and stops once the cells left are farther than
+// the best candidate. Rects not inside a single region (a window larger than
+// its work area allows, or straddling monitors) are kept in a list that every
+// query scans, so answers are exact either way. Not thread-safe; owned by the
+// core.
+class SpatialIndex {
+public:
+    static constexpr int kDefaultCellSize = 128; // pixels
+
+    explicit SpatialIndex(int cellSize = kDefaultCellSize);
+
+    // Replaces the regions and re-buckets every window
+    void setRegions(const std::vector<maat::platform::Rect>& regions);
+
+    // Inserts `id` or moves it to `rect`; a rect with no area takes it out
+    void update(maat::platform::WindowId id, const maat::platform::Rect& rect);
+    void remove(maat::platform::WindowId id);
+    void clear();
+
+    std::size_t size() const { return m_entries.size(); }
+    bool contains(maat::platform::WindowId id) const { return m_entries.contains(id); }
+    // nullptr if not indexed
+    const maat::platform::Rect* rect(maat::platform::WindowId id) const;
+
+    // A window containing the point (the lowest id if rects overlap), or 0
+    maat::platform::WindowId windowAt(int x, int y) const;
+    // Appends every window whose rect intersects `rect` (an empty one meets
+    // nothing), each once, in no particular order
+    void overlapping(const maat::platform::Rect& rect, std::vector<maat::platform::WindowId>& out) const;
+    // The window to go to from `id` in `direction`, or 0. Candidates lie past
+    // the edge of `id` facing `direction` (or, for overlapping rects, have
+    // their centre past it); the nearest wins, distance being the gap along
+    // the direction plus how far the rects miss each other across it, then
+    // the one sharing more of the edge, then the lower id.
+    maat::platform::WindowId neighbour(maat::platform::WindowId id, Direction direction) const;
+
+private:
+    struct Region {
+        maat::platform::Rect area;
+        int columns;
+        int rows;
+        std::size_t firstCell; // into m_cells
+    };
+
+    static constexpr std::uint32_t kOutside = 0xFFFFFFFFu;
+
+    struct Entry {
+        maat::platform::Rect rect;
+        std::uint32_t region;        // whose cells list it, or kOutside (in m_outside)
+        mutable std::uint32_t stamp; // last query that visited it
+    };
+
+    // Cell range of `rect` clipped to `region`; false if they do not meet
+    bool cellRange(const Region& region, const maat::platform::Rect& rect, int& column0, int& row0, int& column1,
+                   int& row1) const;
+    // The region holding all of `rect`, or kOutside
+    std::uint32_t regionOf(const maat::platform::Rect& rect) const;
+    void link(maat::platform::WindowId id, Entry& entry);
+    void unlink(maat::platform::WindowId id, const Entry& entry);
+    std::uint32_t nextStamp() const;
+
+    int m_cellSize;
+    std::vector<Region> m_regions;
+    std::vector<std::vector<maat::platform::WindowId>> m_cells;
+    std::vector<maat::platform::WindowId> m_outside;
+    FlatIdMap<Entry> m_entries;
+    mutable std::uint32_t m_stamp = 0;
+};
+
+} // namespace core
+} // namespace maat
+
+#endif // MAAT_CORE_SPATIAL_INDEX_H
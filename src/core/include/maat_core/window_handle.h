@@ -0,0 +1,26 @@
+#ifndef MAAT_CORE_WINDOW_HANDLE_H
+#define MAAT_CORE_WINDOW_HANDLE_H
+
+#include <cstdint>
+
+namespace maat {
+namespace core {
+
+// Generation-checked reference to a WindowRegistry entry. Platform WindowIds
+// (HWNDs) are recycled by the OS; a handle taken for a window that has since
+// been destroyed stays invalid even if a new window reuses the same id.
+struct WindowHandle {
+    std::uint32_t slot = 0xFFFFFFFFu;
+    std::uint32_t generation = 0;
+
+    bool isNull() const { return slot == 0xFFFFFFFFu; }
+    bool operator==(const WindowHandle& other) const {
+        return slot == other.slot && generation == other.generation;
+    }
+    bool operator!=(const WindowHandle& other) const { return !(*this == other); }
+};
+
+} // namespace core
+} // namespace maat
+
+#endif // MAAT_CORE_WINDOW_HANDLE_H
@@ -0,0 +1,111 @@
+#ifndef MAAT_CORE_WINDOW_REGISTRY_H
+#define MAAT_CORE_WINDOW_REGISTRY_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include <maat_platform/platform_types.h>
+#include <maat_platform/window_attributes.h>
+
+#include "maat_core/flat_id_map.h"
+#include "maat_core/layout_tree.h"
+#include "maat_core/window_handle.h"
+
+namespace maat {
+namespace core {
+
+// Bits of the flags column
+constexpr std::uint32_t kWindowHidden = 0x1; // hidden by the core (workspace not shown)
+
+enum class WindowState : std::uint8_t {
+    Unplaced, // known to the core but not in any layout (e.g. no monitor yet)
+    Tiled     // placed in a workspace layout
+};
+
+// Registry of every window managed by the core.
+//
+// Per-window state is stored structure-of-arrays in dense columns (id, state,
+// monitor, workspace, last geometry, flags, layout slot, size limits). Removal swaps the
+// last entry into the hole, so the columns stay packed and whole-registry
+// passes only touch live data. Handles resolve through a slot table that records each
+// entry's dense position and generation, making stale-handle rejection a
+// single comparison. Lookups by raw WindowId go through a FlatIdMap.
+class WindowRegistry {
+public:
+    explicit WindowRegistry(std::size_t reserveWindows = 64);
+
+    // Registers `id`. Returns the existing handle if it is already present.
+    WindowHandle add(maat::platform::WindowId id);
+    // Unregisters the window; its handle (and any copy) becomes invalid.
+    bool remove(WindowHandle handle);
+
+    WindowHandle find(maat::platform::WindowId id) const;
+    bool isValid(WindowHandle handle) const {
+        return handle.slot < m_slots.size() && m_slots[handle.slot].generation == handle.generation &&
+               m_slots[handle.slot].dense != kNoDense;
+    }
+
+    std::size_t size() const { return m_ids.size(); }
+
+    // Column access by handle; the handle must be valid.
+    maat::platform::WindowId id(WindowHandle h) const { return m_ids[dense(h)]; }
+    WindowState state(WindowHandle h) const { return m_states[dense(h)]; }
+    maat::platform::MonitorId monitor(WindowHandle h) const { return m_monitors[dense(h)]; }
+    std::uint32_t workspace(WindowHandle h) const { return m_workspaces[dense(h)]; }
+    // Rect last laid out for the window (before that, where it appeared)
+    const maat::platform::Rect& geometry(WindowHandle h) const { return m_geometries[dense(h)]; }
+    std::uint32_t flags(WindowHandle h) const { return m_flags[dense(h)]; }
+    NodeIndex layoutNode(WindowHandle h) const { return m_layoutNodes[dense(h)]; }
+    // Sizes the window was found to accept (0 = no limit), see
+    // CoreManager::setWindowSizeLimits()
+    const maat::platform::SizeHints& sizeLimits(WindowHandle h) const { return m_sizeLimits[dense(h)]; }
+
+    void setState(WindowHandle h, WindowState state) { m_states[dense(h)] = state; }
+    void setMonitor(WindowHandle h, maat::platform::MonitorId monitor) { m_monitors[dense(h)] = monitor; }
+    void setWorkspace(WindowHandle h, std::uint32_t workspace) { m_workspaces[dense(h)] = workspace; }
+    void setGeometry(WindowHandle h, const maat::platform::Rect& geometry) { m_geometries[dense(h)] = geometry; }
+    void setFlags(WindowHandle h, std::uint32_t flags) { m_flags[dense(h)] = flags; }
+    void setLayoutNode(WindowHandle h, NodeIndex node) { m_layoutNodes[dense(h)] = node; }
+    void setSizeLimits(WindowHandle h, const maat::platform::SizeHints& limits);
+    // Windows with any size limit; layout output only needs clamping while non-zero
+    std::size_t limitedCount() const { return m_limitedCount; }
+
+    // Dense columns for bulk passes (index i of each column is the same window)
+    const std::vector<maat::platform::WindowId>& ids() const { return m_ids; }
+    const std::vector<maat::platform::MonitorId>& monitors() const { return m_monitors; }
+    const std::vector<WindowState>& states() const { return m_states; }
+    WindowHandle handleAt(std::size_t denseIndex) const;
+
+private:
+    static constexpr std::uint32_t kNoDense = 0xFFFFFFFFu;
+
+    struct Slot {
+        std::uint32_t dense = kNoDense; // doubles as free-list link while free
+        std::uint32_t generation = 0;
+    };
+
+    std::uint32_t dense(WindowHandle h) const { return m_slots[h.slot].dense; }
+
+    // Slot table (indirection from handle to dense position)
+    std::vector<Slot> m_slots;
+    std::vector<std::uint32_t> m_freeSlots;
+
+    // Dense columns
+    std::vector<maat::platform::WindowId> m_ids;
+    std::vector<WindowState> m_states;
+    std::vector<maat::platform::MonitorId> m_monitors;
+    std::vector<std::uint32_t> m_workspaces; // index among the monitor's workspaces
+    std::vector<maat::platform::Rect> m_geometries;
+    std::vector<std::uint32_t> m_flags;
+    std::vector<NodeIndex> m_layoutNodes;
+    std::vector<maat::platform::SizeHints> m_sizeLimits;
+    std::vector<std::uint32_t> m_denseToSlot;
+    std::size_t m_limitedCount = 0;
+
+    FlatIdMap<std::uint32_t> m_slotById;
+};
+
+} // namespace core
+} // namespace maat
+
+#endif // MAAT_CORE_WINDOW_REGISTRY_H
@@ -0,0 +1,195 @@
+#ifndef MAAT_CORE_WINDOW_RULES_H
+#define MAAT_CORE_WINDOW_RULES_H
+
+#include <array>
+#include <climits>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+#include <maat_platform/platform_types.h>
+#include <maat_platform/window.h>
+#include <maat_platform/window_attributes.h>
+
+#include "maat_core/flat_id_map.h"
+
+namespace maat {
+namespace core {
+
+enum class RuleAction : std::uint8_t { Manage, Ignore };
+
+// One window rule. Every condition set on it must hold for the rule to
+// match; rules are tried in order and the first match decides. Built with the
+// chained setters, e.g.
+//   WindowRule(RuleAction::Ignore).process("steam.exe").titleContains("Friends")
+// Text comparisons are exact and case-sensitive.
+struct WindowRule {
+    enum class Text : std::uint8_t { Class, Title, Process };
+    static constexpr std::size_t kTextFields = 3;
+
+    struct TextCondition {
+        Text field;
+        bool contains; // substring instead of whole-string match
+        std::string value;
+    };
+
+    explicit WindowRule(RuleAction ruleAction = RuleAction::Ignore) : action(ruleAction) {}
+
+    WindowRule& className(std::string value) { return addText(Text::Class, false, std::move(value)); }
+    WindowRule& classContains(std::string value) { return addText(Text::Class, true, std::move(value)); }
+    WindowRule& title(std::string value) { return addText(Text::Title, false, std::move(value)); }
+    WindowRule& titleContains(std::string value) { return addText(Text::Title, true, std::move(value)); }
+    WindowRule& process(std::string value) { return addText(Text::Process, false, std::move(value)); }
+    WindowRule& processContains(std::string value) { return addText(Text::Process, true, std::move(value)); }
+    // WindowStyleFlag masks: all of / none of / at least one of
+    WindowRule& withStyle(std::uint32_t flags) { styleAll |= flags; return *this; }
+    WindowRule& withoutStyle(std::uint32_t flags) { styleNone |= flags; return *this; }
+    WindowRule& withAnyStyle(std::uint32_t flags) { styleAny |= flags; return *this; }
+    WindowRule& minSize(int width, int height) { minWidth = width; minHeight = height; return *this; }
+    WindowRule& maxSize(int width, int height) { maxWidth = width; maxHeight = height; return *this; }
+
+    RuleAction action;
+    std::vector<TextCondition> text;
+    std::uint32_t styleAll = 0;
+    std::uint32_t styleNone = 0;
+    std::uint32_t styleAny = 0;
+    int minWidth = 0;
+    int minHeight = 0;
+    int maxWidth = INT_MAX;
+    int maxHeight = INT_MAX;
+
+private:
+    WindowRule& addText(Text field, bool contains, std::string value) {
+        text.push_back({field, contains, std::move(value)});
+        return *this;
+    }
+};
+
+// Immutable, compiled form of an ordered rule list.
+//
+// Compilation flattens the rules into a decision table: every distinct text
+// condition becomes one predicate, evaluated at most once per window (exact
+// matches by binary search over a sorted table per field, substrings by one
+// scan of the distinct needles). Each row keeps its style masks and size
+// bounds inline and lists its predicates in one shared array. Rows with a
+// text condition are indexed under one of their predicates (an exact one if
+// they have it), so evaluation only visits rows whose anchor matched plus the
+// rows without text conditions, in rule order, instead of the whole table.
+// That setup (predicate bits, candidate sort) costs more than it saves on a
+// short list, so sets of up to kLinearRuleLimit rules are instead checked
+// row by row, each text condition tested only when its row gets that far.
+class WindowRuleSet {
+public:
+    // Measured crossover (maat_bench rules/compiled, Release): the scan takes
+    // about 70 ns against 100 ns for the table at 10 rules, they are even
+    // near 16, and the table pulls ahead from 32 on
+    static constexpr std::size_t kLinearRuleLimit = 16;
+
+    static std::shared_ptr<const WindowRuleSet> compile(const std::vector<WindowRule>& rules,
+                                                        RuleAction fallback = RuleAction::Manage);
+    // The exclusions the Windows backend used to hard-code: child or owned,
+    // disabled, popup, tool, non-activating and click-through windows are
+    // ignored, everything else is managed.
+    static std::vector<WindowRule> defaultRules();
+    static std::shared_ptr<const WindowRuleSet> defaults();
+
+    RuleAction evaluate(const maat::platform::WindowAttributes& attributes) const;
+    // Reads only the attributes the rules use, through the window's cached
+    // getters (a rule set without title conditions never fetches a title)
+    RuleAction evaluate(const maat::platform::Window& window) const;
+
+    // WindowAttributeField bits any rule reads; changes to other attributes
+    // cannot change a decision
+    std::uint32_t relevantAttributes() const { return m_relevantAttributes; }
+    std::size_t ruleCount() const { return m_rows.size(); }
+    std::size_t predicateCount() const { return m_predicateCount; }
+    RuleAction fallback() const { return m_fallback; }
+
+private:
+    struct Row {
+        std::uint32_t firstPredicate; // into m_rowPredicates
+        std::uint32_t predicateCount;
+        std::uint32_t styleAll;
+        std::uint32_t styleNone;
+        std::uint32_t styleAny;
+        int minWidth;
+        int minHeight;
+        int maxWidth;
+        int maxHeight;
+        RuleAction action;
+    };
+
+    struct Needle {
+        std::string value;
+        std::uint32_t predicate;
+    };
+
+    struct Predicate {
+        std::uint32_t field; // WindowRule::Text
+        bool contains;
+        std::string value;
+    };
+
+    WindowRuleSet() = default;
+    template <typename Source>
+    RuleAction evaluateFrom(const Source& source) const;
+    template <typename Source>
+    RuleAction evaluateLinear(const Source& source) const;
+    // Style masks and size bounds only
+    static bool boundsMatch(const Row& row, std::uint32_t style, const maat::platform::Rect& geometry);
+    bool rowMatches(const Row& row, const std::uint64_t* predicateBits, std::uint32_t style,
+                    const maat::platform::Rect& geometry) const;
+
+    std::vector<Row> m_rows;
+    std::vector<std::uint32_t> m_rowPredicates;
+    // Rows anchored on predicate p: m_anchoredRows[m_anchorOffsets[p] .. m_anchorOffsets[p + 1]), ascending
+    std::vector<std::uint32_t> m_anchorOffsets;
+    std::vector<std::uint32_t> m_anchoredRows;
+    std::vector<std::uint32_t> m_unanchoredRows; // ascending
+    std::array<std::vector<Needle>, WindowRule::kTextFields> m_exact;    // sorted by value
+    std::array<std::vector<Needle>, WindowRule::kTextFields> m_contains; // distinct values
+    std::vector<Predicate> m_predicates; // by predicate id; kept for linear sets only
+    std::size_t m_predicateCount = 0;
+    RuleAction m_fallback = RuleAction::Manage;
+    std::uint32_t m_relevantAttributes = 0;
+};
+
+// Per-window decision cache in front of a WindowRuleSet. A decision stays
+// valid until invalidate() names an attribute the rules read, or the rules are
+// replaced. Not thread-safe: owned by the thread that reports windows.
+class WindowClassifier {
+public:
+    explicit WindowClassifier(std::shared_ptr<const WindowRuleSet> rules = WindowRuleSet::defaults());
+
+    void setRules(std::shared_ptr<const WindowRuleSet> rules); // drops every cached decision
+    const WindowRuleSet& rules() const { return *m_rules; }
+
+    // Evaluates the rules only on a cache miss
+    RuleAction classify(const maat::platform::Window& window);
+    // True if the rules read one of `changedAttributes` (the decision is dropped)
+    bool invalidate(maat::platform::WindowId id, std::uint32_t changedAttributes);
+    void forget(maat::platform::WindowId id) { m_cache.erase(id); }
+
+    // Batch classification (startup): windows without a cached decision are
+    // evaluated elsewhere with rules(), which is safe to share across threads,
+    // and the results stored here by the owning thread
+    bool isCached(maat::platform::WindowId id) const { return m_cache.contains(id); }
+    void record(maat::platform::WindowId id, RuleAction action);
+
+    std::size_t cachedCount() const { return m_cache.size(); }
+    std::size_t cacheHits() const { return m_cacheHits; }
+    std::size_t cacheMisses() const { return m_cacheMisses; }
+
+private:
+    std::shared_ptr<const WindowRuleSet> m_rules;
+    FlatIdMap<RuleAction> m_cache;
+    std::size_t m_cacheHits = 0;
+    std::size_t m_cacheMisses = 0;
+};
+
+} // namespace core
+} // namespace maat
+
+#endif // MAAT_CORE_WINDOW_RULES_H
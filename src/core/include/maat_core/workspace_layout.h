@@ -0,0 +1,260 @@
+#ifndef MAAT_CORE_WORKSPACE_LAYOUT_H
+#define MAAT_CORE_WORKSPACE_LAYOUT_H
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+#include <maat_platform/platform_types.h>
+
+#include "maat_core/binary_codec.h"
+#include "maat_core/layout_policies.h"
+#include "maat_core/layout_tree.h"
+#include "maat_core/window_registry.h"
+
+namespace maat {
+namespace core {
+
+enum class LayoutKind : std::uint8_t {
+    Tree,        // manual split tree (dwindle-style insertion, per-node weights)
+    MasterStack,
+    Dwindle,
+    Grid,
+    Columns
+};
+
+const char* layoutKindName(LayoutKind kind);
+
+// Binary form of a layout kind and its parameters, shared by the
+// configuration cache and session snapshots: u8 kind, f32 master ratio,
+// varint master count, u8 axis, zigzag inner gap, zigzag outer gap.
+// Decoding fails on anything validLayoutParams() rejects.
+void encodeLayoutSettings(LayoutKind kind, const LayoutParams& params, std::vector<std::uint8_t>& out);
+bool decodeLayoutSettings(codec::Reader& in, LayoutKind& kind, LayoutParams& params);
+
+// The layout of one workspace, behind the only virtual boundary of the
+// layout path: the core makes one call per workspace per operation, and each
+// implementation generates its rects without further dispatch.
+//
+// Windows are identified by registry handle. An implementation may keep a
+// per-window slot (tree leaf, list position) in the registry's layoutNode
+// column; nobody else interprets it.
+class WorkspaceLayout {
+public:
+    virtual ~WorkspaceLayout() = default;
+
+    virtual LayoutKind kind() const = 0;
+
+    virtual void insert(WindowRegistry& registry, WindowHandle window) = 0;
+    virtual void remove(WindowRegistry& registry, WindowHandle window) = 0;
+    // Reports the window's rect again on the next computeDirtyLayout(), even
+    // if it did not change (the user moved it out of its tile).
+    virtual void markDirty(const WindowRegistry& registry, WindowHandle window) = 0;
+    // The window's registry sizeLimits() changed. Layouts that cannot lay out
+    // around them just report the window again (the core clamps its rect).
+    virtual void sizeLimitsChanged(const WindowRegistry& registry, WindowHandle window) {
+        markDirty(registry, window);
+    }
+
+    // Appends the windows whose rect changed since the last call (all of them
+    // after `area` or the gaps changed, or for a fresh layout). Gaps are
+    // applied here, around the rects the implementation produces.
+    void computeDirtyLayout(const maat::platform::Rect& area, LayoutTree::GeometryList& out);
+
+    virtual std::size_t windowCount() const = 0;
+    // Windows in layout order; used to carry them over to a new layout.
+    virtual void collectWindows(const WindowRegistry& registry, std::vector<WindowHandle>& out) const = 0;
+
+    // Session snapshot: the windows, by id and in layout order, plus any
+    // structure the implementation keeps (split tree, weights).
+    virtual void save(const WindowRegistry& registry, std::vector<std::uint8_t>& out) const = 0;
+    // Rebuilds a saved arrangement in this empty layout. Only windows that
+    // are registered and not placed anywhere yet are inserted (appended to
+    // `placed`); the others are left out as if they had been removed.
+    // Returns false on malformed input.
+    virtual bool restore(WindowRegistry& registry, codec::Reader& in, std::vector<WindowHandle>& placed) = 0;
+
+    const LayoutParams& params() const { return m_params; }
+    void setParams(const LayoutParams& params) {
+        const bool gapsChanged = params.innerGap != m_params.innerGap || params.outerGap != m_params.outerGap;
+        m_params = params;
+        paramsChanged();
+        if (gapsChanged) forgetPlacement();
+    }
+
+protected:
+    // computeDirtyLayout() without gaps
+    virtual void arrangeDirty(const maat::platform::Rect& area, LayoutTree::GeometryList& out) = 0;
+    virtual void paramsChanged() = 0;
+    // Reports every window on the next arrangeDirty(), changed or not
+    virtual void forgetPlacement() = 0;
+
+    // Handle of `id` if restore() may insert it, else a null handle
+    static WindowHandle restorable(const WindowRegistry& registry, maat::platform::WindowId id);
+
+    LayoutParams m_params;
+};
+
+// Creates an empty layout of `kind`. Tree layouts allocate their nodes in
+// `tree`, which must outlive the layout.
+std::unique_ptr<WorkspaceLayout> makeWorkspaceLayout(LayoutKind kind, LayoutTree& tree,
+                                                     const LayoutParams& params = LayoutParams());
+
+// Split-tree layout: one root in the core's shared LayoutTree. New windows
+// split the most recent one perpendicular to its container, so an insert only
+// re-tiles that window's area.
+class TreeLayout final : public WorkspaceLayout {
+public:
+    explicit TreeLayout(LayoutTree& tree);
+    ~TreeLayout() override;
+
+    LayoutKind kind() const override { return LayoutKind::Tree; }
+    void insert(WindowRegistry& registry, WindowHandle window) override;
+    void remove(WindowRegistry& registry, WindowHandle window) override;
+    void markDirty(const WindowRegistry& registry, WindowHandle window) override;
+    // Limits go into the tree, whose solver sizes the window's siblings around them
+    void sizeLimitsChanged(const WindowRegistry& registry, WindowHandle window) override;
+    std::size_t windowCount() const override { return m_windowCount; }
+    void collectWindows(const WindowRegistry& registry, std::vector<WindowHandle>& out) const override;
+    void save(const WindowRegistry& registry, std::vector<std::uint8_t>& out) const override;
+    bool restore(WindowRegistry& registry, codec::Reader& in, std::vector<WindowHandle>& placed) override;
+
+    NodeIndex root() const { return m_root; }
+
+protected:
+    void arrangeDirty(const maat::platform::Rect& area, LayoutTree::GeometryList& out) override;
+    void paramsChanged() override;
+    void forgetPlacement() override;
+
+private:
+    struct SavedNode; // restore() scratch, see workspace_layout.cpp
+
+    void saveChildren(NodeIndex container, std::vector<std::uint8_t>& out) const;
+    static long long readSavedChildren(codec::Reader& in, const WindowRegistry& registry, std::size_t depth,
+                                       std::vector<SavedNode>& nodes, std::size_t& liveChildren);
+    std::size_t restoreSubtree(const std::vector<SavedNode>& nodes, std::size_t index, NodeIndex parent, float weight,
+                               WindowRegistry& registry, std::vector<WindowHandle>& placed);
+
+    void applyLimits(const WindowRegistry& registry, WindowHandle window, NodeIndex leaf);
+
+    LayoutTree& m_tree;
+    NodeIndex m_root;
+    std::size_t m_windowCount = 0;
+    int m_limitPadding = 0; // inner gap the leaf limits include
+};
+
+// Ordered window list arranged by `Policy` (see layout_policies.h). Every
+// change re-runs the policy over the whole workspace, which is a flat inlined
+// loop; only rects that differ from the last run are reported.
+template <typename Policy>
+class PolicyLayout final : public WorkspaceLayout {
+public:
+    explicit PolicyLayout(LayoutKind kind) : m_kind(kind) {}
+
+    LayoutKind kind() const override { return m_kind; }
+
+    void insert(WindowRegistry& registry, WindowHandle window) override {
+        registry.setLayoutNode(window, static_cast<NodeIndex>(m_slots.size()));
+        m_slots.push_back({window, registry.id(window), maat::platform::Rect{0, 0, 0, 0}, false});
+        m_dirty = true;
+    }
+
+    void remove(WindowRegistry& registry, WindowHandle window) override {
+        const std::size_t index = registry.layoutNode(window);
+        if (index >= m_slots.size() || m_slots[index].handle != window) return;
+        // Keep the order: the policies are position dependent
+        m_slots.erase(m_slots.begin() + static_cast<std::ptrdiff_t>(index));
+        for (std::size_t i = index; i < m_slots.size(); ++i) {
+            registry.setLayoutNode(m_slots[i].handle, static_cast<NodeIndex>(i));
+        }
+        registry.setLayoutNode(window, kInvalidNode);
+        m_dirty = true;
+    }
+
+    void markDirty(const WindowRegistry& registry, WindowHandle window) override {
+        const std::size_t index = registry.layoutNode(window);
+        if (index < m_slots.size() && m_slots[index].handle == window) {
+            m_slots[index].placed = false;
+            m_dirty = true;
+        }
+    }
+
+    std::size_t windowCount() const override { return m_slots.size(); }
+
+    void collectWindows(const WindowRegistry&, std::vector<WindowHandle>& out) const override {
+        for (const Slot& slot : m_slots) {
+            out.push_back(slot.handle);
+        }
+    }
+
+    // Body: varint count, varint window id each
+    void save(const WindowRegistry&, std::vector<std::uint8_t>& out) const override {
+        codec::putVarint(out, m_slots.size());
+        for (const Slot& slot : m_slots) {
+            codec::putVarint(out, slot.id);
+        }
+    }
+
+    bool restore(WindowRegistry& registry, codec::Reader& in, std::vector<WindowHandle>& placed) override {
+        std::uint64_t count;
+        if (!in.varint(count) || count > in.remaining()) return false;
+        for (std::uint64_t i = 0; i < count; ++i) {
+            std::uint64_t id;
+            if (!in.varint(id)) return false;
+            const WindowHandle window = restorable(registry, static_cast<maat::platform::WindowId>(id));
+            if (!window.isNull()) {
+                insert(registry, window);
+                placed.push_back(window);
+            }
+        }
+        return true;
+    }
+
+protected:
+    void arrangeDirty(const maat::platform::Rect& area, LayoutTree::GeometryList& out) override {
+        if (!m_dirty && sameArea(area)) return;
+        m_area = area;
+        m_dirty = false;
+        Slot* slots = m_slots.data();
+        Policy::arrange(area, m_slots.size(), m_params,
+                        [slots, &out](std::size_t i, const maat::platform::Rect& rect) {
+                            Slot& slot = slots[i];
+                            if (!slot.placed || rect != slot.rect) {
+                                slot.rect = rect;
+                                slot.placed = true;
+                                out.emplace_back(slot.id, rect);
+                            }
+                        });
+    }
+
+    void paramsChanged() override { m_dirty = true; }
+
+    void forgetPlacement() override {
+        for (Slot& slot : m_slots) {
+            slot.placed = false;
+        }
+        m_dirty = true;
+    }
+
+private:
+    struct Slot {
+        WindowHandle handle;
+        maat::platform::WindowId id;
+        maat::platform::Rect rect; // last reported
+        bool placed;
+    };
+
+    bool sameArea(const maat::platform::Rect& area) const {
+        return area == m_area;
+    }
+
+    LayoutKind m_kind;
+    std::vector<Slot> m_slots;
+    maat::platform::Rect m_area{0, 0, 0, 0};
+    bool m_dirty = true;
+};
+
+} // namespace core
+} // namespace maat
+
+#endif // MAAT_CORE_WORKSPACE_LAYOUT_H
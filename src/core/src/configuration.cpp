@@ -0,0 +1,690 @@
+#include "maat_core/configuration.h"
+
+#include <cctype>
+#include <cerrno>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <system_error>
+#include <utility>
+
+#include "maat_core/binary_codec.h"
+#include "maat_core/latency_histogram.h"
+#include "maat_core/log.h"
+#include "maat_core/mapped_file.h"
+
+namespace maat {
+namespace core {
+
+namespace {
+
+// Cache layout: header "MAATCFG\0", u32 version, u32 reserved, u64 source
+// hash, u64 hash of the rest (as SessionStore checks its body), then one
+// varint-length-prefixed block per ConfigSection in bit order:
+//   layout    encodeLayoutSettings()
+//   rules     u8 fallback, varint count, per rule: u8 action, varint text
+//             count, (u8 field, u8 contains, string) each, varint style
+//             all/none/any, zigzag min width/height, max width/height
+//   bindings  varint count, per binding: u8 modifiers, string key, string command
+//   animation u8 enabled, varint frame rate, varint duration, varint frame budget (micros)
+const char kCacheMagic[8] = {'M', 'A', 'A', 'T', 'C', 'F', 'G', '\0'};
+const std::uint32_t kCacheVersion = 3;
+const std::size_t kCacheHeaderSize = 32;
+
+const LayoutKind kLayoutKinds[] = {LayoutKind::Tree, LayoutKind::MasterStack, LayoutKind::Dwindle, LayoutKind::Grid,
+                                   LayoutKind::Columns};
+
+struct StyleName {
+    const char* name;
+    std::uint32_t flag;
+};
+
+const StyleName kStyleNames[] = {
+    {"child", maat::platform::WindowStyleChild},
+    {"disabled", maat::platform::WindowStyleDisabled},
+    {"popup", maat::platform::WindowStylePopup},
+    {"tool", maat::platform::WindowStyleToolWindow},
+    {"noactivate", maat::platform::WindowStyleNoActivate},
+    {"transparent", maat::platform::WindowStyleTransparent},
+    {"dialog", maat::platform::WindowStyleDialog},
+    {"resizable", maat::platform::WindowStyleResizable},
+};
+
+// --- Text ---
+
+struct Token {
+    std::string text;
+    bool quoted;
+};
+
+bool isOperator(const Token& token) {
+    return !token.quoted && (token.text == "=" || token.text == "~=");
+}
+
+// Splits a line into words, double-quoted strings and the operators `=` and
+// `~=`; a `#` outside quotes ends the line
+bool tokenize(const std::string& line, std::vector<Token>& tokens, std::string& error) {
+    tokens.clear();
+    std::size_t i = 0;
+    while (i < line.size()) {
+        const char c = line[i];
+        if (std::isspace(static_cast<unsigned char>(c))) {
+            ++i;
+        } else if (c == '#') {
+            break;
+        } else if (c == '=' || (c == '~' && i + 1 < line.size() && line[i + 1] == '=')) {
+            const std::size_t length = c == '=' ? 1 : 2;
+            tokens.push_back({line.substr(i, length), false});
+            i += length;
+        } else if (c == '"') {
+            std::string text;
+            for (++i; i < line.size() && line[i] != '"'; ++i) {
+                if (line[i] == '\\' && i + 1 < line.size()) ++i;
+                text += line[i];
+            }
+            if (i == line.size()) {
+                error = "unterminated string";
+                return false;
+            }
+            ++i;
+            tokens.push_back({std::move(text), true});
+        } else {
+            const std::size_t start = i;
+            while (i < line.size() && !std::isspace(static_cast<unsigned char>(line[i])) && line[i] != '=' &&
+                   line[i] != '"' && line[i] != '#' && !(line[i] == '~' && i + 1 < line.size() && line[i + 1] == '=')) {
+                ++i;
+            }
+            tokens.push_back({line.substr(start, i - start), false});
+        }
+    }
+    return true;
+}
+
+bool parseInt(const std::string& text, long minimum, long maximum, int& value) {
+    if (text.empty()) return false;
+    char* end = nullptr;
+    errno = 0;
+    const long parsed = std::strtol(text.c_str(), &end, 10);
+    if (errno != 0 || *end != '\0' || parsed < minimum || parsed > maximum) return false;
+    value = static_cast<int>(parsed);
+    return true;
+}
+
+bool parseSize(const std::string& text, int& width, int& height) {
+    const std::size_t x = text.find('x');
+    return x != std::string::npos && parseInt(text.substr(0, x), 0, 1000000, width) &&
+           parseInt(text.substr(x + 1), 0, 1000000, height);
+}
+
+bool parseBool(const std::string& text, bool& value) {
+    if (text == "on" || text == "true" || text == "yes") {
+        value = true;
+    } else if (text == "off" || text == "false" || text == "no") {
+        value = false;
+    } else {
+        return false;
+    }
+    return true;
+}
+
+bool parseAction(const std::string& text, RuleAction& action) {
+    if (text == "manage") {
+        action = RuleAction::Manage;
+    } else if (text == "ignore") {
+        action = RuleAction::Ignore;
+    } else {
+        return false;
+    }
+    return true;
+}
+
+// `a|b|c` of kStyleNames
+bool parseStyles(const std::string& text, std::uint32_t& flags) {
+    flags = 0;
+    std::size_t start = 0;
+    while (start <= text.size()) {
+        std::size_t end = text.find('|', start);
+        if (end == std::string::npos) end = text.size();
+        const std::string name = text.substr(start, end - start);
+        bool known = false;
+        for (const StyleName& style : kStyleNames) {
+            if (name == style.name) {
+                flags |= style.flag;
+                known = true;
+            }
+        }
+        if (!known) return false;
+        start = end + 1;
+    }
+    return true;
+}
+
+std::string lowerCase(std::string text) {
+    for (char& c : text) {
+        c = static_cast<char>(std::tolower(static_cast<unsigned char>(c)));
+    }
+    return text;
+}
+
+// `alt+shift+1`: modifiers, then the key
+bool parseKeyCombo(const std::string& text, KeyBinding& binding) {
+    binding.modifiers = 0;
+    std::size_t start = 0;
+    for (;;) {
+        const std::size_t plus = text.find('+', start);
+        const std::string part = lowerCase(text.substr(start, plus == std::string::npos ? std::string::npos : plus - start));
+        if (part.empty()) return false;
+        if (plus == std::string::npos) {
+            binding.key = part;
+            return true;
+        }
+        if (part == "alt") {
+            binding.modifiers |= KeyModifierAlt;
+        } else if (part == "ctrl" || part == "control") {
+            binding.modifiers |= KeyModifierCtrl;
+        } else if (part == "shift") {
+            binding.modifiers |= KeyModifierShift;
+        } else if (part == "super" || part == "win") {
+            binding.modifiers |= KeyModifierSuper;
+        } else {
+            return false;
+        }
+        start = plus + 1;
+    }
+}
+
+// The statements of one configuration text, before compilation
+class Parser {
+public:
+    explicit Parser(std::vector<ConfigError>& errors) : m_errors(errors) {}
+
+    void parse(const std::string& text) {
+        std::size_t lineNumber = 0;
+        std::size_t start = 0;
+        while (start < text.size()) {
+            std::size_t end = text.find('\n', start);
+            if (end == std::string::npos) end = text.size();
+            std::string line = text.substr(start, end - start);
+            if (!line.empty() && line.back() == '\r') line.pop_back();
+            m_line = ++lineNumber;
+            statement(line);
+            start = end + 1;
+        }
+    }
+
+    CompiledConfig config;
+    bool defaultRules = true;
+
+private:
+    void error(std::string message) { m_errors.push_back({m_line, std::move(message)}); }
+
+    void statement(const std::string& line) {
+        std::string message;
+        if (!tokenize(line, m_tokens, message)) {
+            error(message);
+            return;
+        }
+        if (m_tokens.empty()) return;
+        const Token& head = m_tokens[0];
+        if (head.quoted || isOperator(head)) {
+            error("expected a setting, `rule` or `bind`");
+        } else if (head.text == "rule") {
+            rule();
+        } else if (head.text == "bind") {
+            bind();
+        } else if (m_tokens.size() == 3 && m_tokens[1].text == "=" && !m_tokens[1].quoted && !isOperator(m_tokens[2])) {
+            setting(head.text, m_tokens[2].text);
+        } else {
+            error("expected `" + head.text + " = <value>`");
+        }
+    }
+
+    void setting(const std::string& name, const std::string& value) {
+        LayoutParams& params = config.layoutParams;
+        bool ok = true;
+        if (name == "layout") {
+            ok = false;
+            for (LayoutKind kind : kLayoutKinds) {
+                if (value == layoutKindName(kind)) {
+                    config.layout = kind;
+                    ok = true;
+                }
+            }
+        } else if (name == "master_ratio") {
+            char* end = nullptr;
+            const float ratio = std::strtof(value.c_str(), &end);
+            ok = !value.empty() && *end == '\0' && ratio > 0.0f && ratio < 1.0f; // validLayoutParams()
+            if (ok) params.masterRatio = ratio;
+        } else if (name == "master_count") {
+            int count = 0;
+            ok = parseInt(value, 0, static_cast<int>(kMaxMasterCount), count);
+            if (ok) params.masterCount = static_cast<std::uint32_t>(count);
+        } else if (name == "axis") {
+            ok = value == "horizontal" || value == "vertical";
+            if (ok) params.axis = value == "horizontal" ? SplitAxis::Horizontal : SplitAxis::Vertical;
+        } else if (name == "gap_inner") {
+            ok = parseInt(value, 0, kMaxLayoutGap, params.innerGap);
+        } else if (name == "gap_outer") {
+            ok = parseInt(value, 0, kMaxLayoutGap, params.outerGap);
+        } else if (name == "gaps") {
+            ok = parseInt(value, 0, kMaxLayoutGap, params.innerGap);
+            params.outerGap = params.innerGap;
+        } else if (name == "animation") {
+            ok = parseBool(value, config.animation.enabled);
+        } else if (name == "animation_fps") {
+            int rate = 0;
+            ok = parseInt(value, 1, 240, rate);
+            if (ok) config.animation.frameRate = static_cast<std::uint32_t>(rate);
+        } else if (name == "animation_duration") {
+            int millis = 0;
+            ok = parseInt(value, 0, 10000, millis);
+            if (ok) config.animation.duration = static_cast<std::uint64_t>(millis) * 1000;
+        } else if (name == "animation_budget") {
+            int millis = 0;
+            ok = parseInt(value, 0, 1000, millis);
+            if (ok) config.animation.frameBudget = static_cast<std::uint64_t>(millis) * 1000;
+        } else if (name == "default_rules") {
+            ok = parseBool(value, defaultRules);
+        } else if (name == "fallback") {
+            ok = parseAction(value, config.ruleFallback);
+        } else {
+            error("unknown setting `" + name + "`");
+            return;
+        }
+        if (!ok) error("invalid value `" + value + "` for " + name);
+    }
+
+    void rule() {
+        RuleAction action;
+        if (m_tokens.size() < 2 || m_tokens[1].quoted || !parseAction(m_tokens[1].text, action)) {
+            error("expected `rule manage|ignore <condition>...`");
+            return;
+        }
+        WindowRule rule(action);
+        for (std::size_t i = 2; i < m_tokens.size(); i += 3) {
+            if (i + 2 >= m_tokens.size() || m_tokens[i].quoted || !isOperator(m_tokens[i + 1]) ||
+                isOperator(m_tokens[i + 2])) {
+                error("expected `<field>=<value>` in rule");
+                return;
+            }
+            const std::string& field = m_tokens[i].text;
+            const bool contains = m_tokens[i + 1].text == "~=";
+            const std::string& value = m_tokens[i + 2].text;
+            if (field == "class" || field == "title" || field == "process") {
+                const WindowRule::Text text = field == "class"   ? WindowRule::Text::Class
+                                              : field == "title" ? WindowRule::Text::Title
+                                                                 : WindowRule::Text::Process;
+                rule.text.push_back({text, contains, value});
+                continue;
+            }
+            if (contains) {
+                error("`~=` only applies to class, title and process");
+                return;
+            }
+            std::uint32_t styles = 0;
+            int width = 0;
+            int height = 0;
+            if (field == "style" || field == "not_style" || field == "any_style") {
+                if (!parseStyles(value, styles)) {
+                    error("unknown style in `" + value + "`");
+                    return;
+                }
+                if (field == "style") rule.withStyle(styles);
+                else if (field == "not_style") rule.withoutStyle(styles);
+                else rule.withAnyStyle(styles);
+            } else if (field == "min_size" || field == "max_size") {
+                if (!parseSize(value, width, height)) {
+                    error("expected <width>x<height>, got `" + value + "`");
+                    return;
+                }
+                if (field == "min_size") rule.minSize(width, height);
+                else rule.maxSize(width, height);
+            } else {
+                error("unknown rule field `" + field + "`");
+                return;
+            }
+        }
+        config.rules.push_back(std::move(rule));
+    }
+
+    void bind() {
+        KeyBinding binding;
+        if (m_tokens.size() < 4 || m_tokens[1].quoted || m_tokens[2].text != "=" || m_tokens[2].quoted ||
+            !parseKeyCombo(m_tokens[1].text, binding)) {
+            error("expected `bind <modifier+key> = <command>`");
+            return;
+        }
+        for (std::size_t i = 3; i < m_tokens.size(); ++i) {
+            if (i > 3) binding.command += ' ';
+            binding.command += m_tokens[i].text;
+        }
+        for (const KeyBinding& existing : config.bindings) {
+            if (existing.modifiers == binding.modifiers && existing.key == binding.key) {
+                error("`" + m_tokens[1].text + "` is already bound");
+                return;
+            }
+        }
+        config.bindings.push_back(std::move(binding));
+    }
+
+    std::vector<ConfigError>& m_errors;
+    std::vector<Token> m_tokens;
+    std::size_t m_line = 0;
+};
+
+// --- Binary ---
+
+void encodeLayout(const CompiledConfig& config, std::vector<std::uint8_t>& out) {
+    encodeLayoutSettings(config.layout, config.layoutParams, out);
+}
+
+void encodeRules(const CompiledConfig& config, std::vector<std::uint8_t>& out) {
+    out.push_back(static_cast<std::uint8_t>(config.ruleFallback));
+    codec::putVarint(out, config.rules.size());
+    for (const WindowRule& rule : config.rules) {
+        out.push_back(static_cast<std::uint8_t>(rule.action));
+        codec::putVarint(out, rule.text.size());
+        for (const WindowRule::TextCondition& condition : rule.text) {
+            out.push_back(static_cast<std::uint8_t>(condition.field));
+            out.push_back(condition.contains ? 1 : 0);
+            codec::putString(out, condition.value);
+        }
+        codec::putVarint(out, rule.styleAll);
+        codec::putVarint(out, rule.styleNone);
+        codec::putVarint(out, rule.styleAny);
+        codec::putSigned(out, rule.minWidth);
+        codec::putSigned(out, rule.minHeight);
+        codec::putSigned(out, rule.maxWidth);
+        codec::putSigned(out, rule.maxHeight);
+    }
+}
+
+void encodeBindings(const CompiledConfig& config, std::vector<std::uint8_t>& out) {
+    codec::putVarint(out, config.bindings.size());
+    for (const KeyBinding& binding : config.bindings) {
+        out.push_back(binding.modifiers);
+        codec::putString(out, binding.key);
+        codec::putString(out, binding.command);
+    }
+}
+
+void encodeAnimation(const CompiledConfig& config, std::vector<std::uint8_t>& out) {
+    out.push_back(config.animation.enabled ? 1 : 0);
+    codec::putVarint(out, config.animation.frameRate);
+    codec::putVarint(out, config.animation.duration);
+    codec::putVarint(out, config.animation.frameBudget);
+}
+
+typedef void (*SectionEncoder)(const CompiledConfig&, std::vector<std::uint8_t>&);
+const SectionEncoder kSectionEncoders[kConfigSectionCount] = {encodeLayout, encodeRules, encodeBindings,
+                                                              encodeAnimation};
+
+bool decodeLayout(codec::Reader& in, CompiledConfig& config) {
+    return decodeLayoutSettings(in, config.layout, config.layoutParams);
+}
+
+bool decodeRules(codec::Reader& in, CompiledConfig& config) {
+    std::uint8_t fallback;
+    std::uint64_t count;
+    if (!in.byte(fallback) || fallback > static_cast<std::uint8_t>(RuleAction::Ignore) || !in.varint(count) ||
+        count > in.remaining()) {
+        return false;
+    }
+    config.ruleFallback = static_cast<RuleAction>(fallback);
+    config.rules.reserve(static_cast<std::size_t>(count));
+    for (std::uint64_t i = 0; i < count; ++i) {
+        std::uint8_t action;
+        std::uint64_t textCount;
+        if (!in.byte(action) || action > static_cast<std::uint8_t>(RuleAction::Ignore) || !in.varint(textCount) ||
+            textCount > in.remaining()) {
+            return false;
+        }
+        WindowRule rule(static_cast<RuleAction>(action));
+        for (std::uint64_t t = 0; t < textCount; ++t) {
+            std::uint8_t field;
+            std::uint8_t contains;
+            std::string value;
+            if (!in.byte(field) || field >= WindowRule::kTextFields || !in.byte(contains) || !in.string(value)) {
+                return false;
+            }
+            rule.text.push_back({static_cast<WindowRule::Text>(field), contains != 0, std::move(value)});
+        }
+        std::uint64_t styles[3];
+        std::int64_t bounds[4];
+        for (std::uint64_t& style : styles) {
+            if (!in.varint(style)) return false;
+        }
+        for (std::int64_t& bound : bounds) {
+            if (!in.signedVarint(bound)) return false;
+        }
+        rule.styleAll = static_cast<std::uint32_t>(styles[0]);
+        rule.styleNone = static_cast<std::uint32_t>(styles[1]);
+        rule.styleAny = static_cast<std::uint32_t>(styles[2]);
+        rule.minWidth = static_cast<int>(bounds[0]);
+        rule.minHeight = static_cast<int>(bounds[1]);
+        rule.maxWidth = static_cast<int>(bounds[2]);
+        rule.maxHeight = static_cast<int>(bounds[3]);
+        config.rules.push_back(std::move(rule));
+    }
+    return true;
+}
+
+bool decodeBindings(codec::Reader& in, CompiledConfig& config) {
+    std::uint64_t count;
+    if (!in.varint(count) || count > in.remaining()) return false;
+    config.bindings.resize(static_cast<std::size_t>(count));
+    for (KeyBinding& binding : config.bindings) {
+        if (!in.byte(binding.modifiers) || !in.string(binding.key) || !in.string(binding.command)) return false;
+    }
+    return true;
+}
+
+bool decodeAnimation(codec::Reader& in, CompiledConfig& config) {
+    std::uint8_t enabled;
+    std::uint64_t rate;
+    if (!in.byte(enabled) || enabled > 1 || !in.varint(rate) || rate < 1 || rate > 240 ||
+        !in.varint(config.animation.duration) || !in.varint(config.animation.frameBudget)) {
+        return false;
+    }
+    config.animation.enabled = enabled != 0;
+    config.animation.frameRate = static_cast<std::uint32_t>(rate);
+    return true;
+}
+
+typedef bool (*SectionDecoder)(codec::Reader&, CompiledConfig&);
+const SectionDecoder kSectionDecoders[kConfigSectionCount] = {decodeLayout, decodeRules, decodeBindings,
+                                                              decodeAnimation};
+
+bool readFile(const std::string& path, std::string& text) {
+    std::FILE* file = std::fopen(path.c_str(), "rb");
+    if (!file) return false;
+    text.clear();
+    char chunk[16 * 1024];
+    std::size_t read;
+    while ((read = std::fread(chunk, 1, sizeof(chunk), file)) > 0) {
+        text.append(chunk, read);
+    }
+    const bool ok = !std::ferror(file);
+    std::fclose(file);
+    return ok;
+}
+
+} // namespace
+
+std::shared_ptr<const CompiledConfig> compileConfig(const std::string& text, std::vector<ConfigError>& errors) {
+    const std::size_t firstError = errors.size();
+    Parser parser(errors);
+    parser.parse(text);
+    if (errors.size() != firstError) return nullptr;
+
+    auto config = std::make_shared<CompiledConfig>(std::move(parser.config));
+    if (parser.defaultRules) {
+        for (WindowRule& rule : WindowRuleSet::defaultRules()) {
+            config->rules.push_back(std::move(rule));
+        }
+    }
+    config->ruleSet = WindowRuleSet::compile(config->rules, config->ruleFallback);
+    config->sourceHash = codec::hashBytes(text.data(), text.size());
+    std::vector<std::uint8_t> section;
+    for (std::size_t i = 0; i < kConfigSectionCount; ++i) {
+        section.clear();
+        kSectionEncoders[i](*config, section);
+        config->sectionHashes[i] = codec::hashBytes(section.data(), section.size());
+    }
+    return config;
+}
+
+std::vector<std::uint8_t> encodeConfig(const CompiledConfig& config) {
+    std::vector<std::uint8_t> body;
+    std::vector<std::uint8_t> section;
+    for (SectionEncoder encode : kSectionEncoders) {
+        section.clear();
+        encode(config, section);
+        codec::putVarint(body, section.size());
+        body.insert(body.end(), section.begin(), section.end());
+    }
+    std::vector<std::uint8_t> out(kCacheMagic, kCacheMagic + sizeof(kCacheMagic));
+    out.reserve(kCacheHeaderSize + body.size());
+    codec::putU32(out, kCacheVersion);
+    codec::putU32(out, 0); // reserved
+    codec::putU64(out, config.sourceHash);
+    codec::putU64(out, codec::hashBytes(body.data(), body.size()));
+    out.insert(out.end(), body.begin(), body.end());
+    return out;
+}
+
+std::shared_ptr<const CompiledConfig> decodeConfig(const std::uint8_t* data, std::size_t size,
+                                                   std::uint64_t sourceHash) {
+    if (size < kCacheHeaderSize || std::memcmp(data, kCacheMagic, sizeof(kCacheMagic)) != 0 ||
+        codec::readU32(data + 8) != kCacheVersion || codec::readU64(data + 16) != sourceHash ||
+        codec::readU64(data + 24) != codec::hashBytes(data + kCacheHeaderSize, size - kCacheHeaderSize)) {
+        return nullptr;
+    }
+    auto config = std::make_shared<CompiledConfig>();
+    config->sourceHash = sourceHash;
+    codec::Reader in(data + kCacheHeaderSize, size - kCacheHeaderSize);
+    for (std::size_t i = 0; i < kConfigSectionCount; ++i) {
+        std::uint64_t length;
+        if (!in.varint(length) || length > in.remaining()) return nullptr;
+        const std::uint8_t* section = data + (size - in.remaining());
+        codec::Reader sectionIn(section, static_cast<std::size_t>(length));
+        if (!kSectionDecoders[i](sectionIn, *config) || !sectionIn.atEnd()) return nullptr;
+        config->sectionHashes[i] = codec::hashBytes(section, static_cast<std::size_t>(length));
+        in = codec::Reader(section + length, in.remaining() - static_cast<std::size_t>(length));
+    }
+    if (!in.atEnd()) return nullptr;
+    config->ruleSet = WindowRuleSet::compile(config->rules, config->ruleFallback);
+    return config;
+}
+
+std::uint32_t diffConfig(const CompiledConfig* from, const CompiledConfig& to) {
+    if (!from) return ConfigSectionAll;
+    std::uint32_t changed = 0;
+    for (std::size_t i = 0; i < kConfigSectionCount; ++i) {
+        if (from->sectionHashes[i] != to.sectionHashes[i]) changed |= 1u << i;
+    }
+    return changed;
+}
+
+// --- Configuration ---
+
+Configuration::Configuration(std::string path, std::string cachePath)
+    : m_path(std::move(path)), m_cachePath(cachePath.empty() ? m_path + ".cache" : std::move(cachePath)) {
+}
+
+Configuration::Stamp Configuration::readStamp() const {
+    Stamp stamp;
+    std::error_code error;
+    const std::uintmax_t size = std::filesystem::file_size(m_path, error);
+    if (error) return stamp;
+    const std::filesystem::file_time_type modified = std::filesystem::last_write_time(m_path, error);
+    if (error) return stamp;
+    stamp.exists = true;
+    stamp.size = static_cast<std::uint64_t>(size);
+    stamp.modified = static_cast<std::int64_t>(modified.time_since_epoch().count());
+    return stamp;
+}
+
+bool Configuration::sourceChanged() const {
+    return readStamp() != m_stamp;
+}
+
+bool Configuration::load() {
+    const std::uint64_t start = steadyMicros();
+    LoadStats stats;
+    const Stamp stamp = readStamp();
+    // Remembered even if the text turns out invalid, so polling does not
+    // retry (and report) the same broken file over and over
+    m_stamp = stamp;
+
+    std::string text;
+    if (stamp.exists && !readFile(m_path, text)) {
+        m_errors.assign(1, ConfigError{0, "cannot read " + m_path});
+        MAAT_LOG_WARN("Configuration", "Cannot read configuration", logField("path", m_path));
+        return false;
+    }
+    const std::uint64_t sourceHash = codec::hashBytes(text.data(), text.size());
+    stats.sourceBytes = text.size();
+    const std::uint64_t read = steadyMicros();
+    stats.readMicros = read - start;
+
+    std::shared_ptr<const CompiledConfig> previous = current();
+    if (previous && previous->sourceHash == sourceHash) {
+        m_errors.clear();
+        return true; // Touched but unchanged
+    }
+
+    std::shared_ptr<const CompiledConfig> config;
+    if (stamp.exists) {
+        MappedFile cache;
+        if (cache.open(m_cachePath)) {
+            config = decodeConfig(cache.data(), cache.size(), sourceHash);
+        }
+    }
+    stats.fromCache = config != nullptr;
+    if (!config) {
+        std::vector<ConfigError> errors;
+        config = compileConfig(text, errors);
+        if (!config) {
+            for (const ConfigError& error : errors) {
+                MAAT_LOG_WARN("Configuration", "Invalid configuration line", logField("path", m_path),
+                              logField("line", error.line), logField("error", error.message));
+            }
+            m_errors = std::move(errors);
+            return false;
+        }
+        if (stamp.exists) {
+            stats.cacheWritten = writeCache(*config);
+        }
+    }
+    const std::uint64_t end = steadyMicros();
+    stats.compileMicros = end - read;
+    stats.totalMicros = end - start;
+
+    m_errors.clear();
+    m_stats = stats;
+    std::atomic_store(&m_current, config);
+    MAAT_LOG_INFO("Configuration", "Configuration loaded", logField("path", stamp.exists ? m_path.c_str() : "(defaults)"),
+                  logField("from_cache", stats.fromCache), logField("rules", config->rules.size()),
+                  logField("bindings", config->bindings.size()), logField("compile_us", stats.compileMicros),
+                  logField("total_us", stats.totalMicros));
+    return true;
+}
+
+std::uint32_t Configuration::reload() {
+    const std::shared_ptr<const CompiledConfig> previous = current();
+    if (!load()) return 0;
+    return diffConfig(previous.get(), *current());
+}
+
+bool Configuration::writeCache(const CompiledConfig& config) const {
+    if (!replaceFile(m_cachePath, encodeConfig(config))) {
+        MAAT_LOG_DEBUG("Configuration", "Cannot write configuration cache", logField("path", m_cachePath));
+        return false;
+    }
+    return true;
+}
+
+} // namespace core
+} // namespace maat
@@ -1,15 +1,561 @@
 #include <maat_core/core_manager.h>
-#include <iostream>
+
+#include "maat_core/binary_codec.h"
+#include "maat_core/latency_histogram.h"
+#include "maat_core/log.h"
+#include "maat_core/maat_mediator.h"
 
 namespace maat {
 namespace core {
 
-CoreManager::CoreManager() {
-    std::cout << "[CoreManager] Constructed" << std::endl;
+using maat::platform::Rect;
+using maat::platform::SizeHints;
+using maat::platform::WindowId;
+
+namespace {
+
+constexpr std::size_t kNoMonitor = static_cast<std::size_t>(-1);
+
+bool containsCenter(const Rect& area, const Rect& geometry) {
+    const int cx = geometry.x + geometry.width / 2;
+    const int cy = geometry.y + geometry.height / 2;
+    return cx >= area.x && cx < area.x + area.width &&
+           cy >= area.y && cy < area.y + area.height;
+}
+
+void clampToLimits(Rect& rect, const SizeHints& limits) {
+    if (limits.maxWidth > 0 && rect.width > limits.maxWidth) rect.width = limits.maxWidth;
+    if (limits.maxHeight > 0 && rect.height > limits.maxHeight) rect.height = limits.maxHeight;
+    if (rect.width < limits.minWidth) rect.width = limits.minWidth;
+    if (rect.height < limits.minHeight) rect.height = limits.minHeight;
+}
+
+} // namespace
+
+CoreManager::CoreManager(MaatMediator& mediator) : m_mediator(mediator) {
+    MAAT_LOG_INFO("CoreManager", "Constructed");
 }
 
 CoreManager::~CoreManager() {
-    std::cout << "[CoreManager] Destructed" << std::endl;
+    MAAT_LOG_INFO("CoreManager", "Destructed");
+}
+
+void CoreManager::setTopology(const MonitorTopology& topology, const TopologyDiff& diff) {
+    const bool hadMonitors = !m_monitors.empty();
+
+    // Windows of removed monitors, taken from their layouts (not a registry
+    // scan) and detached before those layouts are dropped whole below
+    std::vector<std::pair<WindowHandle, std::size_t>> orphans; // window, workspace
+    for (maat::platform::MonitorId removed : diff.removed) {
+        const std::size_t index = monitorIndex(removed);
+        if (index == kNoMonitor) continue;
+        const MonitorState& monitor = m_monitors[index];
+        for (std::size_t workspace = 0; workspace < monitor.workspaces.size(); ++workspace) {
+            m_scratchWindows.clear();
+            monitor.workspaces[workspace]->collectWindows(m_registry, m_scratchWindows);
+            for (WindowHandle window : m_scratchWindows) {
+                orphans.emplace_back(window, workspace);
+            }
+        }
+    }
+    for (const auto& orphan : orphans) {
+        m_registry.setLayoutNode(orphan.first, kInvalidNode);
+        m_registry.setState(orphan.first, WindowState::Unplaced);
+        m_spatial.remove(m_registry.id(orphan.first));
+    }
+
+    // Rebuild the list in topology order. Surviving monitors keep their
+    // workspaces; a resized work area is picked up by computeDirtyLayout,
+    // so unchanged monitors cost nothing on the next flush.
+    std::vector<MonitorState> previous = std::move(m_monitors);
+    m_monitors.clear();
+    m_monitors.reserve(topology.monitors().size());
+    for (const MonitorArea& area : topology.monitors()) {
+        MonitorState state;
+        state.area = area;
+        for (MonitorState& old : previous) {
+            if (old.area.id == area.id) {
+                state.workspaces = std::move(old.workspaces);
+                state.active = old.active;
+                break;
+            }
+        }
+        if (state.workspaces.empty()) {
+            ensureWorkspace(state, 0);
+        }
+        m_monitors.push_back(std::move(state));
+    }
+    previous.clear();
+    std::vector<Rect> regions;
+    regions.reserve(m_monitors.size());
+    for (const MonitorState& monitor : m_monitors) {
+        regions.push_back(monitor.area.workArea);
+    }
+    m_spatial.setRegions(regions);
+
+    // With no monitor left, orphans stay unplaced until one appears
+    if (m_monitors.empty()) return;
+    constexpr std::size_t kShownWorkspace = static_cast<std::size_t>(-1);
+    if (!hadMonitors) {
+        for (std::size_t i = 0; i < m_registry.size(); ++i) {
+            const WindowHandle window = m_registry.handleAt(i);
+            if (m_registry.state(window) == WindowState::Tiled) continue;
+            // Windows that lost every monitor keep their workspace; windows
+            // that never had one go to the shown workspace
+            orphans.emplace_back(window, m_registry.monitor(window) != 0 ? m_registry.workspace(window)
+                                                                         : kShownWorkspace);
+        }
+    }
+    for (const auto& orphan : orphans) {
+        const std::size_t workspace = orphan.second == kShownWorkspace ? m_monitors[0].active : orphan.second;
+        insertIntoMonitor(orphan.first, 0, workspace);
+    }
+    ++m_sessionRevision;
+    MAAT_LOG_INFO("CoreManager", "Monitor topology applied", logField("version", topology.version()),
+                  logField("added", diff.added.size()), logField("removed", diff.removed.size()),
+                  logField("resized", diff.resized.size()), logField("migrated", orphans.size()));
+}
+
+void CoreManager::setDefaultLayout(LayoutKind kind, const LayoutParams& params) {
+    m_defaultLayout = kind;
+    m_defaultParams = params;
+}
+
+void CoreManager::applyDefaultLayout(LayoutKind kind, const LayoutParams& params) {
+    const LayoutKind previousKind = m_defaultLayout;
+    const LayoutParams previousParams = m_defaultParams;
+    setDefaultLayout(kind, params);
+
+    std::size_t switched = 0;
+    for (MonitorState& monitor : m_monitors) {
+        for (std::unique_ptr<WorkspaceLayout>& layout : monitor.workspaces) {
+            if (layout->kind() != previousKind || layout->params() != previousParams) continue;
+            if (kind != previousKind) replaceLayout(layout, kind);
+            if (params != previousParams) layout->setParams(params);
+            ++switched;
+        }
+    }
+    if (switched != 0) ++m_sessionRevision;
+    MAAT_LOG_INFO("CoreManager", "Default layout changed", logField("layout", layoutKindName(kind)),
+                  logField("workspaces", switched));
+}
+
+bool CoreManager::setLayout(maat::platform::MonitorId monitorId, LayoutKind kind) {
+    const std::size_t index = monitorIndex(monitorId);
+    if (index == kNoMonitor) return false;
+    MonitorState& monitor = m_monitors[index];
+    std::unique_ptr<WorkspaceLayout>& layout = monitor.workspaces[monitor.active];
+    if (layout->kind() == kind) return true;
+
+    replaceLayout(layout, kind);
+    ++m_sessionRevision;
+    MAAT_LOG_INFO("CoreManager", "Layout changed", logField("monitor", monitorId),
+                  logField("layout", layoutKindName(kind)), logField("windows", layout->windowCount()));
+    return true;
+}
+
+// Rebuilds `layout` as `kind` with the same windows, in order, and parameters
+void CoreManager::replaceLayout(std::unique_ptr<WorkspaceLayout>& layout, LayoutKind kind) {
+    m_scratchWindows.clear();
+    layout->collectWindows(m_registry, m_scratchWindows);
+    const LayoutParams params = layout->params();
+    layout.reset(); // frees its tree nodes before the new layout allocates
+    layout = makeWorkspaceLayout(kind, m_tree, params);
+    for (WindowHandle window : m_scratchWindows) {
+        layout->insert(m_registry, window);
+    }
+}
+
+bool CoreManager::setLayoutParams(maat::platform::MonitorId monitorId, const LayoutParams& params) {
+    const std::size_t index = monitorIndex(monitorId);
+    if (index == kNoMonitor) return false;
+    m_monitors[index].shown().setParams(params);
+    ++m_sessionRevision;
+    return true;
+}
+
+const WorkspaceLayout* CoreManager::layout(maat::platform::MonitorId monitorId) const {
+    const std::size_t index = monitorIndex(monitorId);
+    return index != kNoMonitor ? &m_monitors[index].shown() : nullptr;
+}
+
+bool CoreManager::switchWorkspace(maat::platform::MonitorId monitorId, std::size_t workspace) {
+    const std::size_t index = monitorIndex(monitorId);
+    if (index == kNoMonitor || workspace >= kMaxWorkspaces) return false;
+    MonitorState& monitor = m_monitors[index];
+    if (workspace == monitor.active) return true;
+    ensureWorkspace(monitor, workspace);
+
+    m_scratchWindows.clear();
+    monitor.shown().collectWindows(m_registry, m_scratchWindows);
+    for (WindowHandle window : m_scratchWindows) {
+        setHidden(window, true);
+    }
+    monitor.active = workspace;
+    ++m_sessionRevision;
+    m_scratchWindows.clear();
+    monitor.shown().collectWindows(m_registry, m_scratchWindows);
+    for (WindowHandle window : m_scratchWindows) {
+        setHidden(window, false);
+    }
+    MAAT_LOG_DEBUG("CoreManager", "Workspace switched", logField("monitor", monitorId),
+                   logField("workspace", workspace), logField("windows", m_scratchWindows.size()));
+
+    // The shown layout is clean unless something changed while it was hidden
+    flushLayout();
+    return true;
+}
+
+bool CoreManager::moveWindowToWorkspace(WindowId windowId, std::size_t workspace) {
+    const WindowHandle window = m_registry.find(windowId);
+    if (window.isNull() || m_registry.state(window) != WindowState::Tiled || workspace >= kMaxWorkspaces) {
+        return false;
+    }
+    const std::size_t index = monitorIndex(m_registry.monitor(window));
+    if (index == kNoMonitor) return false;
+    if (m_registry.workspace(window) == workspace) return true;
+
+    detach(window);
+    insertIntoMonitor(window, index, workspace);
+    flushLayout();
+    return true;
+}
+
+std::size_t CoreManager::activeWorkspace(maat::platform::MonitorId monitorId) const {
+    const std::size_t index = monitorIndex(monitorId);
+    return index != kNoMonitor ? m_monitors[index].active : 0;
+}
+
+std::size_t CoreManager::workspaceCount(maat::platform::MonitorId monitorId) const {
+    const std::size_t index = monitorIndex(monitorId);
+    return index != kNoMonitor ? m_monitors[index].workspaces.size() : 0;
+}
+
+// Snapshot body: varint monitor count, then per monitor a varint-length
+// block: rect work area, varint shown workspace, varint workspace count and
+// per workspace a varint-length block of encodeLayoutSettings() followed by
+// WorkspaceLayout::save(). The blocks let restore skip what it cannot place.
+bool CoreManager::saveSession(std::vector<std::uint8_t>& out) const {
+    if (m_monitors.empty()) return false;
+    std::vector<std::uint8_t> monitorBlock;
+    std::vector<std::uint8_t> workspaceBlock;
+    codec::putVarint(out, m_monitors.size());
+    for (const MonitorState& monitor : m_monitors) {
+        monitorBlock.clear();
+        codec::putRect(monitorBlock, monitor.area.workArea);
+        codec::putVarint(monitorBlock, monitor.active);
+        codec::putVarint(monitorBlock, monitor.workspaces.size());
+        for (const std::unique_ptr<WorkspaceLayout>& layout : monitor.workspaces) {
+            workspaceBlock.clear();
+            encodeLayoutSettings(layout->kind(), layout->params(), workspaceBlock);
+            layout->save(m_registry, workspaceBlock);
+            codec::putVarint(monitorBlock, workspaceBlock.size());
+            monitorBlock.insert(monitorBlock.end(), workspaceBlock.begin(), workspaceBlock.end());
+        }
+        codec::putVarint(out, monitorBlock.size());
+        out.insert(out.end(), monitorBlock.begin(), monitorBlock.end());
+    }
+    return true;
+}
+
+std::size_t CoreManager::restoreSession(const std::vector<std::pair<WindowId, Rect>>& windows,
+                                        const std::uint8_t* snapshot, std::size_t size) {
+    const std::uint64_t start = steadyMicros();
+    for (const auto& window : windows) {
+        if (m_registry.find(window.first).isNull()) {
+            m_registry.setGeometry(m_registry.add(window.first), window.second);
+        }
+    }
+
+    std::vector<WindowHandle> restored;
+    std::size_t matchedMonitors = 0;
+    if (snapshot && !m_monitors.empty() &&
+        !restoreMonitors(snapshot, size, restored, matchedMonitors)) {
+        MAAT_LOG_WARN("CoreManager", "Session snapshot malformed; ignored");
+        restored.clear();
+        matchedMonitors = 0;
+    }
+    for (WindowHandle window : restored) {
+        setHidden(window, m_registry.workspace(window) != m_monitors[monitorIndex(m_registry.monitor(window))].active);
+    }
+
+    // Everything the snapshot did not place arrives as if just created
+    if (!m_monitors.empty()) {
+        for (const auto& window : windows) {
+            const WindowHandle handle = m_registry.find(window.first);
+            if (m_registry.state(handle) != WindowState::Unplaced) continue;
+            const std::size_t monitor = monitorForGeometry(window.second);
+            insertIntoMonitor(handle, monitor, m_monitors[monitor].active);
+        }
+    }
+    ++m_sessionRevision;
+    MAAT_LOG_INFO("CoreManager", "Session restored", logField("windows", windows.size()),
+                  logField("restored", restored.size()), logField("monitors", matchedMonitors),
+                  logField("micros", steadyMicros() - start));
+    return restored.size();
+}
+
+// Rebuilds the saved workspaces of every monitor it can match, placing the
+// windows that are registered but unplaced. On malformed input everything
+// restored so far is undone and false returned.
+bool CoreManager::restoreMonitors(const std::uint8_t* snapshot, std::size_t size, std::vector<WindowHandle>& restored,
+                                  std::size_t& matchedMonitors) {
+    struct SavedMonitor {
+        Rect workArea;
+        std::uint64_t active;
+        codec::Reader workspaces;
+        std::size_t target;
+    };
+    codec::Reader in(snapshot, size);
+    std::uint64_t count;
+    if (!in.varint(count) || count > in.remaining()) return false;
+    std::vector<SavedMonitor> saved;
+    saved.reserve(static_cast<std::size_t>(count));
+    for (std::uint64_t i = 0; i < count; ++i) {
+        std::uint64_t length;
+        SavedMonitor monitor{Rect{0, 0, 0, 0}, 0, codec::Reader(nullptr, 0), kNoMonitor};
+        if (!in.varint(length) || !in.slice(length, monitor.workspaces) || !monitor.workspaces.rect(monitor.workArea) ||
+            !monitor.workspaces.varint(monitor.active)) {
+            return false;
+        }
+        saved.push_back(monitor);
+    }
+
+    // Same work area first, then the same position among the unmatched
+    std::vector<bool> taken(m_monitors.size(), false);
+    for (SavedMonitor& monitor : saved) {
+        for (std::size_t i = 0; i < m_monitors.size(); ++i) {
+            const Rect& area = m_monitors[i].area.workArea;
+            if (!taken[i] && area == monitor.workArea) {
+                monitor.target = i;
+                taken[i] = true;
+                break;
+            }
+        }
+    }
+    for (std::size_t i = 0; i < saved.size() && i < m_monitors.size(); ++i) {
+        if (saved[i].target == kNoMonitor && !taken[i]) {
+            saved[i].target = i;
+            taken[i] = true;
+        }
+    }
+
+    std::vector<WindowHandle> placed;
+    std::vector<std::size_t> replaced;
+    bool ok = true;
+    for (SavedMonitor& monitor : saved) {
+        if (monitor.target == kNoMonitor) continue;
+        MonitorState& state = m_monitors[monitor.target];
+        bool empty = true;
+        for (const std::unique_ptr<WorkspaceLayout>& layout : state.workspaces) {
+            empty = empty && layout->windowCount() == 0;
+        }
+        if (!empty) continue; // Already holds windows; restore nothing over them
+
+        std::uint64_t workspaceCount;
+        ok = monitor.workspaces.varint(workspaceCount) && workspaceCount > 0 && workspaceCount <= kMaxWorkspaces;
+        std::vector<std::unique_ptr<WorkspaceLayout>> layouts;
+        for (std::uint64_t w = 0; ok && w < workspaceCount; ++w) {
+            std::uint64_t length;
+            codec::Reader body(nullptr, 0);
+            LayoutKind kind;
+            LayoutParams params;
+            ok = monitor.workspaces.varint(length) && monitor.workspaces.slice(length, body) &&
+                 decodeLayoutSettings(body, kind, params);
+            if (!ok) break;
+            layouts.push_back(makeWorkspaceLayout(kind, m_tree, params));
+            placed.clear();
+            ok = layouts.back()->restore(m_registry, body, placed);
+            for (WindowHandle window : placed) {
+                m_registry.setMonitor(window, state.area.id);
+                m_registry.setWorkspace(window, static_cast<std::uint32_t>(w));
+                m_registry.setState(window, WindowState::Tiled);
+                restored.push_back(window);
+            }
+        }
+        if (!ok) break;
+        state.workspaces = std::move(layouts);
+        state.active = monitor.active < state.workspaces.size() ? static_cast<std::size_t>(monitor.active) : 0;
+        replaced.push_back(monitor.target);
+        ++matchedMonitors;
+    }
+    if (ok) return true;
+
+    for (WindowHandle window : restored) {
+        m_registry.setLayoutNode(window, kInvalidNode);
+        m_registry.setState(window, WindowState::Unplaced);
+        m_registry.setMonitor(window, 0);
+        m_registry.setWorkspace(window, 0);
+    }
+    for (std::size_t index : replaced) {
+        MonitorState& state = m_monitors[index];
+        state.workspaces.clear();
+        state.active = 0;
+        ensureWorkspace(state, 0);
+    }
+    return false;
+}
+
+void CoreManager::revealHiddenWindows() {
+    for (std::size_t i = 0; i < m_registry.size(); ++i) {
+        setHidden(m_registry.handleAt(i), false);
+    }
+    if (!m_visibilityChanges.empty()) {
+        m_mediator.requestWindowVisibility(m_visibilityChanges);
+        m_visibilityChanges.clear();
+    }
+}
+
+WindowHandle CoreManager::onWindowCreated(WindowId windowId, const Rect& geometry) {
+    const WindowHandle existing = m_registry.find(windowId);
+    if (!existing.isNull()) {
+        return existing; // Already managed
+    }
+    const WindowHandle window = m_registry.add(windowId);
+    m_registry.setGeometry(window, geometry);
+    if (!m_monitors.empty()) {
+        const std::size_t monitor = monitorForGeometry(geometry);
+        insertIntoMonitor(window, monitor, m_monitors[monitor].active);
+    }
+    return window;
+}
+
+void CoreManager::onWindowDestroyed(WindowHandle window) {
+    if (!m_registry.isValid(window)) {
+        return;
+    }
+    detach(window);
+    m_registry.remove(window);
+}
+
+void CoreManager::onWindowUnmanaged(WindowHandle window) {
+    if (!m_registry.isValid(window)) {
+        return;
+    }
+    setHidden(window, false); // no longer ours to hide
+    detach(window);
+    m_registry.remove(window);
+}
+
+void CoreManager::onWindowMonitorChanged(WindowHandle window, maat::platform::MonitorId monitorId) {
+    if (!m_registry.isValid(window) || m_registry.state(window) != WindowState::Tiled) {
+        return;
+    }
+    const std::size_t target = monitorIndex(monitorId);
+    if (target == kNoMonitor) {
+        return;
+    }
+    if (m_registry.monitor(window) == monitorId) {
+        // Same monitor: snap the window back into its tile
+        m_monitors[target].workspaces[m_registry.workspace(window)]->markDirty(m_registry, window);
+    } else {
+        detach(window);
+        insertIntoMonitor(window, target, m_monitors[target].active);
+    }
+}
+
+bool CoreManager::setWindowSizeLimits(WindowId windowId, const SizeHints& limits) {
+    const WindowHandle window = m_registry.find(windowId);
+    if (window.isNull()) return false;
+    m_registry.setSizeLimits(window, limits);
+    if (m_registry.state(window) == WindowState::Tiled) {
+        const std::size_t monitor = monitorIndex(m_registry.monitor(window));
+        if (monitor != kNoMonitor) {
+            m_monitors[monitor].workspaces[m_registry.workspace(window)]->sizeLimitsChanged(m_registry, window);
+        }
+    }
+    return true;
+}
+
+void CoreManager::flushLayout() {
+    const std::uint64_t start = steadyMicros();
+    m_changes.clear();
+    for (const MonitorState& monitor : m_monitors) {
+        monitor.shown().computeDirtyLayout(monitor.area.workArea, m_changes);
+    }
+    const bool limited = m_registry.limitedCount() != 0;
+    for (auto& change : m_changes) {
+        const WindowHandle window = m_registry.find(change.first);
+        if (window.isNull()) continue;
+        if (limited) clampToLimits(change.second, m_registry.sizeLimits(window));
+        m_registry.setGeometry(window, change.second);
+        m_spatial.update(change.first, change.second);
+    }
+    m_mediator.recordLatency(LatencyStage::Layout, steadyMicros() - start);
+    const std::size_t overconstrained = m_tree.solverStats().overconstrained;
+    if (overconstrained != m_overconstrainedSeen) {
+        MAAT_LOG_DEBUG("CoreManager", "Minimum sizes exceed their container; windows will overlap",
+                       logField("splits", overconstrained - m_overconstrainedSeen));
+        m_overconstrainedSeen = overconstrained;
+    }
+    if (!m_changes.empty()) {
+        m_mediator.requestApplyLayout(m_changes);
+    }
+    if (!m_visibilityChanges.empty()) {
+        m_mediator.requestWindowVisibility(m_visibilityChanges);
+        m_visibilityChanges.clear();
+    }
+}
+
+std::size_t CoreManager::monitorIndex(maat::platform::MonitorId id) const {
+    for (std::size_t i = 0; i < m_monitors.size(); ++i) {
+        if (m_monitors[i].area.id == id) {
+            return i;
+        }
+    }
+    return kNoMonitor;
+}
+
+std::size_t CoreManager::monitorForGeometry(const Rect& geometry) const {
+    for (std::size_t i = 0; i < m_monitors.size(); ++i) {
+        if (containsCenter(m_monitors[i].area.workArea, geometry)) {
+            return i;
+        }
+    }
+    return 0;
+}
+
+void CoreManager::ensureWorkspace(MonitorState& monitor, std::size_t workspace) {
+    while (monitor.workspaces.size() <= workspace) {
+        monitor.workspaces.push_back(makeWorkspaceLayout(m_defaultLayout, m_tree, m_defaultParams));
+    }
+}
+
+void CoreManager::detach(WindowHandle window) {
+    if (m_registry.state(window) == WindowState::Tiled) {
+        const std::size_t monitor = monitorIndex(m_registry.monitor(window));
+        if (monitor != kNoMonitor) {
+            m_monitors[monitor].workspaces[m_registry.workspace(window)]->remove(m_registry, window);
+        }
+        m_registry.setLayoutNode(window, kInvalidNode);
+        m_registry.setState(window, WindowState::Unplaced);
+        m_spatial.remove(m_registry.id(window));
+        ++m_sessionRevision;
+    }
+}
+
+void CoreManager::insertIntoMonitor(WindowHandle window, std::size_t monitor, std::size_t workspace) {
+    MonitorState& state = m_monitors[monitor];
+    ensureWorkspace(state, workspace);
+    state.workspaces[workspace]->insert(m_registry, window);
+    m_registry.setMonitor(window, state.area.id);
+    m_registry.setWorkspace(window, static_cast<std::uint32_t>(workspace));
+    m_registry.setState(window, WindowState::Tiled);
+    setHidden(window, workspace != state.active);
+    ++m_sessionRevision;
+}
+
+void CoreManager::setHidden(WindowHandle window, bool hidden) {
+    const std::uint32_t flags = m_registry.flags(window);
+    if (((flags & kWindowHidden) != 0) == hidden) return;
+    m_registry.setFlags(window, hidden ? (flags | kWindowHidden) : (flags & ~kWindowHidden));
+    m_visibilityChanges.emplace_back(m_registry.id(window), !hidden);
+    // Shown again at its last rect; a layout that changed meanwhile is flushed next
+    if (hidden) {
+        m_spatial.remove(m_registry.id(window));
+    } else if (m_registry.state(window) == WindowState::Tiled) {
+        m_spatial.update(m_registry.id(window), m_registry.geometry(window));
+    }
 }
 
 } // namespace core
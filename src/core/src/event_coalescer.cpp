@@ -0,0 +1,96 @@
+#include "maat_core/event_coalescer.h"
+
+namespace maat {
+namespace core {
+
+using maat::platform::MonitorId;
+using maat::platform::Rect;
+using maat::platform::Timestamp;
+using maat::platform::WindowId;
+
+EventCoalescer::Entry& EventCoalescer::entryFor(WindowId id, WindowHandle known) {
+    if (const std::uint32_t* index = m_index.find(id)) {
+        return m_entries[*index];
+    }
+    m_index.insert(id, static_cast<std::uint32_t>(m_entries.size()));
+    m_entries.push_back({id, 0, {0, 0, 0, 0}, 0, 0, known, 0});
+    return m_entries.back();
+}
+
+void EventCoalescer::addWindowCreated(WindowId id, WindowHandle known, const Rect& geometry, Timestamp timestamp) {
+    Entry& e = entryFor(id, known);
+    if (e.actions & kRelease) {
+        // Handle reused before we released it: the platform keeps tracking the
+        // same object for the new window, so it must not be released.
+        e.actions &= ~kRelease;
+    }
+    e.actions |= kCreate;
+    e.actions &= ~kMove; // The create geometry supersedes older moves
+    e.geometry = geometry;
+    e.createdAt = timestamp;
+}
+
+void EventCoalescer::addWindowDestroyed(WindowId id, WindowHandle known, std::uint32_t incarnation) {
+    Entry& e = entryFor(id, known);
+    e.incarnation = incarnation; // an earlier one was reused, so only this one is released
+    if ((e.actions & kCreate) && !(e.actions & (kDestroy | kUnmanage))) {
+        // Created and destroyed within the same window: the core never needs
+        // to hear about it, only the platform object has to go.
+        e.actions = kRelease;
+    } else {
+        e.actions = kDestroy | kRelease;
+    }
+}
+
+void EventCoalescer::addWindowMonitorChanged(WindowId id, WindowHandle known, MonitorId monitor) {
+    Entry& e = entryFor(id, known);
+    if ((e.actions & kDestroy) && !(e.actions & kCreate)) {
+        return; // Already gone
+    }
+    if (e.actions == kRelease) {
+        return; // Cancelled create
+    }
+    e.actions |= kMove;
+    e.monitor = monitor;
+}
+
+void EventCoalescer::addWindowUnmanaged(WindowId id, WindowHandle known) {
+    Entry& e = entryFor(id, known);
+    if (e.actions & kCreate) {
+        // The core has not seen this create yet; drop it, and only remove
+        // what it holds from before (a destroyed window, or the window itself)
+        e.actions &= ~(kCreate | kMove);
+        return;
+    }
+    if (e.actions & (kDestroy | kRelease)) {
+        return; // Already gone
+    }
+    e.actions = kUnmanage;
+}
+
+void EventCoalescer::addMonitorLayoutChanged() {
+    m_monitorLayoutChanged = true;
+}
+
+void EventCoalescer::addConfigurationChanged() {
+    m_configurationChanged = true;
+}
+
+std::size_t EventCoalescer::pendingOperationCount() const {
+    std::size_t count = (m_monitorLayoutChanged ? 1 : 0) + (m_configurationChanged ? 1 : 0);
+    for (const Entry& e : m_entries) {
+        count += ((e.actions & kDestroy) ? 1 : 0) + ((e.actions & kCreate) ? 1 : 0) +
+                 ((e.actions & kMove) ? 1 : 0) + ((e.actions & kUnmanage) ? 1 : 0);
+    }
+    return count;
+}
+
+void EventCoalescer::clear() {
+    m_entries.clear();
+    m_index.clear();
+    m_monitorLayoutChanged = false;
+    m_configurationChanged = false;
+}
+
+} // namespace core
+} // namespace maat
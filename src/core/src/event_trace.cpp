@@ -0,0 +1,235 @@
+#include "maat_core/event_trace.h"
+#include <cstring>
+
+#include "maat_core/binary_codec.h"
+#include "maat_core/log.h"
+
+namespace maat {
+namespace core {
+
+namespace {
+
+const char kMagic[8] = {'M', 'A', 'A', 'T', 'T', 'R', 'C', '\0'};
+const std::size_t kHeaderSize = 16;
+const std::size_t kFlushThreshold = 64 * 1024;
+const std::uint8_t kEventKindLast =
+    static_cast<std::uint8_t>(TraceRecordKind::Event) +
+    static_cast<std::uint8_t>(maat::platform::PlatformEventType::ConfigurationChanged);
+
+} // namespace
+
+// --- EventTraceWriter ---
+
+EventTraceWriter::EventTraceWriter() {
+    m_buffer.reserve(kFlushThreshold + 256);
+    m_buffer.insert(m_buffer.end(), kMagic, kMagic + sizeof(kMagic));
+    codec::putU32(m_buffer, kVersion);
+    codec::putU32(m_buffer, 0); // reserved
+}
+
+EventTraceWriter::~EventTraceWriter() {
+    close();
+}
+
+bool EventTraceWriter::open(const std::string& path) {
+    close();
+    m_file = std::fopen(path.c_str(), "wb");
+    if (!m_file) {
+        MAAT_LOG_ERROR("EventTrace", "Cannot open trace file", logField("path", path.c_str()));
+        return false;
+    }
+    flush(); // Header (and anything recorded before open)
+    return true;
+}
+
+void EventTraceWriter::close() {
+    if (!m_file) return;
+    flush();
+    std::fclose(m_file);
+    m_file = nullptr;
+}
+
+void EventTraceWriter::flush() {
+    if (!m_file || m_buffer.empty()) return;
+    std::fwrite(m_buffer.data(), 1, m_buffer.size(), m_file);
+    std::fflush(m_file);
+    m_bytesFlushed += m_buffer.size();
+    m_buffer.clear();
+}
+
+void EventTraceWriter::beginRecord(std::uint8_t kind, maat::platform::Timestamp time) {
+    if (m_file && m_buffer.size() >= kFlushThreshold) {
+        flush();
+    }
+    m_buffer.push_back(kind);
+    // Signed: snapshot records are stamped at processing time and may precede
+    // the receive time of events recorded before them
+    putSigned(m_haveLastTime ? static_cast<std::int64_t>(time - m_lastTime) : static_cast<std::int64_t>(time));
+    m_lastTime = time;
+    m_haveLastTime = true;
+    ++m_recordCount;
+}
+
+void EventTraceWriter::putVarint(std::uint64_t value) {
+    codec::putVarint(m_buffer, value);
+}
+
+void EventTraceWriter::putSigned(std::int64_t value) {
+    codec::putSigned(m_buffer, value);
+}
+
+void EventTraceWriter::putRect(const maat::platform::Rect& rect) {
+    codec::putRect(m_buffer, rect);
+}
+
+void EventTraceWriter::writeEvent(const maat::platform::PlatformEvent& event) {
+    beginRecord(static_cast<std::uint8_t>(TraceRecordKind::Event) + static_cast<std::uint8_t>(event.type),
+                event.received);
+    putVarint(event.received - event.timestamp);
+    switch (event.type) {
+        case maat::platform::PlatformEventType::WindowCreated:
+            putVarint(event.window);
+            putRect(event.geometry);
+            break;
+        case maat::platform::PlatformEventType::WindowDestroyed:
+        case maat::platform::PlatformEventType::WindowUnmanaged:
+            putVarint(event.window);
+            break;
+        case maat::platform::PlatformEventType::WindowMonitorChanged:
+            putVarint(event.window);
+            putVarint(event.monitor);
+            break;
+        case maat::platform::PlatformEventType::MonitorLayoutChanged:
+        case maat::platform::PlatformEventType::ConfigurationChanged:
+            break;
+    }
+}
+
+void EventTraceWriter::writeMonitorSnapshot(maat::platform::Timestamp time,
+                                            const std::vector<MonitorArea>& monitors) {
+    beginRecord(static_cast<std::uint8_t>(TraceRecordKind::MonitorSnapshot), time);
+    putVarint(monitors.size());
+    for (const MonitorArea& monitor : monitors) {
+        putVarint(monitor.id);
+        putRect(monitor.workArea);
+    }
+}
+
+void EventTraceWriter::writeInitialWindow(maat::platform::Timestamp time, maat::platform::WindowId window,
+                                          const maat::platform::Rect& geometry) {
+    beginRecord(static_cast<std::uint8_t>(TraceRecordKind::InitialWindow), time);
+    putVarint(window);
+    putRect(geometry);
+}
+
+// --- EventTrace ---
+
+bool EventTrace::load(const std::string& path) {
+    std::FILE* file = std::fopen(path.c_str(), "rb");
+    if (!file) {
+        m_error = "cannot open " + path;
+        return false;
+    }
+    std::vector<std::uint8_t> data;
+    std::uint8_t chunk[64 * 1024];
+    std::size_t read;
+    while ((read = std::fread(chunk, 1, sizeof(chunk), file)) > 0) {
+        data.insert(data.end(), chunk, chunk + read);
+    }
+    std::fclose(file);
+    return parse(data.data(), data.size());
+}
+
+bool EventTrace::parse(const std::uint8_t* data, std::size_t size) {
+    m_records.clear();
+    m_monitors.clear();
+    m_error.clear();
+
+    if (size < kHeaderSize || std::memcmp(data, kMagic, sizeof(kMagic)) != 0) {
+        m_error = "not a maat event trace";
+        return false;
+    }
+    const std::uint32_t version = codec::readU32(data + 8);
+    if (version != EventTraceWriter::kVersion) {
+        m_error = "unsupported trace version " + std::to_string(version);
+        return false;
+    }
+
+    codec::Reader in(data + kHeaderSize, size - kHeaderSize);
+    maat::platform::Timestamp time = 0;
+    while (!in.atEnd()) {
+        const std::size_t monitorMark = m_monitors.size();
+        std::uint8_t kind;
+        std::int64_t delta;
+        TraceRecord record{};
+        bool ok = in.byte(kind) && in.signedVarint(delta);
+        if (ok) {
+            time += static_cast<maat::platform::Timestamp>(delta);
+            record.time = time;
+        }
+
+        std::uint64_t a = 0, b = 0;
+        if (!ok) {
+            // Fall through to the truncation check below
+        } else if (kind >= static_cast<std::uint8_t>(TraceRecordKind::Event) && kind <= kEventKindLast) {
+            record.kind = TraceRecordKind::Event;
+            maat::platform::PlatformEvent& event = record.event;
+            event.type = static_cast<maat::platform::PlatformEventType>(
+                kind - static_cast<std::uint8_t>(TraceRecordKind::Event));
+            event.received = time;
+            ok = in.varint(a);
+            event.timestamp = time - a;
+            switch (event.type) {
+                case maat::platform::PlatformEventType::WindowCreated:
+                    ok = ok && in.varint(b) && in.rect(event.geometry);
+                    event.window = b;
+                    break;
+                case maat::platform::PlatformEventType::WindowDestroyed:
+                case maat::platform::PlatformEventType::WindowUnmanaged:
+                    ok = ok && in.varint(b);
+                    event.window = b;
+                    break;
+                case maat::platform::PlatformEventType::WindowMonitorChanged:
+                    ok = ok && in.varint(b) && in.varint(a);
+                    event.window = b;
+                    event.monitor = a;
+                    break;
+                case maat::platform::PlatformEventType::MonitorLayoutChanged:
+                case maat::platform::PlatformEventType::ConfigurationChanged:
+                    break;
+            }
+        } else if (kind == static_cast<std::uint8_t>(TraceRecordKind::MonitorSnapshot)) {
+            record.kind = TraceRecordKind::MonitorSnapshot;
+            record.firstMonitor = static_cast<std::uint32_t>(m_monitors.size());
+            ok = in.varint(a);
+            for (std::uint64_t i = 0; ok && i < a; ++i) {
+                MonitorArea monitor{};
+                ok = in.varint(b) && in.rect(monitor.workArea);
+                monitor.id = b;
+                if (ok) m_monitors.push_back(monitor);
+            }
+            record.monitorCount = static_cast<std::uint32_t>(m_monitors.size() - record.firstMonitor);
+        } else if (kind == static_cast<std::uint8_t>(TraceRecordKind::InitialWindow)) {
+            record.kind = TraceRecordKind::InitialWindow;
+            ok = in.varint(b) && in.rect(record.event.geometry);
+            record.event.window = b;
+        } else {
+            m_error = "unknown record kind " + std::to_string(kind) + " after " +
+                      std::to_string(m_records.size()) + " records";
+            m_monitors.resize(monitorMark);
+            return false;
+        }
+
+        if (!ok) {
+            // A recorder that died mid-write leaves a partial last record
+            m_error = "trace truncated after " + std::to_string(m_records.size()) + " records";
+            m_monitors.resize(monitorMark);
+            return false;
+        }
+        m_records.push_back(record);
+    }
+    return true;
+}
+
+} // namespace core
+} // namespace maat
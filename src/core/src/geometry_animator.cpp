@@ -0,0 +1,126 @@
+#include "maat_core/geometry_animator.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace maat {
+namespace core {
+
+using maat::platform::Rect;
+using maat::platform::Timestamp;
+using maat::platform::WindowId;
+
+namespace {
+
+constexpr std::uint32_t kMaxFrameRate = 240;
+
+int lerp(int from, int to, double t) {
+    return from + static_cast<int>(std::lround((to - from) * t));
+}
+
+} // namespace
+
+void GeometryAnimator::setSettings(const AnimationSettings& settings) {
+    m_settings = settings;
+    m_settings.frameRate = std::min(std::max<std::uint32_t>(m_settings.frameRate, 1), kMaxFrameRate);
+}
+
+Timestamp GeometryAnimator::frameInterval() const {
+    return 1000000 / m_settings.frameRate;
+}
+
+void GeometryAnimator::start(WindowId id, const Rect& from, const Rect& to, Timestamp now) {
+    if (m_transitions.empty()) {
+        m_nextFrame = now + frameInterval();
+    }
+    ++m_stats.started;
+    if (const std::uint32_t* index = m_index.find(id)) {
+        // Retarget from where the window is on screen
+        Transition& transition = m_transitions[*index];
+        transition.from = transition.shown;
+        transition.to = to;
+        transition.start = now;
+        ++m_stats.retargeted;
+        return;
+    }
+    m_index.insert(id, static_cast<std::uint32_t>(m_transitions.size()));
+    m_transitions.push_back({id, from, to, from, now});
+}
+
+bool GeometryAnimator::cancel(WindowId id, Rect* target) {
+    const std::uint32_t* index = m_index.find(id);
+    if (!index) return false;
+    if (target) *target = m_transitions[*index].to;
+    remove(*index);
+    ++m_stats.cancelled;
+    return true;
+}
+
+void GeometryAnimator::frame(Timestamp now, std::vector<std::pair<WindowId, Rect>>& out) {
+    if (m_transitions.empty()) return;
+    ++m_stats.frames;
+    const Timestamp interval = frameInterval();
+    const bool late = now >= m_nextFrame + interval;
+    const bool overBudget = m_settings.frameBudget > 0 && m_lastFrameCost > m_settings.frameBudget;
+    if (late || overBudget) {
+        ++m_stats.finalJumps;
+        m_stats.maxFrameSize = std::max(m_stats.maxFrameSize, m_transitions.size());
+        finish(out);
+        return;
+    }
+
+    const std::size_t first = out.size();
+    for (std::size_t i = 0; i < m_transitions.size();) {
+        Transition& transition = m_transitions[i];
+        if (now >= transition.start + m_settings.duration) {
+            out.emplace_back(transition.id, transition.to);
+            remove(i); // the last transition moves into `i`
+            continue;
+        }
+        const Rect rect = currentRect(transition, now);
+        if (rect != transition.shown) {
+            transition.shown = rect;
+            out.emplace_back(transition.id, rect);
+        }
+        ++i;
+    }
+    m_stats.maxFrameSize = std::max(m_stats.maxFrameSize, out.size() - first);
+    // A late frame resets the cadence instead of bursting to catch up
+    m_nextFrame += interval;
+    if (m_nextFrame <= now) m_nextFrame = now + interval;
+}
+
+void GeometryAnimator::finish(std::vector<std::pair<WindowId, Rect>>& out) {
+    for (const Transition& transition : m_transitions) {
+        out.emplace_back(transition.id, transition.to);
+    }
+    m_transitions.clear();
+    m_index.clear();
+    m_lastFrameCost = 0;
+}
+
+Rect GeometryAnimator::currentRect(const Transition& transition, Timestamp now) const {
+    const double progress =
+        now <= transition.start ? 0.0 : static_cast<double>(now - transition.start) / m_settings.duration;
+    if (progress >= 1.0) return transition.to;
+    // Ease-out cubic: fast start, gentle settle
+    const double remaining = 1.0 - progress;
+    const double t = 1.0 - remaining * remaining * remaining;
+    const Rect& from = transition.from;
+    const Rect& to = transition.to;
+    return {lerp(from.x, to.x, t), lerp(from.y, to.y, t), lerp(from.width, to.width, t),
+            lerp(from.height, to.height, t)};
+}
+
+void GeometryAnimator::remove(std::size_t index) {
+    const WindowId id = m_transitions[index].id;
+    if (index + 1 != m_transitions.size()) {
+        m_transitions[index] = m_transitions.back();
+        m_index.set(m_transitions[index].id, static_cast<std::uint32_t>(index));
+    }
+    m_transitions.pop_back();
+    m_index.erase(id);
+}
+
+} // namespace core
+} // namespace maat
@@ -0,0 +1,122 @@
+#include "maat_core/geometry_apply_stage.h"
+
+#include <algorithm>
+
+#include "maat_platform/platform_manager.h"
+
+namespace maat {
+namespace core {
+
+using maat::platform::Rect;
+using maat::platform::WindowId;
+
+GeometryApplyStage::GeometryApplyStage(maat::platform::PlatformManager& platform) : m_platform(platform) {}
+
+GeometryApplyStage::~GeometryApplyStage() {
+    stop();
+}
+
+void GeometryApplyStage::start() {
+    if (m_thread.joinable()) return;
+    m_stop = false;
+    m_thread = std::thread(&GeometryApplyStage::threadMain, this);
+}
+
+void GeometryApplyStage::stop() {
+    if (!m_thread.joinable()) return;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_stop = true;
+    }
+    m_wake.notify_one();
+    m_thread.join();
+}
+
+std::uint64_t GeometryApplyStage::submitGeometry(const std::vector<std::pair<WindowId, Rect>>& updates) {
+    if (updates.empty()) return 0;
+    std::uint64_t sequence;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        sequence = ++m_submitSequence;
+        m_stats.submitted += updates.size();
+        for (const auto& update : updates) {
+            const std::pair<std::uint32_t*, bool> slot =
+                m_pendingIndex.insert(update.first, static_cast<std::uint32_t>(m_pending.size()));
+            if (slot.second) {
+                m_pending.push_back(update);
+            } else {
+                m_pending[*slot.first].second = update.second; // latest wins, keeps its place
+                ++m_stats.superseded;
+            }
+        }
+    }
+    m_wake.notify_one();
+    return sequence;
+}
+
+void GeometryApplyStage::submitVisibility(const std::vector<std::pair<WindowId, bool>>& changes) {
+    if (changes.empty()) return;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_pendingVisibility.insert(m_pendingVisibility.end(), changes.begin(), changes.end());
+    }
+    m_wake.notify_one();
+}
+
+void GeometryApplyStage::flush() {
+    std::unique_lock<std::mutex> lock(m_mutex);
+    m_idle.wait(lock, [this]() {
+        return !m_thread.joinable() || (m_pending.empty() && m_pendingVisibility.empty() && !m_applying);
+    });
+}
+
+GeometryApplyStage::Stats GeometryApplyStage::stats() const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_stats;
+}
+
+std::uint64_t GeometryApplyStage::appliedSequence() const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_appliedSequence;
+}
+
+void GeometryApplyStage::threadMain() {
+    std::vector<std::pair<WindowId, Rect>> batch;
+    std::vector<std::pair<WindowId, bool>> visibility;
+    std::unique_lock<std::mutex> lock(m_mutex);
+    for (;;) {
+        m_wake.wait(lock, [this]() { return m_stop || !m_pending.empty() || !m_pendingVisibility.empty(); });
+        if (m_pending.empty() && m_pendingVisibility.empty()) break; // stopping, nothing left
+        batch.swap(m_pending);
+        visibility.swap(m_pendingVisibility);
+        m_pendingIndex.clear();
+        const std::uint64_t sequence = m_submitSequence; // everything submitted so far is in `batch`
+        m_applying = true;
+        lock.unlock();
+
+        const std::uint64_t start = steadyMicros();
+        if (!batch.empty()) m_platform.applyWindowGeometries(batch);
+        if (!visibility.empty()) m_platform.setWindowVisibility(visibility);
+        if (!batch.empty()) {
+            m_applyMicros.record(steadyMicros() - start);
+            m_batchSizes.record(batch.size());
+        }
+
+        lock.lock();
+        if (!batch.empty()) {
+            ++m_stats.batches;
+            m_stats.applied += batch.size();
+            m_stats.maxBatchSize = std::max<std::uint64_t>(m_stats.maxBatchSize, batch.size());
+        }
+        m_stats.visibilityChanges += visibility.size();
+        m_appliedSequence = sequence;
+        batch.clear();
+        visibility.clear();
+        m_applying = false;
+        m_idle.notify_all();
+    }
+    m_idle.notify_all();
+}
+
+} // namespace core
+} // namespace maat
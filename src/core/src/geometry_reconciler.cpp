@@ -0,0 +1,140 @@
+#include "maat_core/geometry_reconciler.h"
+
+#include <algorithm>
+
+namespace maat {
+namespace core {
+
+using maat::platform::Rect;
+using maat::platform::SizeHints;
+using maat::platform::Timestamp;
+using maat::platform::WindowId;
+
+namespace {
+
+// Learns one axis: a window bigger than asked has a minimum, a smaller one a
+// maximum. A size outside a bound learned earlier retires that bound.
+void learnAxis(int requested, int actual, int tolerance, int& minimum, int& maximum) {
+    if (actual > requested + tolerance) {
+        minimum = actual;
+        if (maximum > 0 && maximum < actual) maximum = 0;
+    } else if (actual < requested - tolerance) {
+        maximum = actual;
+        if (minimum > actual) minimum = 0;
+    }
+}
+
+bool sameLimits(const SizeHints& a, const SizeHints& b) {
+    return a.minWidth == b.minWidth && a.minHeight == b.minHeight && a.maxWidth == b.maxWidth &&
+           a.maxHeight == b.maxHeight;
+}
+
+} // namespace
+
+void GeometryReconciler::setSettings(const ReconcileSettings& settings) {
+    m_settings = settings;
+    m_settings.retryBudget = std::max<std::uint32_t>(m_settings.retryBudget, 1);
+    if (m_settings.snapTolerance < 0) m_settings.snapTolerance = 0;
+    if (!m_settings.enabled) {
+        m_checks.clear();
+        m_checkIndex.clear();
+    }
+}
+
+void GeometryReconciler::expect(WindowId id, const Rect& requested, Timestamp now, std::uint64_t sequence) {
+    if (!m_settings.enabled) return;
+    if (const WindowState* window = m_windows.find(id)) {
+        if (now < window->coolUntil) return;
+    }
+    const Timestamp due = now + m_settings.settleDelay;
+    if (m_checks.empty() || due < m_nextCheck) m_nextCheck = due;
+    const std::pair<std::uint32_t*, bool> slot = m_checkIndex.insert(id, static_cast<std::uint32_t>(m_checks.size()));
+    if (slot.second) {
+        m_checks.push_back({id, requested, due, sequence});
+    } else {
+        m_checks[*slot.first] = {id, requested, due, sequence};
+    }
+}
+
+void GeometryReconciler::cancel(WindowId id) {
+    if (const std::uint32_t* index = m_checkIndex.find(id)) {
+        removeCheck(*index);
+    }
+}
+
+void GeometryReconciler::forget(WindowId id) {
+    cancel(id);
+    m_windows.erase(id);
+}
+
+void GeometryReconciler::takeDue(Timestamp now, std::uint64_t appliedSequence,
+                                 std::vector<std::pair<WindowId, Rect>>& out) {
+    if (m_checks.empty() || now < m_nextCheck) return;
+    Timestamp next = 0;
+    bool haveNext = false;
+    for (std::size_t i = 0; i < m_checks.size();) {
+        Check& check = m_checks[i];
+        if (check.due <= now && check.sequence > appliedSequence) {
+            // The rect has not even been applied yet; give it a full delay once it may be
+            check.due = now + m_settings.settleDelay;
+            ++m_stats.deferred;
+        }
+        if (check.due <= now) {
+            out.emplace_back(check.id, check.requested);
+            removeCheck(i); // the last check moves into `i`
+            continue;
+        }
+        if (!haveNext || check.due < next) next = check.due;
+        haveNext = true;
+        ++i;
+    }
+    m_nextCheck = next;
+}
+
+GeometryReconciler::Outcome GeometryReconciler::reconcile(WindowId id, const Rect& requested, const Rect& actual,
+                                                          Timestamp now) {
+    ++m_stats.checks;
+    if (actual == requested) {
+        if (WindowState* window = m_windows.find(id)) window->refusals = 0;
+        ++m_stats.accepted;
+        return Outcome::Accepted;
+    }
+
+    WindowState& window = m_windows[id];
+    SizeHints learned = window.limits;
+    learnAxis(requested.width, actual.width, m_settings.snapTolerance, learned.minWidth, learned.maxWidth);
+    learnAxis(requested.height, actual.height, m_settings.snapTolerance, learned.minHeight, learned.maxHeight);
+    if (sameLimits(learned, window.limits)) {
+        // Nothing to answer with, so nothing that could loop
+        ++m_stats.refused;
+        return Outcome::Refused;
+    }
+    if (window.refusals++ >= m_settings.retryBudget) {
+        // Whatever it is doing, stop answering it with new rects for a while
+        window.refusals = 0;
+        window.coolUntil = now + m_settings.cooldown;
+        ++m_stats.exhausted;
+        return Outcome::Exhausted;
+    }
+    window.limits = learned;
+    ++m_stats.limited;
+    return Outcome::Limited;
+}
+
+const SizeHints* GeometryReconciler::limits(WindowId id) const {
+    const WindowState* window = m_windows.find(id);
+    return window ? &window->limits : nullptr;
+}
+
+void GeometryReconciler::removeCheck(std::size_t index) {
+    const WindowId id = m_checks[index].id;
+    if (index + 1 != m_checks.size()) {
+        m_checks[index] = m_checks.back();
+        m_checkIndex.set(m_checks[index].id, static_cast<std::uint32_t>(index));
+    }
+    m_checks.pop_back();
+    m_checkIndex.erase(id);
+}
+
+} // namespace core
+} // namespace maat
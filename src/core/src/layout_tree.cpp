@@ -0,0 +1,499 @@
+#include "maat_core/layout_tree.h"
+
+#include <algorithm>
+#include <cassert>
+#include <climits>
+
+namespace maat {
+namespace core {
+
+using maat::platform::Rect;
+using maat::platform::SizeHints;
+using maat::platform::WindowId;
+
+namespace {
+
+bool hasLimits(const SizeHints& limits) {
+    return limits.minWidth > 0 || limits.minHeight > 0 || limits.maxWidth > 0 || limits.maxHeight > 0;
+}
+
+bool sameLimits(const SizeHints& a, const SizeHints& b) {
+    return a.minWidth == b.minWidth && a.minHeight == b.minHeight && a.maxWidth == b.maxWidth &&
+           a.maxHeight == b.maxHeight;
+}
+
+int clampToInt(long long value) {
+    return value > INT_MAX ? INT_MAX : static_cast<int>(value);
+}
+
+} // namespace
+
+LayoutTree::LayoutTree(std::size_t reserveNodes) {
+    reserve(reserveNodes);
+}
+
+void LayoutTree::reserve(std::size_t nodes) {
+    m_nodes.reserve(nodes);
+}
+
+// --- Arena management ---
+
+NodeIndex LayoutTree::allocateNode(NodeKind kind) {
+    NodeIndex index;
+    if (m_freeHead != kInvalidNode) {
+        index = m_freeHead;
+        m_freeHead = m_nodes[index].nextSibling;
+        m_nodes[index] = Node{};
+    } else {
+        index = static_cast<NodeIndex>(m_nodes.size());
+        m_nodes.emplace_back();
+    }
+    m_nodes[index].kind = kind;
+    ++m_liveCount;
+    return index;
+}
+
+void LayoutTree::freeNode(NodeIndex index) {
+    Node& n = m_nodes[index];
+    if (n.kind == NodeKind::Leaf && hasLimits(n.limits)) --m_limitedLeaves;
+    n.kind = NodeKind::Free;
+    n.parent = n.firstChild = n.lastChild = n.prevSibling = kInvalidNode;
+    n.childCount = 0;
+    n.window = 0;
+    n.nextSibling = m_freeHead;
+    m_freeHead = index;
+    --m_liveCount;
+}
+
+void LayoutTree::freeSubtree(NodeIndex index) {
+    NodeIndex child = m_nodes[index].firstChild;
+    while (child != kInvalidNode) {
+        NodeIndex next = m_nodes[child].nextSibling;
+        freeSubtree(child);
+        child = next;
+    }
+    freeNode(index);
+}
+
+// --- Sibling list helpers ---
+
+void LayoutTree::linkAfter(NodeIndex parent, NodeIndex after, NodeIndex child) {
+    Node& p = m_nodes[parent];
+    Node& c = m_nodes[child];
+    c.parent = parent;
+    c.prevSibling = after;
+    if (after == kInvalidNode) {
+        // Insert at front
+        c.nextSibling = p.firstChild;
+        if (p.firstChild != kInvalidNode) m_nodes[p.firstChild].prevSibling = child;
+        p.firstChild = child;
+        if (p.lastChild == kInvalidNode) p.lastChild = child;
+    } else {
+        c.nextSibling = m_nodes[after].nextSibling;
+        if (c.nextSibling != kInvalidNode) m_nodes[c.nextSibling].prevSibling = child;
+        else p.lastChild = child;
+        m_nodes[after].nextSibling = child;
+    }
+    ++p.childCount;
+    if (m_limitedLeaves != 0) refreshLimits(parent);
+}
+
+void LayoutTree::unlink(NodeIndex child) {
+    Node& c = m_nodes[child];
+    const NodeIndex parent = c.parent;
+    Node& p = m_nodes[parent];
+    if (c.prevSibling != kInvalidNode) m_nodes[c.prevSibling].nextSibling = c.nextSibling;
+    else p.firstChild = c.nextSibling;
+    if (c.nextSibling != kInvalidNode) m_nodes[c.nextSibling].prevSibling = c.prevSibling;
+    else p.lastChild = c.prevSibling;
+    --p.childCount;
+    c.parent = c.prevSibling = c.nextSibling = kInvalidNode;
+    if (m_limitedLeaves != 0) refreshLimits(parent);
+}
+
+void LayoutTree::replaceInParent(NodeIndex oldChild, NodeIndex newChild) {
+    NodeIndex parent = m_nodes[oldChild].parent;
+    NodeIndex prev = m_nodes[oldChild].prevSibling;
+    m_nodes[newChild].weight = m_nodes[oldChild].weight;
+    unlink(oldChild);
+    linkAfter(parent, prev, newChild);
+}
+
+// --- Structure editing ---
+
+NodeIndex LayoutTree::createRoot(SplitAxis axis) {
+    NodeIndex root = allocateNode(NodeKind::Container);
+    m_nodes[root].axis = axis;
+    return root;
+}
+
+void LayoutTree::destroyRoot(NodeIndex root) {
+    assert(m_nodes[root].parent == kInvalidNode);
+    freeSubtree(root);
+}
+
+NodeIndex LayoutTree::appendWindow(NodeIndex container, WindowId window, float weight) {
+    assert(isContainer(container));
+    NodeIndex leaf = allocateNode(NodeKind::Leaf);
+    m_nodes[leaf].window = window;
+    m_nodes[leaf].weight = weight;
+    m_nodes[leaf].flags = kDirty; // new leaves are always reported
+    linkAfter(container, m_nodes[container].lastChild, leaf);
+    markDirty(container);
+    return leaf;
+}
+
+NodeIndex LayoutTree::appendContainer(NodeIndex container, SplitAxis axis, float weight) {
+    assert(isContainer(container));
+    NodeIndex child = allocateNode(NodeKind::Container);
+    m_nodes[child].axis = axis;
+    m_nodes[child].weight = weight;
+    m_nodes[child].flags = kDirty;
+    linkAfter(container, m_nodes[container].lastChild, child);
+    markDirty(container);
+    return child;
+}
+
+NodeIndex LayoutTree::insertWindowAfter(NodeIndex sibling, WindowId window, float weight) {
+    NodeIndex parent = m_nodes[sibling].parent;
+    assert(parent != kInvalidNode);
+    NodeIndex leaf = allocateNode(NodeKind::Leaf);
+    m_nodes[leaf].window = window;
+    m_nodes[leaf].weight = weight;
+    m_nodes[leaf].flags = kDirty;
+    linkAfter(parent, sibling, leaf);
+    markDirty(parent);
+    return leaf;
+}
+
+NodeIndex LayoutTree::splitLeaf(NodeIndex leaf, SplitAxis axis, WindowId window) {
+    assert(isLeaf(leaf));
+    NodeIndex container = allocateNode(NodeKind::Container);
+    m_nodes[container].axis = axis;
+    m_nodes[container].rect = m_nodes[leaf].rect;
+    replaceInParent(leaf, container);
+    m_nodes[leaf].weight = 1.0f;
+    linkAfter(container, kInvalidNode, leaf);
+    // The container takes over exactly the leaf's old area, so nothing
+    // outside of it has to move.
+    return appendWindow(container, window);
+}
+
+void LayoutTree::removeLeaf(NodeIndex leaf) {
+    assert(isLeaf(leaf));
+    NodeIndex parent = m_nodes[leaf].parent;
+    unlink(leaf);
+    freeNode(leaf);
+
+    // Walk upwards pruning containers that no longer split anything
+    while (parent != kInvalidNode && m_nodes[parent].parent != kInvalidNode) {
+        Node& p = m_nodes[parent];
+        NodeIndex grandParent = p.parent;
+        if (p.childCount == 0) {
+            unlink(parent);
+            freeNode(parent);
+            parent = grandParent;
+        } else if (p.childCount == 1) {
+            // The survivor inherits the container's slot and area
+            NodeIndex onlyChild = p.firstChild;
+            Rect area = p.rect;
+            unlink(onlyChild);
+            replaceInParent(parent, onlyChild);
+            freeNode(parent);
+            m_nodes[onlyChild].rect = area;
+            markDirty(onlyChild);
+            return;
+        } else {
+            break;
+        }
+    }
+    if (parent != kInvalidNode) {
+        markDirty(parent);
+    }
+}
+
+void LayoutTree::setWeight(NodeIndex node, float weight) {
+    m_nodes[node].weight = weight > 0.0f ? weight : 0.0f;
+    if (m_nodes[node].parent != kInvalidNode) {
+        markDirty(m_nodes[node].parent);
+    }
+}
+
+void LayoutTree::setAxis(NodeIndex container, SplitAxis axis) {
+    assert(isContainer(container));
+    if (m_nodes[container].axis != axis) {
+        m_nodes[container].axis = axis;
+        markDirty(container);
+        if (m_limitedLeaves != 0) refreshLimits(container);
+    }
+}
+
+void LayoutTree::setLimits(NodeIndex leaf, const SizeHints& limits) {
+    assert(isLeaf(leaf));
+    Node& n = m_nodes[leaf];
+    if (sameLimits(n.limits, limits)) return;
+    m_limitedLeaves += hasLimits(limits) ? 1 : 0;
+    m_limitedLeaves -= hasLimits(n.limits) ? 1 : 0;
+    n.limits = limits;
+    markDirty(leaf);
+    const NodeIndex parent = n.parent;
+    if (parent != kInvalidNode) {
+        markDirty(parent);
+        refreshLimits(parent);
+    }
+}
+
+// Recomputes the subtree limits of `container` and its ancestors, stopping
+// at the first that does not change. A container whose limits changed has
+// its parent re-laid out.
+void LayoutTree::refreshLimits(NodeIndex container) {
+    while (container != kInvalidNode) {
+        Node& c = m_nodes[container];
+        const bool horizontal = c.axis == SplitAxis::Horizontal;
+        long long minAlong = 0;
+        long long maxAlong = 0;
+        int minAcross = 0;
+        int maxAcross = 0;
+        bool boundedAlong = c.childCount != 0;
+        bool boundedAcross = c.childCount != 0;
+        for (NodeIndex child = c.firstChild; child != kInvalidNode; child = m_nodes[child].nextSibling) {
+            const SizeHints& l = m_nodes[child].limits;
+            minAlong += horizontal ? l.minWidth : l.minHeight;
+            const int childMaxAlong = horizontal ? l.maxWidth : l.maxHeight;
+            if (childMaxAlong > 0) maxAlong += childMaxAlong;
+            else boundedAlong = false;
+            minAcross = std::max(minAcross, horizontal ? l.minHeight : l.minWidth);
+            const int childMaxAcross = horizontal ? l.maxHeight : l.maxWidth;
+            if (childMaxAcross > 0) maxAcross = std::max(maxAcross, childMaxAcross);
+            else boundedAcross = false;
+        }
+        const int along = clampToInt(minAlong);
+        const int alongMax = boundedAlong ? clampToInt(maxAlong) : 0;
+        const int acrossMax = boundedAcross ? maxAcross : 0;
+        const SizeHints limits = horizontal ? SizeHints{along, minAcross, alongMax, acrossMax}
+                                            : SizeHints{minAcross, along, acrossMax, alongMax};
+        if (sameLimits(limits, c.limits)) return;
+        c.limits = limits;
+        if (c.parent != kInvalidNode) markDirty(c.parent);
+        container = c.parent;
+    }
+}
+
+void LayoutTree::markDirty(NodeIndex node) {
+    m_nodes[node].flags |= kDirty;
+    // Ancestors flagged kChildDirty always have flagged ancestors themselves,
+    // so propagation can stop at the first one already marked.
+    NodeIndex current = m_nodes[node].parent;
+    while (current != kInvalidNode && !(m_nodes[current].flags & kChildDirty)) {
+        m_nodes[current].flags |= kChildDirty;
+        current = m_nodes[current].parent;
+    }
+}
+
+NodeIndex LayoutTree::rootOf(NodeIndex index) const {
+    while (m_nodes[index].parent != kInvalidNode) {
+        index = m_nodes[index].parent;
+    }
+    return index;
+}
+
+// --- Geometry ---
+
+void LayoutTree::layoutChildren(NodeIndex container, bool trackChanges) {
+    const Node& c = m_nodes[container];
+    if (c.childCount == 0) return;
+
+    float totalWeight = 0.0f;
+    for (NodeIndex child = c.firstChild; child != kInvalidNode; child = m_nodes[child].nextSibling) {
+        totalWeight += m_nodes[child].weight;
+    }
+    const bool horizontal = c.axis == SplitAxis::Horizontal;
+    const int origin = horizontal ? c.rect.x : c.rect.y;
+    const int extent = horizontal ? c.rect.width : c.rect.height;
+    const std::uint32_t count = c.childCount;
+    const bool solved = m_limitedLeaves != 0 && solveChildren(c, extent);
+
+    // Edges are derived from the running weight prefix, so rounding never
+    // accumulates and the last child always ends exactly on the far edge.
+    float prefix = 0.0f;
+    double solvedPrefix = 0.0;
+    int start = origin;
+    std::uint32_t i = 0;
+    for (NodeIndex child = c.firstChild; child != kInvalidNode; child = m_nodes[child].nextSibling, ++i) {
+        prefix += m_nodes[child].weight;
+        int end;
+        if (solved) {
+            // Same prefix rounding over the solved sizes; whole-pixel limits stay exact
+            solvedPrefix += m_solveChildren[i].size;
+            end = origin + static_cast<int>(solvedPrefix + 0.5);
+        } else if (i + 1 == count) {
+            end = origin + extent;
+        } else if (totalWeight > 0.0f) {
+            end = origin + static_cast<int>(static_cast<double>(extent) * prefix / totalWeight + 0.5);
+        } else {
+            end = origin + static_cast<int>((static_cast<long long>(extent) * (i + 1)) / count);
+        }
+        Rect r = horizontal ? Rect{start, c.rect.y, end - start, c.rect.height}
+                            : Rect{c.rect.x, start, c.rect.width, end - start};
+        Node& childNode = m_nodes[child];
+        if (trackChanges && childNode.rect != r) {
+            childNode.flags |= kDirty;
+        }
+        childNode.rect = r;
+        start = end;
+    }
+}
+
+// Sizes the children of `c` along its axis into m_solveChildren when any of
+// them has a limit along it; returns false (plain weighted split) otherwise.
+bool LayoutTree::solveChildren(const Node& c, int extent) {
+    const bool horizontal = c.axis == SplitAxis::Horizontal;
+    bool limited = false;
+    double totalWeight = 0.0;
+    m_solveChildren.clear();
+    for (NodeIndex child = c.firstChild; child != kInvalidNode; child = m_nodes[child].nextSibling) {
+        const Node& n = m_nodes[child];
+        const int min = horizontal ? n.limits.minWidth : n.limits.minHeight;
+        const int max = horizontal ? n.limits.maxWidth : n.limits.maxHeight;
+        limited = limited || min > 0 || max > 0;
+        totalWeight += n.weight;
+        m_solveChildren.push_back({n.weight, static_cast<double>(min),
+                                   max > 0 ? static_cast<double>(std::max(max, min)) : 0.0, 0.0});
+    }
+    if (!limited) return false;
+    ++m_solverStats.constrainedSplits;
+
+    // Weights as in the plain split: equal when none has any; a weightless
+    // child among weighted ones only grows once they are all full
+    const double floorWeight = totalWeight > 0.0 ? totalWeight * 1e-9 : 1.0;
+    double minSum = 0.0;
+    double maxSum = 0.0;
+    bool bounded = true;
+    for (SolveChild& child : m_solveChildren) {
+        child.weight = totalWeight > 0.0 ? std::max(child.weight, floorWeight) : 1.0;
+        minSum += child.min;
+        if (child.max > 0.0) maxSum += child.max;
+        else bounded = false;
+    }
+    const double space = extent > 0 ? static_cast<double>(extent) : 0.0;
+
+    if (minSum >= space) {
+        // Over-constrained: shrink in proportion to the minimums
+        if (minSum > space) ++m_solverStats.overconstrained;
+        const double scale = minSum > 0.0 ? space / minSum : 0.0;
+        for (SolveChild& child : m_solveChildren) child.size = child.min * scale;
+        return true;
+    }
+    if (bounded && maxSum <= space) {
+        // Under-filled: everyone at its maximum, the rest stays empty
+        if (maxSum < space) ++m_solverStats.underfilled;
+        for (SolveChild& child : m_solveChildren) child.size = child.max;
+        return true;
+    }
+
+    // total(lambda) = sum of clamp(lambda * weight, min, max) grows piecewise
+    // linearly; walk its breakpoints in order to the segment reaching `space`
+    m_breakpoints.clear();
+    double fixed = 0.0; // children held at a bound
+    double slope = 0.0; // weight of the children growing
+    for (std::uint32_t i = 0; i < m_solveChildren.size(); ++i) {
+        const SolveChild& child = m_solveChildren[i];
+        if (child.min > 0.0) {
+            fixed += child.min;
+            m_breakpoints.push_back({child.min / child.weight, i, false});
+        } else {
+            slope += child.weight;
+        }
+        if (child.max > 0.0) m_breakpoints.push_back({child.max / child.weight, i, true});
+    }
+    std::sort(m_breakpoints.begin(), m_breakpoints.end(), [](const Breakpoint& a, const Breakpoint& b) {
+        if (a.lambda != b.lambda) return a.lambda < b.lambda;
+        if (a.child != b.child) return a.child < b.child;
+        return a.upper < b.upper;
+    });
+    double lambda = -1.0;
+    for (const Breakpoint& point : m_breakpoints) {
+        if (fixed + slope * point.lambda >= space) {
+            lambda = (space - fixed) / slope;
+            break;
+        }
+        const SolveChild& child = m_solveChildren[point.child];
+        if (point.upper) {
+            slope -= child.weight;
+            fixed += child.max;
+        } else {
+            slope += child.weight;
+            fixed -= child.min;
+        }
+    }
+    if (lambda < 0.0) lambda = slope > 0.0 ? (space - fixed) / slope : 0.0; // only unbounded children left
+    for (SolveChild& child : m_solveChildren) {
+        double size = lambda * child.weight;
+        if (child.max > 0.0 && size > child.max) size = child.max;
+        if (size < child.min) size = child.min;
+        child.size = size;
+    }
+    return true;
+}
+
+void LayoutTree::computeLayout(NodeIndex root, const Rect& area, GeometryList& out) {
+    m_nodes[root].rect = area;
+    NodeIndex current = root;
+    while (current != kInvalidNode) {
+        Node& n = m_nodes[current];
+        n.flags = 0;
+        if (n.kind == NodeKind::Leaf) {
+            out.emplace_back(n.window, n.rect);
+        } else {
+            // Children get their rects before being visited (pre-order)
+            layoutChildren(current, false);
+            if (n.firstChild != kInvalidNode) {
+                current = n.firstChild;
+                continue;
+            }
+        }
+        while (current != root && m_nodes[current].nextSibling == kInvalidNode) {
+            current = m_nodes[current].parent;
+        }
+        current = (current == root) ? kInvalidNode : m_nodes[current].nextSibling;
+    }
+}
+
+void LayoutTree::computeDirtyLayout(NodeIndex root, const Rect& area, GeometryList& out) {
+    Node& rootNode = m_nodes[root];
+    if (rootNode.rect != area) {
+        rootNode.rect = area;
+        rootNode.flags |= kDirty;
+    }
+
+    // Same walk as computeLayout, but clean subtrees are skipped entirely and
+    // only dirty containers redistribute their children.
+    NodeIndex current = root;
+    while (current != kInvalidNode) {
+        Node& n = m_nodes[current];
+        const std::uint8_t flags = n.flags;
+        n.flags = 0;
+        bool descend = false;
+        if (n.kind == NodeKind::Leaf) {
+            if (flags & kDirty) {
+                out.emplace_back(n.window, n.rect);
+            }
+        } else if (flags != 0) {
+            if (flags & kDirty) {
+                layoutChildren(current, true);
+            }
+            descend = n.firstChild != kInvalidNode;
+        }
+        if (descend) {
+            current = n.firstChild;
+            continue;
+        }
+        while (current != root && m_nodes[current].nextSibling == kInvalidNode) {
+            current = m_nodes[current].parent;
+        }
+        current = (current == root) ? kInvalidNode : m_nodes[current].nextSibling;
+    }
+}
+
+} // namespace core
+} // namespace maat
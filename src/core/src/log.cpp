@@ -0,0 +1,183 @@
+#include "maat_core/log.h"
+#include <algorithm>
+#include <cinttypes>
+#include <cstdio>
+#include <cstring>
+
+#include "maat_core/latency_histogram.h"
+
+namespace maat {
+namespace core {
+
+namespace {
+
+const char* levelName(LogLevel level) {
+    switch (level) {
+        case LogLevel::Trace: return "TRACE";
+        case LogLevel::Debug: return "DEBUG";
+        case LogLevel::Info: return "INFO ";
+        case LogLevel::Warn: return "WARN ";
+        case LogLevel::Error: return "ERROR";
+    }
+    return "?    ";
+}
+
+// Records are stamped relative to the first use of the logger
+const std::uint64_t kEpoch = steadyMicros();
+
+} // namespace
+
+Logger& Logger::instance() {
+    static Logger logger;
+    return logger;
+}
+
+Logger::Logger() : m_queue(kQueueCapacity) {
+}
+
+Logger::~Logger() {
+    // Runs at static destruction: write out whatever is still queued
+    if (m_writer.joinable()) {
+        {
+            std::lock_guard<std::mutex> lock(m_wakeMutex);
+            m_stop.store(true);
+            m_writerSleeping.store(false);
+        }
+        m_wakeCondition.notify_one();
+        m_writer.join();
+    }
+}
+
+void Logger::write(LogLevel level, const char* component, const char* message,
+                   std::initializer_list<LogField> fields) {
+    LogRecord record;
+    record.timestamp = steadyMicros();
+    record.level = level;
+    record.component = component;
+    record.message = message;
+
+    std::size_t textUsed = 0;
+    for (const LogField& field : fields) {
+        if (record.fieldCount == LogRecord::kMaxFields) break;
+        LogField& stored = record.fields[record.fieldCount++];
+        stored = field;
+        if (field.kind == LogField::Kind::Text) {
+            // Copy into the record (truncating) so the caller's string may die
+            const std::size_t room = LogRecord::kTextCapacity - textUsed;
+            const std::size_t length = room > 0 ? std::min(std::strlen(field.text), room - 1) : 0;
+            stored.u = textUsed;
+            stored.text = nullptr;
+            if (room > 0) {
+                std::memcpy(record.text + textUsed, field.text, length);
+                record.text[textUsed + length] = '\0';
+                textUsed += length + 1;
+            }
+        }
+    }
+
+    startWriter();
+    if (!m_queue.push(record)) {
+        return; // Dropped; counted by the queue and reported by the writer
+    }
+    m_queued.fetch_add(1, std::memory_order_release);
+    wakeWriter();
+}
+
+void Logger::flush() {
+    const std::uint64_t target = m_queued.load(std::memory_order_acquire);
+    if (m_written.load(std::memory_order_acquire) >= target) return;
+    wakeWriter();
+    std::unique_lock<std::mutex> lock(m_wakeMutex);
+    m_flushedCondition.wait(lock, [this, target]() {
+        return m_written.load(std::memory_order_acquire) >= target || m_stop.load();
+    });
+}
+
+void Logger::startWriter() {
+    std::call_once(m_startOnce, [this]() {
+        m_writer = std::thread(&Logger::writerMain, this);
+    });
+}
+
+void Logger::wakeWriter() {
+    // Pairs with the fence in writerMain: either the writer sees our record
+    // before sleeping, or we see it asleep and wake it.
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (m_writerSleeping.exchange(false)) {
+        std::lock_guard<std::mutex> lock(m_wakeMutex);
+        m_wakeCondition.notify_one();
+    }
+}
+
+void Logger::writerMain() {
+    LogRecord record;
+    for (;;) {
+        bool wrote = false;
+        while (m_queue.pop(record)) {
+            format(record);
+            m_written.fetch_add(1, std::memory_order_release);
+            wrote = true;
+        }
+        const std::size_t dropped = m_queue.droppedCount();
+        if (dropped != m_reportedDrops) {
+            std::fprintf(stderr, "[logger] %zu log records dropped (ring full)\n", dropped - m_reportedDrops);
+            m_reportedDrops = dropped;
+        }
+        if (wrote) {
+            std::fflush(stdout);
+            std::fflush(stderr);
+            std::lock_guard<std::mutex> lock(m_wakeMutex);
+            m_flushedCondition.notify_all();
+        }
+
+        std::unique_lock<std::mutex> lock(m_wakeMutex);
+        if (m_stop.load() && m_queue.empty()) break;
+        m_writerSleeping.store(true);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if (!m_queue.empty() || m_stop.load()) {
+            m_writerSleeping.store(false);
+            continue;
+        }
+        m_wakeCondition.wait(lock, [this]() { return !m_writerSleeping.load() || m_stop.load(); });
+        m_writerSleeping.store(false);
+    }
+    std::lock_guard<std::mutex> lock(m_wakeMutex);
+    m_flushedCondition.notify_all();
+}
+
+void Logger::format(const LogRecord& record) {
+    char line[512];
+    const std::uint64_t elapsed = record.timestamp > kEpoch ? record.timestamp - kEpoch : 0;
+    int used = std::snprintf(line, sizeof(line), "[%6" PRIu64 ".%06" PRIu64 "] %s %s: %s",
+                             elapsed / 1000000, elapsed % 1000000, levelName(record.level),
+                             record.component, record.message);
+    for (std::size_t i = 0; i < record.fieldCount && used > 0 && used < static_cast<int>(sizeof(line)); ++i) {
+        const LogField& field = record.fields[i];
+        char* out = line + used;
+        const std::size_t room = sizeof(line) - used;
+        switch (field.kind) {
+            case LogField::Kind::Int:
+                used += std::snprintf(out, room, " %s=%" PRId64, field.key, field.i);
+                break;
+            case LogField::Kind::UInt:
+                used += std::snprintf(out, room, " %s=%" PRIu64, field.key, field.u);
+                break;
+            case LogField::Kind::Double:
+                used += std::snprintf(out, room, " %s=%g", field.key, field.d);
+                break;
+            case LogField::Kind::Bool:
+                used += std::snprintf(out, room, " %s=%s", field.key, field.b ? "true" : "false");
+                break;
+            case LogField::Kind::Text:
+                used += std::snprintf(out, room, " %s=\"%s\"", field.key,
+                                      field.u < LogRecord::kTextCapacity ? record.text + field.u : "");
+                break;
+        }
+    }
+    std::FILE* stream = record.level >= LogLevel::Warn ? stderr : stdout;
+    std::fputs(line, stream);
+    std::fputc('\n', stream);
+}
+
+} // namespace core
+} // namespace maat
@@ -1,84 +1,931 @@
 #include "maat_core/maat_mediator.h"
-#include <iostream>
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <future>
+#include <limits>
 
 #include "maat_platform/platform_manager.h"
+#include "maat_platform/window.h"
+#include "maat_platform/monitor.h"
+#include "maat_core/configuration.h"
 #include "maat_core/core_manager.h"
+#include "maat_core/event_trace.h"
+#include "maat_core/geometry_apply_stage.h"
+#include "maat_core/log.h"
+#include "maat_core/session_store.h"
 
 namespace maat {
 namespace core {
 
-MaatMediator::MaatMediator() {
-    // Default constructor
+namespace {
+
+// classifyInitialWindows() per-window flags
+constexpr std::uint8_t kClassifyCached = 1u << 0;     // decision already in the classifier
+constexpr std::uint8_t kClassifyManageable = 1u << 1; // passed isManageable()
+
+// Events whose loss the core cannot recover from
+bool isLifecycleEvent(maat::platform::PlatformEventType type) {
+    return type == maat::platform::PlatformEventType::WindowCreated ||
+           type == maat::platform::PlatformEventType::WindowDestroyed ||
+           type == maat::platform::PlatformEventType::WindowUnmanaged;
+}
+
+bool withinTolerance(const maat::platform::Rect& a, const maat::platform::Rect& b, int tolerance) {
+    return std::abs(a.x - b.x) <= tolerance && std::abs(a.y - b.y) <= tolerance &&
+           std::abs(a.width - b.width) <= tolerance && std::abs(a.height - b.height) <= tolerance;
+}
+
+} // namespace
+
+MaatMediator::MaatMediator(std::size_t eventQueueCapacity)
+    : m_eventQueue(eventQueueCapacity) {
+}
+
+MaatMediator::~MaatMediator() {
+    stopCoreThread();
 }
 
 // Component registration
 void MaatMediator::registerPlatformManager(maat::platform::PlatformManager& platformManager) {
     m_platformManager = &platformManager;
-    std::cout << "[MaatMediator] PlatformManager registered\n";
+    MAAT_LOG_INFO("MaatMediator", "PlatformManager registered");
 }
 
 void MaatMediator::registerCoreManager(CoreManager& coreManager) {
     m_coreManager = &coreManager;
-    std::cout << "[MaatMediator] CoreManager registered\n";
+    MAAT_LOG_INFO("MaatMediator", "CoreManager registered");
+}
+
+void MaatMediator::registerConfiguration(Configuration& configuration) {
+    m_configuration = &configuration;
+    MAAT_LOG_INFO("MaatMediator", "Configuration registered", logField("path", configuration.path()));
 }
 
 // Notifications from PlatformManager
-void MaatMediator::notifyOsWindowCreated(maat::platform::Window* window) {
-    std::cout << "[MaatMediator] OS window created: " << window << "\n";
-    // TODO: route to CoreManager or other components
+// Notifications only snapshot their data and enqueue it. The consumer (this
+// thread in Inline mode, the core thread otherwise) drains the queue into the
+// coalescer, and the core sees the net effect once per coalescing window.
+void MaatMediator::notifyOsWindowCreated(maat::platform::Window* window,
+                                         maat::platform::Timestamp eventTime) {
+    if (!window) return;
+    MAAT_LOG_DEBUG("MaatMediator", "OS window created", logField("window", window->getId()));
+    maat::platform::PlatformEvent event{};
+    event.type = maat::platform::PlatformEventType::WindowCreated;
+    event.timestamp = eventTime;
+    event.window = window->getId();
+    event.geometry = window->getGeometry();
+    postEvent(event);
+}
+
+void MaatMediator::syncClassifierRules() {
+    const std::uint64_t generation = m_windowRulesGeneration.load(std::memory_order_acquire);
+    if (generation != m_classifierGeneration) {
+        m_classifierGeneration = generation;
+        m_classifier.setRules(std::atomic_load(&m_windowRules));
+    }
+}
+
+bool MaatMediator::classifyWindow(const maat::platform::Window& window) {
+    syncClassifierRules();
+    const bool manage = m_classifier.classify(window) == RuleAction::Manage;
+    if (!manage) {
+        MAAT_LOG_DEBUG("MaatMediator", "Window ignored by rules", logField("window", window.getId()));
+    }
+    return manage;
+}
+
+void MaatMediator::classifyInitialWindows(const std::vector<maat::platform::Window*>& windows,
+                                          std::vector<std::uint8_t>& manage) {
+    const std::uint64_t start = steadyMicros();
+    syncClassifierRules();
+    const std::size_t count = windows.size();
+    // Per window; each entry is written by the one thread owning its batch
+    std::vector<std::uint8_t> flags(count, 0);
+    std::vector<RuleAction> actions(count, RuleAction::Manage);
+    for (std::size_t i = 0; i < count; ++i) {
+        if (m_classifier.isCached(windows[i]->getId())) flags[i] = kClassifyCached;
+    }
+
+    const WindowRuleSet& rules = m_classifier.rules();
+    std::atomic<std::size_t> next{0};
+    // Batches are disjoint, so no Window object is used by two threads (the
+    // contract in maat_platform/window.h)
+    auto classifyBatches = [&]() {
+        for (;;) {
+            const std::size_t begin = next.fetch_add(kClassifyBatchSize, std::memory_order_relaxed);
+            if (begin >= count) return;
+            const std::size_t end = std::min(count, begin + kClassifyBatchSize);
+            for (std::size_t i = begin; i < end; ++i) {
+                if (!windows[i]->isManageable()) continue;
+                flags[i] |= kClassifyManageable;
+                if (!(flags[i] & kClassifyCached)) actions[i] = rules.evaluate(*windows[i]);
+            }
+        }
+    };
+    // Attribute queries dominate (a process name is a few system calls), so
+    // batches are claimed dynamically: one slow window does not hold up a
+    // whole share of the work
+    const std::size_t batches = (count + kClassifyBatchSize - 1) / kClassifyBatchSize;
+    const std::size_t hardware = std::max<std::size_t>(1, std::thread::hardware_concurrency());
+    const std::size_t threads = std::max<std::size_t>(1, std::min({hardware, kMaxClassifyThreads, batches}));
+    std::vector<std::thread> workers;
+    workers.reserve(threads - 1);
+    for (std::size_t i = 1; i < threads; ++i) {
+        workers.emplace_back(classifyBatches);
+    }
+    classifyBatches();
+    for (std::thread& worker : workers) {
+        worker.join();
+    }
+
+    // Decisions enter the cache on this thread, as classifyWindow() would
+    manage.assign(count, 0);
+    for (std::size_t i = 0; i < count; ++i) {
+        if (!(flags[i] & kClassifyManageable)) continue;
+        const maat::platform::Window& window = *windows[i];
+        RuleAction action = actions[i];
+        if (flags[i] & kClassifyCached) {
+            action = m_classifier.classify(window);
+        } else {
+            m_classifier.record(window.getId(), action);
+        }
+        if (action == RuleAction::Manage) {
+            manage[i] = 1;
+        } else {
+            MAAT_LOG_DEBUG("MaatMediator", "Window ignored by rules", logField("window", window.getId()));
+        }
+    }
+    m_startupStats.classifyThreads = threads;
+    m_startupStats.classifyMicros = steadyMicros() - start;
+}
+
+bool MaatMediator::invalidateWindowClassification(maat::platform::WindowId windowId,
+                                                  std::uint32_t changedAttributes) {
+    syncClassifierRules();
+    return m_classifier.invalidate(windowId, changedAttributes);
+}
+
+void MaatMediator::forgetWindowClassification(maat::platform::WindowId windowId) {
+    m_classifier.forget(windowId);
 }
 
-void MaatMediator::notifyOsWindowDestroyed(maat::platform::WindowId windowId) {
-    std::cout << "[MaatMediator] OS window destroyed: " << windowId << "\n";
-    // TODO: handle cleanup
+void MaatMediator::setWindowRules(std::shared_ptr<const WindowRuleSet> rules) {
+    if (!rules) rules = WindowRuleSet::defaults();
+    MAAT_LOG_INFO("MaatMediator", "Window rules set", logField("rules", rules->ruleCount()),
+                  logField("predicates", rules->predicateCount()));
+    std::atomic_store(&m_windowRules, std::move(rules));
+    m_windowRulesGeneration.fetch_add(1, std::memory_order_release);
+}
+
+void MaatMediator::notifyOsWindowDestroyed(maat::platform::WindowId windowId,
+                                           maat::platform::Timestamp eventTime,
+                                           std::uint32_t incarnation) {
+    MAAT_LOG_DEBUG("MaatMediator", "OS window destroyed", logField("window", windowId));
+    maat::platform::PlatformEvent event{};
+    event.type = maat::platform::PlatformEventType::WindowDestroyed;
+    event.timestamp = eventTime;
+    event.window = windowId;
+    event.incarnation = incarnation;
+    postEvent(event);
 }
 
 void MaatMediator::notifyOsWindowMonitorChanged(maat::platform::WindowId windowId,
-                                                maat::platform::MonitorId monitorId) {
-    std::cout << "[MaatMediator] Window " << windowId
-              << " moved to monitor " << monitorId << "\n";
-    // TODO: update layout or notify CoreManager
+                                                maat::platform::MonitorId monitorId,
+                                                maat::platform::Timestamp eventTime) {
+    MAAT_LOG_DEBUG("MaatMediator", "Window moved to monitor",
+                   logField("window", windowId), logField("monitor", monitorId));
+    maat::platform::PlatformEvent event{};
+    event.type = maat::platform::PlatformEventType::WindowMonitorChanged;
+    event.timestamp = eventTime;
+    event.window = windowId;
+    event.monitor = monitorId;
+    postEvent(event);
+}
+
+void MaatMediator::notifyOsMonitorLayoutChanged(maat::platform::Timestamp eventTime) {
+    MAAT_LOG_DEBUG("MaatMediator", "OS monitor layout changed");
+    maat::platform::PlatformEvent event{};
+    event.type = maat::platform::PlatformEventType::MonitorLayoutChanged;
+    event.timestamp = eventTime;
+    postEvent(event);
+}
+
+void MaatMediator::registerSessionStore(SessionStore& store) {
+    m_sessionStore = &store;
+    MAAT_LOG_INFO("MaatMediator", "Session store registered", logField("path", store.path()));
+}
+
+void MaatMediator::notifyOsWindowUnmanaged(maat::platform::WindowId windowId,
+                                           maat::platform::Timestamp eventTime) {
+    MAAT_LOG_DEBUG("MaatMediator", "Window no longer managed", logField("window", windowId));
+    maat::platform::PlatformEvent event{};
+    event.type = maat::platform::PlatformEventType::WindowUnmanaged;
+    event.timestamp = eventTime;
+    event.window = windowId;
+    postEvent(event);
+}
+
+std::uint32_t MaatMediator::reloadConfiguration() {
+    if (!m_configuration) return 0;
+    const std::uint64_t start = steadyMicros();
+    const std::uint32_t changed = m_configuration->reload();
+    if (changed == 0) return 0;
+    ++m_configurationReloads;
+    const std::shared_ptr<const CompiledConfig> config = m_configuration->current();
+    const std::uint64_t loaded = steadyMicros();
+
+    std::size_t reclassified = 0;
+    if (changed & ConfigSectionRules) {
+        setWindowRules(config->ruleSet);
+        if (m_platformManager) {
+            reclassified = m_platformManager->reclassifyWindows();
+        }
+    }
+    if (changed & (ConfigSectionLayout | ConfigSectionAnimation)) {
+        // Layout and animation state belong to the consuming thread
+        maat::platform::PlatformEvent event{};
+        event.type = maat::platform::PlatformEventType::ConfigurationChanged;
+        postEvent(event);
+    }
+    MAAT_LOG_INFO("MaatMediator", "Configuration reloaded", logField("sections", changed),
+                  logField("windows_reclassified", reclassified), logField("load_us", loaded - start),
+                  logField("apply_us", steadyMicros() - loaded));
+    return changed;
+}
+
+std::uint32_t MaatMediator::pollConfiguration() {
+    return m_configuration && m_configuration->sourceChanged() ? reloadConfiguration() : 0;
+}
+
+void MaatMediator::applyConfigurationChange() {
+    if (!m_configuration || !m_coreManager) return;
+    const std::shared_ptr<const CompiledConfig> config = m_configuration->current();
+    if (!config) return;
+    const std::uint32_t changed = diffConfig(m_appliedConfig.get(), *config);
+    // Animation first, so a re-tile in the same reload already uses it
+    if (changed & ConfigSectionAnimation) {
+        setAnimation(config->animation);
+    }
+    if (changed & ConfigSectionLayout) {
+        m_coreManager->applyDefaultLayout(config->layout, config->layoutParams);
+    }
+    m_appliedConfig = config;
+}
+
+void MaatMediator::postEvent(const maat::platform::PlatformEvent& event) {
+    maat::platform::PlatformEvent stamped = event;
+    if (stamped.received == 0 && m_platformManager) {
+        stamped.received = m_platformManager->getMonotonicTime();
+    }
+    if (stamped.timestamp == 0 || stamped.timestamp > stamped.received) {
+        stamped.timestamp = stamped.received;
+    }
+    if (isLifecycleEvent(stamped.type)) {
+        // Behind any that already overflowed, so they stay in order
+        if (m_overflowPending.load(std::memory_order_acquire) || !m_eventQueue.tryPush(stamped)) {
+            std::lock_guard<std::mutex> lock(m_overflowMutex);
+            m_overflowEvents.push_back(stamped);
+            m_overflowPending.store(true, std::memory_order_release);
+            m_overflowedEvents.fetch_add(1, std::memory_order_relaxed);
+        }
+    } else if (!m_eventQueue.push(stamped, m_overflowPolicy)) {
+        return; // Dropped; counted by the queue
+    }
+
+    if (m_coreThreadRunning.load(std::memory_order_acquire)) {
+        wakeCoreThread();
+        return;
+    }
+    drainEventQueue();
+    schedulePendingEvents();
+}
+
+void MaatMediator::notifyWakeup() {
+    if (m_coreThreadRunning.load(std::memory_order_acquire)) return; // Core thread keeps its own time
+    m_wakeupScheduled = false;
+    drainEventQueue();
+    if (!m_platformManager) {
+        processPendingEvents();
+        return;
+    }
+    const maat::platform::Timestamp now = m_platformManager->getMonotonicTime();
+    if (!m_coalescer.empty() && now >= m_pendingSince + m_coalescingWindow) {
+        processPendingEvents();
+    }
+    // After the events, so frames never hold them up
+    advanceAnimation(now);
+    reconcileGeometry(now);
+    if (!m_coalescer.empty()) armWakeup(m_pendingSince + m_coalescingWindow);
+    if (m_animator.active()) armWakeup(m_animator.nextFrameTime());
+    if (m_reconciler.pending()) armWakeup(m_reconciler.nextCheckTime());
+}
+
+// Inline mode: the platform holds one wakeup, so only an earlier deadline
+// replaces it; notifyWakeup() re-arms whatever is still due later
+void MaatMediator::armWakeup(maat::platform::Timestamp deadline) {
+    if (m_wakeupScheduled && m_wakeupDeadline <= deadline) return;
+    m_wakeupScheduled = true;
+    m_wakeupDeadline = deadline;
+    m_platformManager->scheduleWakeup(deadline);
+}
+
+void MaatMediator::setCoalescingWindow(maat::platform::Timestamp micros) {
+    m_coalescingWindow = micros;
+}
+
+void MaatMediator::setThreadingMode(ThreadingMode mode) {
+    m_threadingMode = mode;
+}
+
+void MaatMediator::setApplyThread(bool enabled) {
+    m_applyThreadEnabled = enabled;
+}
+
+void MaatMediator::setOverflowPolicy(maat::platform::OverflowPolicy policy) {
+    m_overflowPolicy = policy;
+}
+
+MaatMediator::EventQueueStats MaatMediator::eventQueueStats() const {
+    EventQueueStats stats;
+    stats.capacity = m_eventQueue.capacity();
+    stats.dropped = static_cast<std::size_t>(m_eventQueue.droppedCount());
+    stats.highWaterMark = m_queueHighWaterMark.load(std::memory_order_relaxed);
+    stats.overflowed = m_overflowedEvents.load(std::memory_order_relaxed);
+    return stats;
+}
+
+void MaatMediator::drainEventQueue() {
+    const std::size_t backlog = m_eventQueue.sizeApprox();
+    if (backlog > m_queueHighWaterMark.load(std::memory_order_relaxed)) {
+        m_queueHighWaterMark.store(backlog, std::memory_order_relaxed);
+    }
+
+    maat::platform::PlatformEvent event;
+    bool haveNow = false;
+    maat::platform::Timestamp now = 0;
+    auto consume = [&](const maat::platform::PlatformEvent& e) {
+        if (!haveNow) {
+            // One clock read per drain; later events can only be younger
+            now = m_platformManager ? m_platformManager->getMonotonicTime() : e.received;
+            haveNow = true;
+        }
+        consumeEvent(e, now);
+    };
+    while (m_eventQueue.pop(event)) {
+        consume(event);
+    }
+    // Overflowed lifecycle events are younger than everything left in the
+    // ring when they overflowed, and no lifecycle event entered it since
+    if (m_overflowPending.load(std::memory_order_acquire)) {
+        {
+            std::lock_guard<std::mutex> lock(m_overflowMutex);
+            m_overflowScratch.swap(m_overflowEvents);
+            m_overflowPending.store(false, std::memory_order_release);
+        }
+        for (const maat::platform::PlatformEvent& overflowed : m_overflowScratch) {
+            consume(overflowed);
+        }
+        m_overflowScratch.clear();
+    }
+}
+
+void MaatMediator::consumeEvent(const maat::platform::PlatformEvent& event, maat::platform::Timestamp now) {
+    m_latency.record(LatencyStage::HookDelivery, event.received - event.timestamp);
+    m_latency.record(LatencyStage::Queue, now > event.received ? now - event.received : 0);
+    if (m_coalescer.empty()) {
+        m_pendingSince = event.received; // First event opens the coalescing window
+    }
+    ++m_coalescingStats.eventsReceived;
+    if (m_traceWriter) {
+        m_traceWriter->writeEvent(event);
+    }
+    // Which window the event is about, pinned down before later events
+    // (or a reused id) can change what the id refers to
+    const WindowHandle known = m_coreManager && event.window != 0 ? m_coreManager->windowHandle(event.window)
+                                                                   : WindowHandle();
+    switch (event.type) {
+        case maat::platform::PlatformEventType::WindowCreated:
+            m_coalescer.addWindowCreated(event.window, known, event.geometry, event.timestamp);
+            break;
+        case maat::platform::PlatformEventType::WindowDestroyed:
+            m_coalescer.addWindowDestroyed(event.window, known, event.incarnation);
+            break;
+        case maat::platform::PlatformEventType::WindowMonitorChanged:
+            m_coalescer.addWindowMonitorChanged(event.window, known, event.monitor);
+            break;
+        case maat::platform::PlatformEventType::MonitorLayoutChanged:
+            m_coalescer.addMonitorLayoutChanged();
+            break;
+        case maat::platform::PlatformEventType::WindowUnmanaged:
+            m_coalescer.addWindowUnmanaged(event.window, known);
+            break;
+        case maat::platform::PlatformEventType::ConfigurationChanged:
+            m_coalescer.addConfigurationChanged();
+            break;
+    }
+}
+
+void MaatMediator::schedulePendingEvents() {
+    if (m_coalescer.empty()) return;
+    if (m_coalescingWindow == 0 || !m_platformManager) {
+        processPendingEvents();
+        return;
+    }
+    const maat::platform::Timestamp deadline = m_pendingSince + m_coalescingWindow;
+    if (m_platformManager->getMonotonicTime() >= deadline) {
+        // The wakeup is late (busy event loop); don't let a storm starve layout
+        processPendingEvents();
+    } else {
+        armWakeup(deadline);
+    }
+}
+
+void MaatMediator::processPendingEvents() {
+    if (m_coalescer.empty()) return;
+
+    m_coalescingStats.eventsDelivered += m_coalescer.pendingOperationCount();
+    ++m_coalescingStats.batches;
+
+    if (m_coalescer.monitorLayoutChanged() && m_platformManager && m_coreManager) {
+        refreshTopology(m_platformManager->getMonotonicTime());
+    }
+    if (m_coalescer.configurationChanged()) {
+        applyConfigurationChange();
+    }
+
+    for (const EventCoalescer::Entry& e : m_coalescer.entries()) {
+        // The core ignores a handle that went stale since it was drained
+        WindowHandle window = e.window;
+        if (e.actions & (EventCoalescer::kDestroy | EventCoalescer::kUnmanage | EventCoalescer::kMove)) {
+            m_animator.cancel(e.id);
+            m_reconciler.cancel(e.id);
+        }
+        if (e.actions & EventCoalescer::kDestroy) {
+            m_lastAppliedGeometry.erase(e.id);
+            m_reconciler.forget(e.id);
+            m_appearedAt.erase(e.id);
+            if (m_coreManager) m_coreManager->onWindowDestroyed(window);
+        }
+        if (e.actions & EventCoalescer::kUnmanage) {
+            m_lastAppliedGeometry.erase(e.id);
+            m_reconciler.forget(e.id);
+            m_appearedAt.erase(e.id);
+            if (m_coreManager) m_coreManager->onWindowUnmanaged(window);
+        }
+        if ((e.actions & EventCoalescer::kRelease) && m_platformManager) {
+            m_platformManager->releaseWindowTracking(e.id, e.incarnation);
+        }
+        if ((e.actions & EventCoalescer::kCreate) && m_coreManager) {
+            m_appearedAt.set(e.id, e.createdAt);
+            window = m_coreManager->onWindowCreated(e.id, e.geometry);
+        }
+        if (e.actions & EventCoalescer::kMove) {
+            // The user moved/sized the window, so its real geometry no longer
+            // matches what we last sent; forget it so the re-tile is not filtered out.
+            m_lastAppliedGeometry.erase(e.id);
+            if (m_coreManager && m_topology) {
+                m_coreManager->onWindowMonitorChanged(window, m_topology->resolve(e.monitor));
+            }
+        }
+    }
+    m_coalescer.clear();
+
+    if (m_coreManager) {
+        ++m_coalescingStats.layoutPasses;
+        m_coreManager->flushLayout();
+        if (m_platformManager) saveSessionIfDue(m_platformManager->getMonotonicTime());
+    }
+}
+
+bool MaatMediator::saveSession() {
+    if (!m_sessionStore || !m_coreManager || m_coreManager->sessionRevision() == m_savedSessionRevision) {
+        return false;
+    }
+    const std::uint64_t start = steadyMicros();
+    m_sessionBuffer.clear();
+    if (!m_coreManager->saveSession(m_sessionBuffer)) return false;
+    const std::uint64_t revision = m_coreManager->sessionRevision();
+    if (!m_sessionStore->save(m_sessionBuffer)) {
+        // Left unsaved, so the next batch past the interval tries again
+        MAAT_LOG_WARN("MaatMediator", "Session save failed", logField("bytes", m_sessionBuffer.size()));
+        return false;
+    }
+    m_savedSessionRevision = revision;
+    MAAT_LOG_DEBUG("MaatMediator", "Session saved", logField("bytes", m_sessionBuffer.size()),
+                   logField("micros", steadyMicros() - start));
+    return true;
+}
+
+// Changes are saved on the first batch after the interval has passed; the
+// last ones before shutdown are saved by run()
+void MaatMediator::saveSessionIfDue(maat::platform::Timestamp now) {
+    if (!m_sessionStore || m_coreManager->sessionRevision() == m_savedSessionRevision ||
+        now < m_lastSessionSave + kSessionSaveInterval) {
+        return;
+    }
+    m_lastSessionSave = now;
+    saveSession();
+}
+
+// --- Core thread ---
+
+void MaatMediator::startCoreThread() {
+    if (m_coreThread.joinable()) return;
+    m_stopCoreThread.store(false);
+    m_coreThreadRunning.store(true, std::memory_order_release);
+    m_coreThread = std::thread(&MaatMediator::coreThreadMain, this);
+}
+
+void MaatMediator::stopCoreThread() {
+    if (!m_coreThread.joinable()) return;
+    m_stopCoreThread.store(true);
+    {
+        std::lock_guard<std::mutex> lock(m_wakeMutex);
+        m_coreThreadSleeping.store(false);
+    }
+    m_wakeCondition.notify_one();
+    m_coreThread.join();
+    m_coreThreadRunning.store(false, std::memory_order_release);
 }
 
-void MaatMediator::notifyOsMonitorLayoutChanged() {
-    std::cout << "[MaatMediator] OS monitor layout changed\n";
-    // TODO: query PlatformManager for new layout
+void MaatMediator::wakeCoreThread() {
+    // Pairs with the fence in coreThreadMain: either the core thread sees our
+    // event before sleeping, or we see it asleep and wake it.
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (m_coreThreadSleeping.exchange(false)) {
+        std::lock_guard<std::mutex> lock(m_wakeMutex);
+        m_wakeCondition.notify_one();
+    }
+}
+
+void MaatMediator::coreThreadMain() {
+    while (!m_stopCoreThread.load()) {
+        drainEventQueue();
+
+        const bool pending = !m_coalescer.empty();
+        const bool animating = m_animator.active();
+        const maat::platform::Timestamp deadline = m_pendingSince + m_coalescingWindow;
+        maat::platform::Timestamp now = m_platformManager ? m_platformManager->getMonotonicTime() : deadline;
+        if (pending && now >= deadline) {
+            processPendingEvents();
+            continue; // More events may have arrived meanwhile
+        }
+        if (animating && now >= m_animator.nextFrameTime()) {
+            advanceAnimation(now);
+            continue; // Events that arrived during the frame go first
+        }
+        const bool checking = m_reconciler.pending();
+        if (checking && now >= m_reconciler.nextCheckTime()) {
+            reconcileGeometry(now);
+            continue;
+        }
+        maat::platform::Timestamp wake = pending ? deadline : m_animator.nextFrameTime();
+        if (pending && animating) wake = std::min(wake, m_animator.nextFrameTime());
+        if (checking) wake = (pending || animating) ? std::min(wake, m_reconciler.nextCheckTime())
+                                                    : m_reconciler.nextCheckTime();
+
+        std::unique_lock<std::mutex> lock(m_wakeMutex);
+        m_coreThreadSleeping.store(true);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if (!m_eventQueue.empty() || m_overflowPending.load() || m_stopCoreThread.load()) {
+            m_coreThreadSleeping.store(false);
+            continue;
+        }
+        auto awake = [this]() { return !m_coreThreadSleeping.load() || m_stopCoreThread.load(); };
+        if (pending || animating || checking) {
+            m_wakeCondition.wait_for(lock, std::chrono::microseconds(wake - now), awake);
+        } else {
+            m_wakeCondition.wait(lock, awake);
+        }
+        m_coreThreadSleeping.store(false);
+    }
+
+    // Deliver whatever arrived before shutdown
+    drainEventQueue();
+    processPendingEvents();
+    finishAnimations();
 }
 
 // Requests from CoreManager
 void MaatMediator::requestApplyLayout(
     const std::vector<std::pair<maat::platform::WindowId, maat::platform::Rect>>& layoutUpdates) {
-    std::cout << "[MaatMediator] Applying layout updates (" << layoutUpdates.size() << " entries)\n";
-    // TODO: forward layout commands to PlatformManager
+    MAAT_LOG_DEBUG("MaatMediator", "Applying layout updates", logField("entries", layoutUpdates.size()));
+    if (!m_platformManager) return;
+
+    const std::uint64_t diffStart = steadyMicros();
+    const bool animate = m_animator.enabled();
+    const maat::platform::Timestamp now = animate ? m_platformManager->getMonotonicTime() : 0;
+    m_filteredUpdates.clear();
+    for (const auto& update : layoutUpdates) {
+        const maat::platform::Rect* last = m_lastAppliedGeometry.find(update.first);
+        if (last && withinTolerance(*last, update.second, m_geometryTolerance)) {
+            // Keep the cached rect: drift can never exceed the tolerance
+            ++m_droppedGeometryUpdates;
+            continue;
+        }
+        if (animate && last) {
+            m_animator.start(update.first, *last, update.second, now);
+            m_reconciler.cancel(update.first); // checked once it lands
+        } else {
+            if (m_animator.active()) m_animator.cancel(update.first);
+            m_filteredUpdates.push_back(update);
+        }
+        m_lastAppliedGeometry.set(update.first, update.second);
+    }
+    const std::uint64_t applyStart = steadyMicros();
+    m_latency.record(LatencyStage::Diff, applyStart - diffStart);
+    if (m_animator.active() && !m_coreThreadRunning.load(std::memory_order_acquire)) {
+        armWakeup(m_animator.nextFrameTime());
+    }
+
+    if (m_filteredUpdates.empty()) return;
+    applyGeometries(m_filteredUpdates);
+    m_latency.record(LatencyStage::Apply, steadyMicros() - applyStart);
+
+    if (!m_appearedAt.empty()) {
+        // First geometry for newly created windows: close their appeared -> tiled span
+        const maat::platform::Timestamp now = m_platformManager->getMonotonicTime();
+        for (const auto& update : m_filteredUpdates) {
+            if (const maat::platform::Timestamp* appeared = m_appearedAt.find(update.first)) {
+                m_latency.record(LatencyStage::WindowTiled, now > *appeared ? now - *appeared : 0);
+                m_appearedAt.erase(update.first);
+            }
+        }
+    }
+}
+
+void MaatMediator::requestWindowVisibility(
+    const std::vector<std::pair<maat::platform::WindowId, bool>>& changes) {
+    MAAT_LOG_DEBUG("MaatMediator", "Applying visibility changes", logField("entries", changes.size()));
+    if (!m_platformManager || changes.empty()) return;
+    if (m_animator.active()) {
+        // Windows shown or hidden land on their targets first
+        m_frameUpdates.clear();
+        for (const auto& change : changes) {
+            maat::platform::Rect target;
+            if (m_animator.cancel(change.first, &target)) m_frameUpdates.emplace_back(change.first, target);
+        }
+        if (!m_frameUpdates.empty()) applyGeometries(m_frameUpdates);
+    }
+    applyVisibility(changes);
+}
+
+void MaatMediator::setAnimation(const AnimationSettings& settings) {
+    if (!settings.enabled) finishAnimations();
+    m_animator.setSettings(settings);
+    MAAT_LOG_INFO("MaatMediator", "Animation set", logField("enabled", settings.enabled),
+                  logField("fps", m_animator.settings().frameRate), logField("duration_us", settings.duration),
+                  logField("budget_us", settings.frameBudget));
+}
+
+void MaatMediator::advanceAnimation(maat::platform::Timestamp now) {
+    if (!m_animator.active() || now < m_animator.nextFrameTime()) return;
+    const std::uint64_t start = steadyMicros();
+    m_frameUpdates.clear();
+    m_animator.frame(now, m_frameUpdates);
+    if (!m_frameUpdates.empty()) applyGeometries(m_frameUpdates);
+    m_animator.recordFrameCost(steadyMicros() - start);
+}
+
+void MaatMediator::finishAnimations() {
+    if (!m_animator.active()) return;
+    m_frameUpdates.clear();
+    m_animator.finish(m_frameUpdates);
+    if (m_platformManager) applyGeometries(m_frameUpdates);
+}
+
+void MaatMediator::applyGeometries(
+    const std::vector<std::pair<maat::platform::WindowId, maat::platform::Rect>>& updates) {
+    std::uint64_t sequence = 0;
+    if (m_applyStage && m_applyStage->running()) {
+        sequence = m_applyStage->submitGeometry(updates);
+    } else {
+        m_platformManager->applyWindowGeometries(updates);
+    }
+    if (!m_reconciler.settings().enabled) return;
+    // Only rects the windows are meant to keep are read back, not animation frames
+    const maat::platform::Timestamp now = m_platformManager->getMonotonicTime();
+    for (const auto& update : updates) {
+        const maat::platform::Rect* target = m_lastAppliedGeometry.find(update.first);
+        if (target && withinTolerance(*target, update.second, 0)) {
+            m_reconciler.expect(update.first, update.second, now, sequence);
+        }
+    }
+    if (m_reconciler.pending() && !m_coreThreadRunning.load(std::memory_order_acquire)) {
+        armWakeup(m_reconciler.nextCheckTime());
+    }
+}
+
+void MaatMediator::setReconciliation(const ReconcileSettings& settings) {
+    m_reconciler.setSettings(settings);
+    MAAT_LOG_INFO("MaatMediator", "Geometry reconciliation set", logField("enabled", settings.enabled),
+                  logField("settle_us", settings.settleDelay), logField("snap_px", settings.snapTolerance),
+                  logField("budget", m_reconciler.settings().retryBudget),
+                  logField("cooldown_us", settings.cooldown));
+}
+
+// Reads back the windows whose checks are due and answers their refusals.
+// Learned limits re-lay out the windows concerned in one pass; their rects
+// go through applyGeometries() and are checked in turn, which the retry
+// budget bounds.
+void MaatMediator::reconcileGeometry(maat::platform::Timestamp now) {
+    if (!m_reconciler.pending() || now < m_reconciler.nextCheckTime() || !m_platformManager) return;
+    m_reconcileRequested.clear();
+    const std::uint64_t applied = (m_applyStage && m_applyStage->running())
+                                      ? m_applyStage->appliedSequence()
+                                      : std::numeric_limits<std::uint64_t>::max();
+    m_reconciler.takeDue(now, applied, m_reconcileRequested);
+    if (m_reconcileRequested.empty()) return;
+    m_reconcileActual = m_reconcileRequested;
+    m_platformManager->queryWindowGeometries(m_reconcileActual);
+
+    bool relayout = false;
+    std::size_t found = 0; // the query keeps the order, dropping windows that are gone
+    for (const auto& request : m_reconcileRequested) {
+        if (found == m_reconcileActual.size() || m_reconcileActual[found].first != request.first) continue;
+        const maat::platform::Rect& actual = m_reconcileActual[found++].second;
+        const maat::platform::Rect* target = m_lastAppliedGeometry.find(request.first);
+        if (!target || !withinTolerance(*target, request.second, 0)) continue; // retargeted since
+        const GeometryReconciler::Outcome outcome = m_reconciler.reconcile(request.first, request.second, actual, now);
+        if (outcome == GeometryReconciler::Outcome::Accepted) continue;
+        MAAT_LOG_DEBUG("MaatMediator", "Window refused its rect", logField("window", request.first),
+                       logField("outcome", static_cast<int>(outcome)), logField("width", actual.width),
+                       logField("height", actual.height));
+        // The window is where it is; a layout rect within the tolerance of
+        // that is not worth sending
+        m_lastAppliedGeometry.set(request.first, actual);
+        if (outcome == GeometryReconciler::Outcome::Limited && m_coreManager) {
+            relayout |= m_coreManager->setWindowSizeLimits(request.first, *m_reconciler.limits(request.first));
+        }
+    }
+    if (relayout) m_coreManager->flushLayout();
+}
+
+void MaatMediator::applyVisibility(const std::vector<std::pair<maat::platform::WindowId, bool>>& changes) {
+    if (m_applyStage && m_applyStage->running()) {
+        m_applyStage->submitVisibility(changes);
+    } else {
+        m_platformManager->setWindowVisibility(changes);
+    }
+}
+
+void MaatMediator::recordLatency(LatencyStage stage, maat::platform::Timestamp micros) {
+    m_latency.record(stage, micros);
+}
+
+void MaatMediator::logLatencyReport() const {
+    for (std::size_t i = 0; i < LatencyRecorder::kStageCount; ++i) {
+        const LatencyStage stage = static_cast<LatencyStage>(i);
+        const LatencyHistogram& h = m_latency.histogram(stage);
+        MAAT_LOG_INFO("MaatMediator", "Latency (us)", logField("stage", LatencyRecorder::stageName(stage)),
+                      logField("count", h.count()), logField("p50", h.percentile(0.50)),
+                      logField("p99", h.percentile(0.99)), logField("p999", h.percentile(0.999)),
+                      logField("max", h.max()));
+    }
+}
+
+void MaatMediator::setTraceWriter(EventTraceWriter* writer) {
+    m_traceWriter = writer;
+}
+
+// Snapshots the platform's current monitors and hands the core what changed.
+// The platform view is traced either way so a replay sees the same work areas.
+void MaatMediator::refreshTopology(maat::platform::Timestamp time) {
+    m_platformMonitors.clear();
+    for (auto* monitor : m_platformManager->enumerateMonitors()) {
+        m_platformMonitors.push_back({monitor->getId(), monitor->getWorkArea()});
+    }
+    if (m_traceWriter) {
+        m_traceWriter->writeMonitorSnapshot(time, m_platformMonitors);
+    }
+    std::shared_ptr<const MonitorTopology> next = MonitorTopology::build(m_topology.get(), m_platformMonitors);
+    const TopologyDiff diff = diffTopology(m_topology.get(), *next);
+    if (m_topology && diff.empty()) {
+        // Still published: a monitor may have kept its identity under a new handle
+        ++m_unchangedTopologies;
+        MAAT_LOG_DEBUG("MaatMediator", "Monitor topology unchanged", logField("version", next->version()));
+    } else {
+        ++m_topologyChanges;
+        m_coreManager->setTopology(*next, diff);
+    }
+    std::atomic_store(&m_topology, std::shared_ptr<const MonitorTopology>(std::move(next)));
+}
+
+void MaatMediator::setGeometryTolerance(int pixels) {
+    m_geometryTolerance = pixels > 0 ? pixels : 0;
 }
 
 // Lifecycle control (called by main)
 void MaatMediator::initialize() {
-    std::cout << "[MaatMediator] Initialization started\n";
-    // TODO: perform any setup before event loop
-    if (m_platformManager) {
-        auto initialWindows = m_platformManager->enumerateInitialWindows();
+    MAAT_LOG_INFO("MaatMediator", "Initialization started");
+    if (m_platformManager && m_coreManager) {
+        const std::uint64_t start = steadyMicros();
+        const maat::platform::Timestamp now = m_platformManager->getMonotonicTime();
+        // Defaults first: the topology creates the first workspaces, and the
+        // rules must be in place before discovery classifies anything
+        const std::shared_ptr<const CompiledConfig> config =
+            m_configuration ? m_configuration->current() : std::shared_ptr<const CompiledConfig>();
+        if (config) {
+            setWindowRules(config->ruleSet);
+            m_coreManager->setDefaultLayout(config->layout, config->layoutParams);
+            m_animator.setSettings(config->animation);
+            m_appliedConfig = config;
+        }
+
+        // Window discovery runs beside monitor enumeration and the session
+        // load; they share no state until the join (the core has no windows,
+        // so the topology pass sends the platform nothing)
+        std::future<std::vector<maat::platform::Window*>> discovery =
+            std::async(std::launch::async, [this]() {
+                const std::uint64_t discoveryStart = steadyMicros();
+                std::vector<maat::platform::Window*> found = m_platformManager->enumerateInitialWindows();
+                m_startupStats.discoveryMicros = steadyMicros() - discoveryStart;
+                return found;
+            });
+        refreshTopology(now);
+        const std::uint64_t topologyDone = steadyMicros();
+        const bool haveSession = m_sessionStore && m_sessionStore->load();
+        const std::uint64_t sessionLoaded = steadyMicros();
+        const std::vector<maat::platform::Window*> initialWindows = discovery.get();
+
+        // Route initial windows straight to the core, back into their saved
+        // places if a session was kept, and lay out once
+        std::vector<std::pair<maat::platform::WindowId, maat::platform::Rect>> windows;
+        windows.reserve(initialWindows.size());
         for (auto* window : initialWindows) {
-            notifyOsWindowCreated(window);
+            windows.emplace_back(window->getId(), window->getGeometry());
+            if (m_traceWriter) {
+                m_traceWriter->writeInitialWindow(now, windows.back().first, windows.back().second);
+            }
         }
+        const std::uint64_t adoptStart = steadyMicros();
+        m_restoredWindows = m_coreManager->restoreSession(windows, haveSession ? m_sessionStore->data() : nullptr,
+                                                          haveSession ? m_sessionStore->size() : 0);
+        if (m_sessionStore) m_sessionStore->release();
+        const std::uint64_t adopted = steadyMicros();
+        m_coreManager->flushLayout();
+        const std::uint64_t laidOut = steadyMicros();
+
+        m_startupStats.windows = windows.size();
+        m_startupStats.topologyMicros = topologyDone - start;
+        m_startupStats.sessionLoadMicros = sessionLoaded - topologyDone;
+        m_startupStats.adoptMicros = adopted - adoptStart;
+        m_startupStats.layoutMicros = laidOut - adopted;
+        m_startupStats.totalMicros = laidOut - start;
+        MAAT_LOG_INFO("MaatMediator", "Startup complete", logField("windows", windows.size()),
+                      logField("topology_us", m_startupStats.topologyMicros),
+                      logField("discovery_us", m_startupStats.discoveryMicros),
+                      logField("classify_us", m_startupStats.classifyMicros),
+                      logField("layout_us", m_startupStats.adoptMicros + m_startupStats.layoutMicros),
+                      logField("total_us", m_startupStats.totalMicros));
+
+        // The reconciled arrangement; not rewritten if it matches the snapshot
+        saveSession();
+        m_lastSessionSave = now;
     }
 }
 
 void MaatMediator::run() {
-    std::cout << "[MaatMediator] Running main loop\n";
+    MAAT_LOG_INFO("MaatMediator", "Running main loop");
     if (m_platformManager) {
+        if (m_applyThreadEnabled) {
+            if (!m_applyStage) m_applyStage.reset(new GeometryApplyStage(*m_platformManager));
+            m_applyStage->start();
+        }
+        if (m_threadingMode == ThreadingMode::DedicatedThread) {
+            startCoreThread();
+        }
         m_platformManager->startEventLoop();
+        stopCoreThread();
+        // Inline mode: flush anything still inside a coalescing window
+        drainEventQueue();
+        processPendingEvents();
+        finishAnimations();
+        if (m_coreManager) {
+            saveSession();
+            m_coreManager->revealHiddenWindows();
+        }
+        if (m_applyStage) {
+            m_applyStage->stop();
+            const GeometryApplyStage::Stats stats = m_applyStage->stats();
+            MAAT_LOG_INFO("MaatMediator", "Apply thread stopped", logField("batches", stats.batches),
+                          logField("applied", stats.applied), logField("superseded", stats.superseded),
+                          logField("max_batch", stats.maxBatchSize),
+                          logField("apply_p99_us", m_applyStage->applyMicros().percentile(0.99)),
+                          logField("apply_max_us", m_applyStage->applyMicros().max()));
+        }
     } else {
-        std::cerr << "[MaatMediator] No PlatformManager to start event loop\n";
+        MAAT_LOG_ERROR("MaatMediator", "No PlatformManager to start event loop");
     }
 }
 
 void MaatMediator::shutdown() {
-    std::cout << "[MaatMediator] Shutdown initiated\n";
+    MAAT_LOG_INFO("MaatMediator", "Shutdown initiated");
     if (m_platformManager) {
         m_platformManager->stopEventLoop();
     } else {
-        std::cerr << "[MaatMediator] No PlatformManager to stop event loop\n";
+        MAAT_LOG_ERROR("MaatMediator", "No PlatformManager to stop event loop");
     }
 }
 
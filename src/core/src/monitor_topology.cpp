@@ -0,0 +1,112 @@
+#include "maat_core/monitor_topology.h"
+
+namespace maat {
+namespace core {
+
+using maat::platform::MonitorId;
+using maat::platform::Rect;
+
+std::shared_ptr<const MonitorTopology> MonitorTopology::build(const MonitorTopology* previous,
+                                                              const std::vector<MonitorArea>& platformMonitors) {
+    std::shared_ptr<MonitorTopology> next(new MonitorTopology());
+    next->m_version = previous ? previous->m_version + 1 : 1;
+    next->m_monitors.reserve(platformMonitors.size());
+    next->m_platformIds.reserve(platformMonitors.size());
+
+    // Monitor counts are tiny; plain scans beat any index here
+    const std::size_t previousCount = previous ? previous->m_monitors.size() : 0;
+    std::vector<bool> inherited(previousCount, false);
+    std::vector<bool> handleSurvives(previousCount, false);
+    std::vector<MonitorId> stableIds(platformMonitors.size(), 0);
+
+    // 1. Same platform handle: same monitor
+    for (std::size_t i = 0; i < platformMonitors.size(); ++i) {
+        for (std::size_t p = 0; p < previousCount; ++p) {
+            if (previous->m_platformIds[p] == platformMonitors[i].id) {
+                stableIds[i] = previous->m_monitors[p].id;
+                inherited[p] = true;
+                handleSurvives[p] = true;
+                break;
+            }
+        }
+    }
+    // 2. New handle in the place of a vanished one with the same work area
+    for (std::size_t i = 0; i < platformMonitors.size(); ++i) {
+        if (stableIds[i] != 0) continue;
+        for (std::size_t p = 0; p < previousCount; ++p) {
+            if (!inherited[p] && !handleSurvives[p] &&
+                previous->m_monitors[p].workArea == platformMonitors[i].workArea) {
+                stableIds[i] = previous->m_monitors[p].id;
+                inherited[p] = true;
+                break;
+            }
+        }
+    }
+    // 3. Genuinely new monitors take their platform handle as identity,
+    //    unless a surviving identity already uses that value
+    auto inUse = [&](MonitorId id) {
+        for (MonitorId stable : stableIds) {
+            if (stable == id) return true;
+        }
+        for (std::size_t p = 0; p < previousCount; ++p) {
+            if (inherited[p] && previous->m_monitors[p].id == id) return true;
+        }
+        return false;
+    };
+    for (std::size_t i = 0; i < platformMonitors.size(); ++i) {
+        if (stableIds[i] != 0) continue;
+        MonitorId id = platformMonitors[i].id != 0 ? platformMonitors[i].id : 1;
+        while (inUse(id)) ++id;
+        stableIds[i] = id;
+    }
+
+    for (std::size_t i = 0; i < platformMonitors.size(); ++i) {
+        next->m_monitors.push_back({stableIds[i], platformMonitors[i].workArea});
+        next->m_platformIds.push_back(platformMonitors[i].id);
+    }
+    return next;
+}
+
+const MonitorArea* MonitorTopology::find(MonitorId id) const {
+    for (const MonitorArea& monitor : m_monitors) {
+        if (monitor.id == id) return &monitor;
+    }
+    return nullptr;
+}
+
+MonitorId MonitorTopology::resolve(MonitorId platformId) const {
+    for (std::size_t i = 0; i < m_platformIds.size(); ++i) {
+        if (m_platformIds[i] == platformId) return m_monitors[i].id;
+    }
+    return 0;
+}
+
+TopologyDiff diffTopology(const MonitorTopology* from, const MonitorTopology& to) {
+    TopologyDiff diff;
+    std::size_t kept = 0;
+    for (const MonitorArea& monitor : to.monitors()) {
+        const MonitorArea* old = from ? from->find(monitor.id) : nullptr;
+        if (!old) {
+            diff.added.push_back(monitor.id);
+            continue;
+        }
+        if (old->workArea != monitor.workArea) {
+            diff.resized.push_back(monitor.id);
+        }
+        // Order only matters among monitors present in both snapshots
+        while (kept < from->monitors().size() && !to.find(from->monitors()[kept].id)) ++kept;
+        if (kept < from->monitors().size() && from->monitors()[kept].id != monitor.id) {
+            diff.reordered = true;
+        }
+        ++kept;
+    }
+    if (from) {
+        for (const MonitorArea& monitor : from->monitors()) {
+            if (!to.find(monitor.id)) diff.removed.push_back(monitor.id);
+        }
+    }
+    return diff;
+}
+
+} // namespace core
+} // namespace maat
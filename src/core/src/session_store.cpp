@@ -0,0 +1,78 @@
+#include "maat_core/session_store.h"
+
+#include <cstring>
+#include <utility>
+
+#include "maat_core/binary_codec.h"
+#include "maat_core/log.h"
+
+namespace maat {
+namespace core {
+
+namespace {
+
+const char kSessionMagic[8] = {'M', 'A', 'A', 'T', 'S', 'E', 'S', '\0'};
+const std::size_t kSessionHeaderSize = 24;
+
+} // namespace
+
+SessionStore::SessionStore(std::string path) : m_path(std::move(path)) {
+}
+
+bool SessionStore::load() {
+    release();
+    if (!m_file.open(m_path)) return false;
+    const std::uint8_t* data = m_file.data();
+    const std::size_t size = m_file.size();
+    if (size < kSessionHeaderSize || std::memcmp(data, kSessionMagic, sizeof(kSessionMagic)) != 0 ||
+        codec::readU32(data + 8) != kFormatVersion) {
+        MAAT_LOG_INFO("SessionStore", "Session snapshot of another format; ignored", logField("path", m_path));
+        release();
+        return false;
+    }
+    const std::uint64_t hash = codec::readU64(data + 16);
+    if (codec::hashBytes(data + kSessionHeaderSize, size - kSessionHeaderSize) != hash) {
+        MAAT_LOG_WARN("SessionStore", "Session snapshot corrupt; ignored", logField("path", m_path));
+        release();
+        return false;
+    }
+    m_body = data + kSessionHeaderSize;
+    m_bodySize = size - kSessionHeaderSize;
+    m_lastHash = hash;
+    m_haveLastHash = true;
+    return true;
+}
+
+void SessionStore::release() {
+    m_file.close();
+    m_body = nullptr;
+    m_bodySize = 0;
+}
+
+bool SessionStore::save(const std::vector<std::uint8_t>& body) {
+    const std::uint64_t hash = codec::hashBytes(body.data(), body.size());
+    if (m_haveLastHash && hash == m_lastHash) {
+        ++m_skippedSaves;
+        return true;
+    }
+    release(); // A mapped file cannot be replaced on Windows
+
+    m_buffer.clear();
+    m_buffer.insert(m_buffer.end(), kSessionMagic, kSessionMagic + sizeof(kSessionMagic));
+    codec::putU32(m_buffer, kFormatVersion);
+    codec::putU32(m_buffer, 0);
+    codec::putU64(m_buffer, hash);
+    m_buffer.insert(m_buffer.end(), body.begin(), body.end());
+    if (!replaceFile(m_path, m_buffer)) {
+        MAAT_LOG_WARN("SessionStore", "Cannot write session snapshot", logField("path", m_path));
+        return false;
+    }
+    m_lastHash = hash;
+    m_haveLastHash = true;
+    ++m_saves;
+    MAAT_LOG_DEBUG("SessionStore", "Session snapshot written", logField("bytes", m_buffer.size()));
+    return true;
+}
+
+} // namespace core
+} // namespace maat
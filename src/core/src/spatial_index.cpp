@@ -0,0 +1,323 @@
+#include "maat_core/spatial_index.h"
+
+#include <algorithm>
+
+namespace maat {
+namespace core {
+
+using maat::platform::Rect;
+using maat::platform::WindowId;
+
+namespace {
+
+constexpr int kMinCellSize = 16;
+
+bool containsPoint(const Rect& rect, int x, int y) {
+    return x >= rect.x && x < rect.x + rect.width && y >= rect.y && y < rect.y + rect.height;
+}
+
+bool intersects(const Rect& a, const Rect& b) {
+    return a.x < b.x + b.width && b.x < a.x + a.width && a.y < b.y + b.height && b.y < a.y + a.height;
+}
+
+void eraseId(std::vector<WindowId>& ids, WindowId id) {
+    const auto it = std::find(ids.begin(), ids.end(), id);
+    if (it == ids.end()) return;
+    *it = ids.back();
+    ids.pop_back();
+}
+
+// How a candidate compares from one window in one direction; lower is better
+struct Score {
+    long long distance; // gap along the direction plus miss across it
+    int shared;         // length of the facing edges that overlap
+    WindowId id;
+
+    bool betterThan(const Score& other) const {
+        if (distance != other.distance) return distance < other.distance;
+        if (shared != other.shared) return shared > other.shared;
+        return id < other.id;
+    }
+};
+
+// Scores `candidate` as a neighbour of `from` in `direction`; false if it
+// does not lie that way
+bool scoreCandidate(const Rect& from, const Rect& candidate, Direction direction, Score& score) {
+    const bool horizontal = direction == Direction::Left || direction == Direction::Right;
+    const bool forward = direction == Direction::Right || direction == Direction::Down;
+    const int fromStart = horizontal ? from.x : from.y;
+    const int fromEnd = fromStart + (horizontal ? from.width : from.height);
+    const int start = horizontal ? candidate.x : candidate.y;
+    const int end = start + (horizontal ? candidate.width : candidate.height);
+    long long gap;
+    if (forward) {
+        // Past the edge, or overlapping with its centre past it
+        if (start < fromEnd && start + end <= 2 * fromEnd) return false;
+        gap = start - fromEnd;
+    } else {
+        if (end > fromStart && start + end >= 2 * fromStart) return false;
+        gap = fromStart - end;
+    }
+    const int acrossStart = horizontal ? from.y : from.x;
+    const int acrossEnd = acrossStart + (horizontal ? from.height : from.width);
+    const int candidateStart = horizontal ? candidate.y : candidate.x;
+    const int candidateEnd = candidateStart + (horizontal ? candidate.height : candidate.width);
+    const int shared = std::min(acrossEnd, candidateEnd) - std::max(acrossStart, candidateStart);
+    score.distance = (gap > 0 ? gap : 0) + (shared < 0 ? -shared : 0);
+    score.shared = shared > 0 ? shared : 0;
+    return true;
+}
+
+} // namespace
+
+SpatialIndex::SpatialIndex(int cellSize) : m_cellSize(std::max(cellSize, kMinCellSize)) {}
+
+void SpatialIndex::setRegions(const std::vector<Rect>& regions) {
+    m_regions.clear();
+    m_cells.clear();
+    m_outside.clear();
+    std::size_t cells = 0;
+    for (const Rect& area : regions) {
+        if (area.width <= 0 || area.height <= 0) continue;
+        const int columns = (area.width + m_cellSize - 1) / m_cellSize;
+        const int rows = (area.height + m_cellSize - 1) / m_cellSize;
+        m_regions.push_back({area, columns, rows, cells});
+        cells += static_cast<std::size_t>(columns) * static_cast<std::size_t>(rows);
+    }
+    m_cells.resize(cells);
+
+    std::vector<WindowId> ids;
+    ids.reserve(m_entries.size());
+    m_entries.forEach([&ids](WindowId id, const Entry&) { ids.push_back(id); });
+    for (WindowId id : ids) {
+        link(id, *m_entries.find(id));
+    }
+}
+
+void SpatialIndex::update(WindowId id, const Rect& rect) {
+    if (rect.width <= 0 || rect.height <= 0) {
+        remove(id); // Covers no point; no query should report it
+        return;
+    }
+    const std::pair<Entry*, bool> slot = m_entries.insert(id, Entry{rect, kOutside, 0});
+    if (!slot.second) {
+        const Rect& old = slot.first->rect;
+        if (old == rect) return;
+        unlink(id, *slot.first);
+        slot.first->rect = rect;
+    }
+    link(id, *slot.first);
+}
+
+void SpatialIndex::remove(WindowId id) {
+    const Entry* entry = m_entries.find(id);
+    if (!entry) return;
+    unlink(id, *entry);
+    m_entries.erase(id);
+}
+
+void SpatialIndex::clear() {
+    for (std::vector<WindowId>& cell : m_cells) {
+        cell.clear();
+    }
+    m_outside.clear();
+    m_entries.clear();
+}
+
+const Rect* SpatialIndex::rect(WindowId id) const {
+    const Entry* entry = m_entries.find(id);
+    return entry ? &entry->rect : nullptr;
+}
+
+WindowId SpatialIndex::windowAt(int x, int y) const {
+    WindowId best = 0;
+    auto consider = [this, x, y, &best](WindowId id) {
+        if ((best == 0 || id < best) && containsPoint(m_entries.find(id)->rect, x, y)) best = id;
+    };
+    for (const Region& region : m_regions) {
+        if (!containsPoint(region.area, x, y)) continue;
+        const int column = (x - region.area.x) / m_cellSize;
+        const int row = (y - region.area.y) / m_cellSize;
+        for (WindowId id : m_cells[region.firstCell + static_cast<std::size_t>(row * region.columns + column)]) {
+            consider(id);
+        }
+        break; // work areas do not overlap
+    }
+    for (WindowId id : m_outside) {
+        consider(id);
+    }
+    return best;
+}
+
+void SpatialIndex::overlapping(const Rect& rect, std::vector<WindowId>& out) const {
+    if (rect.width <= 0 || rect.height <= 0) return;
+    const std::uint32_t stamp = nextStamp();
+    auto consider = [this, &rect, &out, stamp](WindowId id) {
+        const Entry& entry = *m_entries.find(id);
+        if (entry.stamp == stamp) return;
+        entry.stamp = stamp;
+        if (intersects(entry.rect, rect)) out.push_back(id);
+    };
+    for (const Region& region : m_regions) {
+        int column0, row0, column1, row1;
+        if (!cellRange(region, rect, column0, row0, column1, row1)) continue;
+        for (int row = row0; row <= row1; ++row) {
+            for (int column = column0; column <= column1; ++column) {
+                for (WindowId id : m_cells[region.firstCell + static_cast<std::size_t>(row * region.columns + column)]) {
+                    consider(id);
+                }
+            }
+        }
+    }
+    for (WindowId id : m_outside) {
+        consider(id);
+    }
+}
+
+WindowId SpatialIndex::neighbour(WindowId id, Direction direction) const {
+    const Entry* origin = m_entries.find(id);
+    if (!origin) return 0;
+    const Rect from = origin->rect;
+    const std::uint32_t stamp = nextStamp();
+    origin->stamp = stamp;
+    bool found = false;
+    Score best{0, 0, 0};
+    auto consider = [this, &from, direction, stamp, &found, &best](WindowId candidate) {
+        const Entry& entry = *m_entries.find(candidate);
+        if (entry.stamp == stamp) return;
+        entry.stamp = stamp;
+        Score score{0, 0, candidate};
+        if (scoreCandidate(from, entry.rect, direction, score) && (!found || score.betterThan(best))) {
+            best = score;
+            found = true;
+        }
+    };
+
+    // Walk the lines of cells (columns going left or right, rows going up or
+    // down) outward from the edge, and each line outward from the span the
+    // window covers across it. A cell's distance from the edge bounds the
+    // score of any window first met in it, so the walk skips cells beyond the
+    // best candidate and ends at the first line that is.
+    const bool horizontal = direction == Direction::Left || direction == Direction::Right;
+    const bool forward = direction == Direction::Right || direction == Direction::Down;
+    const int edge = forward ? (horizontal ? from.x + from.width : from.y + from.height) : (horizontal ? from.x : from.y);
+    const int spanStart = horizontal ? from.y : from.x;
+    const int spanEnd = spanStart + (horizontal ? from.height : from.width);
+    const long long cell = m_cellSize;
+    for (const Region& region : m_regions) {
+        const int start = horizontal ? region.area.x : region.area.y;
+        const int end = start + (horizontal ? region.area.width : region.area.height);
+        const int lines = horizontal ? region.columns : region.rows;
+        const int across = horizontal ? region.rows : region.columns;
+        const int acrossOrigin = horizontal ? region.area.y : region.area.x;
+        int line;
+        if (forward) {
+            if (edge >= end) continue;
+            line = edge <= start ? 0 : (edge - start) / m_cellSize;
+        } else {
+            if (edge <= start) continue;
+            line = edge > end ? lines - 1 : (edge - 1 - start) / m_cellSize;
+        }
+        // Cells across that the window's span covers (clamped into the grid)
+        const int first = std::min(std::max((spanStart - acrossOrigin) / m_cellSize, 0), across - 1);
+        const int last = std::min(std::max((spanEnd - 1 - acrossOrigin) / m_cellSize, first), across - 1);
+        for (; line >= 0 && line < lines; line += forward ? 1 : -1) {
+            const long long nearest = forward ? start + line * cell - edge : edge - start - (line + 1) * cell;
+            if (found && nearest > best.distance) break;
+            // Scans cell `a` of the line unless it is farther than the best; false if it was
+            auto visit = [&](int a) {
+                const long long cellStart = acrossOrigin + a * cell;
+                const long long miss = std::max(std::max(cellStart - spanEnd, spanStart - (cellStart + cell)), 0LL);
+                if (found && std::max(nearest, 0LL) + miss > best.distance) return false;
+                const int row = horizontal ? a : line;
+                const int column = horizontal ? line : a;
+                for (WindowId candidate :
+                     m_cells[region.firstCell + static_cast<std::size_t>(row * region.columns + column)]) {
+                    consider(candidate);
+                }
+                return true;
+            };
+            for (int a = first; a <= last; ++a) {
+                visit(a);
+            }
+            for (int a = first - 1; a >= 0 && visit(a); --a) {
+            }
+            for (int a = last + 1; a < across && visit(a); ++a) {
+            }
+        }
+    }
+    for (WindowId candidate : m_outside) {
+        consider(candidate);
+    }
+    return found ? best.id : 0;
+}
+
+bool SpatialIndex::cellRange(const Region& region, const Rect& rect, int& column0, int& row0, int& column1,
+                             int& row1) const {
+    const Rect& area = region.area;
+    const int x0 = std::max(rect.x, area.x);
+    const int y0 = std::max(rect.y, area.y);
+    const int x1 = std::min(rect.x + rect.width, area.x + area.width);
+    const int y1 = std::min(rect.y + rect.height, area.y + area.height);
+    if (x0 >= x1 || y0 >= y1) return false;
+    column0 = (x0 - area.x) / m_cellSize;
+    row0 = (y0 - area.y) / m_cellSize;
+    column1 = (x1 - 1 - area.x) / m_cellSize;
+    row1 = (y1 - 1 - area.y) / m_cellSize;
+    return true;
+}
+
+void SpatialIndex::link(WindowId id, Entry& entry) {
+    entry.region = regionOf(entry.rect);
+    if (entry.region == kOutside) {
+        m_outside.push_back(id);
+        return;
+    }
+    const Region& region = m_regions[entry.region];
+    int column0, row0, column1, row1;
+    cellRange(region, entry.rect, column0, row0, column1, row1);
+    for (int row = row0; row <= row1; ++row) {
+        for (int column = column0; column <= column1; ++column) {
+            m_cells[region.firstCell + static_cast<std::size_t>(row * region.columns + column)].push_back(id);
+        }
+    }
+}
+
+void SpatialIndex::unlink(WindowId id, const Entry& entry) {
+    if (entry.region == kOutside) {
+        eraseId(m_outside, id);
+        return;
+    }
+    const Region& region = m_regions[entry.region];
+    int column0, row0, column1, row1;
+    cellRange(region, entry.rect, column0, row0, column1, row1);
+    for (int row = row0; row <= row1; ++row) {
+        for (int column = column0; column <= column1; ++column) {
+            eraseId(m_cells[region.firstCell + static_cast<std::size_t>(row * region.columns + column)], id);
+        }
+    }
+}
+
+std::uint32_t SpatialIndex::regionOf(const Rect& rect) const {
+    if (rect.width <= 0 || rect.height <= 0) return kOutside;
+    for (std::uint32_t i = 0; i < m_regions.size(); ++i) {
+        const Rect& area = m_regions[i].area;
+        if (rect.x >= area.x && rect.y >= area.y && rect.x + rect.width <= area.x + area.width &&
+            rect.y + rect.height <= area.y + area.height) {
+            return i;
+        }
+    }
+    return kOutside;
+}
+
+std::uint32_t SpatialIndex::nextStamp() const {
+    if (++m_stamp == 0) {
+        // Wrapped: stamps left from 2^32 queries ago would read as visited
+        m_entries.forEach([](WindowId, const Entry& entry) { entry.stamp = 0; });
+        m_stamp = 1;
+    }
+    return m_stamp;
+}
+
+} // namespace core
+} // namespace maat
@@ -0,0 +1,122 @@
+#include "maat_core/window_registry.h"
+
+#include <cassert>
+
+namespace maat {
+namespace core {
+
+using maat::platform::SizeHints;
+using maat::platform::WindowId;
+
+namespace {
+
+bool hasLimits(const SizeHints& limits) {
+    return limits.minWidth > 0 || limits.minHeight > 0 || limits.maxWidth > 0 || limits.maxHeight > 0;
+}
+
+} // namespace
+
+WindowRegistry::WindowRegistry(std::size_t reserveWindows) : m_slotById(reserveWindows * 2) {
+    m_slots.reserve(reserveWindows);
+    m_ids.reserve(reserveWindows);
+    m_states.reserve(reserveWindows);
+    m_monitors.reserve(reserveWindows);
+    m_workspaces.reserve(reserveWindows);
+    m_geometries.reserve(reserveWindows);
+    m_flags.reserve(reserveWindows);
+    m_layoutNodes.reserve(reserveWindows);
+    m_sizeLimits.reserve(reserveWindows);
+    m_denseToSlot.reserve(reserveWindows);
+}
+
+WindowHandle WindowRegistry::add(WindowId id) {
+    if (const std::uint32_t* existing = m_slotById.find(id)) {
+        return {*existing, m_slots[*existing].generation};
+    }
+
+    std::uint32_t slot;
+    if (!m_freeSlots.empty()) {
+        slot = m_freeSlots.back();
+        m_freeSlots.pop_back();
+    } else {
+        slot = static_cast<std::uint32_t>(m_slots.size());
+        m_slots.emplace_back();
+    }
+
+    const std::uint32_t denseIndex = static_cast<std::uint32_t>(m_ids.size());
+    m_slots[slot].dense = denseIndex;
+    m_ids.push_back(id);
+    m_states.push_back(WindowState::Unplaced);
+    m_monitors.push_back(0);
+    m_workspaces.push_back(0);
+    m_geometries.push_back({0, 0, 0, 0});
+    m_flags.push_back(0);
+    m_layoutNodes.push_back(kInvalidNode);
+    m_sizeLimits.emplace_back();
+    m_denseToSlot.push_back(slot);
+    m_slotById.insert(id, slot);
+
+    return {slot, m_slots[slot].generation};
+}
+
+bool WindowRegistry::remove(WindowHandle handle) {
+    if (!isValid(handle)) {
+        return false;
+    }
+    const std::uint32_t hole = m_slots[handle.slot].dense;
+    const std::uint32_t last = static_cast<std::uint32_t>(m_ids.size() - 1);
+    m_slotById.erase(m_ids[hole]);
+    if (hasLimits(m_sizeLimits[hole])) --m_limitedCount;
+
+    if (hole != last) {
+        // Swap-remove keeps every column packed
+        m_ids[hole] = m_ids[last];
+        m_states[hole] = m_states[last];
+        m_monitors[hole] = m_monitors[last];
+        m_workspaces[hole] = m_workspaces[last];
+        m_geometries[hole] = m_geometries[last];
+        m_flags[hole] = m_flags[last];
+        m_layoutNodes[hole] = m_layoutNodes[last];
+        m_sizeLimits[hole] = m_sizeLimits[last];
+        m_denseToSlot[hole] = m_denseToSlot[last];
+        m_slots[m_denseToSlot[hole]].dense = hole;
+    }
+    m_ids.pop_back();
+    m_states.pop_back();
+    m_monitors.pop_back();
+    m_workspaces.pop_back();
+    m_geometries.pop_back();
+    m_flags.pop_back();
+    m_layoutNodes.pop_back();
+    m_sizeLimits.pop_back();
+    m_denseToSlot.pop_back();
+
+    Slot& slot = m_slots[handle.slot];
+    slot.dense = kNoDense;
+    ++slot.generation; // Invalidates every outstanding copy of the handle
+    m_freeSlots.push_back(handle.slot);
+    return true;
+}
+
+void WindowRegistry::setSizeLimits(WindowHandle h, const SizeHints& limits) {
+    SizeHints& current = m_sizeLimits[dense(h)];
+    m_limitedCount += (hasLimits(limits) ? 1 : 0);
+    m_limitedCount -= (hasLimits(current) ? 1 : 0);
+    current = limits;
+}
+
+WindowHandle WindowRegistry::find(WindowId id) const {
+    if (const std::uint32_t* slot = m_slotById.find(id)) {
+        return {*slot, m_slots[*slot].generation};
+    }
+    return {};
+}
+
+WindowHandle WindowRegistry::handleAt(std::size_t denseIndex) const {
+    assert(denseIndex < m_denseToSlot.size());
+    const std::uint32_t slot = m_denseToSlot[denseIndex];
+    return {slot, m_slots[slot].generation};
+}
+
+} // namespace core
+} // namespace maat
@@ -0,0 +1,297 @@
+#include "maat_core/window_rules.h"
+
+#include <algorithm>
+#include <unordered_map>
+
+namespace maat {
+namespace core {
+
+using maat::platform::WindowAttributes;
+using maat::platform::WindowId;
+
+namespace {
+
+const std::uint32_t kTextAttribute[WindowRule::kTextFields] = {
+    maat::platform::WindowAttributeClass,
+    maat::platform::WindowAttributeTitle,
+    maat::platform::WindowAttributeProcess,
+};
+
+// Attribute access for evaluateFrom(): a value snapshot, or a live window
+// whose getters fetch and cache on first use
+struct SnapshotSource {
+    const WindowAttributes& attributes;
+
+    const std::string& text(std::size_t field) const {
+        switch (static_cast<WindowRule::Text>(field)) {
+            case WindowRule::Text::Class: return attributes.className;
+            case WindowRule::Text::Title: return attributes.title;
+            case WindowRule::Text::Process: return attributes.processName;
+        }
+        return attributes.className;
+    }
+    std::uint32_t style() const { return attributes.styleFlags; }
+    maat::platform::Rect geometry() const { return attributes.geometry; }
+};
+
+struct WindowSource {
+    const maat::platform::Window& window;
+
+    const std::string& text(std::size_t field) const {
+        switch (static_cast<WindowRule::Text>(field)) {
+            case WindowRule::Text::Class: return window.getClassName();
+            case WindowRule::Text::Title: return window.getTitle();
+            case WindowRule::Text::Process: return window.getProcessName();
+        }
+        return window.getClassName();
+    }
+    std::uint32_t style() const { return window.getStyleFlags(); }
+    maat::platform::Rect geometry() const { return window.getGeometry(); }
+};
+
+// Per-thread evaluation scratch, so a shared rule set stays immutable
+struct EvaluationScratch {
+    std::vector<std::uint64_t> predicateBits;
+    std::vector<std::uint32_t> candidates;
+};
+
+EvaluationScratch& evaluationScratch() {
+    thread_local EvaluationScratch scratch;
+    return scratch;
+}
+
+} // namespace
+
+std::shared_ptr<const WindowRuleSet> WindowRuleSet::compile(const std::vector<WindowRule>& rules,
+                                                            RuleAction fallback) {
+    std::shared_ptr<WindowRuleSet> set(new WindowRuleSet());
+    set->m_fallback = fallback;
+    set->m_rows.reserve(rules.size());
+
+    // Dedupe text conditions into predicates; sorted needle tables come last
+    std::array<std::vector<Needle>, WindowRule::kTextFields> exact;
+    std::array<std::vector<Needle>, WindowRule::kTextFields> contains;
+    std::array<std::unordered_map<std::string, std::uint32_t>, 2 * WindowRule::kTextFields> predicateIds;
+    auto predicateFor = [&](const WindowRule::TextCondition& condition) {
+        const std::size_t field = static_cast<std::size_t>(condition.field);
+        auto inserted = predicateIds[field * 2 + (condition.contains ? 1 : 0)].emplace(
+            condition.value, static_cast<std::uint32_t>(set->m_predicateCount));
+        if (inserted.second) {
+            ++set->m_predicateCount;
+            (condition.contains ? contains : exact)[field].push_back({condition.value, inserted.first->second});
+            if (rules.size() <= kLinearRuleLimit) {
+                set->m_predicates.push_back({static_cast<std::uint32_t>(field), condition.contains, condition.value});
+            }
+        }
+        return inserted.first->second;
+    };
+
+    std::vector<std::uint32_t> anchors(rules.size());
+    constexpr std::uint32_t kNoAnchor = static_cast<std::uint32_t>(-1);
+    for (std::size_t r = 0; r < rules.size(); ++r) {
+        const WindowRule& rule = rules[r];
+        Row row{};
+        row.firstPredicate = static_cast<std::uint32_t>(set->m_rowPredicates.size());
+        row.styleAll = rule.styleAll;
+        row.styleNone = rule.styleNone;
+        row.styleAny = rule.styleAny;
+        row.minWidth = rule.minWidth;
+        row.minHeight = rule.minHeight;
+        row.maxWidth = rule.maxWidth;
+        row.maxHeight = rule.maxHeight;
+        row.action = rule.action;
+
+        anchors[r] = kNoAnchor;
+        bool anchorIsExact = false;
+        for (const WindowRule::TextCondition& condition : rule.text) {
+            const std::uint32_t predicate = predicateFor(condition);
+            if (std::find(set->m_rowPredicates.begin() + row.firstPredicate, set->m_rowPredicates.end(),
+                          predicate) == set->m_rowPredicates.end()) {
+                set->m_rowPredicates.push_back(predicate);
+            }
+            if (anchors[r] == kNoAnchor || (!anchorIsExact && !condition.contains)) {
+                anchors[r] = predicate;
+                anchorIsExact = !condition.contains;
+            }
+            set->m_relevantAttributes |= kTextAttribute[static_cast<std::size_t>(condition.field)];
+        }
+        row.predicateCount = static_cast<std::uint32_t>(set->m_rowPredicates.size()) - row.firstPredicate;
+        if (row.styleAll || row.styleNone || row.styleAny) {
+            set->m_relevantAttributes |= maat::platform::WindowAttributeStyle;
+        }
+        if (row.minWidth > 0 || row.minHeight > 0 || row.maxWidth != INT_MAX || row.maxHeight != INT_MAX) {
+            set->m_relevantAttributes |= maat::platform::WindowAttributeSize;
+        }
+        set->m_rows.push_back(row);
+    }
+
+    // Anchor index in CSR form; rows are visited in order, so each list ascends
+    set->m_anchorOffsets.assign(set->m_predicateCount + 1, 0);
+    for (std::size_t r = 0; r < rules.size(); ++r) {
+        if (anchors[r] != kNoAnchor) ++set->m_anchorOffsets[anchors[r] + 1];
+    }
+    for (std::size_t p = 0; p < set->m_predicateCount; ++p) {
+        set->m_anchorOffsets[p + 1] += set->m_anchorOffsets[p];
+    }
+    set->m_anchoredRows.resize(set->m_anchorOffsets.back());
+    std::vector<std::uint32_t> fill(set->m_anchorOffsets.begin(), set->m_anchorOffsets.end() - 1);
+    for (std::size_t r = 0; r < rules.size(); ++r) {
+        if (anchors[r] != kNoAnchor) {
+            set->m_anchoredRows[fill[anchors[r]]++] = static_cast<std::uint32_t>(r);
+        } else {
+            set->m_unanchoredRows.push_back(static_cast<std::uint32_t>(r));
+        }
+    }
+
+    for (std::size_t field = 0; field < WindowRule::kTextFields; ++field) {
+        std::sort(exact[field].begin(), exact[field].end(),
+                  [](const Needle& a, const Needle& b) { return a.value < b.value; });
+        set->m_exact[field] = std::move(exact[field]);
+        set->m_contains[field] = std::move(contains[field]);
+    }
+    return set;
+}
+
+std::vector<WindowRule> WindowRuleSet::defaultRules() {
+    using namespace maat::platform;
+    return {
+        WindowRule(RuleAction::Ignore).withAnyStyle(WindowStyleChild | WindowStyleDisabled | WindowStylePopup |
+                                                    WindowStyleToolWindow | WindowStyleNoActivate |
+                                                    WindowStyleTransparent),
+    };
+}
+
+std::shared_ptr<const WindowRuleSet> WindowRuleSet::defaults() {
+    return compile(defaultRules());
+}
+
+RuleAction WindowRuleSet::evaluate(const WindowAttributes& attributes) const {
+    return evaluateFrom(SnapshotSource{attributes});
+}
+
+RuleAction WindowRuleSet::evaluate(const maat::platform::Window& window) const {
+    return evaluateFrom(WindowSource{window});
+}
+
+template <typename Source>
+RuleAction WindowRuleSet::evaluateFrom(const Source& source) const {
+    if (m_rows.size() <= kLinearRuleLimit) return evaluateLinear(source);
+
+    EvaluationScratch& scratch = evaluationScratch();
+    scratch.predicateBits.assign((m_predicateCount + 63) / 64, 0);
+    scratch.candidates.clear();
+    std::uint64_t* bits = scratch.predicateBits.data();
+
+    auto matched = [&](std::uint32_t predicate) {
+        bits[predicate / 64] |= std::uint64_t(1) << (predicate % 64);
+        scratch.candidates.insert(scratch.candidates.end(), m_anchoredRows.begin() + m_anchorOffsets[predicate],
+                                  m_anchoredRows.begin() + m_anchorOffsets[predicate + 1]);
+    };
+    for (std::size_t field = 0; field < WindowRule::kTextFields; ++field) {
+        const std::vector<Needle>& exact = m_exact[field];
+        const std::vector<Needle>& contains = m_contains[field];
+        if (exact.empty() && contains.empty()) continue;
+        const std::string& value = source.text(field);
+        // Needles are distinct, so at most one exact predicate matches
+        auto it = std::lower_bound(exact.begin(), exact.end(), value,
+                                   [](const Needle& needle, const std::string& v) { return needle.value < v; });
+        if (it != exact.end() && it->value == value) matched(it->predicate);
+        for (const Needle& needle : contains) {
+            if (value.find(needle.value) != std::string::npos) matched(needle.predicate);
+        }
+    }
+
+    // Style and geometry are fetched only if some rule reads them
+    const std::uint32_t style = (m_relevantAttributes & maat::platform::WindowAttributeStyle) ? source.style() : 0;
+    const maat::platform::Rect geometry = (m_relevantAttributes & maat::platform::WindowAttributeSize)
+                                              ? source.geometry()
+                                              : maat::platform::Rect{0, 0, 0, 0};
+
+    // Walk candidate and unanchored rows together in rule order
+    std::vector<std::uint32_t>& candidates = scratch.candidates;
+    std::sort(candidates.begin(), candidates.end());
+    std::size_t c = 0;
+    std::size_t u = 0;
+    while (c < candidates.size() || u < m_unanchoredRows.size()) {
+        std::uint32_t row;
+        if (u == m_unanchoredRows.size() || (c < candidates.size() && candidates[c] < m_unanchoredRows[u])) {
+            row = candidates[c++];
+        } else {
+            row = m_unanchoredRows[u++];
+        }
+        if (rowMatches(m_rows[row], bits, style, geometry)) return m_rows[row].action;
+    }
+    return m_fallback;
+}
+
+template <typename Source>
+RuleAction WindowRuleSet::evaluateLinear(const Source& source) const {
+    const std::uint32_t style = (m_relevantAttributes & maat::platform::WindowAttributeStyle) ? source.style() : 0;
+    const maat::platform::Rect geometry = (m_relevantAttributes & maat::platform::WindowAttributeSize)
+                                              ? source.geometry()
+                                              : maat::platform::Rect{0, 0, 0, 0};
+    for (const Row& row : m_rows) {
+        if (!boundsMatch(row, style, geometry)) continue;
+        bool matches = true;
+        for (std::uint32_t i = 0; i < row.predicateCount && matches; ++i) {
+            const Predicate& predicate = m_predicates[m_rowPredicates[row.firstPredicate + i]];
+            const std::string& value = source.text(predicate.field);
+            matches = predicate.contains ? value.find(predicate.value) != std::string::npos : value == predicate.value;
+        }
+        if (matches) return row.action;
+    }
+    return m_fallback;
+}
+
+bool WindowRuleSet::boundsMatch(const Row& row, std::uint32_t style, const maat::platform::Rect& geometry) {
+    if ((style & row.styleAll) != row.styleAll || (style & row.styleNone) != 0 ||
+        (row.styleAny != 0 && (style & row.styleAny) == 0)) {
+        return false;
+    }
+    const int width = geometry.width;
+    const int height = geometry.height;
+    return width >= row.minWidth && height >= row.minHeight && width <= row.maxWidth && height <= row.maxHeight;
+}
+
+bool WindowRuleSet::rowMatches(const Row& row, const std::uint64_t* predicateBits, std::uint32_t style,
+                               const maat::platform::Rect& geometry) const {
+    if (!boundsMatch(row, style, geometry)) return false;
+    for (std::uint32_t i = 0; i < row.predicateCount; ++i) {
+        const std::uint32_t predicate = m_rowPredicates[row.firstPredicate + i];
+        if ((predicateBits[predicate / 64] & (std::uint64_t(1) << (predicate % 64))) == 0) return false;
+    }
+    return true;
+}
+
+WindowClassifier::WindowClassifier(std::shared_ptr<const WindowRuleSet> rules) : m_rules(std::move(rules)) {}
+
+void WindowClassifier::setRules(std::shared_ptr<const WindowRuleSet> rules) {
+    m_rules = std::move(rules);
+    m_cache.clear();
+}
+
+RuleAction WindowClassifier::classify(const maat::platform::Window& window) {
+    const WindowId id = window.getId();
+    if (const RuleAction* cached = m_cache.find(id)) {
+        ++m_cacheHits;
+        return *cached;
+    }
+    ++m_cacheMisses;
+    const RuleAction action = m_rules->evaluate(window);
+    m_cache.set(id, action);
+    return action;
+}
+
+void WindowClassifier::record(WindowId id, RuleAction action) {
+    ++m_cacheMisses;
+    m_cache.set(id, action);
+}
+
+bool WindowClassifier::invalidate(WindowId id, std::uint32_t changedAttributes) {
+    if ((changedAttributes & m_rules->relevantAttributes()) == 0) return false;
+    m_cache.erase(id);
+    return true;
+}
+
+} // namespace core
+} // namespace maat
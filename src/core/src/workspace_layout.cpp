@@ -0,0 +1,331 @@
+#include "maat_core/workspace_layout.h"
+
+#include <cmath>
+
+namespace maat {
+namespace core {
+
+namespace {
+
+// Deeper saved trees are treated as malformed; a dwindle chain this long
+// would hold thousands of windows
+constexpr std::size_t kMaxRestoreDepth = 4096;
+
+bool validWeight(float weight) {
+    return std::isfinite(weight) && weight >= 0.0f;
+}
+
+// Grows the limits that are set by `padding`, saturating at 1 (unset is 0)
+maat::platform::SizeHints padLimits(maat::platform::SizeHints limits, int padding) {
+    int* fields[] = {&limits.minWidth, &limits.minHeight, &limits.maxWidth, &limits.maxHeight};
+    for (int* field : fields) {
+        if (*field > 0) *field = *field + padding > 0 ? *field + padding : 1;
+    }
+    return limits;
+}
+
+} // namespace
+
+const char* layoutKindName(LayoutKind kind) {
+    switch (kind) {
+        case LayoutKind::Tree: return "tree";
+        case LayoutKind::MasterStack: return MasterStackPolicy::kName;
+        case LayoutKind::Dwindle: return DwindlePolicy::kName;
+        case LayoutKind::Grid: return GridPolicy::kName;
+        case LayoutKind::Columns: return ColumnsPolicy::kName;
+    }
+    return "unknown";
+}
+
+void encodeLayoutSettings(LayoutKind kind, const LayoutParams& params, std::vector<std::uint8_t>& out) {
+    out.push_back(static_cast<std::uint8_t>(kind));
+    codec::putFloat(out, params.masterRatio);
+    codec::putVarint(out, params.masterCount);
+    out.push_back(static_cast<std::uint8_t>(params.axis));
+    codec::putSigned(out, params.innerGap);
+    codec::putSigned(out, params.outerGap);
+}
+
+bool decodeLayoutSettings(codec::Reader& in, LayoutKind& kind, LayoutParams& params) {
+    std::uint8_t kindByte;
+    std::uint8_t axis;
+    std::uint64_t masterCount;
+    std::int64_t inner;
+    std::int64_t outer;
+    if (!in.byte(kindByte) || !in.floatValue(params.masterRatio) || !in.varint(masterCount) || !in.byte(axis) ||
+        !in.signedVarint(inner) || !in.signedVarint(outer)) {
+        return false;
+    }
+    // Out-of-range values are rejected before any narrowing cast
+    if (kindByte > static_cast<std::uint8_t>(LayoutKind::Columns) ||
+        axis > static_cast<std::uint8_t>(SplitAxis::Vertical) || masterCount > kMaxMasterCount || inner < 0 ||
+        inner > kMaxLayoutGap || outer < 0 || outer > kMaxLayoutGap) {
+        return false;
+    }
+    kind = static_cast<LayoutKind>(kindByte);
+    params.masterCount = static_cast<std::uint32_t>(masterCount);
+    params.axis = static_cast<SplitAxis>(axis);
+    params.innerGap = static_cast<int>(inner);
+    params.outerGap = static_cast<int>(outer);
+    return validLayoutParams(params);
+}
+
+std::unique_ptr<WorkspaceLayout> makeWorkspaceLayout(LayoutKind kind, LayoutTree& tree,
+                                                     const LayoutParams& params) {
+    std::unique_ptr<WorkspaceLayout> layout;
+    switch (kind) {
+        case LayoutKind::Tree: layout.reset(new TreeLayout(tree)); break;
+        case LayoutKind::MasterStack: layout.reset(new PolicyLayout<MasterStackPolicy>(kind)); break;
+        case LayoutKind::Dwindle: layout.reset(new PolicyLayout<DwindlePolicy>(kind)); break;
+        case LayoutKind::Grid: layout.reset(new PolicyLayout<GridPolicy>(kind)); break;
+        case LayoutKind::Columns: layout.reset(new PolicyLayout<ColumnsPolicy>(kind)); break;
+    }
+    if (layout) {
+        layout->setParams(params);
+    }
+    return layout;
+}
+
+// --- WorkspaceLayout ---
+
+void WorkspaceLayout::computeDirtyLayout(const maat::platform::Rect& area, LayoutTree::GeometryList& out) {
+    const int inner = m_params.innerGap > 0 ? m_params.innerGap : 0;
+    const int outer = m_params.outerGap > 0 ? m_params.outerGap : 0;
+    if (inner == 0 && outer == 0) {
+        arrangeDirty(area, out);
+        return;
+    }
+    // Arrange in the work area less the outer gap, grown by half the inner
+    // gap on every side, then shrink every rect by that half: neighbours end
+    // up `inner` apart and edge windows exactly `outer` from the edge.
+    const int lead = inner / 2;
+    const maat::platform::Rect grown{area.x + outer - lead, area.y + outer - lead,
+                                     area.width - 2 * outer + inner, area.height - 2 * outer + inner};
+    const std::size_t first = out.size();
+    arrangeDirty(grown, out);
+    for (std::size_t i = first; i < out.size(); ++i) {
+        maat::platform::Rect& rect = out[i].second;
+        rect.x += lead;
+        rect.y += lead;
+        rect.width = rect.width > inner ? rect.width - inner : 1;
+        rect.height = rect.height > inner ? rect.height - inner : 1;
+    }
+}
+
+WindowHandle WorkspaceLayout::restorable(const WindowRegistry& registry, maat::platform::WindowId id) {
+    const WindowHandle window = registry.find(id);
+    if (window.isNull() || registry.state(window) != WindowState::Unplaced ||
+        registry.layoutNode(window) != kInvalidNode) {
+        return WindowHandle();
+    }
+    return window;
+}
+
+// --- TreeLayout ---
+
+// One saved node, pre-order. `end` is the index after its subtree; `live`
+// counts the windows under it that can be restored, `liveChildren` the
+// children with any.
+struct TreeLayout::SavedNode {
+    bool leaf;
+    SplitAxis axis;
+    float weight;
+    WindowHandle window;
+    std::size_t end;
+    std::size_t live;
+    std::size_t liveChildren;
+};
+
+TreeLayout::TreeLayout(LayoutTree& tree) : m_tree(tree), m_root(tree.createRoot(SplitAxis::Horizontal)) {
+}
+
+TreeLayout::~TreeLayout() {
+    m_tree.destroyRoot(m_root);
+}
+
+void TreeLayout::insert(WindowRegistry& registry, WindowHandle window) {
+    const maat::platform::WindowId windowId = registry.id(window);
+
+    // Dwindle-style insertion: split the most recent window perpendicular to
+    // its container, so only that window's area has to be re-tiled.
+    NodeIndex target = m_root;
+    while (m_tree.isContainer(target) && m_tree.node(target).lastChild != kInvalidNode) {
+        target = m_tree.node(target).lastChild;
+    }
+
+    NodeIndex leaf;
+    if (m_tree.node(m_root).childCount < 2 || !m_tree.isLeaf(target)) {
+        leaf = m_tree.appendWindow(m_root, windowId);
+    } else {
+        const NodeIndex parent = m_tree.node(target).parent;
+        const SplitAxis axis = m_tree.node(parent).axis == SplitAxis::Horizontal
+                                   ? SplitAxis::Vertical
+                                   : SplitAxis::Horizontal;
+        leaf = m_tree.splitLeaf(target, axis, windowId);
+    }
+    registry.setLayoutNode(window, leaf);
+    applyLimits(registry, window, leaf);
+    ++m_windowCount;
+}
+
+void TreeLayout::remove(WindowRegistry& registry, WindowHandle window) {
+    const NodeIndex leaf = registry.layoutNode(window);
+    if (leaf == kInvalidNode) return;
+    m_tree.removeLeaf(leaf);
+    registry.setLayoutNode(window, kInvalidNode);
+    --m_windowCount;
+}
+
+void TreeLayout::markDirty(const WindowRegistry& registry, WindowHandle window) {
+    const NodeIndex leaf = registry.layoutNode(window);
+    if (leaf != kInvalidNode) {
+        m_tree.markDirty(leaf);
+    }
+}
+
+void TreeLayout::sizeLimitsChanged(const WindowRegistry& registry, WindowHandle window) {
+    const NodeIndex leaf = registry.layoutNode(window);
+    if (leaf != kInvalidNode) {
+        applyLimits(registry, window, leaf);
+        m_tree.markDirty(leaf);
+    }
+}
+
+// Tiles are cut `innerGap` larger than the windows in them (see
+// computeDirtyLayout()), so the leaf limits are the window's plus the gap
+void TreeLayout::applyLimits(const WindowRegistry& registry, WindowHandle window, NodeIndex leaf) {
+    m_tree.setLimits(leaf, padLimits(registry.sizeLimits(window), m_limitPadding));
+}
+
+void TreeLayout::paramsChanged() {
+    const int padding = m_params.innerGap > 0 ? m_params.innerGap : 0;
+    if (padding == m_limitPadding) return;
+    const int delta = padding - m_limitPadding;
+    m_limitPadding = padding;
+    if (m_tree.limitedLeafCount() == 0) return;
+    m_tree.forEachLeaf(m_root, [this, delta](NodeIndex leaf, const LayoutTree::Node& node) {
+        m_tree.setLimits(leaf, padLimits(node.limits, delta));
+    });
+}
+
+void TreeLayout::arrangeDirty(const maat::platform::Rect& area, LayoutTree::GeometryList& out) {
+    m_tree.computeDirtyLayout(m_root, area, out);
+}
+
+void TreeLayout::forgetPlacement() {
+    m_tree.forEachLeaf(m_root, [this](NodeIndex leaf, const LayoutTree::Node&) { m_tree.markDirty(leaf); });
+}
+
+// Body: u8 root axis, then the root's children. A child is u8 kind (0 leaf,
+// 1 container) and f32 weight, followed by a varint window id for a leaf or
+// u8 axis, varint child count and the children for a container.
+void TreeLayout::save(const WindowRegistry&, std::vector<std::uint8_t>& out) const {
+    out.push_back(static_cast<std::uint8_t>(m_tree.node(m_root).axis));
+    saveChildren(m_root, out);
+}
+
+void TreeLayout::saveChildren(NodeIndex container, std::vector<std::uint8_t>& out) const {
+    codec::putVarint(out, m_tree.node(container).childCount);
+    for (NodeIndex child = m_tree.node(container).firstChild; child != kInvalidNode;
+         child = m_tree.node(child).nextSibling) {
+        const LayoutTree::Node& node = m_tree.node(child);
+        out.push_back(node.kind == LayoutTree::NodeKind::Leaf ? 0 : 1);
+        codec::putFloat(out, node.weight);
+        if (node.kind == LayoutTree::NodeKind::Leaf) {
+            codec::putVarint(out, node.window);
+        } else {
+            out.push_back(static_cast<std::uint8_t>(node.axis));
+            saveChildren(child, out);
+        }
+    }
+}
+
+bool TreeLayout::restore(WindowRegistry& registry, codec::Reader& in, std::vector<WindowHandle>& placed) {
+    std::uint8_t axis;
+    if (!in.byte(axis) || axis > static_cast<std::uint8_t>(SplitAxis::Vertical)) return false;
+    std::vector<SavedNode> nodes;
+    std::size_t liveChildren = 0;
+    if (readSavedChildren(in, registry, 0, nodes, liveChildren) < 0) return false;
+
+    m_tree.setAxis(m_root, static_cast<SplitAxis>(axis));
+    for (std::size_t i = 0; i < nodes.size();) {
+        i = restoreSubtree(nodes, i, m_root, nodes[i].weight, registry, placed);
+    }
+    return true;
+}
+
+// Rebuilds nodes[index] under `parent` with `weight` and returns the index
+// after its subtree. Subtrees without restorable windows are dropped and
+// containers left with one live child collapse into it, exactly as if the
+// missing windows had been removed.
+std::size_t TreeLayout::restoreSubtree(const std::vector<SavedNode>& nodes, std::size_t index, NodeIndex parent,
+                                       float weight, WindowRegistry& registry, std::vector<WindowHandle>& placed) {
+    const SavedNode& saved = nodes[index];
+    if (saved.live == 0) return saved.end;
+    if (saved.leaf) {
+        if (registry.layoutNode(saved.window) == kInvalidNode) { // listed twice otherwise
+            const NodeIndex leaf = m_tree.appendWindow(parent, registry.id(saved.window), weight);
+            registry.setLayoutNode(saved.window, leaf);
+            applyLimits(registry, saved.window, leaf);
+            placed.push_back(saved.window);
+            ++m_windowCount;
+        }
+        return saved.end;
+    }
+    NodeIndex container = parent;
+    if (saved.liveChildren > 1) {
+        container = m_tree.appendContainer(parent, saved.axis, weight);
+    }
+    for (std::size_t child = index + 1; child < saved.end;) {
+        // A collapsed container's only child takes over its weight
+        child = restoreSubtree(nodes, child, container, saved.liveChildren > 1 ? nodes[child].weight : weight,
+                               registry, placed);
+    }
+    return saved.end;
+}
+
+// Reads the children of a saved container into `nodes` (pre-order) and
+// returns the number of restorable windows under them, or -1 if malformed
+long long TreeLayout::readSavedChildren(codec::Reader& in, const WindowRegistry& registry, std::size_t depth,
+                                        std::vector<SavedNode>& nodes, std::size_t& liveChildren) {
+    std::uint64_t count;
+    if (depth > kMaxRestoreDepth || !in.varint(count) || count > in.remaining()) return -1;
+    long long live = 0;
+    liveChildren = 0;
+    for (std::uint64_t i = 0; i < count; ++i) {
+        std::uint8_t kind;
+        float weight;
+        if (!in.byte(kind) || kind > 1 || !in.floatValue(weight) || !validWeight(weight)) return -1;
+        const std::size_t index = nodes.size();
+        nodes.push_back({kind == 0, SplitAxis::Horizontal, weight, WindowHandle(), 0, 0, 0});
+        long long subtreeLive;
+        if (kind == 0) {
+            std::uint64_t id;
+            if (!in.varint(id)) return -1;
+            nodes[index].window = restorable(registry, static_cast<maat::platform::WindowId>(id));
+            subtreeLive = nodes[index].window.isNull() ? 0 : 1;
+        } else {
+            std::uint8_t axis;
+            if (!in.byte(axis) || axis > static_cast<std::uint8_t>(SplitAxis::Vertical)) return -1;
+            nodes[index].axis = static_cast<SplitAxis>(axis);
+            std::size_t grandChildren = 0;
+            subtreeLive = readSavedChildren(in, registry, depth + 1, nodes, grandChildren);
+            if (subtreeLive < 0) return -1;
+            nodes[index].liveChildren = grandChildren;
+        }
+        nodes[index].end = nodes.size();
+        nodes[index].live = static_cast<std::size_t>(subtreeLive);
+        live += subtreeLive;
+        if (subtreeLive > 0) ++liveChildren;
+    }
+    return live;
+}
+
+void TreeLayout::collectWindows(const WindowRegistry& registry, std::vector<WindowHandle>& out) const {
+    m_tree.forEachLeaf(m_root, [&registry, &out](NodeIndex, const LayoutTree::Node& leaf) {
+        out.push_back(registry.find(leaf.window));
+    });
+}
+
+} // namespace core
+} // namespace maat
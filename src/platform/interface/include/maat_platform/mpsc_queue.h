@@ -0,0 +1,147 @@
+#ifndef MAAT_PLATFORM_MPSC_QUEUE_H_
+#define MAAT_PLATFORM_MPSC_QUEUE_H_
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <thread>
+
+namespace maat { namespace platform {
+
+/**
+ * @brief What a producer does when the queue is full.
+ */
+enum class OverflowPolicy : std::uint8_t {
+    DropNewest, ///< Discard the new element immediately (never waits)
+    YieldRetry  ///< Yield and retry a bounded number of times, then discard
+};
+
+/**
+ * @brief Bounded lock-free multi-producer/single-consumer ring buffer.
+ * @details Each cell carries a sequence number (Vyukov's bounded queue), so
+ *          producers claim a slot with one compare-exchange and never take a
+ *          lock or wait for the consumer. With a single producer thread (the
+ *          usual case for OS hook callbacks) the claim always succeeds on the
+ *          first attempt. pop() must only be called from one thread.
+ * @tparam T Copy-assignable, default-constructible element type.
+ */
+template <typename T>
+class BoundedMpscQueue {
+public:
+    /**
+     * @param capacity Requested size; rounded up to a power of two (minimum 2).
+     */
+    explicit BoundedMpscQueue(std::size_t capacity) {
+        std::size_t size = 2;
+        while (size < capacity) size <<= 1;
+        m_mask = size - 1;
+        m_cells.reset(new Cell[size]);
+        for (std::size_t i = 0; i < size; ++i) {
+            m_cells[i].sequence.store(i, std::memory_order_relaxed);
+        }
+    }
+
+    BoundedMpscQueue(const BoundedMpscQueue&) = delete;
+    BoundedMpscQueue& operator=(const BoundedMpscQueue&) = delete;
+
+    /**
+     * @brief Enqueues @p value; safe from any number of threads.
+     * @return false if the queue was full and the element was dropped.
+     */
+    bool push(const T& value, OverflowPolicy policy = OverflowPolicy::DropNewest) {
+        int retries = policy == OverflowPolicy::YieldRetry ? kYieldRetries : 0;
+        for (;;) {
+            if (tryPush(value)) return true;
+            if (retries-- <= 0) break;
+            std::this_thread::yield();
+        }
+        m_dropped.fetch_add(1, std::memory_order_relaxed);
+        return false;
+    }
+
+    /**
+     * @brief Enqueues @p value if a cell is free; safe from any number of threads.
+     * @return false if the queue was full. Unlike push(), nothing is counted
+     *         as dropped: the caller keeps the element.
+     */
+    bool tryPush(const T& value) {
+        std::size_t pos = m_enqueuePos.load(std::memory_order_relaxed);
+        Cell* cell;
+        for (;;) {
+            cell = &m_cells[pos & m_mask];
+            const std::size_t sequence = cell->sequence.load(std::memory_order_acquire);
+            const std::intptr_t diff = static_cast<std::intptr_t>(sequence - pos);
+            if (diff == 0) {
+                if (m_enqueuePos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                    break;
+                }
+            } else if (diff < 0) {
+                return false; // Full: the consumer has not freed this cell yet
+            } else {
+                pos = m_enqueuePos.load(std::memory_order_relaxed);
+            }
+        }
+        cell->value = value;
+        cell->sequence.store(pos + 1, std::memory_order_release);
+        return true;
+    }
+
+    /**
+     * @brief Dequeues into @p out. Consumer thread only.
+     * @return false if the queue is empty (or the next element is still being written).
+     */
+    bool pop(T& out) {
+        Cell& cell = m_cells[m_dequeuePos & m_mask];
+        const std::size_t sequence = cell.sequence.load(std::memory_order_acquire);
+        if (static_cast<std::intptr_t>(sequence - (m_dequeuePos + 1)) < 0) {
+            return false;
+        }
+        out = cell.value;
+        // Hand the cell back to producers for the next lap
+        cell.sequence.store(m_dequeuePos + m_mask + 1, std::memory_order_release);
+        ++m_dequeuePos;
+        m_consumed.store(m_dequeuePos, std::memory_order_relaxed);
+        return true;
+    }
+
+    /** @brief True if pop() would fail right now. Consumer thread only. */
+    bool empty() const {
+        const Cell& cell = m_cells[m_dequeuePos & m_mask];
+        const std::size_t sequence = cell.sequence.load(std::memory_order_acquire);
+        return static_cast<std::intptr_t>(sequence - (m_dequeuePos + 1)) < 0;
+    }
+
+    std::size_t capacity() const { return m_mask + 1; }
+
+    /** @brief Approximate number of queued elements (exact on the consumer thread when idle). */
+    std::size_t sizeApprox() const {
+        const std::size_t tail = m_enqueuePos.load(std::memory_order_relaxed);
+        const std::size_t head = m_consumed.load(std::memory_order_relaxed);
+        return tail > head ? tail - head : 0;
+    }
+
+    /** @brief Total elements discarded because the queue was full. */
+    std::uint64_t droppedCount() const { return m_dropped.load(std::memory_order_relaxed); }
+
+private:
+    static constexpr int kYieldRetries = 64;
+
+    struct Cell {
+        std::atomic<std::size_t> sequence;
+        T value{};
+    };
+
+    std::unique_ptr<Cell[]> m_cells;
+    std::size_t m_mask = 0;
+
+    // Producer and consumer indices on separate cache lines
+    alignas(64) std::atomic<std::size_t> m_enqueuePos{0};
+    alignas(64) std::size_t m_dequeuePos = 0;
+    std::atomic<std::size_t> m_consumed{0}; // m_dequeuePos mirror for sizeApprox()
+    alignas(64) std::atomic<std::uint64_t> m_dropped{0};
+};
+
+} }
+
+#endif
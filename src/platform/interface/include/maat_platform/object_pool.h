@@ -0,0 +1,168 @@
+#ifndef MAAT_PLATFORM_OBJECT_POOL_H_
+#define MAAT_PLATFORM_OBJECT_POOL_H_
+
+#include <cassert>
+#include <cstddef>
+#include <memory>
+#include <new>
+#include <utility>
+#include <vector>
+
+namespace maat { namespace platform {
+
+/**
+ * @brief Allocation counters of an ObjectPool.
+ */
+struct ObjectPoolStats {
+    std::size_t allocations = 0;     ///< Objects constructed through acquire()
+    std::size_t frees = 0;           ///< Objects destroyed and returned to the pool
+    std::size_t live = 0;            ///< allocations - frees
+    std::size_t capacity = 0;        ///< Slots owned by the pool (live + free)
+    std::size_t heapAllocations = 0; ///< Chunks requested from the heap
+};
+
+/**
+ * @brief Free-list pool of fixed-size slots for objects of type @p T.
+ * @details Slots are carved out of chunks that are only returned to the heap
+ *          when the pool is destroyed. A released slot goes onto an intrusive
+ *          free list and is handed out again by the next acquire(), so once
+ *          the pool has reached its working size, creating and destroying
+ *          objects performs no heap allocation (heapAllocations stays flat).
+ *          Objects are owned through move-only RAII Handles; the pool must
+ *          outlive every handle it issued. Not thread-safe: acquire and
+ *          release from the thread that owns the pool.
+ * @tparam T Any object type; it does not need to know it is pooled.
+ */
+template <typename T>
+class ObjectPool {
+public:
+    /**
+     * @brief Owning reference to a pooled object; returns it to the pool on
+     *        destruction or reset().
+     */
+    class Handle {
+    public:
+        Handle() = default;
+        ~Handle() { reset(); }
+
+        Handle(Handle&& other) noexcept : m_pool(other.m_pool), m_object(other.m_object) {
+            other.m_object = nullptr;
+        }
+
+        Handle& operator=(Handle&& other) noexcept {
+            if (this != &other) {
+                reset();
+                m_pool = other.m_pool;
+                m_object = other.m_object;
+                other.m_object = nullptr;
+            }
+            return *this;
+        }
+
+        Handle(const Handle&) = delete;
+        Handle& operator=(const Handle&) = delete;
+
+        T* get() const { return m_object; }
+        T* operator->() const { return m_object; }
+        T& operator*() const { return *m_object; }
+        explicit operator bool() const { return m_object != nullptr; }
+
+        void reset() {
+            if (m_object) {
+                m_pool->release(m_object);
+                m_object = nullptr;
+            }
+        }
+
+    private:
+        friend class ObjectPool;
+        Handle(ObjectPool* pool, T* object) : m_pool(pool), m_object(object) {}
+
+        ObjectPool* m_pool = nullptr;
+        T* m_object = nullptr;
+    };
+
+    /**
+     * @param chunkSize Number of slots requested from the heap whenever the
+     *                  free list runs dry.
+     */
+    explicit ObjectPool(std::size_t chunkSize = 64) : m_chunkSize(chunkSize ? chunkSize : 1) {}
+
+    ~ObjectPool() {
+        assert(m_stats.live == 0 && "ObjectPool destroyed while handles are outstanding");
+    }
+
+    ObjectPool(const ObjectPool&) = delete;
+    ObjectPool& operator=(const ObjectPool&) = delete;
+
+    /**
+     * @brief Constructs a T from @p args in a free slot.
+     */
+    template <typename... Args>
+    Handle acquire(Args&&... args) {
+        if (!m_freeHead) {
+            grow(m_chunkSize);
+        }
+        Slot* slot = m_freeHead;
+        m_freeHead = slot->next;
+        T* object = nullptr;
+        try {
+            object = ::new (static_cast<void*>(slot->storage)) T(std::forward<Args>(args)...);
+        } catch (...) {
+            slot->next = m_freeHead;
+            m_freeHead = slot;
+            throw;
+        }
+        ++m_stats.allocations;
+        ++m_stats.live;
+        return Handle(this, object);
+    }
+
+    /**
+     * @brief Ensures at least @p count slots exist without further heap allocation.
+     */
+    void reserve(std::size_t count) {
+        if (count > m_stats.capacity) {
+            grow(count - m_stats.capacity);
+        }
+    }
+
+    const ObjectPoolStats& stats() const { return m_stats; }
+
+private:
+    union Slot {
+        Slot* next;
+        alignas(T) unsigned char storage[sizeof(T)];
+    };
+
+    void release(T* object) {
+        object->~T();
+        // storage is the union's first byte, so the object address is the slot address
+        Slot* slot = reinterpret_cast<Slot*>(object);
+        slot->next = m_freeHead;
+        m_freeHead = slot;
+        ++m_stats.frees;
+        --m_stats.live;
+    }
+
+    void grow(std::size_t slots) {
+        std::unique_ptr<Slot[]> chunk(new Slot[slots]);
+        // Thread the new slots onto the free list so they are used in address order
+        for (std::size_t i = slots; i-- > 0;) {
+            chunk[i].next = m_freeHead;
+            m_freeHead = &chunk[i];
+        }
+        m_chunks.push_back(std::move(chunk));
+        m_stats.capacity += slots;
+        ++m_stats.heapAllocations;
+    }
+
+    std::vector<std::unique_ptr<Slot[]>> m_chunks;
+    Slot* m_freeHead = nullptr;
+    std::size_t m_chunkSize;
+    ObjectPoolStats m_stats;
+};
+
+} }
+
+#endif
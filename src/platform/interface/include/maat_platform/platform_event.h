@@ -0,0 +1,37 @@
+#ifndef MAAT_PLATFORM_PLATFORM_EVENT_H_
+#define MAAT_PLATFORM_PLATFORM_EVENT_H_
+
+#include <cstdint>
+
+#include "platform_types.h"
+
+namespace maat { namespace platform {
+
+enum class PlatformEventType : std::uint8_t {
+    WindowCreated,        // window became manageable; geometry is valid
+    WindowDestroyed,
+    WindowMonitorChanged, // user finished a move/size; monitor is valid
+    MonitorLayoutChanged,
+    WindowUnmanaged,      // still exists, but the window rules no longer manage it
+    ConfigurationChanged  // the configuration's layout settings were reloaded
+};
+
+/**
+ * @brief Self-contained snapshot of one OS notification.
+ * @details Trivially copyable so it can travel through lock-free queues; it
+ *          never refers to platform objects, which may only be touched on
+ *          the platform's own thread.
+ */
+struct PlatformEvent {
+    PlatformEventType type;
+    WindowId window;
+    MonitorId monitor;
+    Rect geometry;
+    Timestamp timestamp; // When the OS generated the event (getMonotonicTime() timeline)
+    Timestamp received;  // getMonotonicTime() when it was handed to the mediator
+    std::uint32_t incarnation; // WindowDestroyed: which tracking of a reused id ended; see releaseWindowTracking()
+};
+
+} }
+
+#endif
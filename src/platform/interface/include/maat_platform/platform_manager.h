@@ -1,6 +1,7 @@
 #ifndef MAAT_PLATFORM_PLATFORM_MANAGER_H_
 #define MAAT_PLATFORM_PLATFORM_MANAGER_H_
 
+#include <cstddef>
 #include <vector>
 #include <functional>
 #include <utility>
@@ -27,9 +28,33 @@ public:
      *                and the desired new Rect (position and size) for that window.
      * @details The implementation should attempt to use OS-specific batching
      *          mechanisms for efficiency and visual consistency.
+     * @note With MaatMediator::setApplyThread() this and setWindowVisibility()
+     *       are called from the mediator's apply thread, one call at a time,
+     *       and must not touch state owned by the event loop.
      */
     virtual void applyWindowGeometries(const std::vector<std::pair<WindowId, Rect> >& updates) = 0;
 
+    /**
+     * @brief Shows or hides multiple windows in one call.
+     * @param changes Pairs of WindowId and the requested visibility (true = shown).
+     * @details Used to switch workspaces. Must not wait for the target
+     *          applications (no per-window round trips), must not activate
+     *          shown windows, and must not report the windows as created or
+     *          destroyed. Unknown or destroyed windows are skipped.
+     */
+    virtual void setWindowVisibility(const std::vector<std::pair<WindowId, bool> >& changes) = 0;
+
+    /**
+     * @brief Reads back where windows actually are, for comparison with
+     *        what applyWindowGeometries() asked for.
+     * @param windows Pairs of WindowId and a Rect, which is replaced with the
+     *                window's current outer rect (fresh from the OS, not a
+     *                cached value). Windows that no longer exist are removed.
+     * @details Called by the consuming thread a little after applying, while
+     *          the event loop may be running; like applyWindowGeometries()
+     *          it must not touch state owned by the event loop.
+     */
+    virtual void queryWindowGeometries(std::vector<std::pair<WindowId, Rect> >& windows) = 0;
 
     /**
      * @brief Enumerates all currently active monitors.
@@ -42,7 +67,11 @@ public:
      * @brief Enumerates all existing top-level windows that might be manageable.
      * @return A vector of non-owning pointers to Window objects.
      *         The PlatformManager implementation retains ownership.
-     * @note Core logic should call window->isManageable() to filter further.
+     * @note Only windows passing isManageable() and the core's window rules
+     *       (MaatMediator::classifyInitialWindows) are returned.
+     * @note Called once at startup on a worker thread, concurrently with
+     *       enumerateMonitors(); it must not touch monitor state, and the
+     *       event loop is not running yet.
      */
     virtual std::vector<Window*> enumerateInitialWindows() = 0;
 
@@ -52,10 +81,42 @@ public:
     /**
      * @brief Informs the PlatformManager that the Core is no longer tracking this WindowId.
      * @param id The ID of the window (typically one that was just destroyed).
+     * @param incarnation The value the platform passed with the window's
+     *        destroy notification (MaatMediator::notifyOsWindowDestroyed()).
      * @details Allows the PlatformManager implementation to potentially release
-     *          internal resources associated with the window object.
+     *          internal resources associated with the window object. The OS
+     *          may have reused @p id for a new window by the time this
+     *          arrives; a platform that tracks such a window before the
+     *          release compares @p incarnation to tell the two apart.
+     */
+    virtual void releaseWindowTracking(WindowId id, std::uint32_t incarnation) = 0;
+
+    /**
+     * @brief Classifies every live window again after the window rules changed.
+     * @details Reported windows the rules now ignore are withdrawn with
+     *          MaatMediator::notifyOsWindowUnmanaged(); visible, unreported
+     *          windows the rules now manage are reported as created. Windows
+     *          whose classification is unchanged produce no event.
+     * @return The number of windows withdrawn or reported.
+     */
+    virtual std::size_t reclassifyWindows() = 0;
+
+
+    /**
+     * @brief Returns the current monotonic time in microseconds.
+     * @details Used by the core to timestamp and batch events. Simulated
+     *          backends may return virtual time.
+     */
+    virtual Timestamp getMonotonicTime() const = 0;
+
+    /**
+     * @brief Asks the platform to call MaatMediator::notifyWakeup() from its
+     *        event loop once the monotonic clock reaches @p deadline.
+     * @param deadline Absolute time as returned by getMonotonicTime().
+     * @details Only one wakeup is outstanding at a time; a new request
+     *          replaces the previous one.
      */
-    virtual void releaseWindowTracking(WindowId id) = 0;
+    virtual void scheduleWakeup(Timestamp deadline) = 0;
 
 
     /**
@@ -12,9 +12,20 @@ struct Rect {
     int height;
 };
 
+inline bool operator==(const Rect& a, const Rect& b) {
+    return a.x == b.x && a.y == b.y && a.width == b.width && a.height == b.height;
+}
+
+inline bool operator!=(const Rect& a, const Rect& b) {
+    return !(a == b);
+}
+
 typedef uintptr_t WindowId;
 typedef uintptr_t MonitorId;
 
+// Monotonic time in microseconds, as reported by PlatformManager::getMonotonicTime()
+typedef std::uint64_t Timestamp;
+
 } }
 
 #endif
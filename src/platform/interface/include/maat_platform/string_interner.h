@@ -0,0 +1,54 @@
+#ifndef MAAT_PLATFORM_STRING_INTERNER_H_
+#define MAAT_PLATFORM_STRING_INTERNER_H_
+
+#include <cstddef>
+#include <mutex>
+#include <string>
+#include <unordered_set>
+
+namespace maat { namespace platform {
+
+/**
+ * @brief Pool of immutable strings shared by every window object.
+ * @details Window class names and process names repeat across thousands of
+ *          windows; interning stores each distinct value once and lets
+ *          windows hold a reference. Interned strings are never freed and
+ *          their addresses stay valid for the lifetime of the pool, so two
+ *          interned values are equal exactly when their addresses are.
+ *          Thread-safe; interning takes a lock, reading an interned string
+ *          does not.
+ */
+class StringInterner {
+public:
+    /** @brief The process-wide pool used by the platform backends. */
+    static StringInterner& global() {
+        static StringInterner interner;
+        return interner;
+    }
+
+    /** @brief Returns the pooled copy of @p value, adding it on first use. */
+    const std::string& intern(const std::string& value) {
+        if (value.empty()) return empty();
+        std::lock_guard<std::mutex> lock(m_mutex);
+        return *m_strings.insert(value).first;
+    }
+
+    /** @brief The interned empty string (no lock needed). */
+    static const std::string& empty() {
+        static const std::string value;
+        return value;
+    }
+
+    std::size_t size() const {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        return m_strings.size();
+    }
+
+private:
+    mutable std::mutex m_mutex;
+    std::unordered_set<std::string> m_strings; // node-based: element addresses are stable
+};
+
+} }
+
+#endif // MAAT_PLATFORM_STRING_INTERNER_H_
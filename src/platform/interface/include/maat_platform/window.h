@@ -1,7 +1,11 @@
 #ifndef MAAT_PLATFORM_WINDOW_H_
 #define MAAT_PLATFORM_WINDOW_H_
 
+#include <cstdint>
+#include <string>
+
 #include "platform_types.h"
+#include "window_attributes.h"
 
 namespace maat { namespace platform {
 
@@ -10,8 +14,51 @@ public:
     virtual ~Window() = default;
 
     virtual WindowId getId() const = 0;
-    virtual Rect getGeometry() const = 0;
+    /**
+     * @brief Cheap validity/state check (handle alive, window visible).
+     * @details Whether a valid window is managed is decided by the core's
+     *          window rules from the attribute getters below.
+     */
     virtual bool isManageable() const = 0;
+
+    // --- Attributes ---
+    // Each attribute is read from the OS on first use and cached in the
+    // window object until the backend sees an event that changes it (see
+    // WindowAttributeField), so repeated reads make no OS calls. Class and
+    // process names are interned (StringInterner); references stay valid
+    // for the process lifetime, titles until the next getTitle() call after
+    // a title change.
+    //
+    // Threading: the getters and isManageable() fill the cache without
+    // locking, so one object must be used by one thread at a time. Distinct
+    // objects may be used concurrently (interning is locked). Normally that
+    // thread is the platform event thread; during startup
+    // MaatMediator::classifyInitialWindows() hands disjoint batches of
+    // objects to worker threads while the event thread waits for them, and
+    // no object appears in two batches.
+
+    /** @brief Outer rect as of the last move/size the backend observed. */
+    virtual Rect getGeometry() const = 0;
+    virtual const std::string& getTitle() const = 0;
+    virtual const std::string& getClassName() const = 0;
+    virtual std::uint32_t getProcessId() const = 0;
+    virtual const std::string& getProcessName() const = 0;
+    /** @brief WindowStyleFlag bits. */
+    virtual std::uint32_t getStyleFlags() const = 0;
+    virtual SizeHints getSizeHints() const = 0;
+
+    /** @brief Reads every attribute into a value snapshot. */
+    WindowAttributes getAttributes() const {
+        WindowAttributes attributes;
+        attributes.className = getClassName();
+        attributes.title = getTitle();
+        attributes.processId = getProcessId();
+        attributes.processName = getProcessName();
+        attributes.styleFlags = getStyleFlags();
+        attributes.sizeHints = getSizeHints();
+        attributes.geometry = getGeometry();
+        return attributes;
+    }
 };
 
 } }
@@ -0,0 +1,67 @@
+#ifndef MAAT_PLATFORM_WINDOW_ATTRIBUTES_H_
+#define MAAT_PLATFORM_WINDOW_ATTRIBUTES_H_
+
+#include <cstdint>
+#include <string>
+
+#include "platform_types.h"
+
+namespace maat { namespace platform {
+
+/**
+ * @brief Platform-neutral window style bits, as reported in
+ *        WindowAttributes::styleFlags.
+ */
+enum WindowStyleFlag : std::uint32_t {
+    WindowStyleChild       = 1u << 0, ///< Not a root window (child or owned)
+    WindowStyleDisabled    = 1u << 1, ///< Does not accept input
+    WindowStylePopup       = 1u << 2, ///< Popup (menus, tooltips, splash screens)
+    WindowStyleToolWindow  = 1u << 3, ///< Tool window (kept off taskbar and Alt+Tab)
+    WindowStyleNoActivate  = 1u << 4, ///< Never becomes the foreground window
+    WindowStyleTransparent = 1u << 5, ///< Transparent to mouse input
+    WindowStyleDialog      = 1u << 6, ///< Dialog frame
+    WindowStyleResizable   = 1u << 7  ///< Has a sizing border
+};
+
+/**
+ * @brief Identifies attributes in WindowAttributes; combined as a bit mask
+ *        to say which attributes changed or which ones a consumer reads.
+ */
+enum WindowAttributeField : std::uint32_t {
+    WindowAttributeClass     = 1u << 0,
+    WindowAttributeTitle     = 1u << 1,
+    WindowAttributeProcess   = 1u << 2, ///< Process id and name
+    WindowAttributeStyle     = 1u << 3,
+    WindowAttributeSize      = 1u << 4, ///< Geometry (position and size)
+    WindowAttributeSizeHints = 1u << 5,
+    WindowAttributeAll       = (1u << 6) - 1
+};
+
+/**
+ * @brief Minimum and maximum size a window accepts; 0 means no limit.
+ */
+struct SizeHints {
+    int minWidth = 0;
+    int minHeight = 0;
+    int maxWidth = 0;
+    int maxHeight = 0;
+};
+
+/**
+ * @brief Value snapshot of a window's attributes (see the Window getters).
+ * @details Strings are UTF-8. processName is the executable file name
+ *          without its directory (e.g. "explorer.exe"); empty if unknown.
+ */
+struct WindowAttributes {
+    std::string className;
+    std::string title;
+    std::uint32_t processId = 0;
+    std::string processName;
+    std::uint32_t styleFlags = 0; ///< WindowStyleFlag bits
+    SizeHints sizeHints;
+    Rect geometry{0, 0, 0, 0};
+};
+
+} }
+
+#endif // MAAT_PLATFORM_WINDOW_ATTRIBUTES_H_
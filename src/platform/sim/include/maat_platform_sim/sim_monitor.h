@@ -0,0 +1,31 @@
+#ifndef MAAT_PLATFORM_SIM_SIM_MONITOR_H_
+#define MAAT_PLATFORM_SIM_SIM_MONITOR_H_
+
+#include "maat_platform/monitor.h"
+#include "maat_platform/platform_types.h"
+
+namespace maat { namespace platform {
+
+class SimMonitor final : public Monitor {
+public:
+    SimMonitor(MonitorId id, const Rect& workArea);
+    ~SimMonitor() override = default;
+
+    // Prevent copy and assignment
+    SimMonitor(const SimMonitor&) = delete;
+    SimMonitor& operator=(const SimMonitor&) = delete;
+
+    MonitorId getId() const override;
+    Rect getWorkArea() const override;
+
+    // --- Simulation controls ---
+    void setWorkArea(const Rect& workArea);
+
+private:
+    MonitorId m_id;
+    Rect m_workArea;
+};
+
+} } // namespace maat::platform
+
+#endif // MAAT_PLATFORM_SIM_SIM_MONITOR_H_
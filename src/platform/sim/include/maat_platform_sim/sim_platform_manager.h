@@ -0,0 +1,242 @@
+#ifndef MAAT_PLATFORM_SIM_SIM_PLATFORM_MANAGER_H_
+#define MAAT_PLATFORM_SIM_SIM_PLATFORM_MANAGER_H_
+
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <utility>
+#include <vector>
+
+#include <maat_core/flat_id_map.h>
+
+#include "maat_platform/object_pool.h"
+#include "maat_platform/platform_manager.h"
+#include "maat_platform/platform_types.h"
+#include "maat_platform_sim/sim_monitor.h"
+#include "maat_platform_sim/sim_window.h"
+#include "maat_platform_sim/virtual_clock.h"
+
+namespace maat { namespace core { class MaatMediator; } }
+
+namespace maat::platform {
+
+/**
+ * @brief One recorded call to applyWindowGeometries().
+ */
+struct SimGeometryBatch {
+    std::uint64_t time; // Virtual time (microseconds) at which the batch was applied
+    std::vector<std::pair<WindowId, Rect>> updates;
+};
+
+/**
+ * @brief One recorded call to setWindowVisibility().
+ */
+struct SimVisibilityBatch {
+    std::uint64_t time;
+    std::vector<std::pair<WindowId, bool>> changes;
+};
+
+/**
+ * @brief Headless, in-memory PlatformManager used to build, benchmark and
+ *        test the core without an operating system.
+ * @details Windows and monitors live purely in memory. Scripted OS events are
+ *          delivered to the mediator with the same semantics as the Windows
+ *          backend (create is tracked, show reports manageable windows,
+ *          destroy waits for releaseWindowTracking). Time is driven by a
+ *          VirtualClock so every run is deterministic. Not thread-safe apart
+ *          from stopEventLoop().
+ */
+class SimPlatformManager final : public PlatformManager {
+public:
+    explicit SimPlatformManager(maat::core::MaatMediator& mediator);
+    ~SimPlatformManager() override;
+
+    // Prevent copy and assignment
+    SimPlatformManager(const SimPlatformManager&) = delete;
+    SimPlatformManager& operator=(const SimPlatformManager&) = delete;
+
+    // --- PlatformManager Interface Overrides ---
+
+    void applyWindowGeometries(const std::vector<std::pair<WindowId, Rect>>& updates) override;
+    void setWindowVisibility(const std::vector<std::pair<WindowId, bool>>& changes) override;
+    void queryWindowGeometries(std::vector<std::pair<WindowId, Rect>>& windows) override;
+    std::vector<Monitor*> enumerateMonitors() override;
+    std::vector<Window*> enumerateInitialWindows() override;
+
+    void releaseWindowTracking(WindowId id, std::uint32_t incarnation) override;
+    std::size_t reclassifyWindows() override;
+
+    // Virtual time from clock()
+    Timestamp getMonotonicTime() const override;
+    // Schedules MaatMediator::notifyWakeup() on the virtual timeline
+    void scheduleWakeup(Timestamp deadline) override;
+
+    /**
+     * @brief Runs scheduled actions in time order until none remain or
+     *        stopEventLoop() is called, advancing the virtual clock as it goes.
+     */
+    void startEventLoop() override;
+    void stopEventLoop() override;
+
+    // --- Monitors ---
+
+    /**
+     * @brief Adds a monitor. Emits a monitor layout change unless @p silent.
+     */
+    MonitorId addMonitor(const Rect& workArea, bool silent = false);
+    void removeMonitor(MonitorId id);
+    void setMonitorWorkArea(MonitorId id, const Rect& workArea);
+
+    /**
+     * @brief Replaces every monitor with @p monitors, keeping their ids.
+     * @details No events are emitted (used by trace replay, which delivers
+     *          the recorded layout change itself).
+     */
+    void replaceMonitors(const std::vector<std::pair<MonitorId, Rect>>& monitors);
+
+    // --- Windows ---
+
+    /**
+     * @brief Adds a visible window that existed before startup.
+     * @details No events are emitted; the window is discovered through
+     *          enumerateInitialWindows().
+     */
+    WindowId seedWindow(const Rect& geometry, bool manageable = true);
+
+    /**
+     * @brief Makes a visible, manageable window with the given id exist
+     *        without emitting events, updating its geometry if it already does.
+     * @details Used by trace replay, where the recorded events are delivered
+     *          to the mediator directly.
+     */
+    void adoptWindow(WindowId id, const Rect& geometry);
+
+    /**
+     * @brief Creates a window (EVENT_OBJECT_CREATE). It is reported to the
+     *        mediator once shown.
+     * @param id Explicit id, or 0 to allocate a fresh one. Passing the id of a
+     *           released window simulates OS handle reuse.
+     */
+    WindowId createWindow(const Rect& geometry, bool manageable = true, WindowId id = 0);
+    void showWindow(WindowId id);
+    void destroyWindow(WindowId id);
+
+    /**
+     * @brief Changes a window's class, title, process, style or size hints
+     *        (EVENT_OBJECT_NAMECHANGE / EVENT_OBJECT_STATECHANGE).
+     * @details Invalidates the window's cached attributes and rule decision;
+     *          a shown window that was ignored is reported if the rules now
+     *          manage it, and a reported one the rules now ignore is
+     *          withdrawn (notifyOsWindowUnmanaged).
+     */
+    void setWindowAttributes(WindowId id, const WindowAttributes& attributes);
+
+    /**
+     * @brief Makes a window accept sizes only in steps (terminal character
+     *        cells). No events are emitted.
+     * @details applyWindowGeometries() rounds requested sizes down to the
+     *          step and holds them within the window's size hints.
+     */
+    void setWindowSizeStep(WindowId id, int widthStep, int heightStep);
+
+    /**
+     * @brief Simulates the user finishing an interactive move/size
+     *        (EVENT_SYSTEM_MOVESIZEEND).
+     */
+    void moveSizeWindow(WindowId id, const Rect& geometry);
+
+    // --- Scripting ---
+
+    /**
+     * @brief Queues @p action to run when the virtual clock reaches @p timeMicros.
+     * @details Actions scheduled for the same time run in insertion order.
+     */
+    void scheduleAt(std::uint64_t timeMicros, std::function<void()> action);
+    void scheduleAfter(std::uint64_t delayMicros, std::function<void()> action);
+
+    /**
+     * @brief Advances the clock by @p deltaMicros, running every action that
+     *        becomes due on the way.
+     */
+    void advanceTime(std::uint64_t deltaMicros);
+
+    /**
+     * @brief Runs the next scheduled action, jumping the clock to its time.
+     * @return false if nothing was scheduled.
+     */
+    bool runNext();
+    void runUntilIdle();
+    std::size_t pendingActionCount() const;
+
+    VirtualClock& clock();
+    const VirtualClock& clock() const;
+
+    // --- Inspection ---
+
+    const std::vector<SimGeometryBatch>& appliedBatches() const;
+    const std::vector<SimVisibilityBatch>& visibilityBatches() const;
+    // Clears both the geometry and the visibility batches
+    void clearAppliedBatches();
+    std::size_t appliedUpdateCount() const;
+
+    const SimWindow* findWindow(WindowId id) const;
+    const SimMonitor* findMonitor(MonitorId id) const;
+    std::size_t windowCount() const;
+
+    /**
+     * @brief Allocation counters of the window and monitor object pools.
+     */
+    const ObjectPoolStats& windowPoolStats() const;
+    const ObjectPoolStats& monitorPoolStats() const;
+
+    /**
+     * @brief Returns the monitor whose work area contains the centre of
+     *        @p geometry, falling back to the nearest one (MONITOR_DEFAULTTONEAREST).
+     */
+    MonitorId monitorFromRect(const Rect& geometry) const;
+
+private:
+    SimWindow* lookupWindow(WindowId id);
+    WindowId allocateWindowId();
+    void insertWindow(WindowId id, ObjectPool<SimWindow>::Handle window);
+    // Reports a shown window not yet reported if it is valid and the rules
+    // manage it; true if it was reported now
+    bool reportIfManaged(WindowId id, SimWindow* window);
+
+    // Object storage; declared before the maps so every handle is returned first
+    ObjectPool<SimMonitor> m_monitorPool{8};
+    ObjectPool<SimWindow> m_windowPool;
+
+    struct TrackedWindow {
+        ObjectPool<SimWindow>::Handle window;
+        bool reported = false; // notifyOsWindowCreated sent and still standing
+    };
+
+    // Ownership maps: The manager owns these objects. Windows are looked up
+    // on every event, so they sit in a flat table like the core's registry.
+    std::map<MonitorId, ObjectPool<SimMonitor>::Handle> m_monitors;
+    maat::core::FlatIdMap<TrackedWindow> m_windows;
+    // Creation order; enumerateInitialWindows() reports in this order, the
+    // way the OS reports its z-order. Released ids are pruned lazily.
+    std::vector<WindowId> m_creationOrder;
+
+    // Mediator reference
+    maat::core::MaatMediator& m_mediator;
+
+    VirtualClock m_clock;
+    std::multimap<std::uint64_t, std::function<void()>> m_schedule;
+    std::vector<SimGeometryBatch> m_appliedBatches;
+    std::vector<SimVisibilityBatch> m_visibilityBatches;
+    std::size_t m_appliedUpdateCount = 0;
+
+    std::uint64_t m_wakeupGeneration = 0; // invalidates superseded wakeups
+
+    WindowId m_nextWindowId = 0x1000;
+    MonitorId m_nextMonitorId = 0x10;
+    std::atomic<bool> m_stopEventLoop{false};
+};
+
+} // namespace maat::platform
+
+#endif // MAAT_PLATFORM_SIM_SIM_PLATFORM_MANAGER_H_
@@ -0,0 +1,90 @@
+#ifndef MAAT_PLATFORM_SIM_SIM_WINDOW_H_
+#define MAAT_PLATFORM_SIM_SIM_WINDOW_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+#include "maat_platform/platform_types.h"
+#include "maat_platform/string_interner.h"
+#include "maat_platform/window.h"
+
+namespace maat { namespace platform {
+
+class SimWindow final : public Window {
+public:
+    SimWindow(WindowId id, const Rect& geometry, bool manageable);
+    ~SimWindow() override = default;
+
+    // Prevent copy and assignment
+    SimWindow(const SimWindow&) = delete;
+    SimWindow& operator=(const SimWindow&) = delete;
+
+    WindowId getId() const override;
+    bool isManageable() const override;
+    // Geometry is a plain field in the simulation and is read directly
+    Rect getGeometry() const override;
+
+    // Cached like the Windows backend: each miss counts as one simulated OS
+    // query, and cached values survive setAttributes() until invalidated
+    const std::string& getTitle() const override;
+    const std::string& getClassName() const override;
+    std::uint32_t getProcessId() const override;
+    const std::string& getProcessName() const override;
+    std::uint32_t getStyleFlags() const override;
+    SizeHints getSizeHints() const override;
+
+    /** @brief Drops cached attributes (WindowAttributeField bits). */
+    void invalidateAttributes(std::uint32_t fields);
+    /** @brief Simulated OS queries made by the attribute getters so far. */
+    std::size_t attributeQueryCount() const;
+
+    // --- Simulation controls ---
+    void setGeometry(const Rect& geometry);
+    /**
+     * @brief The rect the window ends up with when a program asks for
+     *        @p requested: the size is rounded down to the size step, then
+     *        held within the OS-side size hints (WM_GETMINMAXINFO); the
+     *        top-left corner is kept.
+     */
+    Rect constrainGeometry(const Rect& requested) const;
+    /**
+     * @brief Sizes the window accepts come in steps (character cells of a
+     *        terminal); 0 or 1 accepts any size.
+     */
+    void setSizeStep(int widthStep, int heightStep);
+    void setManageable(bool manageable);
+    void setVisible(bool visible);
+    bool isVisible() const;
+    /**
+     * @brief Changes the OS-side class, title, process, style and size hints
+     *        (geometry is kept). Does not invalidate the cache.
+     * @return WindowAttributeField bits of the attributes that changed.
+     */
+    std::uint32_t setAttributes(const WindowAttributes& attributes);
+
+private:
+    bool cached(std::uint32_t field) const;
+
+    WindowId m_id;
+    Rect m_geometry;
+    WindowAttributes m_os; // OS-side attributes; geometry unused, m_geometry is authoritative
+    bool m_manageable;
+    bool m_visible = false;
+    int m_widthStep = 0;
+    int m_heightStep = 0;
+
+    // Attribute cache
+    mutable std::uint32_t m_cachedFields = 0;
+    mutable std::string m_title;
+    mutable const std::string* m_className = &StringInterner::empty();
+    mutable const std::string* m_processName = &StringInterner::empty();
+    mutable std::uint32_t m_processId = 0;
+    mutable std::uint32_t m_styleFlags = 0;
+    mutable SizeHints m_sizeHints;
+    mutable std::size_t m_attributeQueries = 0;
+};
+
+} } // namespace maat::platform
+
+#endif // MAAT_PLATFORM_SIM_SIM_WINDOW_H_
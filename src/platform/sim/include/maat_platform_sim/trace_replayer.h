@@ -0,0 +1,72 @@
+#ifndef MAAT_PLATFORM_SIM_TRACE_REPLAYER_H_
+#define MAAT_PLATFORM_SIM_TRACE_REPLAYER_H_
+
+#include <cstddef>
+#include <cstdint>
+
+#include "maat_platform/platform_types.h"
+
+namespace maat { namespace core {
+class EventTrace;
+class MaatMediator;
+} }
+
+namespace maat::platform {
+
+class SimPlatformManager;
+
+/**
+ * @brief Feeds a recorded EventTrace back through a MaatMediator wired to a
+ *        SimPlatformManager.
+ * @details The recorded monitors and initial windows are installed in the
+ *          sim and the mediator is initialized; every recorded event is then
+ *          posted with its original spacing on the sim's virtual clock, so
+ *          coalescing and layout behave as they did on the recording machine.
+ *          Geometry the core applies ends up in the sim's appliedBatches().
+ *          The mediator must be in ThreadingMode::Inline and not initialized
+ *          yet; the sim must not have windows or monitors of its own.
+ */
+class TraceReplayer {
+public:
+    enum class Pacing {
+        AsFastAsPossible, ///< Jump the virtual clock from event to event
+        RecordedSpeed     ///< Also sleep so events arrive at their recorded wall-clock spacing
+    };
+
+    struct Result {
+        std::size_t eventsReplayed = 0;
+        std::size_t monitorSnapshots = 0;
+        std::size_t initialWindows = 0;
+        Timestamp virtualMicros = 0; ///< Span of the trace on the virtual clock
+        std::uint64_t wallMicros = 0;
+    };
+
+    TraceReplayer(const maat::core::EventTrace& trace, maat::core::MaatMediator& mediator,
+                  SimPlatformManager& platform);
+
+    void setPacing(Pacing pacing) { m_pacing = pacing; }
+
+    /**
+     * @brief Replays the whole trace, then flushes pending coalesced events.
+     */
+    Result run();
+
+    /**
+     * @brief Virtual time the first record is replayed at. Leaves room for the
+     *        recorded hook delays, which are subtracted from it.
+     */
+    Timestamp replayEpoch() const { return m_epoch; }
+
+private:
+    void applySnapshot(std::size_t recordIndex);
+
+    const maat::core::EventTrace& m_trace;
+    maat::core::MaatMediator& m_mediator;
+    SimPlatformManager& m_platform;
+    Pacing m_pacing = Pacing::AsFastAsPossible;
+    Timestamp m_epoch = 0;
+};
+
+} // namespace maat::platform
+
+#endif // MAAT_PLATFORM_SIM_TRACE_REPLAYER_H_
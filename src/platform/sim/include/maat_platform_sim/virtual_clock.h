@@ -0,0 +1,32 @@
+#ifndef MAAT_PLATFORM_SIM_VIRTUAL_CLOCK_H_
+#define MAAT_PLATFORM_SIM_VIRTUAL_CLOCK_H_
+
+#include <cstdint>
+
+namespace maat { namespace platform {
+
+/**
+ * @brief Deterministic monotonic clock for the simulated backend.
+ * @details Time is expressed in microseconds and only moves when the
+ *          simulation advances it, so runs are reproducible.
+ */
+class VirtualClock {
+public:
+    std::uint64_t now() const { return m_now; }
+
+    void advanceBy(std::uint64_t deltaMicros) { m_now += deltaMicros; }
+
+    // Never moves backwards; earlier targets are ignored.
+    void advanceTo(std::uint64_t timeMicros) {
+        if (timeMicros > m_now) {
+            m_now = timeMicros;
+        }
+    }
+
+private:
+    std::uint64_t m_now = 0;
+};
+
+} } // namespace maat::platform
+
+#endif // MAAT_PLATFORM_SIM_VIRTUAL_CLOCK_H_
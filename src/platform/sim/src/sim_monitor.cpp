@@ -0,0 +1,20 @@
+#include "maat_platform_sim/sim_monitor.h"
+
+namespace maat { namespace platform {
+
+SimMonitor::SimMonitor(MonitorId id, const Rect& workArea)
+    : m_id(id), m_workArea(workArea) {}
+
+MonitorId SimMonitor::getId() const {
+    return m_id;
+}
+
+Rect SimMonitor::getWorkArea() const {
+    return m_workArea;
+}
+
+void SimMonitor::setWorkArea(const Rect& workArea) {
+    m_workArea = workArea;
+}
+
+} } // namespace maat::platform
@@ -0,0 +1,429 @@
+#include "maat_platform_sim/sim_platform_manager.h"
+#include <maat_core/maat_mediator.h>
+
+#include <cstdint>
+#include <limits>
+
+namespace maat::platform {
+
+namespace {
+
+bool containsPoint(const Rect& rect, int x, int y) {
+    return x >= rect.x && x < rect.x + rect.width &&
+           y >= rect.y && y < rect.y + rect.height;
+}
+
+// Manhattan distance from a point to the closest edge of a rect (0 if inside)
+long long distanceToRect(const Rect& rect, int x, int y) {
+    long long dx = 0;
+    long long dy = 0;
+    if (x < rect.x) dx = rect.x - x;
+    else if (x >= rect.x + rect.width) dx = x - (rect.x + rect.width - 1);
+    if (y < rect.y) dy = rect.y - y;
+    else if (y >= rect.y + rect.height) dy = y - (rect.y + rect.height - 1);
+    return dx + dy;
+}
+
+} // namespace
+
+// --- Constructor & Destructor ---
+
+SimPlatformManager::SimPlatformManager(maat::core::MaatMediator& mediator) :
+    m_mediator(mediator)
+{}
+
+SimPlatformManager::~SimPlatformManager() = default;
+
+// --- PlatformManager Interface Implementation ---
+
+void SimPlatformManager::applyWindowGeometries(const std::vector<std::pair<WindowId, Rect>>& updates) {
+    if (updates.empty()) return;
+
+    for (const auto& update : updates) {
+        // Like the Windows backend, silently skip windows that no longer exist.
+        // The window has the last word on its size, as a real one would.
+        if (SimWindow* window = lookupWindow(update.first)) {
+            window->setGeometry(window->constrainGeometry(update.second));
+        }
+    }
+
+    m_appliedUpdateCount += updates.size();
+    m_appliedBatches.push_back({m_clock.now(), updates});
+}
+
+void SimPlatformManager::setWindowVisibility(const std::vector<std::pair<WindowId, bool>>& changes) {
+    if (changes.empty()) return;
+
+    for (const auto& change : changes) {
+        if (SimWindow* window = lookupWindow(change.first)) {
+            window->setVisible(change.second);
+        }
+    }
+    m_visibilityBatches.push_back({m_clock.now(), changes});
+}
+
+void SimPlatformManager::queryWindowGeometries(std::vector<std::pair<WindowId, Rect>>& windows) {
+    std::size_t kept = 0;
+    for (const auto& entry : windows) {
+        if (const SimWindow* window = lookupWindow(entry.first)) {
+            windows[kept++] = {entry.first, window->getGeometry()};
+        }
+    }
+    windows.resize(kept);
+}
+
+std::vector<Monitor*> SimPlatformManager::enumerateMonitors() {
+    std::vector<Monitor*> result;
+    result.reserve(m_monitors.size());
+    for (auto const& [id, monitor] : m_monitors) {
+        result.push_back(monitor.get());
+    }
+    return result;
+}
+
+std::vector<Window*> SimPlatformManager::enumerateInitialWindows() {
+    std::vector<Window*> candidates;
+    candidates.reserve(m_windows.size());
+    std::size_t kept = 0;
+    for (WindowId id : m_creationOrder) {
+        TrackedWindow* tracked = m_windows.find(id);
+        if (!tracked) continue; // Released
+        m_creationOrder[kept++] = id;
+        tracked->reported = false;
+        candidates.push_back(tracked->window.get());
+    }
+    m_creationOrder.resize(kept);
+
+    std::vector<std::uint8_t> manage;
+    m_mediator.classifyInitialWindows(candidates, manage);
+    std::vector<Window*> result;
+    result.reserve(candidates.size());
+    for (std::size_t i = 0; i < candidates.size(); ++i) {
+        if (!manage[i]) continue;
+        TrackedWindow* tracked = m_windows.find(candidates[i]->getId());
+        if (!tracked->reported) {
+            tracked->reported = true;
+            result.push_back(candidates[i]);
+        }
+    }
+    return result;
+}
+
+void SimPlatformManager::releaseWindowTracking(WindowId id, std::uint32_t /*incarnation*/) {
+    // createWindow() never reuses an id before its release, so there is only
+    // ever the one tracking to end
+    m_windows.erase(id);
+}
+
+std::size_t SimPlatformManager::reclassifyWindows() {
+    // In creation order, so the notifications come out in a reproducible order
+    std::size_t flipped = 0;
+    for (WindowId id : m_creationOrder) {
+        TrackedWindow* tracked = m_windows.find(id);
+        if (!tracked) continue; // Released
+        SimWindow* window = tracked->window.get();
+        if (tracked->reported) {
+            if (!m_mediator.classifyWindow(*window)) {
+                tracked->reported = false;
+                m_mediator.notifyOsWindowUnmanaged(id);
+                ++flipped;
+            }
+        } else if (window->isVisible()) {
+            flipped += reportIfManaged(id, window) ? 1 : 0;
+        }
+    }
+    return flipped;
+}
+
+Timestamp SimPlatformManager::getMonotonicTime() const {
+    return m_clock.now();
+}
+
+void SimPlatformManager::scheduleWakeup(Timestamp deadline) {
+    const std::uint64_t generation = ++m_wakeupGeneration;
+    scheduleAt(deadline, [this, generation]() {
+        if (generation == m_wakeupGeneration) {
+            m_mediator.notifyWakeup();
+        }
+    });
+}
+
+void SimPlatformManager::startEventLoop() {
+    m_stopEventLoop = false;
+    while (!m_stopEventLoop && runNext()) {
+    }
+}
+
+void SimPlatformManager::stopEventLoop() {
+    m_stopEventLoop = true;
+}
+
+// --- Monitors ---
+
+MonitorId SimPlatformManager::addMonitor(const Rect& workArea, bool silent) {
+    MonitorId id = m_nextMonitorId++;
+    m_monitors[id] = m_monitorPool.acquire(id, workArea);
+    if (!silent) {
+        m_mediator.notifyOsMonitorLayoutChanged();
+    }
+    return id;
+}
+
+void SimPlatformManager::removeMonitor(MonitorId id) {
+    if (m_monitors.erase(id) != 0) {
+        m_mediator.notifyOsMonitorLayoutChanged();
+    }
+}
+
+void SimPlatformManager::setMonitorWorkArea(MonitorId id, const Rect& workArea) {
+    auto it = m_monitors.find(id);
+    if (it != m_monitors.end()) {
+        it->second->setWorkArea(workArea);
+        m_mediator.notifyOsMonitorLayoutChanged();
+    }
+}
+
+void SimPlatformManager::replaceMonitors(const std::vector<std::pair<MonitorId, Rect>>& monitors) {
+    m_monitors.clear();
+    for (const auto& [id, workArea] : monitors) {
+        m_monitors[id] = m_monitorPool.acquire(id, workArea);
+        if (id >= m_nextMonitorId) {
+            m_nextMonitorId = id + 1;
+        }
+    }
+}
+
+// --- Windows ---
+
+WindowId SimPlatformManager::seedWindow(const Rect& geometry, bool manageable) {
+    WindowId id = allocateWindowId();
+    auto window = m_windowPool.acquire(id, geometry, manageable);
+    window->setVisible(true);
+    insertWindow(id, std::move(window));
+    return id;
+}
+
+void SimPlatformManager::adoptWindow(WindowId id, const Rect& geometry) {
+    if (SimWindow* window = lookupWindow(id)) {
+        window->setGeometry(geometry);
+        window->setVisible(true);
+        return;
+    }
+    auto window = m_windowPool.acquire(id, geometry, true);
+    window->setVisible(true);
+    insertWindow(id, std::move(window));
+}
+
+WindowId SimPlatformManager::createWindow(const Rect& geometry, bool manageable, WindowId id) {
+    if (id == 0) {
+        id = allocateWindowId();
+    } else if (m_windows.contains(id)) {
+        // Handle still live (destroyed but not yet released); the OS would not reuse it
+        return 0;
+    }
+    insertWindow(id, m_windowPool.acquire(id, geometry, manageable));
+    return id;
+}
+
+void SimPlatformManager::showWindow(WindowId id) {
+    SimWindow* window = lookupWindow(id);
+    if (!window) return;
+
+    window->setVisible(true);
+    reportIfManaged(id, window);
+}
+
+void SimPlatformManager::setWindowAttributes(WindowId id, const WindowAttributes& attributes) {
+    SimWindow* window = lookupWindow(id);
+    if (!window) return;
+
+    const std::uint32_t changed = window->setAttributes(attributes);
+    if (changed == 0) return;
+    window->invalidateAttributes(changed);
+    const bool relevant = m_mediator.invalidateWindowClassification(id, changed);
+    TrackedWindow* tracked = m_windows.find(id);
+    if (relevant && tracked && tracked->reported) {
+        if (!m_mediator.classifyWindow(*window)) {
+            tracked->reported = false;
+            m_mediator.notifyOsWindowUnmanaged(id);
+        }
+        return;
+    }
+    reportIfManaged(id, window);
+}
+
+bool SimPlatformManager::reportIfManaged(WindowId id, SimWindow* window) {
+    TrackedWindow* tracked = m_windows.find(id);
+    if (!tracked || tracked->reported || !window->isManageable() || !m_mediator.classifyWindow(*window)) {
+        return false;
+    }
+    tracked->reported = true;
+    m_mediator.notifyOsWindowCreated(window);
+    return true;
+}
+
+void SimPlatformManager::destroyWindow(WindowId id) {
+    SimWindow* window = lookupWindow(id);
+    if (!window) return;
+
+    window->setVisible(false);
+    // The core MUST call releaseWindowTracking later; the object stays until then.
+    m_mediator.notifyOsWindowDestroyed(id);
+    m_mediator.forgetWindowClassification(id); // the handle may be reused
+    if (TrackedWindow* tracked = m_windows.find(id)) tracked->reported = false;
+}
+
+void SimPlatformManager::setWindowSizeStep(WindowId id, int widthStep, int heightStep) {
+    if (SimWindow* window = lookupWindow(id)) {
+        window->setSizeStep(widthStep, heightStep);
+    }
+}
+
+void SimPlatformManager::moveSizeWindow(WindowId id, const Rect& geometry) {
+    SimWindow* window = lookupWindow(id);
+    if (!window) return;
+
+    window->setGeometry(geometry);
+    MonitorId monitorId = monitorFromRect(geometry);
+    if (monitorId != 0) {
+        m_mediator.notifyOsWindowMonitorChanged(id, monitorId);
+    }
+}
+
+// --- Scripting ---
+
+void SimPlatformManager::scheduleAt(std::uint64_t timeMicros, std::function<void()> action) {
+    m_schedule.emplace(timeMicros, std::move(action));
+}
+
+void SimPlatformManager::scheduleAfter(std::uint64_t delayMicros, std::function<void()> action) {
+    scheduleAt(m_clock.now() + delayMicros, std::move(action));
+}
+
+void SimPlatformManager::advanceTime(std::uint64_t deltaMicros) {
+    const std::uint64_t target = m_clock.now() + deltaMicros;
+    while (!m_schedule.empty() && m_schedule.begin()->first <= target) {
+        runNext();
+    }
+    m_clock.advanceTo(target);
+}
+
+bool SimPlatformManager::runNext() {
+    if (m_schedule.empty()) return false;
+
+    auto it = m_schedule.begin();
+    m_clock.advanceTo(it->first);
+    // Detach before running: the action may schedule further actions
+    std::function<void()> action = std::move(it->second);
+    m_schedule.erase(it);
+    action();
+    return true;
+}
+
+void SimPlatformManager::runUntilIdle() {
+    while (runNext()) {
+    }
+}
+
+std::size_t SimPlatformManager::pendingActionCount() const {
+    return m_schedule.size();
+}
+
+VirtualClock& SimPlatformManager::clock() {
+    return m_clock;
+}
+
+const VirtualClock& SimPlatformManager::clock() const {
+    return m_clock;
+}
+
+// --- Inspection ---
+
+const std::vector<SimGeometryBatch>& SimPlatformManager::appliedBatches() const {
+    return m_appliedBatches;
+}
+
+const std::vector<SimVisibilityBatch>& SimPlatformManager::visibilityBatches() const {
+    return m_visibilityBatches;
+}
+
+void SimPlatformManager::clearAppliedBatches() {
+    m_appliedBatches.clear();
+    m_visibilityBatches.clear();
+    m_appliedUpdateCount = 0;
+}
+
+std::size_t SimPlatformManager::appliedUpdateCount() const {
+    return m_appliedUpdateCount;
+}
+
+const SimWindow* SimPlatformManager::findWindow(WindowId id) const {
+    const TrackedWindow* tracked = m_windows.find(id);
+    return tracked ? tracked->window.get() : nullptr;
+}
+
+const SimMonitor* SimPlatformManager::findMonitor(MonitorId id) const {
+    auto it = m_monitors.find(id);
+    return it != m_monitors.end() ? it->second.get() : nullptr;
+}
+
+std::size_t SimPlatformManager::windowCount() const {
+    return m_windows.size();
+}
+
+const ObjectPoolStats& SimPlatformManager::windowPoolStats() const {
+    return m_windowPool.stats();
+}
+
+const ObjectPoolStats& SimPlatformManager::monitorPoolStats() const {
+    return m_monitorPool.stats();
+}
+
+MonitorId SimPlatformManager::monitorFromRect(const Rect& geometry) const {
+    const int cx = geometry.x + geometry.width / 2;
+    const int cy = geometry.y + geometry.height / 2;
+
+    MonitorId nearest = 0;
+    long long nearestDistance = std::numeric_limits<long long>::max();
+    for (auto const& [id, monitor] : m_monitors) {
+        const Rect area = monitor->getWorkArea();
+        if (containsPoint(area, cx, cy)) {
+            return id;
+        }
+        long long distance = distanceToRect(area, cx, cy);
+        if (distance < nearestDistance) {
+            nearestDistance = distance;
+            nearest = id;
+        }
+    }
+    return nearest;
+}
+
+// --- Private Helpers ---
+
+SimWindow* SimPlatformManager::lookupWindow(WindowId id) {
+    TrackedWindow* tracked = m_windows.find(id);
+    return tracked ? tracked->window.get() : nullptr;
+}
+
+void SimPlatformManager::insertWindow(WindowId id, ObjectPool<SimWindow>::Handle window) {
+    m_windows[id] = TrackedWindow{std::move(window), false};
+    if (m_creationOrder.size() > 2 * m_windows.size() + 64) {
+        // Drop released ids so create/destroy churn stays amortised O(1)
+        std::size_t kept = 0;
+        for (WindowId existing : m_creationOrder) {
+            if (m_windows.contains(existing)) m_creationOrder[kept++] = existing;
+        }
+        m_creationOrder.resize(kept);
+    }
+    m_creationOrder.push_back(id);
+}
+
+WindowId SimPlatformManager::allocateWindowId() {
+    while (m_windows.contains(m_nextWindowId)) {
+        ++m_nextWindowId;
+    }
+    return m_nextWindowId++;
+}
+
+} // namespace maat::platform
@@ -0,0 +1,124 @@
+#include "maat_platform_sim/sim_window.h"
+
+namespace maat { namespace platform {
+
+SimWindow::SimWindow(WindowId id, const Rect& geometry, bool manageable)
+    : m_id(id), m_geometry(geometry), m_manageable(manageable) {
+    m_os.className = "SimWindow";
+    m_os.processName = "sim.exe";
+    m_os.processId = 1;
+}
+
+WindowId SimWindow::getId() const {
+    return m_id;
+}
+
+Rect SimWindow::getGeometry() const {
+    return m_geometry;
+}
+
+bool SimWindow::isManageable() const {
+    // Mirrors the Windows backend: hidden windows are never manageable
+    return m_visible && m_manageable;
+}
+
+bool SimWindow::cached(std::uint32_t field) const {
+    if (m_cachedFields & field) return true;
+    m_cachedFields |= field;
+    ++m_attributeQueries;
+    return false;
+}
+
+const std::string& SimWindow::getTitle() const {
+    if (!cached(WindowAttributeTitle)) m_title = m_os.title;
+    return m_title;
+}
+
+const std::string& SimWindow::getClassName() const {
+    if (!cached(WindowAttributeClass)) m_className = &StringInterner::global().intern(m_os.className);
+    return *m_className;
+}
+
+std::uint32_t SimWindow::getProcessId() const {
+    if (!cached(WindowAttributeProcess)) {
+        m_processId = m_os.processId;
+        m_processName = &StringInterner::global().intern(m_os.processName);
+    }
+    return m_processId;
+}
+
+const std::string& SimWindow::getProcessName() const {
+    getProcessId(); // one query fills both
+    return *m_processName;
+}
+
+std::uint32_t SimWindow::getStyleFlags() const {
+    if (!cached(WindowAttributeStyle)) m_styleFlags = m_os.styleFlags;
+    return m_styleFlags;
+}
+
+SizeHints SimWindow::getSizeHints() const {
+    if (!cached(WindowAttributeSizeHints)) m_sizeHints = m_os.sizeHints;
+    return m_sizeHints;
+}
+
+void SimWindow::invalidateAttributes(std::uint32_t fields) {
+    m_cachedFields &= ~fields;
+}
+
+std::size_t SimWindow::attributeQueryCount() const {
+    return m_attributeQueries;
+}
+
+std::uint32_t SimWindow::setAttributes(const WindowAttributes& attributes) {
+    std::uint32_t changed = 0;
+    if (attributes.className != m_os.className) changed |= WindowAttributeClass;
+    if (attributes.title != m_os.title) changed |= WindowAttributeTitle;
+    if (attributes.processId != m_os.processId || attributes.processName != m_os.processName) {
+        changed |= WindowAttributeProcess;
+    }
+    if (attributes.styleFlags != m_os.styleFlags) changed |= WindowAttributeStyle;
+    if (attributes.sizeHints.minWidth != m_os.sizeHints.minWidth ||
+        attributes.sizeHints.minHeight != m_os.sizeHints.minHeight ||
+        attributes.sizeHints.maxWidth != m_os.sizeHints.maxWidth ||
+        attributes.sizeHints.maxHeight != m_os.sizeHints.maxHeight) {
+        changed |= WindowAttributeSizeHints;
+    }
+    m_os = attributes;
+    return changed;
+}
+
+void SimWindow::setGeometry(const Rect& geometry) {
+    m_geometry = geometry;
+}
+
+Rect SimWindow::constrainGeometry(const Rect& requested) const {
+    Rect result = requested;
+    if (m_widthStep > 1 && result.width > m_widthStep) result.width -= result.width % m_widthStep;
+    if (m_heightStep > 1 && result.height > m_heightStep) result.height -= result.height % m_heightStep;
+    const SizeHints& hints = m_os.sizeHints;
+    if (hints.maxWidth > 0 && result.width > hints.maxWidth) result.width = hints.maxWidth;
+    if (hints.maxHeight > 0 && result.height > hints.maxHeight) result.height = hints.maxHeight;
+    if (result.width < hints.minWidth) result.width = hints.minWidth;
+    if (result.height < hints.minHeight) result.height = hints.minHeight;
+    return result;
+}
+
+void SimWindow::setSizeStep(int widthStep, int heightStep) {
+    m_widthStep = widthStep;
+    m_heightStep = heightStep;
+}
+
+void SimWindow::setManageable(bool manageable) {
+    m_manageable = manageable;
+}
+
+void SimWindow::setVisible(bool visible) {
+    m_visible = visible;
+}
+
+bool SimWindow::isVisible() const {
+    return m_visible;
+}
+
+} } // namespace maat::platform
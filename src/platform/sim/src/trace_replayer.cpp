@@ -0,0 +1,129 @@
+#include "maat_platform_sim/trace_replayer.h"
+#include <maat_core/event_trace.h>
+#include <maat_core/maat_mediator.h>
+
+#include <chrono>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "maat_platform_sim/sim_platform_manager.h"
+
+namespace maat::platform {
+
+using maat::core::TraceRecord;
+using maat::core::TraceRecordKind;
+
+TraceReplayer::TraceReplayer(const maat::core::EventTrace& trace, maat::core::MaatMediator& mediator,
+                             SimPlatformManager& platform) :
+    m_trace(trace),
+    m_mediator(mediator),
+    m_platform(platform)
+{
+    // Rebased OS timestamps (receive time minus hook delay) must stay positive
+    for (const TraceRecord& record : m_trace.records()) {
+        if (record.kind == TraceRecordKind::Event) {
+            const Timestamp delay = record.event.received - record.event.timestamp;
+            if (delay > m_epoch) m_epoch = delay;
+        }
+    }
+}
+
+TraceReplayer::Result TraceReplayer::run() {
+    typedef std::chrono::steady_clock Clock;
+    const Clock::time_point wallStart = Clock::now();
+    const std::vector<TraceRecord>& records = m_trace.records();
+    const Timestamp start = m_trace.startTime();
+    Result result;
+
+    auto virtualTime = [this, start](Timestamp recorded) {
+        return m_epoch + (recorded > start ? recorded - start : 0);
+    };
+
+    // Startup block: the monitors and windows initialize() saw
+    std::size_t first = 0;
+    std::size_t snapshot = records.size();
+    for (; first < records.size() && records[first].kind != TraceRecordKind::Event; ++first) {
+        if (records[first].kind == TraceRecordKind::MonitorSnapshot) {
+            snapshot = first;
+        } else {
+            m_platform.adoptWindow(records[first].event.window, records[first].event.geometry);
+            ++result.initialWindows;
+        }
+    }
+    if (snapshot == records.size()) {
+        // Recording started after initialize(); the first snapshot is the best guess
+        for (std::size_t i = first; i < records.size() && snapshot == records.size(); ++i) {
+            if (records[i].kind == TraceRecordKind::MonitorSnapshot) snapshot = i;
+        }
+    }
+    if (snapshot != records.size()) {
+        applySnapshot(snapshot);
+        ++result.monitorSnapshots;
+    }
+    m_platform.advanceTime(m_epoch > m_platform.getMonotonicTime() ? m_epoch - m_platform.getMonotonicTime() : 0);
+    m_mediator.initialize();
+
+    for (std::size_t i = first; i < records.size(); ++i) {
+        const TraceRecord& record = records[i];
+        if (record.kind != TraceRecordKind::Event) {
+            // Snapshots are installed ahead of the layout change that caused them
+            continue;
+        }
+
+        const Timestamp target = virtualTime(record.time);
+        const Timestamp now = m_platform.getMonotonicTime();
+        if (target > now) {
+            m_platform.advanceTime(target - now); // Runs coalescing wakeups falling due on the way
+        }
+        if (m_pacing == Pacing::RecordedSpeed) {
+            std::this_thread::sleep_until(wallStart + std::chrono::microseconds(target - m_epoch));
+        }
+
+        PlatformEvent event = record.event;
+        switch (event.type) {
+            case PlatformEventType::WindowCreated:
+                m_platform.adoptWindow(event.window, event.geometry);
+                break;
+            case PlatformEventType::MonitorLayoutChanged:
+                // The core re-enumerates when it processes the change; give it
+                // the topology it saw then
+                for (std::size_t next = i + 1; next < records.size(); ++next) {
+                    if (records[next].kind == TraceRecordKind::MonitorSnapshot) {
+                        applySnapshot(next);
+                        ++result.monitorSnapshots;
+                        break;
+                    }
+                }
+                break;
+            default:
+                break;
+        }
+        const Timestamp hookDelay = event.received - event.timestamp;
+        event.received = m_platform.getMonotonicTime();
+        event.timestamp = event.received - hookDelay;
+        m_mediator.postEvent(event);
+        ++result.eventsReplayed;
+    }
+
+    m_platform.runUntilIdle();
+    m_mediator.processPendingEvents();
+
+    result.virtualMicros = m_platform.getMonotonicTime() - m_epoch;
+    result.wallMicros = static_cast<std::uint64_t>(
+        std::chrono::duration_cast<std::chrono::microseconds>(Clock::now() - wallStart).count());
+    return result;
+}
+
+void TraceReplayer::applySnapshot(std::size_t recordIndex) {
+    const TraceRecord& record = m_trace.records()[recordIndex];
+    std::vector<std::pair<MonitorId, Rect>> monitors;
+    monitors.reserve(record.monitorCount);
+    for (std::uint32_t m = 0; m < record.monitorCount; ++m) {
+        const maat::core::MonitorArea& area = m_trace.monitors()[record.firstMonitor + m];
+        monitors.emplace_back(area.id, area.workArea);
+    }
+    m_platform.replaceMonitors(monitors);
+}
+
+} // namespace maat::platform
@@ -24,12 +24,18 @@ public:
     WindowsMonitor& operator=(WindowsMonitor&& other) noexcept;
 
     MonitorId getId() const override;
+    // Cached; reads no OS state. Updated by refresh().
     Rect getWorkArea() const override;
 
     HMONITOR getHandle() const;
 
+    // Re-reads the work area with GetMonitorInfoW. Called once per monitor
+    // per enumeration; returns true if the work area changed.
+    bool refresh();
+
 private:
     HMONITOR m_handle;
+    Rect m_workArea{0, 0, 0, 0};
 };
 
 } } // namespace maat::platform
@@ -13,23 +13,21 @@
 
 #include <vector>
 #include <map>
-#include <set>
 #include <utility>
 #include <functional>
 #include <memory>
-#include <mutex> // Added for thread safety
+#include <atomic>
 
+#include <maat_core/flat_id_map.h>
+
+#include "maat_platform/object_pool.h"
 #include "maat_platform/platform_manager.h"
 #include "maat_platform/platform_types.h"
+#include "maat_platform_windows/windows_monitor.h"
+#include "maat_platform_windows/windows_window.h"
 
 namespace maat { namespace core { class MaatMediator; } }
 
-// Forward declarations instead of including full headers here
-namespace maat { namespace platform {
-class WindowsWindow;
-class WindowsMonitor;
-} } // namespace maat::platform
-
 namespace maat::platform {
 
 class WindowsPlatformManager final : public PlatformManager {
@@ -44,15 +42,26 @@ public:
     // --- PlatformManager Interface Overrides ---
 
     void applyWindowGeometries(const std::vector<std::pair<WindowId, Rect>>& updates) override;
+    void setWindowVisibility(const std::vector<std::pair<WindowId, bool>>& changes) override;
+    void queryWindowGeometries(std::vector<std::pair<WindowId, Rect>>& windows) override;
     std::vector<Monitor*> enumerateMonitors() override;
     std::vector<Window*> enumerateInitialWindows() override;
 
 
-    void releaseWindowTracking(WindowId id) override;
+    void releaseWindowTracking(WindowId id, std::uint32_t incarnation) override;
+    std::size_t reclassifyWindows() override;
+
+    Timestamp getMonotonicTime() const override;
+    void scheduleWakeup(Timestamp deadline) override;
 
     void startEventLoop() override;
     void stopEventLoop() override;
 
+    // Allocation counters of the window and monitor object pools. In steady
+    // state heapAllocations stays flat however many windows come and go.
+    const ObjectPoolStats& windowPoolStats() const;
+    const ObjectPoolStats& monitorPoolStats() const;
+
 private:
     friend LRESULT CALLBACK HelperWndProc(HWND hwnd, UINT uMsg, WPARAM wParam, LPARAM lParam);
     friend BOOL CALLBACK StaticMonitorEnumProc(HMONITOR hMonitor, HDC hdcMonitor, LPRECT lprcMonitor, LPARAM dwData);
@@ -60,6 +69,7 @@ private:
     friend void CALLBACK WinEventProc(HWINEVENTHOOK hWinEventHook, DWORD event, HWND hwnd, LONG idObject, LONG idChild, DWORD dwEventThread, DWORD dwmsEventTime);
 
     // --- Internal Helper Methods ---
+    void releaseWindowTrackingNow(WindowId id, std::uint32_t incarnation);
     void clearMonitors();
     void clearWindows();
     void registerEventHooks();
@@ -69,6 +79,9 @@ private:
     bool registerHelperWindowClass();
     bool createHelperWindow();
     void destroyHelperWindow();
+    void armWakeupTimer();
+    // Converts a WinEvent dwmsEventTime (GetTickCount ms) onto the getMonotonicTime() timeline
+    Timestamp eventTimeFromTicks(DWORD eventTickMs) const;
 
     // --- Event Handling ---
     // Non-static member function to handle events forwarded by the static proc
@@ -82,10 +95,27 @@ private:
 
     // --- Member Variables ---
 
-    // Ownership maps: The manager owns these objects.
-    std::map<MonitorId, WindowsMonitor*> m_monitors;
-    std::map<WindowId, WindowsWindow*> m_windows;
-    std::set<WindowId> m_reportedCreatedWindows;
+    // Object storage; declared before the maps so every handle is returned first
+    ObjectPool<WindowsMonitor> m_monitorPool{8};
+    ObjectPool<WindowsWindow> m_windowPool{256};
+
+    struct TrackedWindow {
+        ObjectPool<WindowsWindow>::Handle window;
+        bool reported = false;  // notifyOsWindowCreated sent and still standing
+        bool destroyed = false; // EVENT_OBJECT_DESTROY seen, release pending
+        // Bumped when a destroyed HWND is created again, so a release sent
+        // for the dead window cannot end the new window's tracking
+        std::uint32_t incarnation = 0;
+    };
+
+    // The HWND of a destroyed, not yet released entry came back as a new window
+    void renewTracking(TrackedWindow& tracked, HWND hwnd);
+
+    // Ownership maps: The manager owns these objects. Every hook event looks
+    // its HWND up, so windows sit in a flat table like the core's registry.
+    std::map<MonitorId, ObjectPool<WindowsMonitor>::Handle> m_monitors;
+    maat::core::FlatIdMap<TrackedWindow> m_windows;
+    std::vector<MonitorId> m_enumeratedMonitors; // Scratch list filled by StaticMonitorEnumProc
 
     // Mediator reference
     maat::core::MaatMediator& m_mediator;
@@ -99,16 +129,27 @@ private:
     HWINEVENTHOOK m_hHookDestroy = nullptr;
     HWINEVENTHOOK m_hHookMoveSize = nullptr;
     HWINEVENTHOOK m_hHookShow = nullptr;
+    HWINEVENTHOOK m_hHookStateChange = nullptr;
+    HWINEVENTHOOK m_hHookNameChange = nullptr;
     HWINEVENTHOOK m_hHookDisplayChange = nullptr;
 
     // Helper window handle
     HWND m_hHelperWindow = nullptr;
 
-    // Static map to associate hook handles with instances
-    // Protected by s_hookMapMutex
-    static std::map<HWINEVENTHOOK, WindowsPlatformManager*> s_hookMap;
-    static std::mutex s_hookMapMutex;
+    // Pending mediator wakeup (0 = none), delivered via WM_TIMER on the helper window
+    Timestamp m_wakeupDeadline = 0;
+
+    // Instance receiving WinEvent callbacks. All hooks are registered by one
+    // manager, so the callback resolves it with a single atomic load instead
+    // of a mutex-protected map lookup.
+    static std::atomic<WindowsPlatformManager*> s_hookInstance;
     static const wchar_t* const kHelperWindowClassName;
+    // Posted to the helper window so tracking is released on the event loop thread
+    static const UINT kReleaseTrackingMessage = WM_APP + 1;
+    static const UINT_PTR kWakeupTimerId = 1;
+    // Periodic check of the configuration file for edits
+    static const UINT_PTR kConfigPollTimerId = 2;
+    static const UINT kConfigPollIntervalMs = 1000;
 };
 
 } // namespace maat::platform
@@ -5,6 +5,10 @@
 #define NOMINMAX
 #include <windows.h>
 
+#include <cstdint>
+#include <string>
+
+#include "maat_platform/string_interner.h"
 #include "maat_platform/window.h"
 #include "maat_platform/platform_types.h" // Include for Rect
 
@@ -25,13 +29,39 @@ public:
 
 
     WindowId getId() const override;
-    Rect getGeometry() const override;
+    // Validity only (live handle, visible); what gets managed is decided
+    // by the core's window rules
     bool isManageable() const override;
 
+    // Attributes are read from Win32 on first use and cached; the manager
+    // invalidates them from WinEvents (name change, state change, move/size)
+    Rect getGeometry() const override;
+    const std::string& getTitle() const override;
+    const std::string& getClassName() const override;
+    std::uint32_t getProcessId() const override;
+    const std::string& getProcessName() const override;
+    std::uint32_t getStyleFlags() const override;
+    SizeHints getSizeHints() const override;
+
+    // Drops cached attributes (WindowAttributeField bits)
+    void invalidateAttributes(std::uint32_t fields);
+
     HWND getHandle() const;
 
 private:
+    bool cached(std::uint32_t field) const;
+
     HWND m_handle;
+
+    // Attribute cache; class name and process never change for a live HWND
+    mutable std::uint32_t m_cachedFields = 0;
+    mutable Rect m_geometry{0, 0, 0, 0};
+    mutable std::string m_title;
+    mutable const std::string* m_className = &StringInterner::empty();
+    mutable const std::string* m_processName = &StringInterner::empty();
+    mutable std::uint32_t m_processId = 0;
+    mutable std::uint32_t m_styleFlags = 0;
+    mutable SizeHints m_sizeHints;
 };
 
 } } // namespace maat::platform
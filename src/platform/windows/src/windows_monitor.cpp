@@ -9,10 +9,12 @@ WindowsMonitor::WindowsMonitor(HMONITOR handle) : m_handle(handle) {
      if (!m_handle) {
         // Consider throwing an exception or logging an error
     }
+    refresh();
 }
 
 // Move constructor
-WindowsMonitor::WindowsMonitor(WindowsMonitor&& other) noexcept : m_handle(other.m_handle) {
+WindowsMonitor::WindowsMonitor(WindowsMonitor&& other) noexcept
+    : m_handle(other.m_handle), m_workArea(other.m_workArea) {
     other.m_handle = nullptr; // Nullify the source object's handle
 }
 
@@ -20,6 +22,7 @@ WindowsMonitor::WindowsMonitor(WindowsMonitor&& other) noexcept : m_handle(other
 WindowsMonitor& WindowsMonitor::operator=(WindowsMonitor&& other) noexcept {
     if (this != &other) {
         m_handle = other.m_handle;
+        m_workArea = other.m_workArea;
         other.m_handle = nullptr; // Nullify the source object's handle
     }
     return *this;
@@ -35,12 +38,17 @@ HMONITOR WindowsMonitor::getHandle() const {
 }
 
 Rect WindowsMonitor::getWorkArea() const {
+    return m_workArea;
+}
+
+bool WindowsMonitor::refresh() {
     MONITORINFO monitorInfo;
     monitorInfo.cbSize = sizeof(MONITORINFO); // Crucial: Set the size member
 
+    Rect workArea{0, 0, 0, 0}; // Empty if GetMonitorInfoW fails (monitor detached)
     if (GetMonitorInfoW(m_handle, &monitorInfo)) {
         const RECT& workRect = monitorInfo.rcWork; // Use rcWork for usable area
-        return {
+        workArea = {
             workRect.left,
             workRect.top,
             workRect.right - workRect.left,
@@ -48,8 +56,9 @@ Rect WindowsMonitor::getWorkArea() const {
         };
     }
 
-    // Return an empty rect or handle error if GetMonitorInfoW fails
-    return {0, 0, 0, 0};
+    const bool changed = workArea != m_workArea;
+    m_workArea = workArea;
+    return changed;
 }
 
 } } // namespace maat::platform
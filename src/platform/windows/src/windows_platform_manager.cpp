@@ -8,19 +8,19 @@
 #include <winuser.h>
 
 
+#include <cstdint>
 #include <vector>
 #include <map>
 #include <utility>
-#include <algorithm> // For std::transform if needed later
-#include <mutex> // Include mutex header
+#include <algorithm> // For std::find
 #include <iostream> // For potential error logging
 #include <set> // Ensure set is included here too if not pulled by header
+#include <chrono>
 
 namespace maat::platform {
 
 // --- Static Member Initialization ---
-std::map<HWINEVENTHOOK, WindowsPlatformManager*> WindowsPlatformManager::s_hookMap;
-std::mutex WindowsPlatformManager::s_hookMapMutex;
+std::atomic<WindowsPlatformManager*> WindowsPlatformManager::s_hookInstance{nullptr};
 const wchar_t* const WindowsPlatformManager::kHelperWindowClassName = L"MaatPlatformHelperWindowClass";
 
 // --- Constructor & Destructor ---
@@ -49,17 +49,11 @@ WindowsPlatformManager::~WindowsPlatformManager() {
 // --- Private Helper Methods ---
 
 void WindowsPlatformManager::clearMonitors() {
-    for (auto const& [id, monitor_ptr] : m_monitors) {
-        delete monitor_ptr;
-    }
-    m_monitors.clear();
+    m_monitors.clear(); // Handles return the objects to m_monitorPool
 }
 
 void WindowsPlatformManager::clearWindows() {
-    for (auto const& [id, window_ptr] : m_windows) {
-        delete window_ptr;
-    }
-    m_windows.clear();
+    m_windows.clear(); // Handles return the objects to m_windowPool
 }
 
 // --- Win32 Callback Implementations (Static Enums) ---
@@ -68,9 +62,13 @@ BOOL CALLBACK WindowsPlatformManager::StaticMonitorEnumProc(HMONITOR hMonitor, H
     auto* self = reinterpret_cast<WindowsPlatformManager*>(dwData);
     if (!self) return FALSE;
     MonitorId id = reinterpret_cast<MonitorId>(hMonitor);
-    if (self->m_monitors.find(id) == self->m_monitors.end()) {
-        self->m_monitors[id] = new WindowsMonitor(hMonitor);
+    auto it = self->m_monitors.find(id);
+    if (it == self->m_monitors.end()) {
+        self->m_monitors[id] = self->m_monitorPool.acquire(hMonitor); // reads its work area
+    } else {
+        it->second->refresh();
     }
+    self->m_enumeratedMonitors.push_back(id);
     return TRUE;
 }
 
@@ -78,9 +76,9 @@ BOOL CALLBACK WindowsPlatformManager::StaticWindowEnumProc(HWND hwnd, LPARAM lPa
     auto* self = reinterpret_cast<WindowsPlatformManager*>(lParam);
     if (!self) return FALSE;
     WindowId id = reinterpret_cast<WindowId>(hwnd);
-    if (self->m_windows.find(id) == self->m_windows.end()) {
+    if (!self->m_windows.contains(id)) {
         // Simple creation, filtering happens later or during event handling
-        self->m_windows[id] = new WindowsWindow(hwnd);
+        self->m_windows.insert(id, TrackedWindow{self->m_windowPool.acquire(hwnd), false});
     }
     return TRUE;
 }
@@ -88,15 +86,9 @@ BOOL CALLBACK WindowsPlatformManager::StaticWindowEnumProc(HWND hwnd, LPARAM lPa
 // --- Static WinEventProc ---
 
 void CALLBACK WindowsPlatformManager::WinEventProc(HWINEVENTHOOK hWinEventHook, DWORD event, HWND hwnd, LONG idObject, LONG idChild, DWORD dwEventThread, DWORD dwmsEventTime) {
-    WindowsPlatformManager* instance = nullptr;
-    {
-        std::lock_guard<std::mutex> lock(s_hookMapMutex);
-        auto it = s_hookMap.find(hWinEventHook);
-        if (it != s_hookMap.end()) {
-            instance = it->second;
-        }
-    } // Mutex released here
-
+    // Hot path: no locks. The callback only snapshots the event and hands it
+    // to the mediator's lock-free queue.
+    WindowsPlatformManager* instance = s_hookInstance.load(std::memory_order_acquire);
     if (instance) {
         // Forward the event to the non-static member function
         instance->HandleWindowEvent(hWinEventHook, event, hwnd, idObject, idChild, dwEventThread, dwmsEventTime);
@@ -124,6 +116,32 @@ case WM_DISPLAYCHANGE:
                 pThis->m_mediator.notifyOsMonitorLayoutChanged();
                 return 0; // Indicate message was handled
 
+            case WM_SETTINGCHANGE:
+                // Work areas change without WM_DISPLAYCHANGE when the taskbar
+                // moves or resizes; the cached work areas must be re-read
+                if (wParam == SPI_SETWORKAREA) {
+                    pThis->m_mediator.notifyOsMonitorLayoutChanged();
+                }
+                break;
+
+            case kReleaseTrackingMessage:
+                pThis->releaseWindowTrackingNow(static_cast<WindowId>(wParam), static_cast<std::uint32_t>(lParam));
+                return 0;
+
+            case WM_TIMER:
+                if (wParam == kWakeupTimerId) {
+                    // One-shot: the mediator re-arms it through scheduleWakeup if needed
+                    KillTimer(hwnd, kWakeupTimerId);
+                    pThis->m_wakeupDeadline = 0;
+                    pThis->m_mediator.notifyWakeup();
+                    return 0;
+                }
+                if (wParam == kConfigPollTimerId) {
+                    pThis->m_mediator.pollConfiguration();
+                    return 0;
+                }
+                break;
+
             // Handle other messages if needed (e.g., WM_DESTROY)
             case WM_DESTROY:
                 // Clean up the association when the window is destroyed
@@ -148,6 +166,7 @@ void WindowsPlatformManager::HandleWindowEvent(HWINEVENTHOOK hWinEventHook, DWOR
 
 
     WindowId windowId = reinterpret_cast<WindowId>(hwnd);
+    const Timestamp eventTime = eventTimeFromTicks(dwmsEventTime);
 
     switch (event) {
         case EVENT_OBJECT_CREATE: {
@@ -155,11 +174,16 @@ void WindowsPlatformManager::HandleWindowEvent(HWINEVENTHOOK hWinEventHook, DWOR
             if (IsWindow(hwnd)) {
                  // Add to tracking map if not already present.
                  // Defer isManageable check and callback to EVENT_OBJECT_SHOW.
-                 std::lock_guard<std::mutex> lock(s_hookMapMutex); // Protect m_windows access potentially? If called from multiple threads? Assume WinEventProc serializes for now. Revisit if needed.
-                 if (m_windows.find(windowId) == m_windows.end()) {
+                 TrackedWindow* tracked = m_windows.find(windowId);
+                 if (!tracked) {
                     // Just create and store. The SHOW event will handle the rest.
-                    m_windows[windowId] = new WindowsWindow(hwnd);
+                    m_windows.insert(windowId, TrackedWindow{m_windowPool.acquire(hwnd), false});
                     // std::cout << "DEBUG: EVENT_OBJECT_CREATE tracked HWND: " << hwnd << std::endl; // Optional debug
+                 } else if (tracked->destroyed) {
+                    renewTracking(*tracked, hwnd);
+                 } else if (!tracked->reported) {
+                    // Nothing cached for it may predate the create
+                    tracked->window = m_windowPool.acquire(hwnd);
                  }
             }
             break;
@@ -167,15 +191,22 @@ void WindowsPlatformManager::HandleWindowEvent(HWINEVENTHOOK hWinEventHook, DWOR
 
         case EVENT_OBJECT_SHOW: {
             // Window is being shown. Now check if it's manageable and if we haven't reported it yet.
-            std::lock_guard<std::mutex> lock(s_hookMapMutex); // Protect map and set access
-            auto it = m_windows.find(windowId);
+            TrackedWindow* tracked = m_windows.find(windowId);
+            if (tracked && tracked->destroyed) {
+                renewTracking(*tracked, hwnd); // its CREATE was missed
+            }
             // Check if we are tracking it AND haven't reported it yet
-            if (it != m_windows.end() && m_reportedCreatedWindows.find(windowId) == m_reportedCreatedWindows.end()) {
-                WindowsWindow* window = it->second;
-                if (window && window->isManageable()) {
+            if (tracked && tracked->window) {
+                // The window may have been placed while hidden
+                tracked->window->invalidateAttributes(WindowAttributeSize);
+            }
+            if (tracked && !tracked->reported) {
+                WindowsWindow* window = tracked->window.get();
+                // Re-shown windows hit the rule cache and make no attribute queries
+                if (window && window->isManageable() && m_mediator.classifyWindow(*window)) {
                     // It's manageable and not reported, report it now.
-                    m_reportedCreatedWindows.insert(windowId); // Mark as reported
-                    m_mediator.notifyOsWindowCreated(window);
+                    tracked->reported = true; // Mark as reported
+                    m_mediator.notifyOsWindowCreated(window, eventTime);
                 }
                 // If it's not manageable at this point, we just leave it in m_windows.
                 // It might become manageable later, or it might be irrelevant.
@@ -186,31 +217,60 @@ void WindowsPlatformManager::HandleWindowEvent(HWINEVENTHOOK hWinEventHook, DWOR
 
         case EVENT_OBJECT_DESTROY: {
              // Check if we were tracking this window
-             std::lock_guard<std::mutex> lock(s_hookMapMutex); // Protect map/set access
-             auto it = m_windows.find(windowId);
-             if (it != m_windows.end()) {
+             TrackedWindow* tracked = m_windows.find(windowId);
+             if (tracked) {
                  // We were tracking it. Notify the core logic.
                  // The core logic MUST call releaseWindowTracking later.
-                 m_mediator.notifyOsWindowDestroyed(windowId);
-                 // DO NOT delete it->second here. Deletion happens in releaseWindowTracking.
+                 m_mediator.notifyOsWindowDestroyed(windowId, eventTime, tracked->incarnation);
+                 m_mediator.forgetWindowClassification(windowId); // HWNDs are reused
+                 // So are the cached attributes, should SHOW come before CREATE
+                 if (tracked->window) tracked->window->invalidateAttributes(WindowAttributeAll);
+                 // DO NOT release tracked->window here. That happens in releaseWindowTracking.
                  // DO NOT remove from map here, wait for releaseWindowTracking.
-                 // DO remove from the reported set now, as it's destroyed.
-                 m_reportedCreatedWindows.erase(windowId);
+                 // DO clear the reported flag now, as it's destroyed.
+                 tracked->reported = false;
+                 tracked->destroyed = true;
              }
              break;
          }
 
+        case EVENT_OBJECT_NAMECHANGE:
+        case EVENT_OBJECT_STATECHANGE: {
+            // Title or enabled state changed; the rule decision may be stale
+            TrackedWindow* tracked = m_windows.find(windowId);
+            if (tracked && !tracked->destroyed) {
+                const std::uint32_t changed = event == EVENT_OBJECT_NAMECHANGE
+                                                  ? WindowAttributeTitle
+                                                  : WindowAttributeStyle | WindowAttributeSizeHints;
+                WindowsWindow* window = tracked->window.get();
+                if (window) window->invalidateAttributes(changed);
+                const bool relevant = m_mediator.invalidateWindowClassification(windowId, changed);
+                if (!window) break;
+                if (tracked->reported) {
+                    // As reclassifyWindows() does: a managed window whose new
+                    // title or state an ignore rule matches is withdrawn
+                    if (relevant && !m_mediator.classifyWindow(*window)) {
+                        tracked->reported = false;
+                        m_mediator.notifyOsWindowUnmanaged(windowId, eventTime);
+                    }
+                } else if (window->isManageable() && m_mediator.classifyWindow(*window)) {
+                    tracked->reported = true;
+                    m_mediator.notifyOsWindowCreated(window, eventTime);
+                }
+            }
+            break;
+        }
+
         case EVENT_SYSTEM_MOVESIZEEND: {
-            // Lock might not be strictly necessary if map isn't changing, but safer
-            std::lock_guard<std::mutex> lock(s_hookMapMutex);
-            auto it = m_windows.find(windowId);
-            if (it != m_windows.end()) {
+            TrackedWindow* tracked = m_windows.find(windowId);
+            if (tracked) {
+                 if (tracked->window) tracked->window->invalidateAttributes(WindowAttributeSize);
                  // Check if window is still valid before getting monitor
                  if (IsWindow(hwnd)) {
                     HMONITOR hMonitor = MonitorFromWindow(hwnd, MONITOR_DEFAULTTONEAREST);
                     if (hMonitor) {
                          MonitorId monitorId = reinterpret_cast<MonitorId>(hMonitor);
-                         m_mediator.notifyOsWindowMonitorChanged(windowId, monitorId);
+                         m_mediator.notifyOsWindowMonitorChanged(windowId, monitorId, eventTime);
                     }
                  }
             }
@@ -226,12 +286,23 @@ void WindowsPlatformManager::HandleWindowEvent(HWINEVENTHOOK hWinEventHook, DWOR
 // --- PlatformManager Interface Implementation ---
 
 std::vector<Monitor*> WindowsPlatformManager::enumerateMonitors() {
-    clearMonitors();
+    // Monitors still attached keep their objects; only vanished ones are
+    // returned to the pool. Work areas are read once here and cached, so the
+    // core's topology rebuild makes no further OS calls. Monitors are returned
+    // in enumeration order.
+    m_enumeratedMonitors.clear();
     EnumDisplayMonitors(NULL, NULL, StaticMonitorEnumProc, reinterpret_cast<LPARAM>(this));
+    for (auto it = m_monitors.begin(); it != m_monitors.end();) {
+        if (std::find(m_enumeratedMonitors.begin(), m_enumeratedMonitors.end(), it->first) == m_enumeratedMonitors.end()) {
+            it = m_monitors.erase(it);
+        } else {
+            ++it;
+        }
+    }
     std::vector<Monitor*> result;
-    result.reserve(m_monitors.size());
-    for (auto const& [id, monitor_ptr] : m_monitors) {
-        result.push_back(monitor_ptr);
+    result.reserve(m_enumeratedMonitors.size());
+    for (MonitorId id : m_enumeratedMonitors) {
+        result.push_back(m_monitors[id].get());
     }
     return result;
 }
@@ -239,36 +310,40 @@ std::vector<Monitor*> WindowsPlatformManager::enumerateMonitors() {
 std::vector<Window*> WindowsPlatformManager::enumerateInitialWindows() {
     // Clear potentially stale window list and reported set
     clearWindows();
-    {
-        std::lock_guard<std::mutex> lock(s_hookMapMutex);
-        m_reportedCreatedWindows.clear();
-    }
 
     EnumWindows(StaticWindowEnumProc, reinterpret_cast<LPARAM>(this));
-    std::vector<Window*> result;
-    result.reserve(m_windows.size());
-
-    // Populate the initial list and also the reported set for manageable ones
-    std::lock_guard<std::mutex> lock(s_hookMapMutex); // Protect map/set access
-    std::vector<WindowId> to_remove; // Windows failing initial check
-    for (auto const& [id, window_ptr] : m_windows) {
-        if (window_ptr && window_ptr->isManageable()) {
-             result.push_back(window_ptr);
-             m_reportedCreatedWindows.insert(id); // Mark initially manageable ones as reported
-        } else if (window_ptr) {
-            // Optional: Decide if non-manageable windows found during initial enum
-            // should be kept in m_windows or removed immediately.
-            // Let's remove them for simplicity now.
+    std::vector<Window*> candidates;
+    candidates.reserve(m_windows.size());
+    std::vector<WindowId> to_remove; // Null entries; should not happen
+    m_windows.forEach([&](WindowId id, const TrackedWindow& tracked) {
+        if (tracked.window) {
+            candidates.push_back(tracked.window.get());
+        } else {
             to_remove.push_back(id);
-            delete window_ptr; // Delete the object
+        }
+    });
+
+    // Manageability and the window rules are evaluated in parallel batches;
+    // most of the cost is the per-window attribute queries
+    std::vector<std::uint8_t> manage;
+    m_mediator.classifyInitialWindows(candidates, manage);
+    std::vector<Window*> result;
+    result.reserve(candidates.size());
+    for (std::size_t i = 0; i < candidates.size(); ++i) {
+        const WindowId id = candidates[i]->getId();
+        if (manage[i]) {
+            result.push_back(candidates[i]);
+            m_windows.find(id)->reported = true; // Mark initially manageable ones as reported
         } else {
-            // Should not happen, but handle null pointer case
-             to_remove.push_back(id);
+            // Non-manageable windows found during initial enumeration are
+            // dropped; they are rediscovered if they become manageable
+            to_remove.push_back(id); // Erasing the handle returns the object to the pool
         }
     }
 
     // Remove non-manageable windows discovered during initial enumeration
     for(const auto& id : to_remove) {
+        m_mediator.forgetWindowClassification(id);
         m_windows.erase(id);
     }
 
@@ -276,6 +351,8 @@ std::vector<Window*> WindowsPlatformManager::enumerateInitialWindows() {
 }
 
 void WindowsPlatformManager::applyWindowGeometries(const std::vector<std::pair<WindowId, Rect>>& updates) {
+    // Usually runs on the mediator's apply thread: only HWNDs are touched,
+    // never m_windows
     if (updates.empty()) return;
 
     HDWP hdwp = BeginDeferWindowPos(static_cast<int>(updates.size()));
@@ -308,18 +385,132 @@ void WindowsPlatformManager::applyWindowGeometries(const std::vector<std::pair<W
     EndDeferWindowPos(currentHdwp);
 }
 
+void WindowsPlatformManager::setWindowVisibility(const std::vector<std::pair<WindowId, bool>>& changes) {
+    // ShowWindowAsync only posts the request to the owning thread, so a hung
+    // application cannot stall a workspace switch. Hidden windows stay
+    // tracked: there is no EVENT_OBJECT_HIDE hook, and EVENT_OBJECT_SHOW for
+    // an already reported window is ignored.
+    for (const auto& change : changes) {
+        HWND hwnd = reinterpret_cast<HWND>(change.first);
+        if (!IsWindow(hwnd)) continue;
+        ShowWindowAsync(hwnd, change.second ? SW_SHOWNOACTIVATE : SW_HIDE);
+    }
+}
 
+void WindowsPlatformManager::queryWindowGeometries(std::vector<std::pair<WindowId, Rect>>& windows) {
+    // GetWindowRect reads the window manager's copy of the rect, so it
+    // neither waits for the application nor touches m_windows (whose cached
+    // geometry is only refreshed on move/size end)
+    std::size_t kept = 0;
+    for (const auto& entry : windows) {
+        HWND hwnd = reinterpret_cast<HWND>(entry.first);
+        RECT rect;
+        if (!IsWindow(hwnd) || !GetWindowRect(hwnd, &rect)) continue;
+        windows[kept++] = {entry.first, Rect{rect.left, rect.top, rect.right - rect.left, rect.bottom - rect.top}};
+    }
+    windows.resize(kept);
+}
 
 
 
-void WindowsPlatformManager::releaseWindowTracking(WindowId id) {
-    std::lock_guard<std::mutex> lock(s_hookMapMutex); // Protect map/set access
-    auto it = m_windows.find(id);
-    if (it != m_windows.end()) {
-        delete it->second;    // Delete the owned WindowsWindow object
-        m_windows.erase(it); // Remove the entry from the map
-        m_reportedCreatedWindows.erase(id); // Also remove from reported set
+
+
+void WindowsPlatformManager::releaseWindowTracking(WindowId id, std::uint32_t incarnation) {
+    // m_windows is only touched on the event loop thread (hook callbacks run
+    // there). The core may call this from its own thread, so hop over.
+    if (m_eventLoopThreadId != 0 && GetCurrentThreadId() != m_eventLoopThreadId && m_hHelperWindow) {
+        PostMessage(m_hHelperWindow, kReleaseTrackingMessage, static_cast<WPARAM>(id),
+                    static_cast<LPARAM>(incarnation));
+        return;
+    }
+    releaseWindowTrackingNow(id, incarnation);
+}
+
+void WindowsPlatformManager::releaseWindowTrackingNow(WindowId id, std::uint32_t incarnation) {
+    // The HWND may have been reused before the release arrived, whether or
+    // not the new window has been shown yet; the entry then belongs to it.
+    const TrackedWindow* tracked = m_windows.find(id);
+    if (!tracked || tracked->incarnation != incarnation) {
+        return;
     }
+    m_windows.erase(id); // Returns the WindowsWindow to m_windowPool
+}
+
+void WindowsPlatformManager::renewTracking(TrackedWindow& tracked, HWND hwnd) {
+    // A fresh object: nothing cached for the dead window may describe this one
+    tracked.window = m_windowPool.acquire(hwnd);
+    tracked.reported = false;
+    tracked.destroyed = false;
+    ++tracked.incarnation;
+}
+
+std::size_t WindowsPlatformManager::reclassifyWindows() {
+    // Runs on the event loop thread (mediator configuration reload), which owns m_windows
+    std::size_t flipped = 0;
+    // The notifications only enqueue, so nothing is inserted or erased meanwhile
+    m_windows.forEach([&](WindowId id, TrackedWindow& tracked) {
+        WindowsWindow* window = tracked.window.get();
+        if (!window) return;
+        if (tracked.reported) {
+            if (!m_mediator.classifyWindow(*window)) {
+                tracked.reported = false;
+                m_mediator.notifyOsWindowUnmanaged(id);
+                ++flipped;
+            }
+        } else if (IsWindowVisible(reinterpret_cast<HWND>(id)) && window->isManageable() &&
+                   m_mediator.classifyWindow(*window)) {
+            tracked.reported = true;
+            m_mediator.notifyOsWindowCreated(window);
+            ++flipped;
+        }
+    });
+    return flipped;
+}
+
+Timestamp WindowsPlatformManager::getMonotonicTime() const {
+    // steady_clock is backed by QueryPerformanceCounter on Windows
+    return static_cast<Timestamp>(std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count());
+}
+
+Timestamp WindowsPlatformManager::eventTimeFromTicks(DWORD eventTickMs) const {
+    // dwmsEventTime shares GetTickCount's clock; its age (wrap-safe unsigned
+    // difference) carries over to our microsecond timeline. Resolution is the
+    // system tick (~10-16 ms).
+    const Timestamp now = getMonotonicTime();
+    const Timestamp ageMicros = static_cast<Timestamp>(static_cast<DWORD>(GetTickCount() - eventTickMs)) * 1000;
+    return ageMicros < now ? now - ageMicros : now;
+}
+
+void WindowsPlatformManager::scheduleWakeup(Timestamp deadline) {
+    // Called on the event loop thread (from mediator notifications), which owns
+    // the helper window; SetTimer requires that.
+    m_wakeupDeadline = deadline;
+    armWakeupTimer();
+}
+
+void WindowsPlatformManager::armWakeupTimer() {
+    if (!m_hHelperWindow || m_wakeupDeadline == 0) {
+        return; // Armed once the helper window exists
+    }
+    Timestamp now = getMonotonicTime();
+    UINT delayMs = USER_TIMER_MINIMUM;
+    if (m_wakeupDeadline > now) {
+        Timestamp remainingMs = (m_wakeupDeadline - now + 999) / 1000;
+        if (remainingMs > USER_TIMER_MINIMUM) {
+            delayMs = static_cast<UINT>(remainingMs);
+        }
+    }
+    // Re-using the timer id replaces any previously armed wakeup
+    SetTimer(m_hHelperWindow, kWakeupTimerId, delayMs, NULL);
+}
+
+const ObjectPoolStats& WindowsPlatformManager::windowPoolStats() const {
+    return m_windowPool.stats();
+}
+
+const ObjectPoolStats& WindowsPlatformManager::monitorPoolStats() const {
+    return m_monitorPool.stats();
 }
 
 // --- Helper Window Management ---
@@ -343,12 +534,13 @@ bool WindowsPlatformManager::createHelperWindow() {
      if (!m_hHelperWindow) { // Only create if it doesn't exist
          // Pass 'this' pointer so HelperWndProc can associate it
         m_hHelperWindow = CreateWindowExW(
-            0,                              // Optional window styles.
+            WS_EX_TOOLWINDOW,               // Kept off the taskbar and Alt+Tab
             kHelperWindowClassName,         // Window class
             L"Maat Helper Window",          // Window text (Not visible)
-            0,                              // Window style (Not visible)
+            WS_POPUP,                       // Window style (never shown)
             0, 0, 0, 0,                     // Size and position (Not visible)
-            HWND_MESSAGE,                   // Parent window: Use HWND_MESSAGE for message-only
+            NULL,                           // Top-level, not HWND_MESSAGE: message-only windows
+                                            // miss the WM_DISPLAYCHANGE/WM_SETTINGCHANGE broadcasts
             NULL,                           // Menu
             GetModuleHandle(NULL),          // Instance handle
             this                            // Additional application data (pass 'this')
@@ -364,6 +556,7 @@ bool WindowsPlatformManager::createHelperWindow() {
 
 void WindowsPlatformManager::destroyHelperWindow() {
     if (m_hHelperWindow) {
+        KillTimer(m_hHelperWindow, kWakeupTimerId);
         DestroyWindow(m_hHelperWindow);
         m_hHelperWindow = nullptr;
     }
@@ -389,37 +582,30 @@ void WindowsPlatformManager::registerEventHooks() {
     m_hHookDestroy = SetWinEventHook(EVENT_OBJECT_DESTROY, EVENT_OBJECT_DESTROY, NULL, WinEventProc, targetProcessId, targetThreadId, flags);
     // Hook for window finishing move/size operation
     m_hHookMoveSize = SetWinEventHook(EVENT_SYSTEM_MOVESIZEEND, EVENT_SYSTEM_MOVESIZEEND, NULL, WinEventProc, targetProcessId, targetThreadId, flags);
+    // Hooks for title and enabled-state changes, which invalidate cached rule decisions
+    m_hHookStateChange = SetWinEventHook(EVENT_OBJECT_STATECHANGE, EVENT_OBJECT_STATECHANGE, NULL, WinEventProc, targetProcessId, targetThreadId, flags);
+    m_hHookNameChange = SetWinEventHook(EVENT_OBJECT_NAMECHANGE, EVENT_OBJECT_NAMECHANGE, NULL, WinEventProc, targetProcessId, targetThreadId, flags);
     // Note: Display change is handled by WM_DISPLAYCHANGE on the helper window
 
-    // Update Static Map (Protected Access)
-    std::lock_guard<std::mutex> lock(s_hookMapMutex);
-    if (m_hHookCreate) s_hookMap[m_hHookCreate] = this; else { /* Log Error */ }
-    if (m_hHookShow) s_hookMap[m_hHookShow] = this; else { /* Log Error */ } // Add SHOW hook
-    if (m_hHookDestroy) s_hookMap[m_hHookDestroy] = this; else { /* Log Error */ }
-    if (m_hHookMoveSize) s_hookMap[m_hHookMoveSize] = this; else { /* Log Error */ }
+    // Route callbacks to this instance
+    s_hookInstance.store(this, std::memory_order_release);
 }
 
 void WindowsPlatformManager::unregisterEventHooks() {
     // Store handles locally before clearing members
     HWINEVENTHOOK hooksToUnregister[] = {
-        m_hHookCreate, m_hHookShow, m_hHookDestroy, m_hHookMoveSize // Add SHOW hook
+        m_hHookCreate, m_hHookShow, m_hHookDestroy, m_hHookMoveSize, m_hHookStateChange, m_hHookNameChange
         // Don't unregister display change hook here, it's tied to window message
     };
 
     // Clear member handles immediately
-    m_hHookCreate = m_hHookShow = m_hHookDestroy = m_hHookMoveSize = nullptr; // Add SHOW hook
-
-    // --- Remove from Static Map & Unhook (Mutex Protected Map Access) ---
-    {
-         std::lock_guard<std::mutex> lock(s_hookMapMutex);
-         for (HWINEVENTHOOK hHook : hooksToUnregister) {
-            if (hHook) {
-                s_hookMap.erase(hHook);
-            }
-         }
-    } // Mutex released
+    m_hHookCreate = m_hHookShow = m_hHookDestroy = m_hHookMoveSize = nullptr;
+    m_hHookStateChange = m_hHookNameChange = nullptr;
+
+    // --- Stop routing callbacks to this instance, then unhook ---
+    WindowsPlatformManager* expected = this;
+    s_hookInstance.compare_exchange_strong(expected, nullptr, std::memory_order_acq_rel);
 
-    // Now unhook outside the lock
     for (HWINEVENTHOOK hHook : hooksToUnregister) {
         if (hHook) {
             UnhookWinEvent(hHook);
@@ -442,6 +628,8 @@ void WindowsPlatformManager::startEventLoop() {
     }
 
     registerEventHooks(); // Register hooks after helper window is ready
+    armWakeupTimer(); // A wakeup may have been requested during initialization
+    SetTimer(m_hHelperWindow, kConfigPollTimerId, kConfigPollIntervalMs, nullptr);
 
     // Standard Windows message loop - this will now process messages for the helper window too
     MSG msg;
@@ -2,9 +2,23 @@
 
 #include <windows.h>
 #include <stdexcept> // For potential future error handling
+#include <string>
+#include <utility>
 
 namespace maat { namespace platform {
 
+namespace {
+
+std::string toUtf8(const wchar_t* text) {
+    const int size = WideCharToMultiByte(CP_UTF8, 0, text, -1, nullptr, 0, nullptr, nullptr);
+    if (size <= 1) return std::string();
+    std::string result(static_cast<std::size_t>(size - 1), '\0');
+    WideCharToMultiByte(CP_UTF8, 0, text, -1, &result[0], size, nullptr, nullptr);
+    return result;
+}
+
+} // namespace
+
 WindowsWindow::WindowsWindow(HWND handle) : m_handle(handle) {
     if (!m_handle) {
         // Consider throwing an exception or logging an error
@@ -13,15 +27,34 @@ WindowsWindow::WindowsWindow(HWND handle) : m_handle(handle) {
 }
 
 // Move constructor
-WindowsWindow::WindowsWindow(WindowsWindow&& other) noexcept : m_handle(other.m_handle) {
+WindowsWindow::WindowsWindow(WindowsWindow&& other) noexcept
+    : m_handle(other.m_handle),
+      m_cachedFields(other.m_cachedFields),
+      m_geometry(other.m_geometry),
+      m_title(std::move(other.m_title)),
+      m_className(other.m_className),
+      m_processName(other.m_processName),
+      m_processId(other.m_processId),
+      m_styleFlags(other.m_styleFlags),
+      m_sizeHints(other.m_sizeHints) {
     other.m_handle = nullptr; // Nullify the source object's handle
+    other.m_cachedFields = 0;
 }
 
 // Move assignment operator
 WindowsWindow& WindowsWindow::operator=(WindowsWindow&& other) noexcept {
     if (this != &other) {
         m_handle = other.m_handle;
+        m_cachedFields = other.m_cachedFields;
+        m_geometry = other.m_geometry;
+        m_title = std::move(other.m_title);
+        m_className = other.m_className;
+        m_processName = other.m_processName;
+        m_processId = other.m_processId;
+        m_styleFlags = other.m_styleFlags;
+        m_sizeHints = other.m_sizeHints;
         other.m_handle = nullptr; // Nullify the source object's handle
+        other.m_cachedFields = 0;
     }
     return *this;
 }
@@ -36,92 +69,126 @@ HWND WindowsWindow::getHandle() const {
     return m_handle;
 }
 
-Rect WindowsWindow::getGeometry() const {
-    RECT win_rect{};
-    if (GetWindowRect(m_handle, &win_rect)) {
-        return {
-            win_rect.left,
-            win_rect.top,
-            win_rect.right - win_rect.left,
-            win_rect.bottom - win_rect.top
-        };
-    }
-    // Return an empty rect or handle error if GetWindowRect fails
-    return {0, 0, 0, 0};
+bool WindowsWindow::isManageable() const {
+    // Style-based exclusions (child/owned, disabled, popup, tool windows...)
+    // are expressed as WindowRuleSet::defaultRules() in the core
+    return m_handle && IsWindow(m_handle) && IsWindowVisible(m_handle);
 }
 
-bool WindowsWindow::isManageable() const {
-    if (!m_handle || !IsWindow(m_handle)) {
-        return false; // Invalid handle
-    }
+void WindowsWindow::invalidateAttributes(std::uint32_t fields) {
+    m_cachedFields &= ~fields;
+}
 
-    // 1. Must be visible
-    if (!IsWindowVisible(m_handle)) {
-        return false;
-    }
+// Returns true if `field` is cached; otherwise marks it cached for the
+// caller, which fills it in
+bool WindowsWindow::cached(std::uint32_t field) const {
+    if (m_cachedFields & field) return true;
+    m_cachedFields |= field;
+    return false;
+}
 
-    // 2. Must be a top-level window (not owned)
-    //    GetAncestor with GA_ROOT returns the root window. If it's not the window itself, it's a child/owned.
-    if (GetAncestor(m_handle, GA_ROOT) != m_handle) {
-         return false;
+Rect WindowsWindow::getGeometry() const {
+    if (!cached(WindowAttributeSize)) {
+        RECT win_rect{};
+        if (GetWindowRect(m_handle, &win_rect)) {
+            m_geometry = {
+                win_rect.left,
+                win_rect.top,
+                win_rect.right - win_rect.left,
+                win_rect.bottom - win_rect.top
+            };
+        } else {
+            // Empty rect if GetWindowRect fails; not cached
+            m_geometry = {0, 0, 0, 0};
+            m_cachedFields &= ~WindowAttributeSize;
+        }
     }
+    return m_geometry;
+}
 
-    // 3. Check standard styles
-    LONG style = GetWindowLongPtr(m_handle, GWL_STYLE);
-    if (style == 0 && GetLastError() != 0) {
-         // Error getting style
-         return false;
+const std::string& WindowsWindow::getTitle() const {
+    if (!cached(WindowAttributeTitle)) {
+        // Reads the cached caption; unlike WM_GETTEXT it cannot block on a hung window
+        wchar_t buffer[512];
+        m_title = InternalGetWindowText(m_handle, buffer, 512) > 0 ? toUtf8(buffer) : std::string();
     }
+    return m_title;
+}
 
-    // Must have WS_VISIBLE (somewhat redundant with IsWindowVisible, but good check)
-    // Must NOT be a child (redundant with GetAncestor)
-    // Must NOT be disabled
-    // Must NOT be a popup (often temporary/tool windows)
-    if (!(style & WS_VISIBLE) || (style & WS_CHILD) || (style & WS_DISABLED) || (style & WS_POPUP)) {
-        return false;
+const std::string& WindowsWindow::getClassName() const {
+    if (!cached(WindowAttributeClass)) {
+        wchar_t buffer[256];
+        m_className = GetClassNameW(m_handle, buffer, 256) > 0 ? &StringInterner::global().intern(toUtf8(buffer))
+                                                               : &StringInterner::empty();
     }
+    return *m_className;
+}
 
-    // 4. Check extended styles
-    LONG exStyle = GetWindowLongPtr(m_handle, GWL_EXSTYLE);
-     if (exStyle == 0 && GetLastError() != 0 && !(style & WS_CHILD)) {
-         // Error getting exStyle, but ignore error for child windows as they might not have exStyles set
-         // However, we already filtered out child windows above. Still, keep check robust.
-         // Only consider error significant if it's not potentially a child window case.
-         // Note: This check is complex because GetWindowLongPtr can legitimately return 0.
-         // A more robust check involves SetLastError(0) before the call. For simplicity,
-         // we'll assume failure if 0 is returned and GetLastError is non-zero.
-         // But since we filter WS_CHILD earlier, this error case becomes less likely relevant.
-         // Let's simplify: if GetLastError is set after the call, assume failure unless exStyle is actually 0.
-         DWORD lastError = GetLastError();
-         if(exStyle == 0 && lastError != 0) {
-            return false;
-         }
-     }
-
-
-    // Must NOT be a tool window (WS_EX_TOOLWINDOW)
-    // Must NOT be non-activatable (WS_EX_NOACTIVATE)
-    // Must NOT be transparent to input (WS_EX_TRANSPARENT)
-    if ((exStyle & WS_EX_TOOLWINDOW) || (exStyle & WS_EX_NOACTIVATE) || (exStyle & WS_EX_TRANSPARENT)) {
-        return false;
+std::uint32_t WindowsWindow::getProcessId() const {
+    if (!cached(WindowAttributeProcess)) {
+        DWORD processId = 0;
+        GetWindowThreadProcessId(m_handle, &processId);
+        m_processId = processId;
+        m_processName = &StringInterner::empty();
+        if (HANDLE process = OpenProcess(PROCESS_QUERY_LIMITED_INFORMATION, FALSE, processId)) {
+            wchar_t buffer[MAX_PATH];
+            DWORD length = MAX_PATH;
+            if (QueryFullProcessImageNameW(process, 0, buffer, &length)) {
+                const wchar_t* name = buffer;
+                for (const wchar_t* p = buffer; *p; ++p) {
+                    if (*p == L'\\' || *p == L'/') name = p + 1;
+                }
+                m_processName = &StringInterner::global().intern(toUtf8(name));
+            }
+            CloseHandle(process);
+        }
     }
+    return m_processId;
+}
 
-    // Consider if it should be an app window.
-    // Typically, windows that are not tool windows and are top-level are considered manageable.
-    // WS_EX_APPWINDOW is often present on main application windows showing in the taskbar.
-    // Absence of WS_EX_TOOLWINDOW is usually a strong indicator for manageability.
-    // Let's stick to the exclusion logic for now as per requirements.
-
+const std::string& WindowsWindow::getProcessName() const {
+    getProcessId(); // one lookup fills both
+    return *m_processName;
+}
 
-    // Optional: Check for zero size - although unlikely for manageable windows
-    // RECT r;
-    // GetWindowRect(m_handle, &r);
-    // if (r.right - r.left <= 0 || r.bottom - r.top <= 0) {
-    //    return false;
-    // }
+std::uint32_t WindowsWindow::getStyleFlags() const {
+    if (!cached(WindowAttributeStyle)) {
+        const LONG_PTR style = GetWindowLongPtrW(m_handle, GWL_STYLE);
+        const LONG_PTR exStyle = GetWindowLongPtrW(m_handle, GWL_EXSTYLE);
+        std::uint32_t flags = 0;
+        // GetAncestor with GA_ROOT returns the root window; anything else is a child
+        if ((style & WS_CHILD) || GetAncestor(m_handle, GA_ROOT) != m_handle) flags |= WindowStyleChild;
+        if (style & WS_DISABLED) flags |= WindowStyleDisabled;
+        if (style & WS_POPUP) flags |= WindowStylePopup;
+        if ((style & WS_CAPTION) == WS_CAPTION && (exStyle & WS_EX_DLGMODALFRAME)) flags |= WindowStyleDialog;
+        if (style & WS_THICKFRAME) flags |= WindowStyleResizable;
+        if (exStyle & WS_EX_TOOLWINDOW) flags |= WindowStyleToolWindow;
+        if (exStyle & WS_EX_NOACTIVATE) flags |= WindowStyleNoActivate;
+        if (exStyle & WS_EX_TRANSPARENT) flags |= WindowStyleTransparent;
+        m_styleFlags = flags;
+    }
+    return m_styleFlags;
+}
 
-    // Passed all checks
-    return true;
+SizeHints WindowsWindow::getSizeHints() const {
+    if (!cached(WindowAttributeSizeHints)) {
+        // WM_GETMINMAXINFO is marshalled across processes; the timeout keeps
+        // a hung application from stalling the event thread
+        MINMAXINFO info{};
+        DWORD_PTR result = 0;
+        m_sizeHints = SizeHints();
+        if (SendMessageTimeoutW(m_handle, WM_GETMINMAXINFO, 0, reinterpret_cast<LPARAM>(&info),
+                                SMTO_ABORTIFHUNG, 50, &result)) {
+            m_sizeHints.minWidth = info.ptMinTrackSize.x;
+            m_sizeHints.minHeight = info.ptMinTrackSize.y;
+            // The system default maximum is the virtual screen: no real limit
+            if (info.ptMaxTrackSize.x < GetSystemMetrics(SM_CXMAXTRACK)) m_sizeHints.maxWidth = info.ptMaxTrackSize.x;
+            if (info.ptMaxTrackSize.y < GetSystemMetrics(SM_CYMAXTRACK)) m_sizeHints.maxHeight = info.ptMaxTrackSize.y;
+        } else {
+            m_cachedFields &= ~WindowAttributeSizeHints; // retry next time
+        }
+    }
+    return m_sizeHints;
 }
 
 } } // namespace maat::platform
@@ -0,0 +1,109 @@
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+#include "maat_core/core_manager.h"
+#include "maat_core/event_trace.h"
+#include "maat_core/latency_histogram.h"
+#include "maat_core/log.h"
+#include "maat_core/maat_mediator.h"
+#include "maat_platform_sim/sim_platform_manager.h"
+#include "maat_platform_sim/trace_replayer.h"
+
+namespace {
+
+void printUsage() {
+    std::fprintf(stderr,
+                 "usage: maat_replay <trace> [--realtime] [--coalesce <micros>] [--batches]\n"
+                 "Replays a trace recorded with MAAT_RECORD_TRACE through the core on the\n"
+                 "simulated backend and prints what the core did.\n"
+                 "  --realtime   keep the recorded event spacing (default: as fast as possible)\n"
+                 "  --coalesce   coalescing window in microseconds (default: 16000, as maat_app)\n"
+                 "  --batches    also print every applied geometry batch, for diffing runs\n");
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    using maat::core::LatencyStage;
+    using maat::platform::TraceReplayer;
+
+    const char* tracePath = nullptr;
+    TraceReplayer::Pacing pacing = TraceReplayer::Pacing::AsFastAsPossible;
+    maat::platform::Timestamp coalesce = 16000;
+    bool printBatches = false;
+    for (int i = 1; i < argc; ++i) {
+        if (std::strcmp(argv[i], "--realtime") == 0) {
+            pacing = TraceReplayer::Pacing::RecordedSpeed;
+        } else if (std::strcmp(argv[i], "--coalesce") == 0 && i + 1 < argc) {
+            coalesce = std::strtoull(argv[++i], nullptr, 10);
+        } else if (std::strcmp(argv[i], "--batches") == 0) {
+            printBatches = true;
+        } else if (argv[i][0] != '-' && !tracePath) {
+            tracePath = argv[i];
+        } else {
+            printUsage();
+            return 2;
+        }
+    }
+    if (!tracePath) {
+        printUsage();
+        return 2;
+    }
+
+    // stdout carries the report; keep per-component chatter off it
+    maat::core::Logger::instance().setMinimumLevel(maat::core::LogLevel::Warn);
+
+    maat::core::EventTrace trace;
+    if (!trace.load(tracePath)) {
+        if (trace.records().empty()) {
+            std::fprintf(stderr, "maat_replay: %s\n", trace.error().c_str());
+            return 1;
+        }
+        std::fprintf(stderr, "maat_replay: %s; replaying what was read\n", trace.error().c_str());
+    }
+
+    maat::core::MaatMediator mediator;
+    maat::platform::SimPlatformManager platform(mediator);
+    maat::core::CoreManager core(mediator);
+    mediator.registerPlatformManager(platform);
+    mediator.registerCoreManager(core);
+    mediator.setCoalescingWindow(coalesce);
+
+    TraceReplayer replayer(trace, mediator, platform);
+    replayer.setPacing(pacing);
+    const TraceReplayer::Result result = replayer.run();
+
+    const maat::core::MaatMediator::CoalescingStats& coalescing = mediator.coalescingStats();
+    std::printf("trace: %s (%zu records)\n", tracePath, trace.records().size());
+    std::printf("events replayed: %zu (%zu initial windows, %zu monitor snapshots)\n", result.eventsReplayed,
+                result.initialWindows, result.monitorSnapshots);
+    std::printf("trace span: %.3f s virtual, %.3f s wall\n", result.virtualMicros / 1e6, result.wallMicros / 1e6);
+    std::printf("operations delivered: %zu in %zu layout passes\n", coalescing.eventsDelivered,
+                coalescing.layoutPasses);
+    std::printf("apply batches: %zu (%zu updates, %zu filtered as unchanged)\n", platform.appliedBatches().size(),
+                platform.appliedUpdateCount(), mediator.droppedGeometryUpdateCount());
+    for (std::size_t i = 0; i < maat::core::LatencyRecorder::kStageCount; ++i) {
+        const LatencyStage stage = static_cast<LatencyStage>(i);
+        const maat::core::LatencyHistogram& h = mediator.latency().histogram(stage);
+        std::printf("latency %-14s count %-8llu p50 %-8llu p99 %-8llu max %llu us\n",
+                    maat::core::LatencyRecorder::stageName(stage), static_cast<unsigned long long>(h.count()),
+                    static_cast<unsigned long long>(h.percentile(0.50)),
+                    static_cast<unsigned long long>(h.percentile(0.99)),
+                    static_cast<unsigned long long>(h.max()));
+    }
+
+    if (printBatches) {
+        // Times are relative to the first replayed record
+        for (const maat::platform::SimGeometryBatch& batch : platform.appliedBatches()) {
+            std::printf("batch %llu:", static_cast<unsigned long long>(batch.time - replayer.replayEpoch()));
+            for (const auto& update : batch.updates) {
+                std::printf(" %llu=%d,%d,%dx%d", static_cast<unsigned long long>(update.first), update.second.x,
+                            update.second.y, update.second.width, update.second.height);
+            }
+            std::printf("\n");
+        }
+    }
+    MAAT_LOG_FLUSH();
+    return 0;
+}
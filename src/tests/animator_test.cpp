@@ -0,0 +1,212 @@
+#include <map>
+#include <utility>
+#include <vector>
+
+#include "maat_core/geometry_animator.h"
+#include "maat_platform_sim/virtual_clock.h"
+#include "sim_stack.h"
+#include "test.h"
+
+// GeometryAnimator on a VirtualClock: frame cadence, completion, retargeting
+// and the jumps to the targets under load; then the mediator's frames as the
+// simulated backend receives them.
+
+namespace maat {
+namespace tests {
+
+namespace {
+
+using maat::core::AnimationSettings;
+using maat::core::GeometryAnimator;
+using maat::platform::Rect;
+using maat::platform::VirtualClock;
+using maat::platform::WindowId;
+
+typedef std::vector<std::pair<WindowId, Rect>> Updates;
+
+AnimationSettings settings(std::uint64_t frameBudget = 0) {
+    AnimationSettings animation;
+    animation.enabled = true;
+    animation.frameRate = 60;
+    animation.duration = 100000;
+    animation.frameBudget = frameBudget;
+    return animation;
+}
+
+void framePacing(TestContext& context) {
+    VirtualClock clock;
+    GeometryAnimator animator;
+    animator.setSettings(settings());
+    const Rect from{0, 0, 100, 100};
+    const Rect to{1000, 500, 300, 200};
+    const std::uint64_t interval = animator.frameInterval();
+    MAAT_CHECK(context, interval == 16666);
+
+    animator.start(1, from, to, clock.now());
+    MAAT_CHECK(context, animator.active());
+    MAAT_CHECK(context, animator.nextFrameTime() == interval);
+
+    Updates out;
+    std::size_t frames = 0;
+    int lastX = from.x;
+    bool monotonic = true;
+    while (animator.active() && frames < 100) {
+        const std::uint64_t due = animator.nextFrameTime();
+        MAAT_CHECK(context, due == (frames + 1) * interval); // one frame per interval, no drift
+        clock.advanceTo(due);
+        out.clear();
+        animator.frame(clock.now(), out);
+        ++frames;
+        MAAT_CHECK(context, out.size() == 1);
+        if (out.empty()) break;
+        monotonic = monotonic && out[0].second.x >= lastX;
+        lastX = out[0].second.x;
+    }
+    MAAT_CHECK(context, monotonic);
+    // 100 ms at 60 Hz: six frames in flight, the seventh lands on the target
+    MAAT_CHECK(context, frames == 7);
+    MAAT_CHECK(context, !out.empty() && out.back().second == to);
+    MAAT_CHECK(context, !animator.active());
+    MAAT_CHECK(context, animator.stats().frames == 7);
+    MAAT_CHECK(context, animator.stats().finalJumps == 0);
+}
+
+void unchangedRectsAreNotResent(TestContext& context) {
+    VirtualClock clock;
+    GeometryAnimator animator;
+    animator.setSettings(settings());
+    // Only the width moves, by a pixel: most frames round to the same rect
+    animator.start(1, {0, 0, 100, 100}, {0, 0, 101, 100}, clock.now());
+    std::size_t emitted = 0;
+    Updates out;
+    while (animator.active()) {
+        clock.advanceTo(animator.nextFrameTime());
+        out.clear();
+        animator.frame(clock.now(), out);
+        emitted += out.size();
+    }
+    MAAT_CHECK(context, emitted < animator.stats().frames);
+    MAAT_CHECK(context, (out.back().second == Rect{0, 0, 101, 100}));
+}
+
+void retargetStartsFromShownRect(TestContext& context) {
+    VirtualClock clock;
+    GeometryAnimator animator;
+    animator.setSettings(settings());
+    animator.start(1, {0, 0, 100, 100}, {1000, 0, 100, 100}, clock.now());
+    Updates out;
+    clock.advanceTo(animator.nextFrameTime());
+    animator.frame(clock.now(), out);
+    MAAT_CHECK(context, out.size() == 1);
+    const Rect shown = out[0].second;
+    MAAT_CHECK(context, shown.x > 0 && shown.x < 1000);
+
+    // Back to the start: the new transition leaves from where the window is
+    const Rect back{0, 0, 100, 100};
+    animator.start(1, {0, 0, 100, 100}, back, clock.now());
+    MAAT_CHECK(context, animator.activeCount() == 1);
+    MAAT_CHECK(context, animator.stats().retargeted == 1);
+    out.clear();
+    clock.advanceTo(animator.nextFrameTime());
+    animator.frame(clock.now(), out);
+    MAAT_CHECK(context, out.size() == 1 && out[0].second.x < shown.x && out[0].second.x > 0);
+
+    Rect target{};
+    MAAT_CHECK(context, animator.cancel(1, &target));
+    MAAT_CHECK(context, target == back);
+    MAAT_CHECK(context, !animator.active());
+    MAAT_CHECK(context, !animator.cancel(1));
+}
+
+void lateFrameJumpsToTargets(TestContext& context) {
+    VirtualClock clock;
+    GeometryAnimator animator;
+    animator.setSettings(settings());
+    animator.start(1, {0, 0, 100, 100}, {500, 0, 100, 100}, clock.now());
+    animator.start(2, {0, 0, 100, 100}, {0, 500, 100, 100}, clock.now());
+    // A whole frame interval missed
+    clock.advanceTo(animator.nextFrameTime() + animator.frameInterval());
+    Updates out;
+    animator.frame(clock.now(), out);
+    MAAT_CHECK(context, out.size() == 2);
+    MAAT_CHECK(context, !animator.active());
+    MAAT_CHECK(context, animator.stats().finalJumps == 1);
+    std::map<WindowId, Rect> last(out.begin(), out.end());
+    MAAT_CHECK(context, (last[1] == Rect{500, 0, 100, 100}));
+    MAAT_CHECK(context, (last[2] == Rect{0, 500, 100, 100}));
+}
+
+void overBudgetFrameJumpsToTargets(TestContext& context) {
+    VirtualClock clock;
+    GeometryAnimator animator;
+    animator.setSettings(settings(8000));
+    animator.start(1, {0, 0, 100, 100}, {500, 0, 100, 100}, clock.now());
+    Updates out;
+    clock.advanceTo(animator.nextFrameTime());
+    animator.frame(clock.now(), out);
+    MAAT_CHECK(context, animator.active());
+    animator.recordFrameCost(9000); // the platform took longer than the budget
+    out.clear();
+    clock.advanceTo(animator.nextFrameTime());
+    animator.frame(clock.now(), out);
+    MAAT_CHECK(context, !animator.active());
+    MAAT_CHECK(context, (out.size() == 1 && out[0].second == Rect{500, 0, 100, 100}));
+    MAAT_CHECK(context, animator.stats().finalJumps == 1);
+}
+
+// Eight windows tiled and settled, the startup batches cleared; `animation`
+// (nullptr: none) applies to what follows
+void startEight(SimStack& stack, const AnimationSettings* animation) {
+    if (animation) stack.mediator.setAnimation(*animation);
+    for (int i = 0; i < 8; ++i) stack.platform.seedWindow({10, 10, 300, 200});
+    stack.start();
+    stack.platform.clearAppliedBatches();
+}
+
+void retile(SimStack& stack) {
+    stack.core.setLayout(stack.monitor, maat::core::LayoutKind::MasterStack);
+    stack.core.flushLayout();
+    stack.platform.runUntilIdle();
+}
+
+void mediatorFramesOnVirtualTime(TestContext& context) {
+    SimStack plain;
+    startEight(plain, nullptr);
+    retile(plain);
+    const std::map<WindowId, Rect> targets = plain.appliedGeometry();
+    MAAT_CHECK(context, plain.platform.appliedBatches().size() == 1);
+
+    const AnimationSettings animation = settings();
+    SimStack animated;
+    startEight(animated, &animation);
+    const std::uint64_t start = animated.platform.getMonotonicTime();
+    retile(animated);
+    const auto& batches = animated.platform.appliedBatches();
+    MAAT_CHECK(context, batches.size() > 2);
+    // Every frame after the first lands one interval after the previous
+    const std::uint64_t interval = 1000000 / animation.frameRate;
+    for (std::size_t i = 1; i < batches.size(); ++i) {
+        MAAT_CHECK(context, batches[i].time - batches[i - 1].time == interval);
+    }
+    MAAT_CHECK(context, batches.back().time - start >= animation.duration);
+    // ... and the last leaves every window where the plain layout puts it
+    const std::map<WindowId, Rect> finals = animated.appliedGeometry();
+    MAAT_CHECK(context, finals.size() == targets.size());
+    for (const auto& target : targets) {
+        const auto it = finals.find(target.first);
+        MAAT_CHECK(context, it != finals.end() && it->second == target.second);
+    }
+    MAAT_CHECK(context, animated.mediator.animationStats().finalJumps == 0);
+}
+
+} // namespace
+
+MAAT_TEST("animator", framePacing);
+MAAT_TEST("animator", unchangedRectsAreNotResent);
+MAAT_TEST("animator", retargetStartsFromShownRect);
+MAAT_TEST("animator", lateFrameJumpsToTargets);
+MAAT_TEST("animator", overBudgetFrameJumpsToTargets);
+MAAT_TEST("animator", mediatorFramesOnVirtualTime);
+
+} // namespace tests
+} // namespace maat
@@ -0,0 +1,253 @@
+#include <cstdint>
+#include <cstdio>
+#include <filesystem>
+#include <memory>
+#include <string>
+#include <system_error>
+#include <vector>
+
+#include "maat_core/binary_codec.h"
+#include "maat_core/configuration.h"
+#include "test.h"
+
+// Configuration: text through the binary cache and back, one diffConfig bit
+// per section, invalid lines reported with their numbers, out-of-range
+// cached values, then load()/reload() against files on disk.
+
+namespace maat {
+namespace tests {
+
+namespace {
+
+using maat::core::CompiledConfig;
+using maat::core::ConfigError;
+using maat::core::Configuration;
+using maat::core::KeyBinding;
+using maat::core::LayoutKind;
+using maat::core::LayoutParams;
+using maat::core::WindowRule;
+
+typedef std::shared_ptr<const CompiledConfig> ConfigPtr;
+
+// Every section set away from its default
+const char kFullText[] =
+    "# every section\n"
+    "layout = master_stack\n"
+    "master_ratio = 0.6\n"
+    "master_count = 2\n"
+    "axis = vertical\n"
+    "gap_inner = 8\n"
+    "gap_outer = 4\n"
+    "default_rules = off\n"
+    "fallback = ignore\n"
+    "rule manage class=Notepad title~=\"Untitled - \" style=resizable|dialog min_size=200x100\n"
+    "rule ignore process~=steam not_style=child any_style=popup|tool max_size=640x480\n"
+    "bind alt+1 = workspace 1\n"
+    "bind super+shift+H = focus left\n"
+    "animation = on\n"
+    "animation_fps = 120\n"
+    "animation_duration = 200\n"
+    "animation_budget = 4\n";
+
+ConfigPtr compile(const std::string& text) {
+    std::vector<ConfigError> errors;
+    return maat::core::compileConfig(text, errors);
+}
+
+bool sameRule(const WindowRule& a, const WindowRule& b) {
+    if (a.action != b.action || a.text.size() != b.text.size() || a.styleAll != b.styleAll ||
+        a.styleNone != b.styleNone || a.styleAny != b.styleAny || a.minWidth != b.minWidth ||
+        a.minHeight != b.minHeight || a.maxWidth != b.maxWidth || a.maxHeight != b.maxHeight) {
+        return false;
+    }
+    for (std::size_t i = 0; i < a.text.size(); ++i) {
+        if (a.text[i].field != b.text[i].field || a.text[i].contains != b.text[i].contains ||
+            a.text[i].value != b.text[i].value) {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool sameConfig(const CompiledConfig& a, const CompiledConfig& b) {
+    bool same = a.layout == b.layout && a.layoutParams == b.layoutParams && a.ruleFallback == b.ruleFallback &&
+                a.rules.size() == b.rules.size() && a.bindings.size() == b.bindings.size() &&
+                a.animation.enabled == b.animation.enabled && a.animation.frameRate == b.animation.frameRate &&
+                a.animation.duration == b.animation.duration &&
+                a.animation.frameBudget == b.animation.frameBudget && a.sourceHash == b.sourceHash;
+    for (std::size_t i = 0; same && i < a.rules.size(); ++i) same = sameRule(a.rules[i], b.rules[i]);
+    for (std::size_t i = 0; same && i < a.bindings.size(); ++i) {
+        const KeyBinding& x = a.bindings[i];
+        const KeyBinding& y = b.bindings[i];
+        same = x.modifiers == y.modifiers && x.key == y.key && x.command == y.command;
+    }
+    for (std::size_t i = 0; same && i < maat::core::kConfigSectionCount; ++i) {
+        same = a.sectionHashes[i] == b.sectionHashes[i];
+    }
+    return same;
+}
+
+void textRoundTripsThroughCache(TestContext& context) {
+    const ConfigPtr compiled = compile(kFullText);
+    MAAT_CHECK(context, compiled != nullptr);
+    if (!compiled) return;
+    MAAT_CHECK(context, compiled->layout == LayoutKind::MasterStack && compiled->layoutParams.masterCount == 2);
+    MAAT_CHECK(context, compiled->rules.size() == 2 && compiled->rules[0].text.size() == 2);
+    MAAT_CHECK(context, compiled->rules.size() == 2 && compiled->rules[0].text[1].value == "Untitled - ");
+    MAAT_CHECK(context, compiled->bindings.size() == 2 && compiled->bindings[1].key == "h" &&
+                            compiled->bindings[1].command == "focus left");
+    MAAT_CHECK(context, compiled->animation.duration == 200000 && compiled->animation.frameBudget == 4000);
+
+    const std::vector<std::uint8_t> cache = maat::core::encodeConfig(*compiled);
+    const ConfigPtr decoded = maat::core::decodeConfig(cache.data(), cache.size(), compiled->sourceHash);
+    MAAT_CHECK(context, decoded && sameConfig(*compiled, *decoded));
+    MAAT_CHECK(context, decoded && decoded->ruleSet != nullptr);
+    // Encoding is deterministic: the decoded config encodes to the same bytes
+    MAAT_CHECK(context, decoded && maat::core::encodeConfig(*decoded) == cache);
+
+    // Compiled from other text, truncated or damaged: not used
+    MAAT_CHECK(context, !maat::core::decodeConfig(cache.data(), cache.size(), compiled->sourceHash + 1));
+    MAAT_CHECK(context, !maat::core::decodeConfig(cache.data(), cache.size() - 1, compiled->sourceHash));
+    std::vector<std::uint8_t> damaged = cache;
+    damaged[damaged.size() / 2] ^= 0x40;
+    MAAT_CHECK(context, !maat::core::decodeConfig(damaged.data(), damaged.size(), compiled->sourceHash));
+}
+
+void diffFlagsEachSection(TestContext& context) {
+    const ConfigPtr base = compile(kFullText);
+    MAAT_CHECK(context, base != nullptr);
+    if (!base) return;
+    MAAT_CHECK(context, maat::core::diffConfig(nullptr, *base) == maat::core::ConfigSectionAll);
+    MAAT_CHECK(context, maat::core::diffConfig(base.get(), *base) == 0);
+
+    struct Edit {
+        const char* from;
+        const char* to;
+        std::uint32_t section;
+    };
+    const Edit edits[] = {
+        {"gap_outer = 4", "gap_outer = 5", maat::core::ConfigSectionLayout},
+        {"axis = vertical", "axis = horizontal", maat::core::ConfigSectionLayout},
+        {"min_size=200x100", "min_size=200x101", maat::core::ConfigSectionRules},
+        {"fallback = ignore", "fallback = manage", maat::core::ConfigSectionRules},
+        {"focus left", "focus right", maat::core::ConfigSectionBindings},
+        {"animation_fps = 120", "animation_fps = 60", maat::core::ConfigSectionAnimation},
+        // Same meaning, different text: nothing to apply
+        {"# every section", "# every section, reworded", 0},
+        {"gap_inner = 8", "gap_inner   =   8", 0},
+    };
+    for (const Edit& edit : edits) {
+        std::string text = kFullText;
+        text.replace(text.find(edit.from), std::string(edit.from).size(), edit.to);
+        const ConfigPtr edited = compile(text);
+        MAAT_CHECK(context, edited && edited->sourceHash != base->sourceHash);
+        MAAT_CHECK(context, edited && maat::core::diffConfig(base.get(), *edited) == edit.section);
+    }
+}
+
+void invalidLinesAreReported(TestContext& context) {
+    const std::string text =
+        "layout = grid\r\n"                  // 1: fine, CRLF
+        "layout = spiral\n"                  // 2: unknown layout
+        "master_ratio = 1.5\n"               // 3: out of range
+        "gaps = 1001\n"                      // 4: out of range
+        "\n"                                 // 5
+        "master_count = 1001\n"              // 6: out of range
+        "colour = blue\n"                    // 7: unknown setting
+        "rule ignore class~=X style=shiny\n" // 8: unknown style
+        "rule maybe class=X\n"               // 9: unknown action
+        "bind alt+1 = workspace 1\n"         // 10: fine
+        "bind ALT+1 = workspace 2\n"         // 11: already bound
+        "title = \"unterminated\n"           // 12: tokenizer
+        "  # indented comment\n"             // 13
+        "master_ratio = 0.7\n";              // 14: fine
+    std::vector<ConfigError> errors;
+    MAAT_CHECK(context, maat::core::compileConfig(text, errors) == nullptr);
+    const std::size_t expected[] = {2, 3, 4, 6, 7, 8, 9, 11, 12};
+    MAAT_CHECK(context, errors.size() == sizeof(expected) / sizeof(expected[0]));
+    for (std::size_t i = 0; i < errors.size() && i < sizeof(expected) / sizeof(expected[0]); ++i) {
+        MAAT_CHECK(context, errors[i].line == expected[i] && !errors[i].message.empty());
+    }
+
+    // The bounds are inclusive where the parser documents them
+    errors.clear();
+    const ConfigPtr edges = maat::core::compileConfig("gaps = 1000\nmaster_count = 1000\nmaster_ratio = 0.01\n", errors);
+    MAAT_CHECK(context, edges && errors.empty());
+    MAAT_CHECK(context, edges && edges->layoutParams.outerGap == 1000 && edges->layoutParams.masterCount == 1000);
+}
+
+void outOfRangeLayoutIsNotDecoded(TestContext& context) {
+    const auto decodes = [](const LayoutParams& params) {
+        std::vector<std::uint8_t> bytes;
+        maat::core::encodeLayoutSettings(LayoutKind::MasterStack, params, bytes);
+        maat::core::codec::Reader in(bytes.data(), bytes.size());
+        LayoutKind kind;
+        LayoutParams decoded;
+        return maat::core::decodeLayoutSettings(in, kind, decoded) && decoded == params;
+    };
+    LayoutParams params;
+    MAAT_CHECK(context, decodes(params));
+    params.masterRatio = 1.0f;
+    MAAT_CHECK(context, !decodes(params));
+    params.masterRatio = 0.0f / 0.0f;
+    MAAT_CHECK(context, !decodes(params));
+    params = LayoutParams();
+    params.masterCount = maat::core::kMaxMasterCount + 1;
+    MAAT_CHECK(context, !decodes(params));
+    params = LayoutParams();
+    params.innerGap = -1;
+    MAAT_CHECK(context, !decodes(params));
+    params.innerGap = 0;
+    params.outerGap = maat::core::kMaxLayoutGap + 1;
+    MAAT_CHECK(context, !decodes(params));
+    params.outerGap = maat::core::kMaxLayoutGap;
+    MAAT_CHECK(context, decodes(params));
+}
+
+bool writeText(const std::string& path, const std::string& text) {
+    std::FILE* file = std::fopen(path.c_str(), "wb");
+    if (!file) return false;
+    const bool ok = std::fwrite(text.data(), 1, text.size(), file) == text.size();
+    return std::fclose(file) == 0 && ok;
+}
+
+void loadUsesCacheAndReloadDiffs(TestContext& context) {
+    const std::string path = (std::filesystem::temp_directory_path() / "maat_configuration_test.conf").string();
+    std::error_code error;
+    std::filesystem::remove(path + ".cache", error);
+    MAAT_CHECK(context, writeText(path, kFullText));
+    {
+        Configuration first(path);
+        MAAT_CHECK(context, first.load());
+        MAAT_CHECK(context, !first.lastLoadStats().fromCache && first.lastLoadStats().cacheWritten);
+    }
+    Configuration configuration(path);
+    MAAT_CHECK(context, configuration.load() && configuration.lastLoadStats().fromCache);
+    const ConfigPtr cached = configuration.current();
+    MAAT_CHECK(context, cached && cached->layout == LayoutKind::MasterStack);
+
+    // Only the animation section changed
+    std::string text = kFullText;
+    text.replace(text.find("animation = on"), 14, "animation = off");
+    MAAT_CHECK(context, writeText(path, text));
+    MAAT_CHECK(context, configuration.reload() == maat::core::ConfigSectionAnimation);
+    // A broken edit keeps the current configuration and reports its line
+    MAAT_CHECK(context, writeText(path, text + "gaps = -3\n"));
+    MAAT_CHECK(context, configuration.reload() == 0);
+    MAAT_CHECK(context, configuration.errors().size() == 1 && configuration.errors()[0].line == 18);
+    MAAT_CHECK(context, configuration.current() && !configuration.current()->animation.enabled);
+
+    std::filesystem::remove(path, error);
+    std::filesystem::remove(configuration.cachePath(), error);
+}
+
+} // namespace
+
+MAAT_TEST("configuration", textRoundTripsThroughCache);
+MAAT_TEST("configuration", diffFlagsEachSection);
+MAAT_TEST("configuration", invalidLinesAreReported);
+MAAT_TEST("configuration", outOfRangeLayoutIsNotDecoded);
+MAAT_TEST("configuration", loadUsesCacheAndReloadDiffs);
+
+} // namespace tests
+} // namespace maat
@@ -0,0 +1,159 @@
+#include <cstdint>
+
+#include "maat_core/event_coalescer.h"
+#include "test.h"
+
+// EventCoalescer: each row of the table in its header comment (a create
+// cancelled by its destroy, a reused id, collapsing moves, unmanage after
+// create), then entry order and the flags that collapse to one.
+
+namespace maat {
+namespace tests {
+
+namespace {
+
+using maat::core::EventCoalescer;
+using maat::core::WindowHandle;
+using maat::platform::Rect;
+
+typedef EventCoalescer::Entry Entry;
+
+const WindowHandle kUnknown;
+const WindowHandle kManaged{3, 7};
+const Rect kGeometry{10, 20, 300, 200};
+
+// The entry for `id`, nullptr if none
+const Entry* entryFor(const EventCoalescer& coalescer, maat::platform::WindowId id) {
+    for (const Entry& e : coalescer.entries()) {
+        if (e.id == id) return &e;
+    }
+    return nullptr;
+}
+
+void createThenDestroyCancels(TestContext& context) {
+    EventCoalescer coalescer;
+    coalescer.addWindowCreated(1, kUnknown, kGeometry, 500);
+    coalescer.addWindowMonitorChanged(1, kUnknown, 2);
+    coalescer.addWindowDestroyed(1, kUnknown, 4);
+    // The core never hears of it; only the platform tracking goes
+    const Entry* e = entryFor(coalescer, 1);
+    MAAT_CHECK(context, e && e->actions == EventCoalescer::kRelease && e->incarnation == 4);
+    MAAT_CHECK(context, coalescer.pendingOperationCount() == 0);
+    MAAT_CHECK(context, !coalescer.empty());
+    // A late move does not revive it
+    coalescer.addWindowMonitorChanged(1, kUnknown, 3);
+    MAAT_CHECK(context, e->actions == EventCoalescer::kRelease);
+}
+
+void destroyThenCreateKeepsPlatformObject(TestContext& context) {
+    EventCoalescer coalescer;
+    coalescer.addWindowMonitorChanged(1, kManaged, 2);
+    coalescer.addWindowDestroyed(1, kManaged, 5);
+    const Rect reused{400, 0, 640, 480};
+    coalescer.addWindowCreated(1, kUnknown, reused, 900);
+    // The old window leaves the core and the new one joins it; the platform
+    // tracks the new window with the same entry, so nothing is released
+    const Entry* e = entryFor(coalescer, 1);
+    MAAT_CHECK(context, e && e->actions == (EventCoalescer::kDestroy | EventCoalescer::kCreate));
+    MAAT_CHECK(context, e && e->window == kManaged); // the destroy refers to the old window
+    MAAT_CHECK(context, (e && e->geometry == reused && e->createdAt == 900));
+    MAAT_CHECK(context, coalescer.pendingOperationCount() == 2);
+    MAAT_CHECK(context, coalescer.entries().size() == 1);
+
+    // Destroyed again: both windows gone, and the release names the last
+    // destroy's incarnation
+    coalescer.addWindowDestroyed(1, kUnknown, 6);
+    MAAT_CHECK(context, e->actions == (EventCoalescer::kDestroy | EventCoalescer::kRelease));
+    MAAT_CHECK(context, e->incarnation == 6 && e->window == kManaged);
+    MAAT_CHECK(context, coalescer.pendingOperationCount() == 1);
+}
+
+void repeatedMovesCollapse(TestContext& context) {
+    EventCoalescer coalescer;
+    for (maat::platform::MonitorId monitor = 1; monitor <= 50; ++monitor) {
+        coalescer.addWindowMonitorChanged(1, kManaged, monitor % 3 + 1);
+    }
+    const Entry* e = entryFor(coalescer, 1);
+    MAAT_CHECK(context, e && e->actions == EventCoalescer::kMove && e->monitor == 50 % 3 + 1);
+    MAAT_CHECK(context, coalescer.entries().size() == 1 && coalescer.pendingOperationCount() == 1);
+
+    // A create supersedes the moves before it; later ones still count
+    coalescer.addWindowMonitorChanged(2, kUnknown, 1);
+    coalescer.addWindowCreated(2, kUnknown, kGeometry);
+    const Entry* created = entryFor(coalescer, 2);
+    MAAT_CHECK(context, created && created->actions == EventCoalescer::kCreate);
+    coalescer.addWindowMonitorChanged(2, kUnknown, 2);
+    MAAT_CHECK(context, created->actions == (EventCoalescer::kCreate | EventCoalescer::kMove));
+    MAAT_CHECK(context, created->monitor == 2);
+
+    // Moves of a destroyed window are dropped
+    coalescer.addWindowDestroyed(3, kManaged);
+    coalescer.addWindowMonitorChanged(3, kManaged, 2);
+    MAAT_CHECK(context, entryFor(coalescer, 3)->actions == (EventCoalescer::kDestroy | EventCoalescer::kRelease));
+    MAAT_CHECK(context, coalescer.pendingOperationCount() == 1 + 2 + 1);
+}
+
+void unmanageAfterCreate(TestContext& context) {
+    EventCoalescer coalescer;
+    // The core never saw the create: nothing left to do, nothing released
+    coalescer.addWindowCreated(1, kUnknown, kGeometry);
+    coalescer.addWindowMonitorChanged(1, kUnknown, 2);
+    coalescer.addWindowUnmanaged(1, kUnknown);
+    const Entry* e = entryFor(coalescer, 1);
+    MAAT_CHECK(context, e && e->actions == 0);
+    MAAT_CHECK(context, coalescer.pendingOperationCount() == 0);
+
+    // Reused id: the old window still has to leave the core
+    coalescer.addWindowDestroyed(2, kManaged, 1);
+    coalescer.addWindowCreated(2, kUnknown, kGeometry);
+    coalescer.addWindowUnmanaged(2, kUnknown);
+    MAAT_CHECK(context, entryFor(coalescer, 2)->actions == EventCoalescer::kDestroy);
+
+    // A managed window is unmanaged; a destroy afterwards turns it into a
+    // destroy and release, and an unmanage after the destroy changes nothing
+    coalescer.addWindowUnmanaged(3, kManaged);
+    const Entry* managed = entryFor(coalescer, 3);
+    MAAT_CHECK(context, managed->actions == EventCoalescer::kUnmanage);
+    coalescer.addWindowDestroyed(3, kManaged, 2);
+    MAAT_CHECK(context, managed->actions == (EventCoalescer::kDestroy | EventCoalescer::kRelease));
+    coalescer.addWindowUnmanaged(3, kManaged);
+    MAAT_CHECK(context, managed->actions == (EventCoalescer::kDestroy | EventCoalescer::kRelease));
+}
+
+void entriesKeepFirstSeenOrder(TestContext& context) {
+    EventCoalescer coalescer;
+    MAAT_CHECK(context, coalescer.empty());
+    coalescer.addWindowMonitorChanged(30, kManaged, 1);
+    coalescer.addWindowCreated(10, kUnknown, kGeometry);
+    coalescer.addWindowMonitorChanged(30, kManaged, 2);
+    coalescer.addWindowCreated(20, kUnknown, kGeometry);
+    coalescer.addWindowDestroyed(10, kUnknown);
+    const auto& entries = coalescer.entries();
+    MAAT_CHECK(context, entries.size() == 3);
+    MAAT_CHECK(context, entries.size() == 3 && entries[0].id == 30 && entries[1].id == 10 && entries[2].id == 20);
+
+    // Any number of layout changes and reloads are one operation each
+    for (int i = 0; i < 10; ++i) {
+        coalescer.addMonitorLayoutChanged();
+        coalescer.addConfigurationChanged();
+    }
+    MAAT_CHECK(context, coalescer.monitorLayoutChanged() && coalescer.configurationChanged());
+    MAAT_CHECK(context, coalescer.pendingOperationCount() == 1 + 0 + 1 + 2);
+
+    coalescer.clear();
+    MAAT_CHECK(context, coalescer.empty() && coalescer.pendingOperationCount() == 0);
+    // A cleared id opens a fresh entry
+    coalescer.addWindowCreated(10, kUnknown, kGeometry);
+    MAAT_CHECK(context, entries.size() == 1 && entries[0].actions == EventCoalescer::kCreate);
+}
+
+} // namespace
+
+MAAT_TEST("event_coalescer", createThenDestroyCancels);
+MAAT_TEST("event_coalescer", destroyThenCreateKeepsPlatformObject);
+MAAT_TEST("event_coalescer", repeatedMovesCollapse);
+MAAT_TEST("event_coalescer", unmanageAfterCreate);
+MAAT_TEST("event_coalescer", entriesKeepFirstSeenOrder);
+
+} // namespace tests
+} // namespace maat
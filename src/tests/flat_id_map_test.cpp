@@ -0,0 +1,186 @@
+#include <map>
+#include <memory>
+#include <vector>
+
+#include "maat_core/flat_id_map.h"
+#include "test.h"
+
+// FlatIdMap's backward-shift erase: chains of keys sharing a home bucket,
+// chains that wrap past the end of the table, and a long randomised run
+// against std::map. Then values that can only be moved.
+
+namespace maat {
+namespace tests {
+
+namespace {
+
+using maat::core::FlatIdMap;
+typedef FlatIdMap<int>::Key Key;
+
+// Mirrors FlatIdMap::bucketFor() so tests can build colliding chains on
+// purpose; keep the two in step.
+std::size_t homeBucket(Key key, std::size_t mask) {
+    std::uint64_t h = static_cast<std::uint64_t>(key);
+    h ^= h >> 30;
+    h *= 0xbf58476d1ce4e5b9ULL;
+    h ^= h >> 27;
+    h *= 0x94d049bb133111ebULL;
+    h ^= h >> 31;
+    return static_cast<std::size_t>(h) & mask;
+}
+
+// The first `count` keys from `after` on whose home is `bucket` in an
+// eight-slot table
+std::vector<Key> keysHomedAt(std::size_t bucket, std::size_t count, Key after = 0) {
+    std::vector<Key> keys;
+    for (Key key = after + 1; keys.size() < count; ++key) {
+        if (homeBucket(key, 7) == bucket) keys.push_back(key);
+    }
+    return keys;
+}
+
+std::vector<Key> tableOrder(const FlatIdMap<int>& map) {
+    std::vector<Key> keys;
+    map.forEach([&keys](Key key, int) { keys.push_back(key); });
+    return keys;
+}
+
+void eraseShiftsChainBack(TestContext& context) {
+    // Eight slots hold six entries before growing; all four here start at 2
+    const std::vector<Key> chain = keysHomedAt(2, 4);
+    FlatIdMap<int> map(8);
+    for (std::size_t i = 0; i < chain.size(); ++i) map.insert(chain[i], static_cast<int>(i));
+    MAAT_CHECK(context, tableOrder(map) == chain);
+
+    // A hole at the head: the rest move up one slot each, order kept
+    MAAT_CHECK(context, map.erase(chain[0]));
+    MAAT_CHECK(context, (tableOrder(map) == std::vector<Key>{chain[1], chain[2], chain[3]}));
+    for (std::size_t i = 1; i < chain.size(); ++i) {
+        const int* value = map.find(chain[i]);
+        MAAT_CHECK(context, value && *value == static_cast<int>(i));
+    }
+    MAAT_CHECK(context, !map.contains(chain[0]));
+    // A hole in the middle
+    MAAT_CHECK(context, map.erase(chain[2]));
+    MAAT_CHECK(context, (tableOrder(map) == std::vector<Key>{chain[1], chain[3]}));
+    MAAT_CHECK(context, map.contains(chain[3]) && map.size() == 2);
+    // Reinsertion takes the first free slot of the chain again
+    map.insert(chain[0], 10);
+    MAAT_CHECK(context, (tableOrder(map) == std::vector<Key>{chain[1], chain[3], chain[0]}));
+    MAAT_CHECK(context, !map.erase(chain[2]));
+}
+
+void eraseLeavesOtherHomesInPlace(TestContext& context) {
+    // a0 a1 b0 in slots 2..4, with b0 at its own home 4: erasing a0 moves a1
+    // up but must not drag b0 in front of its home
+    const std::vector<Key> a = keysHomedAt(2, 2);
+    const std::vector<Key> b = keysHomedAt(4, 1);
+    FlatIdMap<int> map(8);
+    map.insert(a[0], 1);
+    map.insert(a[1], 2);
+    map.insert(b[0], 3);
+    MAAT_CHECK(context, (tableOrder(map) == std::vector<Key>{a[0], a[1], b[0]}));
+    map.erase(a[0]);
+    MAAT_CHECK(context, (tableOrder(map) == std::vector<Key>{a[1], b[0]}));
+    MAAT_CHECK(context, map.find(b[0]) && *map.find(b[0]) == 3);
+    MAAT_CHECK(context, map.find(a[1]) && *map.find(a[1]) == 2);
+    // Slot 3 is the free one: a key homed there lands in front of b0
+    const std::vector<Key> c = keysHomedAt(3, 1);
+    map.insert(c[0], 4);
+    MAAT_CHECK(context, (tableOrder(map) == std::vector<Key>{a[1], c[0], b[0]}));
+}
+
+void eraseAcrossWraparound(TestContext& context) {
+    // Three keys homed at the last slot occupy 7, 0 and 1; one homed at 0
+    // follows in 2
+    const std::vector<Key> last = keysHomedAt(7, 3);
+    const std::vector<Key> first = keysHomedAt(0, 1);
+    FlatIdMap<int> map(8);
+    for (Key key : last) map.insert(key, static_cast<int>(key));
+    map.insert(first[0], static_cast<int>(first[0]));
+    MAAT_CHECK(context, (tableOrder(map) == std::vector<Key>{last[1], last[2], first[0], last[0]}));
+
+    // Erasing in slot 7 pulls the chain back over the end of the table
+    map.erase(last[0]);
+    MAAT_CHECK(context, (tableOrder(map) == std::vector<Key>{last[2], first[0], last[1]}));
+    for (Key key : {last[1], last[2], first[0]}) {
+        const int* value = map.find(key);
+        MAAT_CHECK(context, value && *value == static_cast<int>(key));
+    }
+    map.erase(last[1]);
+    map.erase(last[2]);
+    MAAT_CHECK(context, (tableOrder(map) == std::vector<Key>{first[0]}));
+    MAAT_CHECK(context, map.size() == 1 && map.contains(first[0]));
+}
+
+void matchesStdMap(TestContext& context) {
+    Random random(11);
+    FlatIdMap<int> map;
+    std::map<Key, int> expected;
+    std::size_t mismatches = 0;
+    for (int step = 0; step < 200000; ++step) {
+        // A small key range keeps chains long and erases frequent
+        const Key key = 1 + random.below(512);
+        switch (random.below(4)) {
+        case 0:
+        case 1: {
+            const int value = static_cast<int>(random.below(1000));
+            const bool inserted = map.insert(key, value).second;
+            mismatches += inserted != expected.emplace(key, value).second;
+            break;
+        }
+        case 2:
+            mismatches += map.erase(key) != (expected.erase(key) == 1);
+            break;
+        default: {
+            const int* value = map.find(key);
+            const auto it = expected.find(key);
+            mismatches += (value != nullptr) != (it != expected.end());
+            mismatches += value && it != expected.end() && *value != it->second;
+            break;
+        }
+        }
+        if (step % 20000 == 0 && step > 0) {
+            std::map<Key, int> visited;
+            map.forEach([&visited](Key k, int v) { visited[k] = v; });
+            mismatches += visited != expected;
+            if (step % 100000 == 0) {
+                map.clear();
+                expected.clear();
+            }
+        }
+    }
+    MAAT_CHECK(context, map.size() == expected.size());
+    MAAT_CHECK(context, mismatches == 0);
+}
+
+void holdsMoveOnlyValues(TestContext& context) {
+    FlatIdMap<std::unique_ptr<int>> map(8);
+    for (Key key = 1; key <= 100; ++key) {
+        MAAT_CHECK(context, map.insert(key, std::unique_ptr<int>(new int(static_cast<int>(key)))).second);
+    }
+    // Growth moved every value; none was lost
+    bool intact = map.size() == 100;
+    for (Key key = 1; key <= 100; ++key) {
+        const std::unique_ptr<int>* value = map.find(key);
+        intact = intact && value && *value && **value == static_cast<int>(key);
+    }
+    MAAT_CHECK(context, intact);
+    // An existing key keeps its value
+    MAAT_CHECK(context, !map.insert(5, std::unique_ptr<int>(new int(0))).second);
+    MAAT_CHECK(context, **map.find(5) == 5);
+    for (Key key = 1; key <= 100; key += 2) map.erase(key);
+    map[7].reset(new int(-7));
+    MAAT_CHECK(context, map.size() == 51 && **map.find(7) == -7 && **map.find(8) == 8);
+}
+
+} // namespace
+
+MAAT_TEST("flat_id_map", eraseShiftsChainBack);
+MAAT_TEST("flat_id_map", eraseLeavesOtherHomesInPlace);
+MAAT_TEST("flat_id_map", eraseAcrossWraparound);
+MAAT_TEST("flat_id_map", matchesStdMap);
+MAAT_TEST("flat_id_map", holdsMoveOnlyValues);
+
+} // namespace tests
+} // namespace maat
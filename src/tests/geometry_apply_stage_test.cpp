@@ -0,0 +1,225 @@
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "maat_core/geometry_apply_stage.h"
+#include "sim_stack.h"
+#include "test.h"
+
+// GeometryApplyStage against the simulated backend, with every
+// applyWindowGeometries call held at a gate the test opens: rects submitted
+// while a batch is stuck wait in the latest-wins mailbox, appliedSequence
+// only moves once the platform returns, flush() waits for all of it, and
+// visibility is applied after the geometry of the same round.
+
+namespace maat {
+namespace tests {
+
+namespace {
+
+using maat::core::GeometryApplyStage;
+using maat::platform::Rect;
+using maat::platform::WindowId;
+
+typedef std::vector<std::pair<WindowId, Rect>> Updates;
+typedef std::vector<std::pair<WindowId, bool>> Changes;
+
+// Forwards to the sim, but each applyWindowGeometries call waits until the
+// gate is open. Calls land on the apply thread; the test reads the sim only
+// after flush() or stop().
+class GatedPlatform : public maat::platform::PlatformManager {
+public:
+    explicit GatedPlatform(maat::platform::SimPlatformManager& sim) : m_sim(sim) {}
+
+    void applyWindowGeometries(const Updates& updates) override {
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            ++m_blocked;
+            m_changed.notify_all();
+            m_changed.wait(lock, [this]() { return m_open; });
+            --m_blocked;
+            m_calls += 'G';
+        }
+        m_sim.applyWindowGeometries(updates);
+    }
+    void setWindowVisibility(const Changes& changes) override {
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_calls += 'V';
+        }
+        m_sim.setWindowVisibility(changes);
+    }
+    void queryWindowGeometries(Updates& windows) override { m_sim.queryWindowGeometries(windows); }
+    std::vector<maat::platform::Monitor*> enumerateMonitors() override { return m_sim.enumerateMonitors(); }
+    std::vector<maat::platform::Window*> enumerateInitialWindows() override {
+        return m_sim.enumerateInitialWindows();
+    }
+    void releaseWindowTracking(WindowId id, std::uint32_t incarnation) override {
+        m_sim.releaseWindowTracking(id, incarnation);
+    }
+    std::size_t reclassifyWindows() override { return m_sim.reclassifyWindows(); }
+    maat::platform::Timestamp getMonotonicTime() const override { return m_sim.getMonotonicTime(); }
+    void scheduleWakeup(maat::platform::Timestamp deadline) override { m_sim.scheduleWakeup(deadline); }
+    void startEventLoop() override {}
+    void stopEventLoop() override {}
+
+    void open() {
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_open = true;
+        }
+        m_changed.notify_all();
+    }
+    void close() {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_open = false;
+    }
+    // Blocks until the apply thread is held at the gate
+    void waitUntilBlocked() {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        m_changed.wait(lock, [this]() { return m_blocked > 0; });
+    }
+    // 'G' per geometry batch, 'V' per visibility batch, in call order
+    std::string calls() const {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        return m_calls;
+    }
+
+private:
+    maat::platform::SimPlatformManager& m_sim;
+    mutable std::mutex m_mutex;
+    std::condition_variable m_changed;
+    bool m_open = false;
+    int m_blocked = 0;
+    std::string m_calls;
+};
+
+std::vector<WindowId> seedWindows(SimStack& stack, std::size_t count) {
+    std::vector<WindowId> ids;
+    for (std::size_t i = 0; i < count; ++i) ids.push_back(stack.platform.seedWindow({0, 0, 300, 200}));
+    return ids;
+}
+
+Rect rectAt(int x) {
+    return Rect{x, 0, 400, 300};
+}
+
+void latestWinsWhileApplyIsBlocked(TestContext& context) {
+    SimStack stack;
+    const std::vector<WindowId> w = seedWindows(stack, 3);
+    GatedPlatform platform(stack.platform);
+    GeometryApplyStage stage(platform);
+    stage.start();
+
+    MAAT_CHECK(context, stage.submitGeometry({}) == 0);
+    MAAT_CHECK(context, stage.submitGeometry({{w[0], rectAt(1)}, {w[1], rectAt(1)}}) == 1);
+    platform.waitUntilBlocked();
+    // The first batch is with the platform; these wait in the mailbox
+    MAAT_CHECK(context, stage.submitGeometry({{w[0], rectAt(2)}}) == 2);
+    MAAT_CHECK(context, stage.submitGeometry({{w[2], rectAt(3)}, {w[1], rectAt(3)}}) == 3);
+    MAAT_CHECK(context, stage.submitGeometry({{w[0], rectAt(4)}}) == 4);
+    MAAT_CHECK(context, stage.appliedSequence() == 0);
+    GeometryApplyStage::Stats stats = stage.stats();
+    MAAT_CHECK(context, stats.submitted == 6 && stats.superseded == 1 && stats.applied == 0 && stats.batches == 0);
+
+    platform.open();
+    stage.flush();
+    MAAT_CHECK(context, stage.appliedSequence() == 4);
+    stats = stage.stats();
+    MAAT_CHECK(context, stats.submitted == 6 && stats.superseded == 1 && stats.applied == 5);
+    MAAT_CHECK(context, stats.batches == 2 && stats.maxBatchSize == 3 && stats.visibilityChanges == 0);
+    // One batch for everything that waited: the latest rect of each window,
+    // in first-submitted order
+    const std::vector<maat::platform::SimGeometryBatch>& batches = stack.platform.appliedBatches();
+    MAAT_CHECK(context, batches.size() == 2);
+    MAAT_CHECK(context, (batches.size() == 2 && batches[0].updates == Updates{{w[0], rectAt(1)}, {w[1], rectAt(1)}}));
+    MAAT_CHECK(context, (batches.size() == 2 &&
+                         batches[1].updates == Updates{{w[0], rectAt(4)}, {w[2], rectAt(3)}, {w[1], rectAt(3)}}));
+    MAAT_CHECK(context, stack.platform.findWindow(w[0])->getGeometry() == rectAt(4));
+    MAAT_CHECK(context, stage.applyMicros().count() == 2 && stage.batchSizes().max() == 3);
+    stage.stop();
+}
+
+void flushWaitsForTheBlockedBatch(TestContext& context) {
+    SimStack stack;
+    const std::vector<WindowId> w = seedWindows(stack, 2);
+    GatedPlatform platform(stack.platform);
+    GeometryApplyStage stage(platform);
+    // Not running: nothing to wait for
+    stage.flush();
+    stage.start();
+
+    const std::uint64_t first = stage.submitGeometry({{w[0], rectAt(1)}});
+    platform.waitUntilBlocked();
+    const std::uint64_t second = stage.submitGeometry({{w[1], rectAt(2)}});
+    std::atomic<bool> flushed(false);
+    std::uint64_t appliedAtFlush = 0;
+    std::thread waiter([&]() {
+        stage.flush();
+        appliedAtFlush = stage.appliedSequence();
+        flushed = true;
+    });
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    MAAT_CHECK(context, !flushed && stage.appliedSequence() == 0);
+    platform.open();
+    waiter.join();
+    MAAT_CHECK(context, flushed && first == 1 && second == 2 && appliedAtFlush == second);
+    MAAT_CHECK(context, stack.platform.appliedBatches().size() == 2);
+
+    // stop() applies what is still waiting before joining
+    platform.close();
+    stage.submitGeometry({{w[0], rectAt(5)}});
+    platform.waitUntilBlocked();
+    stage.submitGeometry({{w[1], rectAt(6)}});
+    platform.open();
+    stage.stop();
+    MAAT_CHECK(context, !stage.running() && stage.appliedSequence() == 4);
+    MAAT_CHECK(context, stack.platform.findWindow(w[1])->getGeometry() == rectAt(6));
+}
+
+void visibilityFollowsGeometry(TestContext& context) {
+    SimStack stack;
+    const std::vector<WindowId> w = seedWindows(stack, 2);
+    GatedPlatform platform(stack.platform);
+    GeometryApplyStage stage(platform);
+    stage.start();
+
+    stage.submitGeometry({{w[0], rectAt(1)}});
+    platform.waitUntilBlocked();
+    // Shown and moved in one pass, the visibility submitted first
+    stage.submitVisibility({{w[1], false}});
+    stage.submitVisibility({{w[1], true}});
+    stage.submitGeometry({{w[1], rectAt(2)}});
+    platform.open();
+    stage.flush();
+
+    // The second round is geometry, then the visibility it was paired with
+    MAAT_CHECK(context, platform.calls() == "GGV");
+    const std::vector<maat::platform::SimVisibilityBatch>& shown = stack.platform.visibilityBatches();
+    MAAT_CHECK(context, (shown.size() == 1 && shown[0].changes == Changes{{w[1], false}, {w[1], true}}));
+    MAAT_CHECK(context, stack.platform.findWindow(w[1])->isVisible());
+    MAAT_CHECK(context, stack.platform.findWindow(w[1])->getGeometry() == rectAt(2));
+    MAAT_CHECK(context, stage.stats().visibilityChanges == 2);
+
+    // Visibility alone needs no geometry batch
+    stage.submitVisibility({{w[0], false}});
+    stage.flush();
+    MAAT_CHECK(context, platform.calls() == "GGVV" && !stack.platform.findWindow(w[0])->isVisible());
+    MAAT_CHECK(context, stage.stats().batches == 2);
+    stage.stop();
+}
+
+} // namespace
+
+MAAT_TEST("geometry_apply_stage", latestWinsWhileApplyIsBlocked);
+MAAT_TEST("geometry_apply_stage", flushWaitsForTheBlockedBatch);
+MAAT_TEST("geometry_apply_stage", visibilityFollowsGeometry);
+
+} // namespace tests
+} // namespace maat
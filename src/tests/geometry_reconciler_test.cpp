@@ -0,0 +1,204 @@
+#include <cstdint>
+#include <functional>
+#include <utility>
+#include <vector>
+
+#include "maat_core/geometry_reconciler.h"
+#include "sim_stack.h"
+#include "test.h"
+
+// GeometryReconciler: the limits it learns from refused rects, the snap
+// tolerance, the retry budget and cooldown, and the check schedule; then
+// the mediator with simulated windows that refuse their rects.
+
+namespace maat {
+namespace tests {
+
+namespace {
+
+using maat::core::GeometryReconciler;
+using maat::core::ReconcileSettings;
+using maat::platform::Rect;
+using maat::platform::WindowId;
+
+typedef GeometryReconciler::Outcome Outcome;
+typedef std::vector<std::pair<WindowId, Rect>> Checks;
+
+const Rect kAsked{0, 0, 500, 500};
+
+void acceptedRectTeachesNothing(TestContext& context) {
+    GeometryReconciler reconciler;
+    MAAT_CHECK(context, reconciler.reconcile(1, kAsked, kAsked, 0) == Outcome::Accepted);
+    MAAT_CHECK(context, reconciler.limits(1) == nullptr);
+    // A moved window with the right size has nothing to learn either
+    MAAT_CHECK(context, reconciler.reconcile(1, kAsked, {30, 40, 500, 500}, 0) == Outcome::Refused);
+    // Nor does one that snapped to its increments
+    MAAT_CHECK(context, reconciler.reconcile(1, kAsked, {0, 0, 480, 491}, 0) == Outcome::Refused);
+    const maat::platform::SizeHints* limits = reconciler.limits(1);
+    MAAT_CHECK(context, limits && limits->minWidth == 0 && limits->maxWidth == 0 && limits->minHeight == 0 &&
+                            limits->maxHeight == 0);
+    MAAT_CHECK(context, reconciler.stats().checks == 3 && reconciler.stats().accepted == 1 &&
+                            reconciler.stats().refused == 2);
+}
+
+void learnsMinimumAndMaximum(TestContext& context) {
+    GeometryReconciler reconciler;
+    // Wider than asked: a minimum width; shorter: a maximum height
+    MAAT_CHECK(context, reconciler.reconcile(1, kAsked, {0, 0, 700, 300}, 0) == Outcome::Limited);
+    const maat::platform::SizeHints* limits = reconciler.limits(1);
+    MAAT_CHECK(context, limits && limits->minWidth == 700 && limits->maxHeight == 300);
+    MAAT_CHECK(context, limits && limits->maxWidth == 0 && limits->minHeight == 0);
+    // The same answer again changes nothing
+    MAAT_CHECK(context, reconciler.reconcile(1, kAsked, {0, 0, 700, 300}, 0) == Outcome::Refused);
+    // A height beyond the learned maximum retires it and becomes a minimum
+    MAAT_CHECK(context, reconciler.reconcile(1, kAsked, {0, 0, 500, 600}, 0) == Outcome::Limited);
+    limits = reconciler.limits(1);
+    MAAT_CHECK(context, limits && limits->minHeight == 600 && limits->maxHeight == 0 && limits->minWidth == 700);
+    reconciler.forget(1);
+    MAAT_CHECK(context, reconciler.limits(1) == nullptr);
+}
+
+void retryBudgetCoolsWindowDown(TestContext& context) {
+    GeometryReconciler reconciler;
+    ReconcileSettings settings;
+    settings.retryBudget = 3;
+    settings.cooldown = 1000000;
+    reconciler.setSettings(settings);
+    // Grows with every rect: each answer is a new minimum
+    for (int i = 0; i < 3; ++i) {
+        MAAT_CHECK(context, reconciler.reconcile(1, kAsked, {0, 0, 600 + 50 * i, 500}, 0) == Outcome::Limited);
+    }
+    MAAT_CHECK(context, reconciler.reconcile(1, kAsked, {0, 0, 800, 500}, 1000) == Outcome::Exhausted);
+    MAAT_CHECK(context, reconciler.limits(1)->minWidth == 700); // the spent answer was not learned
+    reconciler.expect(1, kAsked, 2000);
+    MAAT_CHECK(context, !reconciler.pending());
+    reconciler.expect(1, kAsked, 1000 + settings.cooldown);
+    MAAT_CHECK(context, reconciler.pending());
+
+    // Taking a rect refills the budget
+    MAAT_CHECK(context, reconciler.reconcile(2, kAsked, {0, 0, 600, 500}, 0) == Outcome::Limited);
+    MAAT_CHECK(context, reconciler.reconcile(2, kAsked, {0, 0, 650, 500}, 0) == Outcome::Limited);
+    MAAT_CHECK(context, reconciler.reconcile(2, kAsked, kAsked, 0) == Outcome::Accepted);
+    for (int i = 0; i < 3; ++i) {
+        MAAT_CHECK(context, reconciler.reconcile(2, kAsked, {0, 0, 700 + 50 * i, 500}, 0) == Outcome::Limited);
+    }
+    MAAT_CHECK(context, reconciler.stats().exhausted == 1 && reconciler.stats().limited == 8);
+}
+
+void checksFallDueAfterSettling(TestContext& context) {
+    GeometryReconciler reconciler;
+    ReconcileSettings settings;
+    settings.settleDelay = 1000;
+    reconciler.setSettings(settings);
+    reconciler.expect(1, kAsked, 0, 1);
+    reconciler.expect(2, kAsked, 500, 2);
+    reconciler.expect(3, kAsked, 200, 1);
+    // A second rect for a window replaces its pending check
+    reconciler.expect(3, {0, 0, 10, 10}, 300, 1);
+    MAAT_CHECK(context, reconciler.pending() && reconciler.nextCheckTime() == 1000);
+
+    Checks due;
+    reconciler.takeDue(999, 2, due);
+    MAAT_CHECK(context, due.empty());
+    reconciler.takeDue(1300, 2, due);
+    MAAT_CHECK(context, due.size() == 2);
+    bool replaced = false;
+    for (const auto& check : due) replaced = replaced || (check.first == 3 && check.second.width == 10);
+    MAAT_CHECK(context, replaced);
+    MAAT_CHECK(context, reconciler.nextCheckTime() == 1500);
+
+    // Due, but its rect is not applied yet: pushed back a whole delay
+    due.clear();
+    reconciler.takeDue(1500, 1, due);
+    MAAT_CHECK(context, due.empty() && reconciler.stats().deferred == 1);
+    MAAT_CHECK(context, reconciler.pending() && reconciler.nextCheckTime() == 2500);
+    reconciler.cancel(2);
+    MAAT_CHECK(context, !reconciler.pending());
+
+    // Disabled: nothing is checked
+    settings.enabled = false;
+    reconciler.setSettings(settings);
+    reconciler.expect(4, kAsked, 0);
+    MAAT_CHECK(context, !reconciler.pending());
+}
+
+// Width of every rect sent to `id`, in order
+std::vector<int> sentWidths(const SimStack& stack, WindowId id) {
+    std::vector<int> widths;
+    for (const Rect& rect : stack.sentRects(id)) widths.push_back(rect.width);
+    return widths;
+}
+
+void mediatorLearnsMinimumSize(TestContext& context) {
+    SimStack stack;
+    stack.core.setDefaultLayout(maat::core::LayoutKind::Columns);
+    WindowId ids[3];
+    for (WindowId& id : ids) id = stack.platform.seedWindow({10, 10, 300, 200});
+    // Hints the platform honours but does not report up front
+    maat::platform::WindowAttributes attributes;
+    attributes.className = "SimWindow";
+    attributes.processName = "sim.exe";
+    attributes.processId = 1;
+    attributes.sizeHints.minWidth = 800;
+    stack.platform.setWindowAttributes(ids[1], attributes);
+    stack.start();
+
+    // A third of 1920 was too narrow; the window kept 800 and that was learned
+    const std::vector<int> first = sentWidths(stack, ids[1]);
+    MAAT_CHECK(context, !first.empty() && first[0] == 640);
+    MAAT_CHECK(context, stack.platform.findWindow(ids[1])->getGeometry().width == 800);
+    MAAT_CHECK(context, stack.mediator.reconcileStats().limited == 1);
+
+    // Later layouts stay within it: 960 is fine, the 480 of four columns is not
+    stack.platform.clearAppliedBatches();
+    stack.platform.destroyWindow(ids[2]);
+    stack.platform.runUntilIdle();
+    stack.platform.createWindow({10, 10, 300, 200});
+    stack.platform.createWindow({10, 10, 300, 200});
+    stack.platform.runUntilIdle();
+    const std::vector<int> later = sentWidths(stack, ids[1]);
+    MAAT_CHECK(context, !later.empty());
+    for (int width : later) MAAT_CHECK(context, width >= 800);
+    MAAT_CHECK(context, stack.mediator.reconcileStats().limited == 1);
+    MAAT_CHECK(context, stack.mediator.reconcileStats().exhausted == 0);
+}
+
+void mediatorStopsAnsweringFightingWindow(TestContext& context) {
+    SimStack stack;
+    stack.core.setDefaultLayout(maat::core::LayoutKind::Columns);
+    WindowId ids[3];
+    for (WindowId& id : ids) id = stack.platform.seedWindow({10, 10, 300, 200});
+    // Whenever it is moved or resized from outside, it shifts and grows by
+    // 40 px a few ms later
+    Rect seen{10, 10, 300, 200};
+    std::function<void()> poll = [&]() {
+        Rect rect = stack.platform.findWindow(ids[0])->getGeometry();
+        if (rect.x != seen.x || rect.width != seen.width) {
+            rect.x += 40;
+            rect.width += 40;
+            stack.platform.adoptWindow(ids[0], rect);
+        }
+        seen = rect;
+        if (stack.platform.getMonotonicTime() < 30000000) stack.platform.scheduleAfter(5000, poll);
+    };
+    stack.platform.scheduleAt(1000, poll);
+    stack.start();
+
+    // A few limits learned, then left alone: not one rect per poll for 30 s
+    const maat::core::GeometryReconciler::Stats& stats = stack.mediator.reconcileStats();
+    MAAT_CHECK(context, stats.exhausted >= 1);
+    MAAT_CHECK(context, stats.limited <= stack.mediator.reconciliation().retryBudget * (stats.exhausted + 1));
+    MAAT_CHECK(context, sentWidths(stack, ids[0]).size() <= 2 * stats.limited + 2);
+}
+
+} // namespace
+
+MAAT_TEST("geometry_reconciler", acceptedRectTeachesNothing);
+MAAT_TEST("geometry_reconciler", learnsMinimumAndMaximum);
+MAAT_TEST("geometry_reconciler", retryBudgetCoolsWindowDown);
+MAAT_TEST("geometry_reconciler", checksFallDueAfterSettling);
+MAAT_TEST("geometry_reconciler", mediatorLearnsMinimumSize);
+MAAT_TEST("geometry_reconciler", mediatorStopsAnsweringFightingWindow);
+
+} // namespace tests
+} // namespace maat
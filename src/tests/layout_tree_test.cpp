@@ -0,0 +1,179 @@
+#include <vector>
+
+#include "maat_core/layout_tree.h"
+#include "test.h"
+
+// LayoutTree's constrained split solver: per-window minimum and maximum
+// sizes, the fallbacks when they cannot all hold, and the subtree limits
+// containers aggregate.
+
+namespace maat {
+namespace tests {
+
+namespace {
+
+using maat::core::LayoutTree;
+using maat::core::NodeIndex;
+using maat::core::SplitAxis;
+using maat::platform::Rect;
+using maat::platform::SizeHints;
+
+const Rect kArea{0, 0, 1000, 500};
+
+std::vector<Rect> leafRects(const LayoutTree& tree, NodeIndex root) {
+    std::vector<Rect> rects;
+    tree.forEachLeaf(root, [&rects](NodeIndex, const LayoutTree::Node& node) { rects.push_back(node.rect); });
+    return rects;
+}
+
+void layout(LayoutTree& tree, NodeIndex root) {
+    LayoutTree::GeometryList out;
+    tree.computeDirtyLayout(root, kArea, out);
+}
+
+// Side by side from the left edge, full height, nothing overlapping
+bool tiledAcross(const std::vector<Rect>& rects) {
+    int x = kArea.x;
+    for (const Rect& rect : rects) {
+        if (rect.x != x || rect.y != kArea.y || rect.height != kArea.height || rect.width < 0) return false;
+        x += rect.width;
+    }
+    return true;
+}
+
+SizeHints minWidth(int width) {
+    SizeHints hints{};
+    hints.minWidth = width;
+    return hints;
+}
+
+SizeHints maxWidth(int width) {
+    SizeHints hints{};
+    hints.maxWidth = width;
+    return hints;
+}
+
+struct Row {
+    LayoutTree tree;
+    NodeIndex root;
+    NodeIndex leaves[3];
+
+    Row() : root(tree.createRoot(SplitAxis::Horizontal)) {
+        for (int i = 0; i < 3; ++i) leaves[i] = tree.appendWindow(root, static_cast<maat::platform::WindowId>(i + 1));
+        layout(tree, root);
+    }
+};
+
+void minimumIsHonoured(TestContext& context) {
+    Row row;
+    row.tree.setLimits(row.leaves[0], minWidth(600));
+    layout(row.tree, row.root);
+    const std::vector<Rect> rects = leafRects(row.tree, row.root);
+    MAAT_CHECK(context, tiledAcross(rects));
+    MAAT_CHECK(context, rects[0].width == 600);
+    // The others share what is left by weight
+    MAAT_CHECK(context, rects[1].width == 200 && rects[2].width == 200);
+    MAAT_CHECK(context, rects[2].x + rects[2].width == 1000);
+    MAAT_CHECK(context, row.tree.solverStats().constrainedSplits >= 1);
+}
+
+void maximumIsHonoured(TestContext& context) {
+    Row row;
+    row.tree.setLimits(row.leaves[1], maxWidth(100));
+    layout(row.tree, row.root);
+    const std::vector<Rect> rects = leafRects(row.tree, row.root);
+    MAAT_CHECK(context, tiledAcross(rects));
+    MAAT_CHECK(context, rects[1].width == 100);
+    MAAT_CHECK(context, rects[0].width == 450 && rects[2].width == 450);
+}
+
+void slackLimitsChangeNothing(TestContext& context) {
+    Row plain;
+    const std::vector<Rect> expected = leafRects(plain.tree, plain.root);
+
+    Row row;
+    row.tree.setLimits(row.leaves[0], minWidth(100));
+    row.tree.setLimits(row.leaves[2], maxWidth(900));
+    layout(row.tree, row.root);
+    const std::vector<Rect> rects = leafRects(row.tree, row.root);
+    bool same = rects.size() == expected.size();
+    for (std::size_t i = 0; same && i < rects.size(); ++i) {
+        same = rects[i].x == expected[i].x && rects[i].width == expected[i].width;
+    }
+    MAAT_CHECK(context, same);
+}
+
+void overconstrainedShrinksByMinimum(TestContext& context) {
+    Row row;
+    row.tree.setLimits(row.leaves[0], minWidth(600));
+    row.tree.setLimits(row.leaves[2], minWidth(900));
+    layout(row.tree, row.root);
+    const std::vector<Rect> rects = leafRects(row.tree, row.root);
+    // Nothing overlaps and the extent is filled exactly
+    MAAT_CHECK(context, tiledAcross(rects));
+    MAAT_CHECK(context, rects[2].x + rects[2].width == 1000);
+    // In proportion to the minimums: 600:0:900 of 1000
+    MAAT_CHECK(context, rects[0].width == 400 && rects[1].width == 0 && rects[2].width == 600);
+    MAAT_CHECK(context, row.tree.solverStats().overconstrained == 1);
+}
+
+void underfilledLeavesSpaceAtTheEnd(TestContext& context) {
+    Row row;
+    for (NodeIndex leaf : row.leaves) row.tree.setLimits(leaf, maxWidth(200));
+    layout(row.tree, row.root);
+    const std::vector<Rect> rects = leafRects(row.tree, row.root);
+    MAAT_CHECK(context, tiledAcross(rects));
+    for (const Rect& rect : rects) MAAT_CHECK(context, rect.width == 200);
+    MAAT_CHECK(context, rects[2].x + rects[2].width == 600);
+    MAAT_CHECK(context, row.tree.solverStats().underfilled == 1);
+}
+
+void containersAggregateLimits(TestContext& context) {
+    Row row;
+    row.tree.setLimits(row.leaves[0], minWidth(300));
+    // Leaf 2 becomes a vertical container holding it and window 4
+    const NodeIndex added = row.tree.splitLeaf(row.leaves[1], SplitAxis::Vertical, 4);
+    row.tree.setLimits(row.leaves[1], minWidth(250));
+    row.tree.setLimits(added, minWidth(350));
+    layout(row.tree, row.root);
+
+    const NodeIndex column = row.tree.node(added).parent;
+    MAAT_CHECK(context, row.tree.isContainer(column));
+    // Across a container's axis the largest minimum applies ...
+    MAAT_CHECK(context, row.tree.node(column).limits.minWidth == 350);
+    // ... along it they add up
+    MAAT_CHECK(context, row.tree.node(row.root).limits.minWidth == 300 + 350);
+    MAAT_CHECK(context, row.tree.node(column).rect.width >= 350);
+    MAAT_CHECK(context, row.tree.node(row.leaves[0]).rect.width >= 300);
+    MAAT_CHECK(context, row.tree.limitedLeafCount() == 3);
+}
+
+void clearingLimitsRestoresWeights(TestContext& context) {
+    Row row;
+    row.tree.setLimits(row.leaves[0], minWidth(600));
+    row.tree.setLimits(row.leaves[1], maxWidth(100));
+    layout(row.tree, row.root);
+    MAAT_CHECK(context, row.tree.limitedLeafCount() == 2);
+
+    row.tree.setLimits(row.leaves[0], SizeHints{});
+    row.tree.removeLeaf(row.leaves[1]);
+    MAAT_CHECK(context, row.tree.limitedLeafCount() == 0);
+    MAAT_CHECK(context, row.tree.node(row.root).limits.minWidth == 0);
+    layout(row.tree, row.root);
+    const std::vector<Rect> rects = leafRects(row.tree, row.root);
+    MAAT_CHECK(context, rects.size() == 2 && tiledAcross(rects));
+    MAAT_CHECK(context, rects[0].width == 500 && rects[1].width == 500);
+}
+
+} // namespace
+
+MAAT_TEST("layout_tree", minimumIsHonoured);
+MAAT_TEST("layout_tree", maximumIsHonoured);
+MAAT_TEST("layout_tree", slackLimitsChangeNothing);
+MAAT_TEST("layout_tree", overconstrainedShrinksByMinimum);
+MAAT_TEST("layout_tree", underfilledLeavesSpaceAtTheEnd);
+MAAT_TEST("layout_tree", containersAggregateLimits);
+MAAT_TEST("layout_tree", clearingLimitsRestoresWeights);
+
+} // namespace tests
+} // namespace maat
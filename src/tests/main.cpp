@@ -0,0 +1,52 @@
+#include <cstdio>
+#include <cstring>
+
+#include "maat_core/log.h"
+#include "test.h"
+
+namespace maat {
+namespace tests {
+
+std::vector<TestRegistration>& registeredTests() {
+    static std::vector<TestRegistration> tests;
+    return tests;
+}
+
+void TestContext::fail(const char* expression, const char* file, int line) {
+    ++m_failures;
+    std::fprintf(stderr, "%s:%d: check failed: %s\n", file, line, expression);
+}
+
+} // namespace tests
+} // namespace maat
+
+int main(int argc, char** argv) {
+    using namespace maat::tests;
+
+    if (argc > 2) {
+        std::fprintf(stderr, "usage: maat_tests [group]\nRuns the unit tests, or those of one group.\n");
+        return 2;
+    }
+    const char* group = argc == 2 ? argv[1] : nullptr;
+
+    // Keep component chatter out of the test output
+    maat::core::Logger::instance().setMinimumLevel(maat::core::LogLevel::Warn);
+
+    std::size_t run = 0;
+    std::size_t failed = 0;
+    for (const TestRegistration& registration : registeredTests()) {
+        if (group && std::strcmp(group, registration.group) != 0) continue;
+        TestContext context;
+        registration.function(context);
+        ++run;
+        if (context.failures() != 0) ++failed;
+        std::fprintf(stderr, "[maat_tests] %s/%s %s\n", registration.group, registration.name,
+                     context.failures() == 0 ? "ok" : "FAILED");
+    }
+    if (run == 0) {
+        std::fprintf(stderr, "maat_tests: no tests in group %s\n", group ? group : "(any)");
+        return 2;
+    }
+    std::fprintf(stderr, "[maat_tests] %zu run, %zu failed\n", run, failed);
+    return failed == 0 ? 0 : 1;
+}
@@ -0,0 +1,138 @@
+#include <cstdio>
+#include <memory>
+#include <vector>
+
+#include "maat_core/monitor_topology.h"
+#include "test.h"
+
+// MonitorTopology::build() and diffTopology(), table driven: each case is a
+// sequence of platform reports, and every step lists the stable ids the
+// snapshot must assign and the diff against the step before.
+
+namespace maat {
+namespace tests {
+
+namespace {
+
+using maat::core::MonitorArea;
+using maat::core::MonitorTopology;
+using maat::core::TopologyDiff;
+using maat::platform::MonitorId;
+using maat::platform::Rect;
+
+typedef std::vector<MonitorId> Ids;
+
+const Rect kLeft{0, 0, 1920, 1040};
+const Rect kRight{1920, 0, 2560, 1400};
+const Rect kRightDocked{1920, 0, 2560, 1440};
+const Rect kAbove{0, -1080, 1920, 1080};
+
+struct Step {
+    std::vector<MonitorArea> reported; // platform handle and work area, in platform order
+    Ids ids;                           // stable ids expected, in the same order
+    Ids added;
+    Ids removed;
+    Ids resized;
+    bool reordered;
+};
+
+struct Case {
+    const char* name;
+    std::vector<Step> steps;
+};
+
+const Case kCases[] = {
+    {"first snapshot adds everything",
+     {{{{10, kLeft}, {20, kRight}}, {10, 20}, {10, 20}, {}, {}, false}}},
+    {"surviving handles keep their ids",
+     {{{{10, kLeft}, {20, kRight}}, {10, 20}, {10, 20}, {}, {}, false},
+      {{{10, kLeft}, {20, kRight}}, {10, 20}, {}, {}, {}, false},
+      {{{10, kLeft}, {20, kRightDocked}}, {10, 20}, {}, {}, {20}, false}}},
+    {"new handles take over vanished monitors' work areas",
+     {{{{10, kLeft}, {20, kRight}}, {10, 20}, {10, 20}, {}, {}, false},
+      {{{21, kRight}, {11, kLeft}}, {20, 10}, {}, {}, {}, true},
+      {{{22, kRight}, {12, kLeft}}, {20, 10}, {}, {}, {}, false}}},
+    {"a new handle with a new work area is a new monitor",
+     {{{{10, kLeft}}, {10}, {10}, {}, {}, false},
+      {{{11, kAbove}}, {11}, {11}, {10}, {}, false}}},
+    {"a surviving handle keeps its id over a new one with its old area",
+     {{{{10, kLeft}, {20, kRight}}, {10, 20}, {10, 20}, {}, {}, false},
+      {{{20, kLeft}, {30, kRight}}, {20, 30}, {30}, {10}, {20}, false}}},
+    {"only one vanished monitor is inherited per new handle",
+     {{{{10, kLeft}, {20, kLeft}}, {10, 20}, {10, 20}, {}, {}, false},
+      {{{11, kLeft}}, {10}, {}, {20}, {}, false}}},
+    {"a new handle colliding with a surviving identity gets the next free id",
+     {{{{10, kLeft}}, {10}, {10}, {}, {}, false},
+      {{{11, kLeft}}, {10}, {}, {}, {}, false},
+      {{{11, kLeft}, {10, kRight}}, {10, 11}, {11}, {}, {}, false},
+      {{{11, kLeft}, {10, kRight}}, {10, 11}, {}, {}, {}, false},
+      {{{10, kRight}, {11, kLeft}}, {11, 10}, {}, {}, {}, true}}},
+    {"collisions skip every identity in use",
+     {{{{11, kLeft}, {12, kRight}}, {11, 12}, {11, 12}, {}, {}, false},
+      {{{21, kLeft}, {22, kRight}}, {11, 12}, {}, {}, {}, false},
+      {{{21, kLeft}, {22, kRight}, {11, kAbove}}, {11, 12, 13}, {13}, {}, {}, false}}},
+    {"a surviving handle may move to another work area",
+     {{{{10, kLeft}, {11, kRight}}, {10, 11}, {10, 11}, {}, {}, false},
+      {{{12, kLeft}, {13, kRight}, {10, kAbove}}, {12, 11, 10}, {12}, {}, {10}, true}}},
+    {"a zero handle still gets a non-zero identity",
+     {{{{0, kLeft}}, {1}, {1}, {}, {}, false}}},
+    {"removing a monitor is not a reorder",
+     {{{{10, kLeft}, {20, kRight}, {30, kAbove}}, {10, 20, 30}, {10, 20, 30}, {}, {}, false},
+      {{{10, kLeft}, {30, kAbove}}, {10, 30}, {}, {20}, {}, false},
+      {{{30, kAbove}, {10, kLeft}, {40, kRight}}, {30, 10, 40}, {40}, {}, {}, true}}},
+    {"everything unplugged, then plugged back in",
+     {{{{10, kLeft}, {20, kRight}}, {10, 20}, {10, 20}, {}, {}, false},
+      {{}, {}, {}, {10, 20}, {}, false},
+      // The vanished identities are gone with the empty snapshot
+      {{{11, kLeft}, {21, kRight}}, {11, 21}, {11, 21}, {}, {}, false}}},
+};
+
+Ids idsOf(const MonitorTopology& topology) {
+    Ids ids;
+    for (const MonitorArea& monitor : topology.monitors()) ids.push_back(monitor.id);
+    return ids;
+}
+
+void buildAndDiffTable(TestContext& context) {
+    for (const Case& c : kCases) {
+        std::shared_ptr<const MonitorTopology> previous;
+        for (std::size_t s = 0; s < c.steps.size(); ++s) {
+            const Step& step = c.steps[s];
+            const std::shared_ptr<const MonitorTopology> next = MonitorTopology::build(previous.get(), step.reported);
+            const TopologyDiff diff = maat::core::diffTopology(previous.get(), *next);
+
+            bool ok = idsOf(*next) == step.ids && next->version() == s + 1;
+            ok = ok && diff.added == step.added && diff.removed == step.removed && diff.resized == step.resized &&
+                 diff.reordered == step.reordered && diff.empty() == (step.added.empty() && step.removed.empty() &&
+                                                                      step.resized.empty() && !step.reordered);
+            // Platform handles translate to the identities they were given
+            for (std::size_t i = 0; ok && i < step.reported.size(); ++i) {
+                ok = next->resolve(step.reported[i].id) == step.ids[i];
+                const MonitorArea* found = next->find(step.ids[i]);
+                ok = ok && found && found->workArea == step.reported[i].workArea;
+            }
+            if (!ok) std::fprintf(stderr, "  case \"%s\", step %zu\n", c.name, s);
+            MAAT_CHECK(context, ok);
+            previous = next;
+        }
+    }
+}
+
+void unknownHandlesResolveToZero(TestContext& context) {
+    const std::shared_ptr<const MonitorTopology> first = MonitorTopology::build(nullptr, {{10, kLeft}});
+    const std::shared_ptr<const MonitorTopology> second = MonitorTopology::build(first.get(), {{11, kLeft}});
+    MAAT_CHECK(context, second->resolve(11) == 10);
+    // The old handle is no longer reported, even though its identity lives on
+    MAAT_CHECK(context, second->resolve(10) == 0);
+    MAAT_CHECK(context, second->find(11) == nullptr && second->find(10) != nullptr);
+    // An earlier snapshot is unaffected by its successor
+    MAAT_CHECK(context, first->resolve(10) == 10 && first->version() == 1 && second->version() == 2);
+}
+
+} // namespace
+
+MAAT_TEST("monitor_topology", buildAndDiffTable);
+MAAT_TEST("monitor_topology", unknownHandlesResolveToZero);
+
+} // namespace tests
+} // namespace maat
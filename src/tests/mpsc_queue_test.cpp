@@ -0,0 +1,116 @@
+#include <atomic>
+#include <cstdint>
+#include <thread>
+#include <vector>
+
+#include "maat_platform/mpsc_queue.h"
+#include "test.h"
+
+// BoundedMpscQueue: FIFO order and wraparound from one producer, the
+// overflow policies, then several producer threads against one consumer.
+
+namespace maat {
+namespace tests {
+
+namespace {
+
+using maat::platform::BoundedMpscQueue;
+using maat::platform::OverflowPolicy;
+
+void capacityRoundsUp(TestContext& context) {
+    MAAT_CHECK(context, BoundedMpscQueue<int>(0).capacity() == 2);
+    MAAT_CHECK(context, BoundedMpscQueue<int>(5).capacity() == 8);
+    MAAT_CHECK(context, BoundedMpscQueue<int>(64).capacity() == 64);
+}
+
+void singleProducerIsFifo(TestContext& context) {
+    BoundedMpscQueue<std::uint64_t> queue(8);
+    MAAT_CHECK(context, queue.empty());
+    std::uint64_t pushed = 0;
+    std::uint64_t popped = 0;
+    bool ordered = true;
+    // Uneven bursts walk the indices around the ring many times
+    for (int round = 0; round < 1000; ++round) {
+        const int burst = 1 + round % 8;
+        for (int i = 0; i < burst; ++i) ordered = queue.push(pushed++) && ordered;
+        MAAT_CHECK(context, queue.sizeApprox() == static_cast<std::size_t>(burst));
+        std::uint64_t value = 0;
+        while (queue.pop(value)) ordered = value == popped++ && ordered;
+    }
+    MAAT_CHECK(context, ordered);
+    MAAT_CHECK(context, popped == pushed);
+    MAAT_CHECK(context, queue.empty() && queue.sizeApprox() == 0);
+    MAAT_CHECK(context, queue.droppedCount() == 0);
+}
+
+void fullQueueDropsNewest(TestContext& context) {
+    BoundedMpscQueue<int> queue(4);
+    for (int i = 0; i < 4; ++i) MAAT_CHECK(context, queue.push(i));
+    MAAT_CHECK(context, !queue.push(4));
+    // No consumer frees a cell, so the retries give up too
+    MAAT_CHECK(context, !queue.push(5, OverflowPolicy::YieldRetry));
+    MAAT_CHECK(context, queue.droppedCount() == 2);
+    // tryPush() leaves the element with the caller: nothing counts as dropped
+    MAAT_CHECK(context, !queue.tryPush(7));
+    MAAT_CHECK(context, queue.droppedCount() == 2);
+    // What was queued is intact and in order; the dropped values never show
+    int value = -1;
+    for (int i = 0; i < 4; ++i) MAAT_CHECK(context, queue.pop(value) && value == i);
+    MAAT_CHECK(context, !queue.pop(value));
+    MAAT_CHECK(context, queue.push(6) && queue.pop(value) && value == 6);
+}
+
+void producersInterleaveWithoutLoss(TestContext& context) {
+    const std::uint32_t kProducers = 4;
+    const std::uint32_t kPerProducer = 100000;
+    // Small enough that producers keep finding it full
+    BoundedMpscQueue<std::uint64_t> queue(64);
+    std::atomic<bool> go{false};
+    std::vector<std::thread> producers;
+    for (std::uint32_t p = 0; p < kProducers; ++p) {
+        producers.emplace_back([&queue, &go, p]() {
+            while (!go.load(std::memory_order_acquire)) std::this_thread::yield();
+            for (std::uint32_t i = 0; i < kPerProducer; ++i) {
+                const std::uint64_t value = (static_cast<std::uint64_t>(p) << 32) | i;
+                while (!queue.push(value, OverflowPolicy::YieldRetry)) std::this_thread::yield();
+            }
+        });
+    }
+    go.store(true, std::memory_order_release);
+
+    // Each producer's items must arrive exactly once and in its push order
+    std::vector<std::uint32_t> next(kProducers, 0);
+    std::uint64_t received = 0;
+    std::uint64_t outOfOrder = 0;
+    while (received < static_cast<std::uint64_t>(kProducers) * kPerProducer) {
+        std::uint64_t value = 0;
+        if (!queue.pop(value)) {
+            std::this_thread::yield();
+            continue;
+        }
+        const std::uint32_t producer = static_cast<std::uint32_t>(value >> 32);
+        const std::uint32_t sequence = static_cast<std::uint32_t>(value);
+        if (producer >= kProducers || sequence != next[producer]) {
+            ++outOfOrder;
+        } else {
+            ++next[producer];
+        }
+        ++received;
+    }
+    for (std::thread& producer : producers) producer.join();
+
+    MAAT_CHECK(context, outOfOrder == 0);
+    for (std::uint32_t p = 0; p < kProducers; ++p) MAAT_CHECK(context, next[p] == kPerProducer);
+    std::uint64_t value = 0;
+    MAAT_CHECK(context, !queue.pop(value));
+}
+
+} // namespace
+
+MAAT_TEST("mpsc_queue", capacityRoundsUp);
+MAAT_TEST("mpsc_queue", singleProducerIsFifo);
+MAAT_TEST("mpsc_queue", fullQueueDropsNewest);
+MAAT_TEST("mpsc_queue", producersInterleaveWithoutLoss);
+
+} // namespace tests
+} // namespace maat
@@ -0,0 +1,259 @@
+#include <cstdint>
+#include <filesystem>
+#include <map>
+#include <string>
+#include <system_error>
+#include <vector>
+
+#include "maat_core/mapped_file.h"
+#include "maat_core/session_store.h"
+#include "sim_stack.h"
+#include "test.h"
+
+// Session snapshots on the simulated backend: one instance arranges its
+// windows and saves, a fresh one with the same windows restores. Windows
+// go back to their workspaces and rects, missing ones leave no holes, and
+// a malformed snapshot restores nothing.
+
+namespace maat {
+namespace tests {
+
+namespace {
+
+using maat::core::LayoutKind;
+using maat::core::SessionStore;
+using maat::core::WindowHandle;
+using maat::platform::Rect;
+using maat::platform::WindowId;
+
+const std::size_t kWindows = 6;
+
+std::string sessionPath(const char* name) {
+    const std::string path = (std::filesystem::temp_directory_path() / name).string();
+    std::error_code error;
+    std::filesystem::remove(path, error);
+    return path;
+}
+
+std::vector<std::uint8_t> readFile(const std::string& path) {
+    maat::core::MappedFile mapped;
+    if (!mapped.open(path)) return std::vector<std::uint8_t>();
+    return std::vector<std::uint8_t>(mapped.data(), mapped.data() + mapped.size());
+}
+
+// The same windows, with the same ids, on every start; `missing` ones exist
+// but are not manageable
+std::vector<WindowId> seedWindows(SimStack& stack, std::size_t missing = kWindows) {
+    std::vector<WindowId> ids;
+    for (std::size_t i = 0; i < kWindows; ++i) {
+        const int offset = static_cast<int>(i) * 40;
+        ids.push_back(stack.platform.seedWindow({offset, offset, 300 + offset, 200}, i != missing));
+    }
+    return ids;
+}
+
+std::uint32_t workspaceOf(const SimStack& stack, WindowId id) {
+    const WindowHandle window = stack.core.windowHandle(id);
+    return window.isNull() ? 0xFFFFFFFFu : stack.core.registry().workspace(window);
+}
+
+// True if the shown windows' rects cover `area` exactly, without overlap
+bool tilesArea(const SimStack& stack, const std::vector<WindowId>& ids, const Rect& area) {
+    std::vector<Rect> rects;
+    for (WindowId id : ids) rects.push_back(stack.platform.findWindow(id)->getGeometry());
+    long long covered = 0;
+    for (std::size_t i = 0; i < rects.size(); ++i) {
+        const Rect& a = rects[i];
+        if (a.x < area.x || a.y < area.y || a.x + a.width > area.x + area.width ||
+            a.y + a.height > area.y + area.height) {
+            return false;
+        }
+        covered += static_cast<long long>(a.width) * a.height;
+        for (std::size_t j = i + 1; j < rects.size(); ++j) {
+            const Rect& b = rects[j];
+            if (a.x < b.x + b.width && b.x < a.x + a.width && a.y < b.y + b.height && b.y < a.y + a.height) {
+                return false;
+            }
+        }
+    }
+    return covered == static_cast<long long>(area.width) * area.height;
+}
+
+void windowsReturnToTheirWorkspaces(TestContext& context) {
+    const std::string path = sessionPath("maat_session_test_restore.session");
+    std::map<WindowId, std::uint32_t> workspaces;
+    std::map<WindowId, Rect> shown;
+    std::vector<WindowId> saved;
+    {
+        SessionStore store(path);
+        SimStack stack;
+        stack.mediator.registerSessionStore(store);
+        saved = seedWindows(stack);
+        stack.start();
+        // Workspace 0 in master-stack, 1 as a grid (left shown), 2 in the default tree
+        stack.core.setLayout(stack.monitor, LayoutKind::MasterStack);
+        stack.core.moveWindowToWorkspace(saved[1], 1);
+        stack.core.moveWindowToWorkspace(saved[3], 1);
+        stack.core.moveWindowToWorkspace(saved[4], 1);
+        stack.core.moveWindowToWorkspace(saved[5], 2);
+        stack.core.switchWorkspace(stack.monitor, 1);
+        stack.core.setLayout(stack.monitor, LayoutKind::Grid);
+        stack.core.flushLayout();
+        stack.platform.runUntilIdle();
+        for (WindowId id : saved) {
+            workspaces[id] = workspaceOf(stack, id);
+            if (workspaces[id] == 1) shown[id] = stack.platform.findWindow(id)->getGeometry();
+        }
+        // Saved now unless the periodic save already has this arrangement
+        stack.mediator.saveSession();
+        MAAT_CHECK(context, store.saveCount() >= 1);
+        MAAT_CHECK(context, !stack.mediator.saveSession());
+    }
+
+    SessionStore store(path);
+    SimStack stack;
+    stack.mediator.registerSessionStore(store);
+    const std::vector<WindowId> ids = seedWindows(stack);
+    MAAT_CHECK(context, ids == saved);
+    stack.start();
+    MAAT_CHECK(context, stack.mediator.restoredWindowCount() == kWindows);
+    MAAT_CHECK(context, stack.core.activeWorkspace(stack.monitor) == 1);
+    MAAT_CHECK(context, stack.core.workspaceCount(stack.monitor) == 3);
+    MAAT_CHECK(context, stack.core.layout(stack.monitor) &&
+                            stack.core.layout(stack.monitor)->kind() == LayoutKind::Grid);
+    for (WindowId id : ids) MAAT_CHECK(context, workspaceOf(stack, id) == workspaces[id]);
+    // The shown workspace is back in one batch, each window where it was
+    MAAT_CHECK(context, stack.platform.appliedBatches().size() == 1);
+    for (const auto& window : shown) {
+        MAAT_CHECK(context, stack.platform.findWindow(window.first)->getGeometry() == window.second);
+    }
+    // Workspace 0 kept its layout too
+    stack.core.switchWorkspace(stack.monitor, 0);
+    MAAT_CHECK(context, stack.core.layout(stack.monitor)->kind() == LayoutKind::MasterStack);
+
+    std::error_code error;
+    std::filesystem::remove(path, error);
+}
+
+void missingWindowsCollapseContainers(TestContext& context) {
+    const std::string path = sessionPath("maat_session_test_missing.session");
+    const Rect area{0, 0, 1920, 1080};
+    {
+        SessionStore store(path);
+        SimStack stack(area);
+        stack.mediator.registerSessionStore(store);
+        const std::vector<WindowId> ids = seedWindows(stack);
+        stack.start();
+        // Nested splits: some windows share a container with only one other
+        MAAT_CHECK(context, tilesArea(stack, ids, area));
+        stack.mediator.saveSession();
+        MAAT_CHECK(context, store.saveCount() >= 1);
+    }
+
+    // Each start saves its own arrangement; every one restores the first's
+    const std::vector<std::uint8_t> snapshot = readFile(path);
+    for (std::size_t missing = 0; missing < kWindows; ++missing) {
+        MAAT_CHECK(context, maat::core::replaceFile(path, snapshot));
+        SessionStore store(path);
+        SimStack stack(area);
+        stack.mediator.registerSessionStore(store);
+        std::vector<WindowId> ids = seedWindows(stack, missing);
+        stack.start();
+        MAAT_CHECK(context, stack.mediator.restoredWindowCount() == kWindows - 1);
+        MAAT_CHECK(context, stack.core.managedWindowCount() == kWindows - 1);
+        // The rest fill the work area: no hole where the window was
+        ids.erase(ids.begin() + static_cast<std::ptrdiff_t>(missing));
+        MAAT_CHECK(context, tilesArea(stack, ids, area));
+
+        // ... exactly as if it had been closed before the save
+        SimStack closed(area);
+        const std::vector<WindowId> all = seedWindows(closed);
+        closed.start();
+        closed.platform.destroyWindow(all[missing]);
+        closed.platform.runUntilIdle();
+        // The same tree, not only the same rects: a window opened next goes
+        // to the same place in both
+        const WindowId opened = stack.platform.createWindow({0, 0, 300, 200});
+        stack.platform.showWindow(opened);
+        stack.platform.runUntilIdle();
+        const WindowId reference = closed.platform.createWindow({0, 0, 300, 200});
+        closed.platform.showWindow(reference);
+        closed.platform.runUntilIdle();
+        MAAT_CHECK(context, stack.platform.findWindow(opened)->getGeometry() ==
+                                closed.platform.findWindow(reference)->getGeometry());
+        for (WindowId id : ids) {
+            MAAT_CHECK(context, stack.platform.findWindow(id)->getGeometry() ==
+                                    closed.platform.findWindow(id)->getGeometry());
+        }
+    }
+
+    std::error_code error;
+    std::filesystem::remove(path, error);
+}
+
+// Starts a fresh stack against the snapshot at `path`; true if nothing was
+// restored and every window was still placed as if new
+bool restoresNothing(const std::string& path) {
+    SessionStore store(path);
+    SimStack stack;
+    stack.mediator.registerSessionStore(store);
+    const std::vector<WindowId> ids = seedWindows(stack);
+    stack.start();
+    return stack.mediator.restoredWindowCount() == 0 && stack.core.managedWindowCount() == kWindows &&
+           stack.appliedGeometry().size() == kWindows && stack.core.activeWorkspace(stack.monitor) == 0;
+}
+
+void malformedSnapshotRestoresNothing(TestContext& context) {
+    const std::string path = sessionPath("maat_session_test_malformed.session");
+    std::vector<std::uint8_t> body;
+    {
+        SimStack stack;
+        const std::vector<WindowId> ids = seedWindows(stack);
+        stack.start();
+        stack.core.moveWindowToWorkspace(ids[0], 1);
+        stack.core.switchWorkspace(stack.monitor, 1);
+        MAAT_CHECK(context, stack.core.saveSession(body));
+    }
+
+    // Intact headers (SessionStore hashes whatever body it is given) around
+    // bodies the core cannot parse
+    std::vector<std::vector<std::uint8_t>> malformed;
+    malformed.push_back(std::vector<std::uint8_t>(body.begin(), body.end() - 3));
+    malformed.push_back(std::vector<std::uint8_t>(64, 0xFF));
+    malformed.push_back(std::vector<std::uint8_t>(1, 0x05)); // five monitors, none there
+    std::vector<std::uint8_t> extended = body;
+    extended.back() ^= 0x80; // a varint that runs off the end
+    malformed.push_back(extended);
+    for (const std::vector<std::uint8_t>& bad : malformed) {
+        {
+            SessionStore store(path);
+            MAAT_CHECK(context, store.save(bad));
+        }
+        MAAT_CHECK(context, restoresNothing(path));
+    }
+
+    // A damaged file fails its hash and is not even loaded
+    {
+        SessionStore store(path);
+        MAAT_CHECK(context, store.save(body));
+    }
+    std::vector<std::uint8_t> file = readFile(path);
+    MAAT_CHECK(context, !file.empty());
+    if (!file.empty()) file.back() ^= 0x01;
+    MAAT_CHECK(context, maat::core::replaceFile(path, file));
+    SessionStore store(path);
+    MAAT_CHECK(context, !store.load());
+    MAAT_CHECK(context, restoresNothing(path));
+
+    std::error_code error;
+    std::filesystem::remove(path, error);
+}
+
+} // namespace
+
+MAAT_TEST("session", windowsReturnToTheirWorkspaces);
+MAAT_TEST("session", missingWindowsCollapseContainers);
+MAAT_TEST("session", malformedSnapshotRestoresNothing);
+
+} // namespace tests
+} // namespace maat
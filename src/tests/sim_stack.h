@@ -0,0 +1,61 @@
+#ifndef MAAT_TESTS_SIM_STACK_H
+#define MAAT_TESTS_SIM_STACK_H
+
+#include <map>
+#include <vector>
+
+#include "maat_core/core_manager.h"
+#include "maat_core/maat_mediator.h"
+#include "maat_platform_sim/sim_platform_manager.h"
+
+namespace maat {
+namespace tests {
+
+// A mediator, core and simulated backend wired together on the sim's virtual
+// clock, with one primary monitor. Everything is public: configure the
+// mediator (coalescing, animation, rules), add monitors and seed windows,
+// then start(). Shared by the tests and the mediator benchmarks.
+struct SimStack {
+    maat::core::MaatMediator mediator;
+    maat::platform::SimPlatformManager platform;
+    maat::core::CoreManager core;
+    maat::platform::MonitorId monitor;
+
+    explicit SimStack(const maat::platform::Rect& monitorArea = {0, 0, 1920, 1080})
+        : platform(mediator), core(mediator) {
+        mediator.registerPlatformManager(platform);
+        mediator.registerCoreManager(core);
+        monitor = platform.addMonitor(monitorArea, true);
+    }
+
+    // Initializes the mediator and runs the startup until nothing is pending
+    void start() {
+        mediator.initialize();
+        platform.runUntilIdle();
+    }
+
+    // Every rect applied to `id`, in order
+    std::vector<maat::platform::Rect> sentRects(maat::platform::WindowId id) const {
+        std::vector<maat::platform::Rect> rects;
+        for (const auto& batch : platform.appliedBatches()) {
+            for (const auto& update : batch.updates) {
+                if (update.first == id) rects.push_back(update.second);
+            }
+        }
+        return rects;
+    }
+
+    // The last rect applied to each window
+    std::map<maat::platform::WindowId, maat::platform::Rect> appliedGeometry() const {
+        std::map<maat::platform::WindowId, maat::platform::Rect> geometry;
+        for (const auto& batch : platform.appliedBatches()) {
+            for (const auto& update : batch.updates) geometry[update.first] = update.second;
+        }
+        return geometry;
+    }
+};
+
+} // namespace tests
+} // namespace maat
+
+#endif // MAAT_TESTS_SIM_STACK_H
@@ -0,0 +1,190 @@
+#include <algorithm>
+#include <utility>
+#include <vector>
+
+#include "maat_core/spatial_index.h"
+#include "test.h"
+
+// SpatialIndex against a brute-force pass over every rect, on random
+// windows inside, across and outside three regions, then the empty-rect and
+// re-bucketing edge cases.
+
+namespace maat {
+namespace tests {
+
+namespace {
+
+using maat::core::Direction;
+using maat::core::SpatialIndex;
+using maat::platform::Rect;
+using maat::platform::WindowId;
+
+typedef std::vector<std::pair<WindowId, Rect>> Windows;
+
+bool containsPoint(const Rect& rect, int x, int y) {
+    return x >= rect.x && x < rect.x + rect.width && y >= rect.y && y < rect.y + rect.height;
+}
+
+bool intersects(const Rect& a, const Rect& b) {
+    return a.x < b.x + b.width && b.x < a.x + a.width && a.y < b.y + b.height && b.y < a.y + a.height;
+}
+
+WindowId bruteWindowAt(const Windows& windows, int x, int y) {
+    WindowId best = 0;
+    for (const auto& window : windows) {
+        if (containsPoint(window.second, x, y) && (best == 0 || window.first < best)) best = window.first;
+    }
+    return best;
+}
+
+// The rules documented on SpatialIndex::neighbour(), checked one rect at a time
+WindowId bruteNeighbour(const Windows& windows, WindowId id, Direction direction) {
+    const Rect* from = nullptr;
+    for (const auto& window : windows) {
+        if (window.first == id) from = &window.second;
+    }
+    const bool horizontal = direction == Direction::Left || direction == Direction::Right;
+    const bool forward = direction == Direction::Right || direction == Direction::Down;
+    const int fromStart = horizontal ? from->x : from->y;
+    const int fromEnd = fromStart + (horizontal ? from->width : from->height);
+    const int acrossStart = horizontal ? from->y : from->x;
+    const int acrossEnd = acrossStart + (horizontal ? from->height : from->width);
+    WindowId best = 0;
+    long long bestDistance = 0;
+    int bestShared = 0;
+    for (const auto& window : windows) {
+        if (window.first == id) continue;
+        const Rect& c = window.second;
+        const int start = horizontal ? c.x : c.y;
+        const int end = start + (horizontal ? c.width : c.height);
+        const bool past = forward ? (start >= fromEnd || start + end > 2 * fromEnd)
+                                  : (end <= fromStart || start + end < 2 * fromStart);
+        if (!past) continue;
+        const long long gap = forward ? start - fromEnd : fromStart - end;
+        const int candidateStart = horizontal ? c.y : c.x;
+        const int candidateEnd = candidateStart + (horizontal ? c.height : c.width);
+        const int shared = std::min(acrossEnd, candidateEnd) - std::max(acrossStart, candidateStart);
+        const long long distance = std::max(gap, 0LL) + (shared < 0 ? -shared : 0);
+        const int edge = std::max(shared, 0);
+        if (best == 0 || distance < bestDistance || (distance == bestDistance && edge > bestShared) ||
+            (distance == bestDistance && edge == bestShared && window.first < best)) {
+            best = window.first;
+            bestDistance = distance;
+            bestShared = edge;
+        }
+    }
+    return best;
+}
+
+Rect randomRect(Random& random) {
+    // Mostly within the regions below, some across their edges or outside
+    return {random.between(-1200, 3400), random.between(-400, 1200), random.between(20, 620), random.between(20, 520)};
+}
+
+void matchesBruteForce(TestContext& context) {
+    Random random(7);
+    std::size_t mismatches = 0;
+    for (int round = 0; round < 20; ++round) {
+        SpatialIndex index(round % 2 ? 64 : 128);
+        std::vector<Rect> regions = {{0, 0, 1920, 1080}, {1920, -200, 1280, 1024}, {-1024, 300, 1024, 768}};
+        index.setRegions(regions);
+        Windows windows;
+        const std::size_t count = 50 + random.below(150);
+        for (std::size_t i = 0; i < count; ++i) {
+            windows.emplace_back(static_cast<WindowId>(100 + i), randomRect(random));
+            index.update(windows.back().first, windows.back().second);
+        }
+        // Churn: removals and moves
+        for (std::size_t i = 0; i < count / 3; ++i) {
+            const std::size_t k = random.below(windows.size());
+            if (random.below(2)) {
+                index.remove(windows[k].first);
+                windows.erase(windows.begin() + static_cast<std::ptrdiff_t>(k));
+            } else {
+                windows[k].second = randomRect(random);
+                index.update(windows[k].first, windows[k].second);
+            }
+        }
+        if (round % 5 == 0) {
+            regions.push_back({3200, 0, 800, 600});
+            index.setRegions(regions);
+        }
+        MAAT_CHECK(context, index.size() == windows.size());
+
+        for (int q = 0; q < 200; ++q) {
+            const int x = random.between(-1200, 3400);
+            const int y = random.between(-400, 1200);
+            mismatches += index.windowAt(x, y) != bruteWindowAt(windows, x, y);
+
+            const Rect query{x, y, random.between(1, 400), random.between(1, 400)};
+            std::vector<WindowId> got;
+            std::vector<WindowId> want;
+            index.overlapping(query, got);
+            for (const auto& window : windows) {
+                if (intersects(window.second, query)) want.push_back(window.first);
+            }
+            std::sort(got.begin(), got.end());
+            std::sort(want.begin(), want.end());
+            mismatches += got != want;
+        }
+        for (const auto& window : windows) {
+            for (int d = 0; d < 4; ++d) {
+                const Direction direction = static_cast<Direction>(d);
+                mismatches += index.neighbour(window.first, direction) != bruteNeighbour(windows, window.first, direction);
+            }
+        }
+    }
+    MAAT_CHECK(context, mismatches == 0);
+}
+
+void emptyRectsAreNotIndexed(TestContext& context) {
+    SpatialIndex index;
+    index.setRegions({{0, 0, 1920, 1080}});
+    index.update(1, {100, 100, 0, 200});
+    index.update(2, {100, 100, 200, -5});
+    MAAT_CHECK(context, index.size() == 0);
+    MAAT_CHECK(context, !index.contains(1) && !index.contains(2));
+
+    index.update(3, {0, 0, 400, 400});
+    index.update(4, {400, 0, 400, 400});
+    MAAT_CHECK(context, index.neighbour(3, Direction::Right) == 4);
+    // Collapsing a window takes it out of every query
+    index.update(4, {400, 0, 0, 400});
+    MAAT_CHECK(context, !index.contains(4));
+    MAAT_CHECK(context, index.rect(4) == nullptr);
+    MAAT_CHECK(context, index.windowAt(400, 10) == 0);
+    MAAT_CHECK(context, index.neighbour(3, Direction::Right) == 0);
+    std::vector<WindowId> found;
+    index.overlapping({0, 0, 1920, 1080}, found);
+    MAAT_CHECK(context, found.size() == 1 && found[0] == 3);
+    // An empty query meets nothing
+    found.clear();
+    index.overlapping({10, 10, 0, 0}, found);
+    MAAT_CHECK(context, found.empty());
+}
+
+void regionsRebucketWindows(TestContext& context) {
+    SpatialIndex index;
+    // No regions yet: everything is in the outside list, still exact
+    index.update(1, {100, 100, 200, 200});
+    index.update(2, {2000, 100, 200, 200});
+    MAAT_CHECK(context, index.windowAt(150, 150) == 1);
+    index.setRegions({{0, 0, 1920, 1080}, {1920, 0, 1920, 1080}});
+    MAAT_CHECK(context, index.windowAt(150, 150) == 1);
+    MAAT_CHECK(context, index.windowAt(2050, 150) == 2);
+    MAAT_CHECK(context, index.neighbour(1, Direction::Right) == 2);
+    MAAT_CHECK(context, index.neighbour(2, Direction::Left) == 1);
+    const Rect* rect = index.rect(2);
+    MAAT_CHECK(context, rect && rect->x == 2000 && rect->width == 200);
+    index.clear();
+    MAAT_CHECK(context, index.size() == 0 && index.windowAt(150, 150) == 0);
+}
+
+} // namespace
+
+MAAT_TEST("spatial_index", matchesBruteForce);
+MAAT_TEST("spatial_index", emptyRectsAreNotIndexed);
+MAAT_TEST("spatial_index", regionsRebucketWindows);
+
+} // namespace tests
+} // namespace maat
@@ -0,0 +1,72 @@
+#ifndef MAAT_TESTS_TEST_H
+#define MAAT_TESTS_TEST_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace maat {
+namespace tests {
+
+// Handed to every registered test: collects failed checks. A failed check
+// is reported and the test carries on, so one run shows every broken
+// expectation.
+class TestContext {
+public:
+    void fail(const char* expression, const char* file, int line);
+    std::size_t failures() const { return m_failures; }
+
+private:
+    std::size_t m_failures = 0;
+};
+
+typedef void (*TestFunction)(TestContext& context);
+
+struct TestRegistration {
+    const char* group; // one ctest entry per group
+    const char* name;
+    TestFunction function;
+};
+
+// Tests register themselves at static-initialisation time through MAAT_TEST
+// and run in registration order, grouped by translation unit.
+std::vector<TestRegistration>& registeredTests();
+
+struct TestRegistrar {
+    TestRegistrar(const char* group, const char* name, TestFunction function) {
+        registeredTests().push_back({group, name, function});
+    }
+};
+
+#define MAAT_TEST_CONCAT_(a, b) a##b
+#define MAAT_TEST_CONCAT(a, b) MAAT_TEST_CONCAT_(a, b)
+#define MAAT_TEST(group, function) \
+    static ::maat::tests::TestRegistrar MAAT_TEST_CONCAT(s_testRegistrar, __LINE__)(group, #function, function)
+
+#define MAAT_CHECK(context, condition)                                  \
+    do {                                                                \
+        if (!(condition)) (context).fail(#condition, __FILE__, __LINE__); \
+    } while (false)
+
+// Deterministic PRNG (xorshift64*) so randomised tests fail reproducibly.
+class Random {
+public:
+    explicit Random(std::uint64_t seed = 0x9E3779B97F4A7C15ULL) : m_state(seed ? seed : 1) {}
+    std::uint64_t next() {
+        m_state ^= m_state >> 12;
+        m_state ^= m_state << 25;
+        m_state ^= m_state >> 27;
+        return m_state * 0x2545F4914F6CDD1DULL;
+    }
+    std::size_t below(std::size_t bound) { return bound ? static_cast<std::size_t>(next() % bound) : 0; }
+    // Uniform in [low, high)
+    int between(int low, int high) { return low + static_cast<int>(below(static_cast<std::size_t>(high - low))); }
+
+private:
+    std::uint64_t m_state;
+};
+
+} // namespace tests
+} // namespace maat
+
+#endif // MAAT_TESTS_TEST_H